@@ -0,0 +1,130 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_buf_pool.h>
+#include <aws/common/clock.h>
+#include <aws/common/thread.h>
+
+#include <stdio.h>
+
+/*
+ * Has N threads, for N from 1 to 16, each get a few 4-64KiB buffers, write to them, and give them back, over and over:
+ * with aws_byte_buf_init() and aws_byte_buf_clean_up(), through an aws_byte_buf_pool with thread caches, and through
+ * one without, which takes the pool's lock for every buffer.
+ */
+
+enum {
+    TOTAL_BUFFERS = 1 << 22,
+    BUFFERS_IN_FLIGHT = 3,
+    MAX_THREADS = 16,
+};
+
+static const size_t s_buffer_sizes[BUFFERS_IN_FLIGHT] = {4 * 1024, 16 * 1024, 64 * 1024};
+
+enum bench_mode {
+    BENCH_MALLOC,
+    BENCH_POOL,
+    BENCH_POOL_NO_THREAD_CACHES,
+};
+
+static const char *s_mode_names[] = {"malloc", "pool", "shared pool"};
+
+struct bench_ctx {
+    struct aws_allocator *allocator;
+    enum bench_mode mode;
+    struct aws_byte_buf_pool *pool;
+    size_t rounds_per_thread;
+};
+
+static void s_thread_fn(void *arg) {
+    struct bench_ctx *ctx = arg;
+    struct aws_byte_buf bufs[BUFFERS_IN_FLIGHT];
+
+    for (size_t round = 0; round < ctx->rounds_per_thread; ++round) {
+        for (size_t i = 0; i < BUFFERS_IN_FLIGHT; ++i) {
+            int result = ctx->mode == BENCH_MALLOC
+                             ? aws_byte_buf_init(&bufs[i], ctx->allocator, s_buffer_sizes[i])
+                             : aws_byte_buf_pool_acquire_buf(ctx->pool, s_buffer_sizes[i], &bufs[i]);
+            AWS_FATAL_ASSERT(result == AWS_OP_SUCCESS);
+            /* a message header's worth, so the allocator can't get away with never touching the memory */
+            aws_byte_buf_write_u8_n(&bufs[i], (uint8_t)round, 64);
+        }
+        for (size_t i = 0; i < BUFFERS_IN_FLIGHT; ++i) {
+            if (ctx->mode == BENCH_MALLOC) {
+                aws_byte_buf_clean_up(&bufs[i]);
+            } else {
+                aws_byte_buf_pool_release_buf(ctx->pool, &bufs[i]);
+            }
+        }
+    }
+}
+
+static int s_run(struct aws_allocator *allocator, enum bench_mode mode, size_t thread_count) {
+    struct aws_byte_buf_pool_options options = {
+        .disable_thread_caches = mode == BENCH_POOL_NO_THREAD_CACHES,
+    };
+    struct bench_ctx ctx = {
+        .allocator = allocator,
+        .mode = mode,
+        .pool = aws_byte_buf_pool_new(allocator, &options),
+        .rounds_per_thread = TOTAL_BUFFERS / BUFFERS_IN_FLIGHT / thread_count,
+    };
+    if (!ctx.pool) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_thread threads[MAX_THREADS];
+    uint64_t start = 0;
+    aws_high_res_clock_get_ticks(&start);
+    for (size_t i = 0; i < thread_count; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        if (aws_thread_launch(&threads[i], s_thread_fn, &ctx, NULL)) {
+            return AWS_OP_ERR;
+        }
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+        aws_thread_join(&threads[i]);
+        aws_thread_clean_up(&threads[i]);
+    }
+    uint64_t end = 0;
+    aws_high_res_clock_get_ticks(&end);
+
+    struct aws_byte_buf_pool_stats stats;
+    aws_byte_buf_pool_get_stats(ctx.pool, &stats);
+
+    size_t buffers = ctx.rounds_per_thread * BUFFERS_IN_FLIGHT * thread_count;
+    fprintf(
+        stdout,
+        "%-11s threads=%-2zu %8.2f Mbuffers/s",
+        s_mode_names[mode],
+        thread_count,
+        (double)buffers * 1000.0 / (double)(end - start));
+    if (mode != BENCH_MALLOC) {
+        fprintf(
+            stdout,
+            "  hit rate %6.2f%%  retained %zuKiB",
+            100.0 * (double)stats.hit_count / (double)stats.acquire_count,
+            stats.retained_bytes / 1024);
+    }
+    fprintf(stdout, "\n");
+
+    aws_byte_buf_pool_release(ctx.pool);
+    return AWS_OP_SUCCESS;
+}
+
+int main(void) {
+    struct aws_allocator *allocator = aws_default_allocator();
+    aws_common_library_init(allocator);
+
+    int result = 0;
+    for (size_t thread_count = 1; thread_count <= MAX_THREADS && !result; thread_count *= 2) {
+        for (int mode = BENCH_MALLOC; mode <= BENCH_POOL_NO_THREAD_CACHES && !result; ++mode) {
+            result = s_run(allocator, (enum bench_mode)mode, thread_count);
+        }
+    }
+
+    aws_common_library_clean_up();
+    return result;
+}
@@ -0,0 +1,141 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_buf.h>
+#include <aws/common/clock.h>
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Searches haystacks from 1KiB to 64MiB for a pattern that only occurs at the very end, with the memchr()+memcmp()
+ * loop aws_byte_cursor_find_exact() used to be, with aws_byte_cursor_find_exact(), and with a pattern prepared once
+ * by aws_byte_find_pattern_init(). The haystacks are full of the pattern's first byte, which is what made the old loop
+ * slow. Run with AWS_COMMON_AVX2=0 to measure the portable path on x86.
+ */
+
+enum {
+    /* search about this many bytes per measurement, whatever the haystack size */
+    BYTES_PER_MEASUREMENT = 256 * 1024 * 1024,
+};
+
+struct bench_case {
+    const char *name;
+    const char *filler;
+    const char *pattern;
+};
+
+static const struct bench_case s_cases[] = {
+    {
+        .name = "http headers",
+        .filler = "Header-Name: some header value\r\n",
+        .pattern = "\r\n\r\n",
+    },
+    {
+        .name = "multipart body",
+        .filler = "--\r\n--- line of body text --\r\n",
+        .pattern = "\r\n--boundary-7f3a91c2",
+    },
+    {
+        .name = "xml",
+        .filler = "<Key>photos/2024/img.jpg</Key><Size>1024</Size>",
+        .pattern = "</ListBucketResult>",
+    },
+};
+
+static const size_t s_haystack_sizes[] = {1024, 64 * 1024, 1024 * 1024, 64 * 1024 * 1024};
+
+static uint64_t s_now(void) {
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    return now;
+}
+
+/* What aws_byte_cursor_find_exact() did before: memchr() on the first byte, memcmp() at each hit. */
+static const uint8_t *s_find_memchr_memcmp(struct aws_byte_cursor haystack, struct aws_byte_cursor needle) {
+    struct aws_byte_cursor working = haystack;
+    while (working.len >= needle.len) {
+        uint8_t *first = memchr(working.ptr, needle.ptr[0], working.len);
+        if (!first) {
+            return NULL;
+        }
+        aws_byte_cursor_advance(&working, (size_t)(first - working.ptr));
+        if (working.len < needle.len) {
+            return NULL;
+        }
+        if (!memcmp(working.ptr, needle.ptr, needle.len)) {
+            return working.ptr;
+        }
+        aws_byte_cursor_advance(&working, 1);
+    }
+    return NULL;
+}
+
+/* GB/s for `iterations` searches of haystack, checking each one finds the pattern at the end. */
+static double s_measure(
+    int method,
+    struct aws_byte_cursor haystack,
+    struct aws_byte_cursor needle,
+    const struct aws_byte_find_pattern *pattern,
+    size_t iterations) {
+
+    const uint8_t *expected = haystack.ptr + haystack.len - needle.len;
+    uint64_t start = s_now();
+    for (size_t i = 0; i < iterations; ++i) {
+        const uint8_t *found = NULL;
+        struct aws_byte_cursor result;
+        switch (method) {
+            case 0:
+                found = s_find_memchr_memcmp(haystack, needle);
+                break;
+            case 1:
+                found = aws_byte_cursor_find_exact(&haystack, &needle, &result) ? NULL : result.ptr;
+                break;
+            default:
+                found = aws_byte_cursor_find_pattern(&haystack, pattern, &result) ? NULL : result.ptr;
+                break;
+        }
+        AWS_FATAL_ASSERT(found == expected);
+    }
+    uint64_t elapsed = s_now() - start;
+
+    return (double)haystack.len * (double)iterations / (double)elapsed;
+}
+
+int main(void) {
+    struct aws_allocator *allocator = aws_default_allocator();
+    size_t max_size = s_haystack_sizes[AWS_ARRAY_SIZE(s_haystack_sizes) - 1];
+    uint8_t *storage = aws_mem_acquire(allocator, max_size);
+
+    fprintf(stdout, "%-16s %10s %14s %14s %14s\n", "case", "haystack", "memchr GB/s", "find_exact", "precompiled");
+    for (size_t c = 0; c < AWS_ARRAY_SIZE(s_cases); ++c) {
+        struct aws_byte_cursor needle = aws_byte_cursor_from_c_str(s_cases[c].pattern);
+        struct aws_byte_find_pattern pattern;
+        AWS_FATAL_ASSERT(!aws_byte_find_pattern_init(&pattern, needle));
+
+        for (size_t s = 0; s < AWS_ARRAY_SIZE(s_haystack_sizes); ++s) {
+            size_t size = s_haystack_sizes[s];
+            size_t filler_len = strlen(s_cases[c].filler);
+            for (size_t i = 0; i < size; ++i) {
+                storage[i] = (uint8_t)s_cases[c].filler[i % filler_len];
+            }
+            memcpy(storage + size - needle.len, needle.ptr, needle.len);
+            struct aws_byte_cursor haystack = aws_byte_cursor_from_array(storage, size);
+
+            size_t iterations = BYTES_PER_MEASUREMENT / size;
+            fprintf(
+                stdout,
+                "%-16s %9zuK %14.2f %14.2f %14.2f\n",
+                s_cases[c].name,
+                size / 1024,
+                s_measure(0, haystack, needle, &pattern, iterations),
+                s_measure(1, haystack, needle, &pattern, iterations),
+                s_measure(2, haystack, needle, &pattern, iterations));
+        }
+    }
+
+    aws_mem_release(allocator, storage);
+    return 0;
+}
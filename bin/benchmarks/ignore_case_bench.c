@@ -0,0 +1,107 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_buf.h>
+#include <aws/common/clock.h>
+
+#include <stdio.h>
+
+/*
+ * Compares equal strings that differ only in case, from header-name sized up to 4KiB, with the byte-at-a-time table
+ * lookups aws_array_eq_ignore_case() and aws_byte_cursor_compare_lookup() used to be, and with the library. Run with
+ * AWS_COMMON_AVX2=0 to measure the SSE2 path on x86.
+ */
+
+enum {
+    /* process about this many bytes per measurement, whatever the string size */
+    BYTES_PER_MEASUREMENT = 64 * 1024 * 1024,
+};
+
+static const size_t s_sizes[] = {12, 24, 64, 256, 4096};
+
+static uint64_t s_now(void) {
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    return now;
+}
+
+static bool s_eq_table(const uint8_t *a, const uint8_t *b, size_t len) {
+    const uint8_t *table = aws_lookup_table_to_lower_get();
+    for (size_t i = 0; i < len; ++i) {
+        if (table[a[i]] != table[b[i]]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int s_compare_table(const uint8_t *a, const uint8_t *b, size_t len) {
+    const uint8_t *table = aws_lookup_table_to_lower_get();
+    for (size_t i = 0; i < len; ++i) {
+        if (table[a[i]] != table[b[i]]) {
+            return table[a[i]] < table[b[i]] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/* GB/s for `iterations` runs of `method` over a and b, checking each one finds them equal. */
+static double s_measure(int method, struct aws_byte_cursor a, struct aws_byte_cursor b, size_t iterations) {
+    const uint8_t *table = aws_lookup_table_to_lower_get();
+    uint64_t start = s_now();
+    for (size_t i = 0; i < iterations; ++i) {
+        bool equal = false;
+        switch (method) {
+            case 0:
+                equal = s_eq_table(a.ptr, b.ptr, a.len);
+                break;
+            case 1:
+                equal = aws_byte_cursor_eq_ignore_case(&a, &b);
+                break;
+            case 2:
+                equal = s_compare_table(a.ptr, b.ptr, a.len) == 0;
+                break;
+            default:
+                equal = aws_byte_cursor_compare_lookup(&a, &b, table) == 0;
+                break;
+        }
+        AWS_FATAL_ASSERT(equal);
+    }
+    uint64_t elapsed = s_now() - start;
+
+    return (double)a.len * (double)iterations / (double)elapsed;
+}
+
+int main(void) {
+    struct aws_allocator *allocator = aws_default_allocator();
+    size_t max_size = s_sizes[AWS_ARRAY_SIZE(s_sizes) - 1];
+    uint8_t *lower = aws_mem_acquire(allocator, max_size);
+    uint8_t *mixed = aws_mem_acquire(allocator, max_size);
+    const char *text = "x-amz-content-sha256: UNSIGNED-PAYLOAD; Content-Type=application/json ";
+    size_t text_len = strlen(text);
+    for (size_t i = 0; i < max_size; ++i) {
+        mixed[i] = (uint8_t)text[i % text_len];
+        lower[i] = aws_lookup_table_to_lower_get()[mixed[i]];
+    }
+
+    fprintf(stdout, "%8s %10s %10s %12s %12s   (GB/s)\n", "size", "eq table", "eq", "cmp table", "cmp");
+    for (size_t s = 0; s < AWS_ARRAY_SIZE(s_sizes); ++s) {
+        struct aws_byte_cursor a = aws_byte_cursor_from_array(mixed, s_sizes[s]);
+        struct aws_byte_cursor b = aws_byte_cursor_from_array(lower, s_sizes[s]);
+        size_t iterations = BYTES_PER_MEASUREMENT / s_sizes[s];
+        fprintf(
+            stdout,
+            "%8zu %10.2f %10.2f %12.2f %12.2f\n",
+            s_sizes[s],
+            s_measure(0, a, b, iterations),
+            s_measure(1, a, b, iterations),
+            s_measure(2, a, b, iterations),
+            s_measure(3, a, b, iterations));
+    }
+
+    aws_mem_release(allocator, mixed);
+    aws_mem_release(allocator, lower);
+    return 0;
+}
@@ -0,0 +1,195 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/array_list.h>
+#include <aws/common/clock.h>
+#include <aws/common/condition_variable.h>
+#include <aws/common/mpmc_queue.h>
+#include <aws/common/mutex.h>
+#include <aws/common/thread.h>
+
+#include <stdio.h>
+
+/*
+ * Moves a fixed number of items from N producer threads to N consumer threads, for N from 1 to 64, through an
+ * aws_mpmc_queue (blocking push/pop, one item at a time and in batches), and through the usual mutex + condition
+ * variable + aws_array_list for comparison. Both queues hold the same number of items.
+ */
+
+enum {
+    TOTAL_ITEMS = 1 << 20,
+    QUEUE_CAPACITY = 1024,
+    BATCH_SIZE = 32,
+    MAX_THREADS = 64,
+};
+
+/* The mutex based queue everyone writes by hand: a bounded aws_array_list used as a ring. */
+struct locked_queue {
+    struct aws_mutex mutex;
+    struct aws_condition_variable not_empty;
+    struct aws_condition_variable not_full;
+    struct aws_array_list items;
+    size_t head;
+    size_t count;
+};
+
+static void s_locked_push(struct locked_queue *queue, void *item) {
+    aws_mutex_lock(&queue->mutex);
+    while (queue->count == QUEUE_CAPACITY) {
+        aws_condition_variable_wait(&queue->not_full, &queue->mutex);
+    }
+    aws_array_list_set_at(&queue->items, &item, (queue->head + queue->count) % QUEUE_CAPACITY);
+    ++queue->count;
+    aws_mutex_unlock(&queue->mutex);
+    aws_condition_variable_notify_one(&queue->not_empty);
+}
+
+static void *s_locked_pop(struct locked_queue *queue) {
+    aws_mutex_lock(&queue->mutex);
+    while (queue->count == 0) {
+        aws_condition_variable_wait(&queue->not_empty, &queue->mutex);
+    }
+    void *item = NULL;
+    aws_array_list_get_at(&queue->items, &item, queue->head);
+    queue->head = (queue->head + 1) % QUEUE_CAPACITY;
+    --queue->count;
+    aws_mutex_unlock(&queue->mutex);
+    aws_condition_variable_notify_one(&queue->not_full);
+    return item;
+}
+
+enum bench_mode {
+    BENCH_MPMC,
+    BENCH_MPMC_BATCH,
+    BENCH_LOCKED,
+};
+
+static const char *s_mode_names[] = {"mpmc", "mpmc batch", "mutex+cvar"};
+
+struct bench_ctx {
+    enum bench_mode mode;
+    struct aws_mpmc_queue *mpmc;
+    struct locked_queue locked;
+    size_t items_per_thread;
+};
+
+static void s_producer_fn(void *arg) {
+    struct bench_ctx *ctx = arg;
+    void *batch[BATCH_SIZE];
+    for (size_t i = 0; i < BATCH_SIZE; ++i) {
+        batch[i] = (void *)(uintptr_t)(i + 1);
+    }
+
+    size_t remaining = ctx->items_per_thread;
+    while (remaining > 0) {
+        switch (ctx->mode) {
+            case BENCH_MPMC:
+                aws_mpmc_queue_push_wait(ctx->mpmc, batch[0], AWS_MPMC_QUEUE_WAIT_FOREVER);
+                --remaining;
+                break;
+            case BENCH_MPMC_BATCH:
+                remaining -= aws_mpmc_queue_push_batch_wait(
+                    ctx->mpmc, batch, aws_min_size(remaining, BATCH_SIZE), AWS_MPMC_QUEUE_WAIT_FOREVER);
+                break;
+            case BENCH_LOCKED:
+                s_locked_push(&ctx->locked, batch[0]);
+                --remaining;
+                break;
+        }
+    }
+}
+
+static void s_consumer_fn(void *arg) {
+    struct bench_ctx *ctx = arg;
+    void *batch[BATCH_SIZE];
+
+    size_t remaining = ctx->items_per_thread;
+    while (remaining > 0) {
+        switch (ctx->mode) {
+            case BENCH_MPMC:
+                aws_mpmc_queue_pop_wait(ctx->mpmc, &batch[0], AWS_MPMC_QUEUE_WAIT_FOREVER);
+                --remaining;
+                break;
+            case BENCH_MPMC_BATCH:
+                remaining -= aws_mpmc_queue_pop_batch_wait(
+                    ctx->mpmc, batch, aws_min_size(remaining, BATCH_SIZE), AWS_MPMC_QUEUE_WAIT_FOREVER);
+                break;
+            case BENCH_LOCKED:
+                s_locked_pop(&ctx->locked);
+                --remaining;
+                break;
+        }
+    }
+}
+
+static int s_run(struct aws_allocator *allocator, enum bench_mode mode, size_t thread_count) {
+    struct bench_ctx ctx;
+    AWS_ZERO_STRUCT(ctx);
+    ctx.mode = mode;
+    ctx.items_per_thread = TOTAL_ITEMS / thread_count;
+
+    ctx.mpmc = aws_mpmc_queue_new(allocator, QUEUE_CAPACITY);
+    if (!ctx.mpmc || aws_mutex_init(&ctx.locked.mutex) || aws_condition_variable_init(&ctx.locked.not_empty) ||
+        aws_condition_variable_init(&ctx.locked.not_full) ||
+        aws_array_list_init_dynamic(&ctx.locked.items, allocator, QUEUE_CAPACITY, sizeof(void *))) {
+        return AWS_OP_ERR;
+    }
+    void *empty = NULL;
+    for (size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+        aws_array_list_push_back(&ctx.locked.items, &empty);
+    }
+
+    struct aws_thread producers[MAX_THREADS];
+    struct aws_thread consumers[MAX_THREADS];
+
+    uint64_t start = 0;
+    aws_high_res_clock_get_ticks(&start);
+    for (size_t i = 0; i < thread_count; ++i) {
+        aws_thread_init(&consumers[i], allocator);
+        aws_thread_init(&producers[i], allocator);
+        if (aws_thread_launch(&consumers[i], s_consumer_fn, &ctx, NULL) ||
+            aws_thread_launch(&producers[i], s_producer_fn, &ctx, NULL)) {
+            return AWS_OP_ERR;
+        }
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+        aws_thread_join(&producers[i]);
+        aws_thread_join(&consumers[i]);
+        aws_thread_clean_up(&producers[i]);
+        aws_thread_clean_up(&consumers[i]);
+    }
+    uint64_t end = 0;
+    aws_high_res_clock_get_ticks(&end);
+
+    size_t items = ctx.items_per_thread * thread_count;
+    fprintf(
+        stdout,
+        "%-10s producers=consumers=%-2zu %8.2f Mitems/s\n",
+        s_mode_names[mode],
+        thread_count,
+        (double)items * 1000.0 / (double)(end - start));
+
+    aws_array_list_clean_up(&ctx.locked.items);
+    aws_condition_variable_clean_up(&ctx.locked.not_full);
+    aws_condition_variable_clean_up(&ctx.locked.not_empty);
+    aws_mutex_clean_up(&ctx.locked.mutex);
+    aws_mpmc_queue_destroy(ctx.mpmc);
+    return AWS_OP_SUCCESS;
+}
+
+int main(void) {
+    struct aws_allocator *allocator = aws_default_allocator();
+    aws_common_library_init(allocator);
+
+    int result = 0;
+    for (size_t thread_count = 1; thread_count <= MAX_THREADS && !result; thread_count *= 2) {
+        for (int mode = BENCH_MPMC; mode <= BENCH_LOCKED && !result; ++mode) {
+            result = s_run(allocator, (enum bench_mode)mode, thread_count);
+        }
+    }
+
+    aws_common_library_clean_up();
+    return result;
+}
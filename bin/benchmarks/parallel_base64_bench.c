@@ -0,0 +1,127 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_buf.h>
+#include <aws/common/clock.h>
+#include <aws/common/encoding.h>
+#include <aws/common/parallel_for.h>
+#include <aws/common/system_info.h>
+#include <aws/common/thread_pool.h>
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Base64 encodes a large buffer with a single aws_base64_encode() call, then again with aws_parallel_for() splitting
+ * the input on 3-byte boundaries across a pool with one worker per processor, and checks both outputs match.
+ */
+
+enum {
+    INPUT_SIZE = 256 * 1024 * 1024,
+    ITERATIONS = 3,
+    /* 64KiB of input per chunk at the least */
+    GRAIN_TRIPLES = 64 * 1024 / 3,
+};
+
+struct encode_job {
+    struct aws_byte_cursor input;
+    uint8_t *output;
+};
+
+static uint64_t s_now(void) {
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    return now;
+}
+
+/*
+ * Encodes input triples [begin, end). aws_base64_encode() writes a NUL terminator past its output, which would land
+ * on the next chunk's first byte, so the last triple of each chunk is encoded into a scratch buffer and copied over.
+ */
+static void s_encode_triples(size_t begin, size_t end, void *user_data) {
+    struct encode_job *job = user_data;
+
+    if (end - begin > 1) {
+        struct aws_byte_cursor head = aws_byte_cursor_from_array(job->input.ptr + begin * 3, (end - 1 - begin) * 3);
+        struct aws_byte_buf head_out = aws_byte_buf_from_empty_array(job->output + begin * 4, (end - begin) * 4);
+        AWS_FATAL_ASSERT(!aws_base64_encode(&head, &head_out));
+    }
+
+    size_t last_offset = (end - 1) * 3;
+    struct aws_byte_cursor last =
+        aws_byte_cursor_from_array(job->input.ptr + last_offset, aws_min_size(3, job->input.len - last_offset));
+    uint8_t scratch[5];
+    struct aws_byte_buf last_out = aws_byte_buf_from_empty_array(scratch, sizeof(scratch));
+    AWS_FATAL_ASSERT(!aws_base64_encode(&last, &last_out));
+    memcpy(job->output + (end - 1) * 4, scratch, 4);
+}
+
+int main(void) {
+    struct aws_allocator *allocator = aws_default_allocator();
+    aws_common_library_init(allocator);
+
+    size_t encoded_len = 0;
+    aws_base64_compute_encoded_len(INPUT_SIZE, &encoded_len);
+
+    uint8_t *input = aws_mem_acquire(allocator, INPUT_SIZE);
+    uint8_t *serial_output = aws_mem_acquire(allocator, encoded_len);
+    uint8_t *parallel_output = aws_mem_acquire(allocator, encoded_len);
+    if (!input || !serial_output || !parallel_output) {
+        return 1;
+    }
+
+    uint32_t seed = 0x2545f491;
+    for (size_t i = 0; i < INPUT_SIZE; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        input[i] = (uint8_t)(seed >> 24);
+    }
+    /* touch every output page up front so neither run pays for faulting them in */
+    memset(serial_output, 0, encoded_len);
+    memset(parallel_output, 0, encoded_len);
+
+    struct aws_thread_pool_options options = {.worker_count = aws_system_info_processor_count()};
+    struct aws_thread_pool *pool = aws_thread_pool_new(allocator, &options);
+    if (!pool) {
+        return 1;
+    }
+
+    struct aws_byte_cursor input_cur = aws_byte_cursor_from_array(input, INPUT_SIZE);
+    struct encode_job job = {.input = input_cur, .output = parallel_output};
+    size_t triple_count = (INPUT_SIZE + 2) / 3;
+
+    uint64_t best_serial = UINT64_MAX;
+    uint64_t best_parallel = UINT64_MAX;
+    for (size_t i = 0; i < ITERATIONS; ++i) {
+        struct aws_byte_buf serial_buf = aws_byte_buf_from_empty_array(serial_output, encoded_len);
+        uint64_t start = s_now();
+        AWS_FATAL_ASSERT(!aws_base64_encode(&input_cur, &serial_buf));
+        best_serial = aws_min_u64(best_serial, s_now() - start);
+
+        start = s_now();
+        aws_parallel_for(allocator, pool, 0, triple_count, GRAIN_TRIPLES, s_encode_triples, &job);
+        best_parallel = aws_min_u64(best_parallel, s_now() - start);
+    }
+
+    /* the serial output carries a NUL terminator the chunked one never writes */
+    int result = memcmp(serial_output, parallel_output, encoded_len - 1) != 0;
+
+    double mib = (double)INPUT_SIZE / (1024.0 * 1024.0);
+    fprintf(stdout, "input %.0f MiB, %zu workers\n", mib, aws_thread_pool_get_worker_count(pool));
+    fprintf(stdout, "single thread  %8.1f ms  %8.1f MiB/s\n", best_serial / 1e6, mib * 1e9 / (double)best_serial);
+    fprintf(
+        stdout, "parallel_for   %8.1f ms  %8.1f MiB/s\n", best_parallel / 1e6, mib * 1e9 / (double)best_parallel);
+    fprintf(
+        stdout,
+        "speedup        %8.2fx  (outputs %s)\n",
+        (double)best_serial / (double)best_parallel,
+        result ? "DIFFER" : "match");
+
+    aws_thread_pool_release(pool);
+    aws_mem_release(allocator, parallel_output);
+    aws_mem_release(allocator, serial_output);
+    aws_mem_release(allocator, input);
+    aws_common_library_clean_up();
+    return result;
+}
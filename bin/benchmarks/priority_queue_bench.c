@@ -0,0 +1,146 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/clock.h>
+#include <aws/common/device_random.h>
+#include <aws/common/priority_queue.h>
+
+#include <stdio.h>
+
+/*
+ * Measures push, pop, reschedule (remove + push vs. update), remove-by-backpointer and bulk build on queues shaped
+ * like a timer heap: the queue stores pointers to caller-owned structs, ordered by a 64-bit timestamp.
+ */
+
+struct bench_timer {
+    uint64_t timestamp;
+    struct aws_priority_queue_node node;
+};
+
+static int s_compare_timers(const void *a, const void *b) {
+    const struct bench_timer *timer_a = *(const struct bench_timer **)a;
+    const struct bench_timer *timer_b = *(const struct bench_timer **)b;
+    return timer_a->timestamp > timer_b->timestamp;
+}
+
+static uint64_t s_now(void) {
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    return now;
+}
+
+static void s_report(const char *op, size_t arity, size_t count, uint64_t nanos) {
+    fprintf(stdout, "%-7s arity=%-2zu n=%-8zu %8.1f ns/op\n", op, arity, count, (double)nanos / (double)count);
+}
+
+static int s_run(
+    struct aws_allocator *allocator,
+    struct bench_timer *timers,
+    struct bench_timer **timer_ptrs,
+    struct aws_priority_queue_node **timer_nodes,
+    size_t count,
+    size_t arity) {
+    struct aws_priority_queue queue;
+    if (aws_priority_queue_init_dynamic_with_arity(
+            &queue, allocator, count, sizeof(struct bench_timer *), s_compare_timers, arity)) {
+        return AWS_OP_ERR;
+    }
+
+    /* push everything, then pop everything */
+    uint64_t start = s_now();
+    for (size_t i = 0; i < count; ++i) {
+        struct bench_timer *timer = &timers[i];
+        aws_priority_queue_push_ref(&queue, &timer, &timer->node);
+    }
+    s_report("push", arity, count, s_now() - start);
+
+    start = s_now();
+    struct bench_timer *popped = NULL;
+    while (aws_priority_queue_pop(&queue, &popped) == AWS_OP_SUCCESS) {
+    }
+    s_report("pop", arity, count, s_now() - start);
+
+    /* refill, then cancel every timer in insertion order, as a connection-timeout workload would */
+    for (size_t i = 0; i < count; ++i) {
+        struct bench_timer *timer = &timers[i];
+        aws_priority_queue_push_ref(&queue, &timer, &timer->node);
+    }
+
+    /* reschedule every timer further into the future, as an idle timeout refreshed on each read would */
+    start = s_now();
+    for (size_t i = 0; i < count; ++i) {
+        struct bench_timer *timer = &timers[i];
+        aws_priority_queue_remove(&queue, &timer, &timer->node);
+        timer->timestamp += UINT32_MAX;
+        aws_priority_queue_push_ref(&queue, &timer, &timer->node);
+    }
+    s_report("resched", arity, count, s_now() - start);
+
+    start = s_now();
+    for (size_t i = 0; i < count; ++i) {
+        timers[i].timestamp += UINT32_MAX;
+        aws_priority_queue_update(&queue, &timers[i].node);
+    }
+    s_report("update", arity, count, s_now() - start);
+
+    start = s_now();
+    for (size_t i = 0; i < count; ++i) {
+        struct bench_timer *removed = NULL;
+        aws_priority_queue_remove(&queue, &removed, &timers[i].node);
+    }
+    s_report("remove", arity, count, s_now() - start);
+
+    /* bulk build from the same timers */
+    start = s_now();
+    aws_priority_queue_push_many_ref(&queue, timer_ptrs, timer_nodes, count);
+    s_report("pushmny", arity, count, s_now() - start);
+
+    aws_priority_queue_clean_up(&queue);
+    return AWS_OP_SUCCESS;
+}
+
+int main(void) {
+    struct aws_allocator *allocator = aws_default_allocator();
+    aws_common_library_init(allocator);
+
+    const size_t counts[] = {1000, 10000, 100000, 1000000};
+    const size_t arities[] = {2, 4, 8};
+
+    size_t max_count = counts[AWS_ARRAY_SIZE(counts) - 1];
+    struct bench_timer *timers = NULL;
+    struct bench_timer **timer_ptrs = NULL;
+    struct aws_priority_queue_node **timer_nodes = NULL;
+    if (!aws_mem_acquire_many(
+            allocator,
+            3,
+            &timers,
+            max_count * sizeof(*timers),
+            &timer_ptrs,
+            max_count * sizeof(*timer_ptrs),
+            &timer_nodes,
+            max_count * sizeof(*timer_nodes))) {
+        return 1;
+    }
+
+    int result = 0;
+    for (size_t c = 0; c < AWS_ARRAY_SIZE(counts) && !result; ++c) {
+        for (size_t i = 0; i < counts[c]; ++i) {
+            aws_device_random_u64(&timers[i].timestamp);
+            timers[i].timestamp >>= 1;
+            aws_priority_queue_node_init(&timers[i].node);
+            timer_ptrs[i] = &timers[i];
+            timer_nodes[i] = &timers[i].node;
+        }
+
+        for (size_t a = 0; a < AWS_ARRAY_SIZE(arities) && !result; ++a) {
+            result = s_run(allocator, timers, timer_ptrs, timer_nodes, counts[c], arities[a]);
+        }
+        fprintf(stdout, "\n");
+    }
+
+    aws_mem_release(allocator, timers);
+    aws_common_library_clean_up();
+    return result;
+}
@@ -0,0 +1,132 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_buf.h>
+#include <aws/common/clock.h>
+
+#include <stdio.h>
+
+/*
+ * Splits 64KiB inputs on a few delimiters three ways: a byte loop checking each byte against the delimiters,
+ * aws_byte_cursor_next_split() on the first delimiter and then each piece on the next one and so on, and one pass of
+ * aws_byte_cursor_next_split_on_any(). Run with AWS_COMMON_AVX2=0 to measure the portable path on x86.
+ */
+
+enum {
+    INPUT_SIZE = 64 * 1024,
+    /* split about this many bytes per measurement */
+    BYTES_PER_MEASUREMENT = 256 * 1024 * 1024,
+};
+
+struct bench_case {
+    const char *name;
+    const char *filler;
+    const char *delimiters;
+};
+
+static const struct bench_case s_cases[] = {
+    {
+        .name = "query string",
+        .filler = "X-Amz-Algorithm=AWS4-HMAC-SHA256&X-Amz-Expires=3600&prefix=photos%2F2024&",
+        .delimiters = "&=",
+    },
+    {
+        .name = "header value",
+        .filler = "max-age=31536000; includeSubDomains; preload, text/html;q=0.9, application/xhtml+xml,",
+        .delimiters = ",;",
+    },
+    {
+        .name = "xml attributes",
+        .filler = "<Contents key=\"photos/2024/img.jpg\"\tsize=\"1024\"\r\n  class=\"STANDARD\"></Contents>\n",
+        .delimiters = " \t\r\n",
+    },
+    {
+        .name = "long tokens",
+        .filler = "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef;0123456789,",
+        .delimiters = ",;",
+    },
+};
+
+static uint64_t s_now(void) {
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    return now;
+}
+
+static size_t s_count_byte_loop(struct aws_byte_cursor input, const char *delimiters) {
+    /* every split ends at a delimiter but the last */
+    size_t count = 1;
+    size_t delimiter_count = strlen(delimiters);
+    for (size_t i = 0; i < input.len; ++i) {
+        if (memchr(delimiters, input.ptr[i], delimiter_count)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+static size_t s_count_nested(struct aws_byte_cursor input, const char *delimiters) {
+    if (!*delimiters) {
+        return 1;
+    }
+    size_t count = 0;
+    struct aws_byte_cursor split = {0};
+    while (aws_byte_cursor_next_split(&input, delimiters[0], &split)) {
+        count += s_count_nested(split, delimiters + 1);
+    }
+    return count;
+}
+
+static size_t s_count_one_pass(struct aws_byte_cursor input, const struct aws_byte_delimiter_set *delimiters) {
+    size_t count = 0;
+    struct aws_byte_cursor split = {0};
+    while (aws_byte_cursor_next_split_on_any(&input, delimiters, &split)) {
+        ++count;
+    }
+    return count;
+}
+
+int main(void) {
+    struct aws_allocator *allocator = aws_default_allocator();
+    uint8_t *storage = aws_mem_acquire(allocator, INPUT_SIZE);
+    size_t iterations = BYTES_PER_MEASUREMENT / INPUT_SIZE;
+
+    fprintf(stdout, "%-16s %12s %14s %14s   (GB/s)\n", "case", "byte loop", "next_split", "split_on_any");
+    for (size_t c = 0; c < AWS_ARRAY_SIZE(s_cases); ++c) {
+        size_t filler_len = strlen(s_cases[c].filler);
+        for (size_t i = 0; i < INPUT_SIZE; ++i) {
+            storage[i] = (uint8_t)s_cases[c].filler[i % filler_len];
+        }
+        struct aws_byte_cursor input = aws_byte_cursor_from_array(storage, INPUT_SIZE);
+        struct aws_byte_delimiter_set delimiters;
+        aws_byte_delimiter_set_init(&delimiters, aws_byte_cursor_from_c_str(s_cases[c].delimiters));
+        size_t expected = s_count_one_pass(input, &delimiters);
+
+        double gbps[3];
+        for (int method = 0; method < 3; ++method) {
+            uint64_t start = s_now();
+            for (size_t i = 0; i < iterations; ++i) {
+                size_t count = 0;
+                switch (method) {
+                    case 0:
+                        count = s_count_byte_loop(input, s_cases[c].delimiters);
+                        break;
+                    case 1:
+                        count = s_count_nested(input, s_cases[c].delimiters);
+                        break;
+                    default:
+                        count = s_count_one_pass(input, &delimiters);
+                        break;
+                }
+                AWS_FATAL_ASSERT(count == expected);
+            }
+            gbps[method] = (double)INPUT_SIZE * (double)iterations / (double)(s_now() - start);
+        }
+        fprintf(stdout, "%-16s %12.2f %14.2f %14.2f\n", s_cases[c].name, gbps[0], gbps[1], gbps[2]);
+    }
+
+    aws_mem_release(allocator, storage);
+    return 0;
+}
@@ -0,0 +1,163 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/clock.h>
+#include <aws/common/device_random.h>
+#include <aws/common/task_scheduler.h>
+
+#include <stdio.h>
+
+/*
+ * Compares the heap and timing wheel backends of aws_task_scheduler under connection-timeout churn: every connection
+ * holds an idle timeout of about 30 seconds, and each simulated event loop iteration some connections see traffic,
+ * which cancels their timeout and schedules a new one. Time advances by 100 microseconds per iteration, so a few
+ * timeouts actually fire along the way.
+ */
+
+enum {
+    ITERATIONS = 2000,
+    TIME_STEP_NS = 100000,
+};
+
+static const uint64_t IDLE_TIMEOUT_NS = 30000000000ULL;
+
+struct bench_connection {
+    struct aws_task timeout_task;
+    uint64_t fired;
+};
+
+static void s_on_timeout(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    struct bench_connection *connection = arg;
+    if (status == AWS_TASK_STATUS_RUN_READY) {
+        ++connection->fired;
+    }
+}
+
+static uint64_t s_now(void) {
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    return now;
+}
+
+static uint64_t s_jitter(void) {
+    uint64_t jitter = 0;
+    aws_device_random_u64(&jitter);
+    return jitter % IDLE_TIMEOUT_NS;
+}
+
+static int s_run(
+    struct aws_allocator *allocator,
+    const struct aws_task_scheduler_options *options,
+    const char *name,
+    struct bench_connection *connections,
+    const uint32_t *activity,
+    size_t connection_count,
+    size_t events_per_iteration) {
+
+    struct aws_task_scheduler scheduler;
+    if (aws_task_scheduler_init_with_options(&scheduler, allocator, options)) {
+        return AWS_OP_ERR;
+    }
+
+    uint64_t sim_now = 0;
+    for (size_t i = 0; i < connection_count; ++i) {
+        aws_task_init(&connections[i].timeout_task, s_on_timeout, &connections[i], "bench_timeout");
+        connections[i].fired = 0;
+        aws_task_scheduler_schedule_future(&scheduler, &connections[i].timeout_task, sim_now + s_jitter());
+    }
+
+    uint64_t reschedule_nanos = 0;
+    uint64_t run_nanos = 0;
+    size_t next_event = 0;
+
+    for (size_t iteration = 0; iteration < ITERATIONS; ++iteration) {
+        sim_now += TIME_STEP_NS;
+
+        uint64_t start = s_now();
+        for (size_t e = 0; e < events_per_iteration; ++e) {
+            struct bench_connection *connection = &connections[activity[next_event++] % connection_count];
+            aws_task_scheduler_cancel_task(&scheduler, &connection->timeout_task);
+            aws_task_scheduler_schedule_future(&scheduler, &connection->timeout_task, sim_now + IDLE_TIMEOUT_NS);
+        }
+        uint64_t middle = s_now();
+        aws_task_scheduler_run_all(&scheduler, sim_now);
+        uint64_t end = s_now();
+
+        reschedule_nanos += middle - start;
+        run_nanos += end - middle;
+    }
+
+    size_t fired = 0;
+    for (size_t i = 0; i < connection_count; ++i) {
+        fired += connections[i].fired;
+    }
+
+    fprintf(
+        stdout,
+        "%-12s connections=%-8zu reschedule %7.1f ns/op   run_all %9.1f ns/iteration   fired=%zu\n",
+        name,
+        connection_count,
+        (double)reschedule_nanos / (double)(ITERATIONS * events_per_iteration),
+        (double)run_nanos / (double)ITERATIONS,
+        fired);
+
+    aws_task_scheduler_clean_up(&scheduler);
+    return AWS_OP_SUCCESS;
+}
+
+int main(void) {
+    struct aws_allocator *allocator = aws_default_allocator();
+    aws_common_library_init(allocator);
+
+    const size_t connection_counts[] = {1000, 10000, 100000, 500000};
+    const size_t events_per_iteration = 100;
+
+    struct aws_task_scheduler_options heap_options = {
+        .timer_backend = AWS_TASK_SCHEDULER_TIMER_BACKEND_HEAP,
+    };
+    struct aws_task_scheduler_options wheel_options = {
+        .timer_backend = AWS_TASK_SCHEDULER_TIMER_BACKEND_TIMING_WHEEL,
+    };
+
+    size_t max_connections = connection_counts[AWS_ARRAY_SIZE(connection_counts) - 1];
+    size_t activity_count = ITERATIONS * events_per_iteration;
+    struct bench_connection *connections = NULL;
+    uint32_t *activity = NULL;
+    if (!aws_mem_acquire_many(
+            allocator,
+            2,
+            &connections,
+            max_connections * sizeof(*connections),
+            &activity,
+            activity_count * sizeof(*activity))) {
+        return 1;
+    }
+
+    /* both backends see the same sequence of active connections */
+    for (size_t i = 0; i < activity_count; ++i) {
+        aws_device_random_u32(&activity[i]);
+    }
+
+    int result = 0;
+    for (size_t c = 0; c < AWS_ARRAY_SIZE(connection_counts) && !result; ++c) {
+        result = s_run(
+            allocator, &heap_options, "heap", connections, activity, connection_counts[c], events_per_iteration);
+        if (!result) {
+            result = s_run(
+                allocator,
+                &wheel_options,
+                "timing_wheel",
+                connections,
+                activity,
+                connection_counts[c],
+                events_per_iteration);
+        }
+    }
+
+    aws_mem_release(allocator, connections);
+    aws_common_library_clean_up();
+    return result;
+}
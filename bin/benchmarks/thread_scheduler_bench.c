@@ -0,0 +1,122 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/atomics.h>
+#include <aws/common/clock.h>
+#include <aws/common/task_scheduler.h>
+#include <aws/common/thread.h>
+#include <aws/common/thread_scheduler.h>
+
+#include <stdio.h>
+
+/*
+ * Measures cross-thread submission into aws_thread_scheduler: a number of producer threads each submit a burst of
+ * small tasks with aws_thread_scheduler_schedule_now(), and the scheduler thread runs them.
+ */
+
+enum {
+    TASKS_PER_PRODUCER = 200000,
+    MAX_PRODUCERS = 8,
+};
+
+struct bench_producer {
+    struct aws_thread_scheduler *scheduler;
+    struct aws_task *tasks;
+    uint64_t submit_nanos;
+};
+
+static struct aws_atomic_var s_tasks_run;
+
+static uint64_t s_now(void) {
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    return now;
+}
+
+static void s_task_fn(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)arg;
+    (void)status;
+    aws_atomic_fetch_add_explicit(&s_tasks_run, 1, aws_memory_order_relaxed);
+}
+
+static void s_producer_fn(void *arg) {
+    struct bench_producer *producer = arg;
+    uint64_t start = s_now();
+    for (size_t i = 0; i < TASKS_PER_PRODUCER; ++i) {
+        aws_thread_scheduler_schedule_now(producer->scheduler, &producer->tasks[i]);
+    }
+    producer->submit_nanos = s_now() - start;
+}
+
+static int s_run(struct aws_allocator *allocator, struct aws_task *tasks, size_t producer_count) {
+    struct aws_thread_scheduler *scheduler = aws_thread_scheduler_new(allocator, NULL);
+    if (!scheduler) {
+        return AWS_OP_ERR;
+    }
+
+    size_t total_tasks = producer_count * TASKS_PER_PRODUCER;
+    for (size_t i = 0; i < total_tasks; ++i) {
+        aws_task_init(&tasks[i], s_task_fn, NULL, "bench_submission");
+    }
+    aws_atomic_store_int(&s_tasks_run, 0);
+
+    struct bench_producer producers[MAX_PRODUCERS];
+    struct aws_thread threads[MAX_PRODUCERS];
+
+    uint64_t start = s_now();
+    for (size_t p = 0; p < producer_count; ++p) {
+        producers[p].scheduler = scheduler;
+        producers[p].tasks = &tasks[p * TASKS_PER_PRODUCER];
+        producers[p].submit_nanos = 0;
+        aws_thread_init(&threads[p], allocator);
+        if (aws_thread_launch(&threads[p], s_producer_fn, &producers[p], NULL)) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    uint64_t submit_nanos = 0;
+    for (size_t p = 0; p < producer_count; ++p) {
+        aws_thread_join(&threads[p]);
+        aws_thread_clean_up(&threads[p]);
+        submit_nanos += producers[p].submit_nanos;
+    }
+
+    while (aws_atomic_load_int(&s_tasks_run) < total_tasks) {
+        aws_thread_current_sleep(100000);
+    }
+    uint64_t elapsed = s_now() - start;
+
+    fprintf(
+        stdout,
+        "producers=%zu submit %7.1f ns/op   end-to-end %8.2f Mtasks/s\n",
+        producer_count,
+        (double)submit_nanos / (double)total_tasks,
+        (double)total_tasks * 1000.0 / (double)elapsed);
+
+    aws_thread_scheduler_release(scheduler);
+    return AWS_OP_SUCCESS;
+}
+
+int main(void) {
+    struct aws_allocator *allocator = aws_default_allocator();
+    aws_common_library_init(allocator);
+    aws_atomic_init_int(&s_tasks_run, 0);
+
+    struct aws_task *tasks = aws_mem_calloc(allocator, MAX_PRODUCERS * TASKS_PER_PRODUCER, sizeof(struct aws_task));
+    if (!tasks) {
+        return 1;
+    }
+
+    const size_t producer_counts[] = {1, 2, 4, MAX_PRODUCERS};
+    int result = 0;
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(producer_counts) && !result; ++i) {
+        result = s_run(allocator, tasks, producer_counts[i]);
+    }
+
+    aws_mem_release(allocator, tasks);
+    aws_common_library_clean_up();
+    return result;
+}
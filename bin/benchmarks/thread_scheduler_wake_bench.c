@@ -0,0 +1,128 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/atomics.h>
+#include <aws/common/clock.h>
+#include <aws/common/task_scheduler.h>
+#include <aws/common/thread.h>
+#include <aws/common/thread_scheduler.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Measures how quickly an idle aws_thread_scheduler reacts, for each wakeup backend:
+ * - wake: time from aws_thread_scheduler_schedule_now() on another thread to the task starting.
+ * - timer: how late a task scheduled 500us in the future starts.
+ */
+
+enum {
+    SAMPLE_COUNT = 2000,
+    /* long enough for the scheduler thread to go back to sleep between samples */
+    IDLE_NANOS = 200000,
+    TIMER_DELAY_NANOS = 500000,
+};
+
+static struct aws_atomic_var s_ran_at;
+
+static uint64_t s_now(void) {
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    return now;
+}
+
+static void s_task_fn(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)arg;
+    (void)status;
+    aws_atomic_store_int(&s_ran_at, (size_t)s_now());
+}
+
+static uint64_t s_wait_for_run(void) {
+    size_t ran_at = 0;
+    while ((ran_at = aws_atomic_load_int(&s_ran_at)) == 0) {
+        /* the task records its own start time, so how long this thread takes to notice doesn't matter */
+        aws_thread_current_sleep(10000);
+    }
+    return ran_at;
+}
+
+static int s_compare_u64(const void *a, const void *b) {
+    uint64_t lhs = *(const uint64_t *)a;
+    uint64_t rhs = *(const uint64_t *)b;
+    return lhs < rhs ? -1 : lhs > rhs;
+}
+
+static void s_report(const char *backend, const char *what, uint64_t *samples) {
+    qsort(samples, SAMPLE_COUNT, sizeof(uint64_t), s_compare_u64);
+    fprintf(
+        stdout,
+        "%-18s %-6s p50 %8.1f us   p99 %8.1f us   max %8.1f us\n",
+        backend,
+        what,
+        (double)samples[SAMPLE_COUNT / 2] / 1000.0,
+        (double)samples[SAMPLE_COUNT * 99 / 100] / 1000.0,
+        (double)samples[SAMPLE_COUNT - 1] / 1000.0);
+}
+
+static int s_run(
+    struct aws_allocator *allocator,
+    enum aws_thread_scheduler_wakeup_backend backend,
+    const char *backend_name,
+    uint64_t *samples) {
+
+    struct aws_thread_scheduler_options options = {.wakeup_backend = backend};
+    struct aws_thread_scheduler *scheduler = aws_thread_scheduler_new_with_options(allocator, &options);
+    if (!scheduler) {
+        fprintf(stdout, "%-18s not available: %s\n", backend_name, aws_error_name(aws_last_error()));
+        return AWS_OP_SUCCESS;
+    }
+
+    struct aws_task task;
+    for (size_t i = 0; i < SAMPLE_COUNT; ++i) {
+        aws_thread_current_sleep(IDLE_NANOS);
+        aws_atomic_store_int(&s_ran_at, 0);
+        aws_task_init(&task, s_task_fn, NULL, "wake_bench");
+
+        /* the clock is monotonic and samples are far apart, so it never reads 0 here */
+        uint64_t submitted_at = s_now();
+        aws_thread_scheduler_schedule_now(scheduler, &task);
+        samples[i] = s_wait_for_run() - submitted_at;
+    }
+    s_report(backend_name, "wake", samples);
+
+    for (size_t i = 0; i < SAMPLE_COUNT; ++i) {
+        aws_atomic_store_int(&s_ran_at, 0);
+        aws_task_init(&task, s_task_fn, NULL, "timer_bench");
+
+        uint64_t time_to_run = s_now() + TIMER_DELAY_NANOS;
+        aws_thread_scheduler_schedule_future(scheduler, &task, time_to_run);
+        samples[i] = s_wait_for_run() - time_to_run;
+    }
+    s_report(backend_name, "timer", samples);
+
+    aws_thread_scheduler_release(scheduler);
+    return AWS_OP_SUCCESS;
+}
+
+int main(void) {
+    struct aws_allocator *allocator = aws_default_allocator();
+    aws_common_library_init(allocator);
+    aws_atomic_init_int(&s_ran_at, 0);
+
+    uint64_t *samples = aws_mem_calloc(allocator, SAMPLE_COUNT, sizeof(uint64_t));
+    if (!samples) {
+        return 1;
+    }
+
+    int result = s_run(allocator, AWS_THREAD_SCHEDULER_WAKEUP_BACKEND_CONDITION_VARIABLE, "condition_variable", samples);
+    if (!result) {
+        result = s_run(allocator, AWS_THREAD_SCHEDULER_WAKEUP_BACKEND_EPOLL, "epoll", samples);
+    }
+
+    aws_mem_release(allocator, samples);
+    aws_common_library_clean_up();
+    return result;
+}
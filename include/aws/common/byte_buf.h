@@ -43,6 +43,28 @@ struct aws_byte_cursor {
     uint8_t *ptr;
 };
 
+/**
+ * A search pattern prepared by aws_byte_find_pattern_init(). Candidate positions are filtered on two anchor bytes of
+ * the pattern, picked to be ones that are unlikely to be common in the data, before the whole pattern is compared.
+ *
+ * All fields are private.
+ */
+struct aws_byte_find_pattern {
+    struct aws_byte_cursor pattern;
+    size_t anchor_offsets[2];
+};
+
+/**
+ * A set of delimiter bytes prepared by aws_byte_delimiter_set_init(), for splitting on any of them in one pass with
+ * aws_byte_cursor_next_split_on_any(). The set is a 256 bit bitmap, which is small enough to be looked up 16 or 32
+ * bytes at a time with byte shuffles.
+ *
+ * All fields are private.
+ */
+struct aws_byte_delimiter_set {
+    uint8_t bitmap[32];
+};
+
 /**
  * Helper macro for passing aws_byte_cursor to the printf family of functions.
  * Intended for use with the PRInSTR format macro.
@@ -326,6 +348,35 @@ int aws_byte_cursor_split_on_char_n(
     size_t n,
     struct aws_array_list *AWS_RESTRICT output);
 
+/**
+ * Prepares a set of delimiters for aws_byte_cursor_next_split_on_any(). Every byte of `delimiters` is a delimiter;
+ * repeats are fine. Typical sets are a handful of bytes: "&=" for query strings, ",;" for header values, or " \t\r\n"
+ * between XML attributes. The set doesn't point back into `delimiters` once initialized.
+ */
+AWS_COMMON_API
+void aws_byte_delimiter_set_init(struct aws_byte_delimiter_set *set, struct aws_byte_cursor delimiters);
+
+/**
+ * Same as aws_byte_cursor_next_split(), splitting on any byte in `delimiters` rather than a single char, in one pass
+ * over the input. No copies, no allocations.
+ *
+ * When a split ends at a delimiter rather than at the end of input_str, that delimiter is
+ * substr->ptr[substr->len], so formats like query strings can tell "&" from "=" without looking at the input again.
+ *
+ * Example usage.
+ * struct aws_byte_delimiter_set delimiters;
+ * aws_byte_delimiter_set_init(&delimiters, aws_byte_cursor_from_c_str("&="));
+ * struct aws_byte_cursor substr = {0};
+ * while (aws_byte_cursor_next_split_on_any(&input_str, &delimiters, &substr)) {
+ *   // ...use substr...
+ * }
+ */
+AWS_COMMON_API
+bool aws_byte_cursor_next_split_on_any(
+    const struct aws_byte_cursor *AWS_RESTRICT input_str,
+    const struct aws_byte_delimiter_set *delimiters,
+    struct aws_byte_cursor *AWS_RESTRICT substr);
+
 /**
  * Search for an exact byte match inside a cursor. The first match will be returned. Returns AWS_OP_SUCCESS
  * on successful match and first_find will be set to the offset in input_str, and length will be the remaining length
@@ -338,6 +389,23 @@ int aws_byte_cursor_find_exact(
     const struct aws_byte_cursor *AWS_RESTRICT to_find,
     struct aws_byte_cursor *first_find);
 
+/**
+ * Prepares `to_find` for repeated searches with aws_byte_cursor_find_pattern(), which then skip the setup
+ * aws_byte_cursor_find_exact() does on every call. The pattern's bytes aren't copied, and must outlive it.
+ * Raises AWS_ERROR_SHORT_BUFFER if `to_find` is empty.
+ */
+AWS_COMMON_API
+int aws_byte_find_pattern_init(struct aws_byte_find_pattern *pattern, struct aws_byte_cursor to_find);
+
+/**
+ * Same as aws_byte_cursor_find_exact(), for a pattern prepared with aws_byte_find_pattern_init().
+ */
+AWS_COMMON_API
+int aws_byte_cursor_find_pattern(
+    const struct aws_byte_cursor *AWS_RESTRICT input_str,
+    const struct aws_byte_find_pattern *AWS_RESTRICT pattern,
+    struct aws_byte_cursor *first_find);
+
 /**
  *
  * Shrinks a byte cursor from the right for as long as the supplied predicate is true
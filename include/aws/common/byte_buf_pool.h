@@ -0,0 +1,131 @@
+#ifndef AWS_COMMON_BYTE_BUF_POOL_H
+#define AWS_COMMON_BYTE_BUF_POOL_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_buf.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+struct aws_byte_buf_pool;
+
+/**
+ * Defaults for struct aws_byte_buf_pool_options.
+ */
+#define AWS_BYTE_BUF_POOL_DEFAULT_MIN_BUFFER_SIZE (4 * 1024)
+#define AWS_BYTE_BUF_POOL_DEFAULT_MAX_BUFFER_SIZE (64 * 1024)
+#define AWS_BYTE_BUF_POOL_DEFAULT_MAX_RETAINED_BYTES (4 * 1024 * 1024)
+#define AWS_BYTE_BUF_POOL_DEFAULT_THREAD_CACHE_SIZE 4
+
+struct aws_byte_buf_pool_options {
+    /**
+     * Capacity of the smallest size class. Size classes are powers of two, so this is rounded up to one, and it's at
+     * least 64. 0 means AWS_BYTE_BUF_POOL_DEFAULT_MIN_BUFFER_SIZE.
+     */
+    size_t min_buffer_size;
+
+    /**
+     * Capacity of the largest size class, rounded up to a power of two. Larger buffers are allocated and freed as
+     * usual. 0 means AWS_BYTE_BUF_POOL_DEFAULT_MAX_BUFFER_SIZE.
+     */
+    size_t max_buffer_size;
+
+    /**
+     * Most bytes the pool keeps in idle buffers, counting the thread caches. Buffers released past this are freed.
+     * Thread caches take their share of this a max_buffer_size at a time, so with many threads, part of it can be
+     * reserved without being used. 0 means AWS_BYTE_BUF_POOL_DEFAULT_MAX_RETAINED_BYTES.
+     */
+    size_t max_retained_bytes;
+
+    /**
+     * Most buffers of each size class a thread keeps for itself. 0 means AWS_BYTE_BUF_POOL_DEFAULT_THREAD_CACHE_SIZE.
+     */
+    size_t thread_cache_size;
+
+    /**
+     * If true, every thread goes through the shared free lists, which are protected by a lock.
+     */
+    bool disable_thread_caches;
+};
+
+/**
+ * What a pool has done so far, see aws_byte_buf_pool_get_stats().
+ */
+struct aws_byte_buf_pool_stats {
+    /* Buffers handed out by aws_byte_buf_pool_acquire_buf() */
+    uint64_t acquire_count;
+    /* Of those, how many were reused instead of allocated. The hit rate is hit_count / acquire_count */
+    uint64_t hit_count;
+    /* Of the hits, how many came from the calling thread's own cache, without taking the lock */
+    uint64_t thread_cache_hit_count;
+    /* Buffers given back with aws_byte_buf_pool_release_buf() */
+    uint64_t release_count;
+    /* Of those, how many were freed because the pool was full or they didn't fit a size class */
+    uint64_t discard_count;
+    /* Bytes currently kept in idle buffers, in the shared free lists and every thread cache */
+    size_t retained_bytes;
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Creates a pool of reusable byte buffers, for I/O paths that would otherwise allocate and free a buffer per message.
+ * Buffers come in power of two size classes between the minimum and maximum buffer sizes. On success, this function
+ * returns an instance with a ref-count of 1. On failure it returns NULL.
+ *
+ * options are optional.
+ *
+ * Each thread started with aws_thread keeps a few buffers of each size class for itself, so a thread that releases and
+ * acquires buffers in a loop doesn't take the pool's lock. A thread cache holds a reference to the pool's internals
+ * until its thread exits, but the buffers in it are freed along with the rest once the last reference to the pool is
+ * released. Other threads use the shared free lists.
+ *
+ * allocator must be thread safe.
+ */
+AWS_COMMON_API
+struct aws_byte_buf_pool *aws_byte_buf_pool_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_buf_pool_options *options);
+
+/**
+ * Acquire a reference to the pool.
+ */
+AWS_COMMON_API void aws_byte_buf_pool_acquire(struct aws_byte_buf_pool *pool);
+
+/**
+ * Release a reference to the pool. Releasing the last reference frees every idle buffer. Buffers that are still
+ * acquired stay valid, and must be cleaned up with aws_byte_buf_clean_up().
+ */
+AWS_COMMON_API void aws_byte_buf_pool_release(struct aws_byte_buf_pool *pool);
+
+/**
+ * Initializes `buf` as an empty buffer with a capacity of at least `min_capacity`, reusing an idle one of the
+ * right size class if there is one. Requests bigger than the largest size class get a buffer of exactly that capacity.
+ * Safe to call from any thread.
+ *
+ * The buffer is an ordinary aws_byte_buf of the pool's allocator: hand it back with aws_byte_buf_pool_release_buf(),
+ * or clean it up as usual if it goes somewhere else. Don't grow it if it's going back to the pool.
+ */
+AWS_COMMON_API
+int aws_byte_buf_pool_acquire_buf(struct aws_byte_buf_pool *pool, size_t min_capacity, struct aws_byte_buf *buf);
+
+/**
+ * Gives `buf` back to the pool and zeroes it out. Buffers that don't have the capacity of a size class, or that
+ * weren't allocated with the pool's allocator, or that would take the pool over its retained bytes limit, are cleaned
+ * up instead. Safe to call from any thread, with a buffer acquired on any thread.
+ */
+AWS_COMMON_API
+void aws_byte_buf_pool_release_buf(struct aws_byte_buf_pool *pool, struct aws_byte_buf *buf);
+
+/**
+ * Fills `stats` with what the pool has done so far. The counts from other threads' caches can lag a little behind.
+ */
+AWS_COMMON_API
+void aws_byte_buf_pool_get_stats(struct aws_byte_buf_pool *pool, struct aws_byte_buf_pool_stats *stats);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_COMMON_BYTE_BUF_POOL_H */
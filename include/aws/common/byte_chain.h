@@ -0,0 +1,194 @@
+#ifndef AWS_COMMON_BYTE_CHAIN_H
+#define AWS_COMMON_BYTE_CHAIN_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/array_list.h>
+#include <aws/common/byte_buf.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+/**
+ * A sequence of byte ranges that reads as one buffer: "these five existing buffers, concatenated", without copying
+ * any of them. Use it to assemble a payload from headers and bodies that already live elsewhere, then hand the
+ * segments to writev() or equivalent with aws_byte_chain_get_segments().
+ *
+ * A segment either borrows memory, which must stay valid for as long as it's in the chain, or owns an aws_byte_buf
+ * that was handed over to the chain, which cleans it up when the segment is consumed or the chain is cleaned up.
+ *
+ * Not thread safe.
+ */
+struct aws_byte_chain {
+    struct aws_allocator *allocator;
+    /* struct aws_byte_chain_segment, in order */
+    struct aws_array_list segments;
+    /* total bytes across all segments */
+    size_t len;
+};
+
+/**
+ * One segment of an aws_byte_chain.
+ */
+struct aws_byte_chain_segment {
+    /* the bytes this segment adds to the chain */
+    struct aws_byte_cursor cursor;
+    /* memory the chain owns, zeroed for borrowed segments */
+    struct aws_byte_buf storage;
+};
+
+/**
+ * A read position in an aws_byte_chain, which works like an aws_byte_cursor over the chain's bytes and reads across
+ * segment boundaries. Create it with aws_byte_chain_cursor_from_chain().
+ *
+ * Appending to the chain leaves the cursor valid, though it won't see the new bytes. Prepending to the chain or
+ * consuming from it invalidates the cursor.
+ */
+struct aws_byte_chain_cursor {
+    const struct aws_byte_chain *chain;
+    size_t segment_index;
+    size_t segment_offset;
+    /* bytes left to read */
+    size_t len;
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Initializes an empty chain with room for `initial_segment_count` segments before it has to grow.
+ */
+AWS_COMMON_API
+int aws_byte_chain_init(struct aws_byte_chain *chain, struct aws_allocator *allocator, size_t initial_segment_count);
+
+/**
+ * Cleans up the chain and every buffer it owns. Borrowed memory is left alone.
+ */
+AWS_COMMON_API
+void aws_byte_chain_clean_up(struct aws_byte_chain *chain);
+
+/**
+ * Returns the number of segments in the chain.
+ */
+AWS_COMMON_API
+size_t aws_byte_chain_segment_count(const struct aws_byte_chain *chain);
+
+/**
+ * Adds the bytes of `cursor` to the end of the chain, without copying them. The memory must outlive its use in the
+ * chain. Empty cursors are ignored.
+ */
+AWS_COMMON_API
+int aws_byte_chain_append(struct aws_byte_chain *chain, struct aws_byte_cursor cursor);
+
+/**
+ * Same as aws_byte_chain_append(), adding the bytes at the start of the chain instead. This moves every segment
+ * pointer in the chain, so prefer building chains front to back.
+ */
+AWS_COMMON_API
+int aws_byte_chain_prepend(struct aws_byte_chain *chain, struct aws_byte_cursor cursor);
+
+/**
+ * Adds the contents of `buf` to the end of the chain and hands its memory over to the chain, which will clean it up
+ * with buf->allocator. On success, `buf` is zeroed out and must not be used anymore; on failure, it's left as is and
+ * still belongs to the caller.
+ */
+AWS_COMMON_API
+int aws_byte_chain_append_buf(struct aws_byte_chain *chain, struct aws_byte_buf *buf);
+
+/**
+ * Same as aws_byte_chain_append_buf(), adding the bytes at the start of the chain instead.
+ */
+AWS_COMMON_API
+int aws_byte_chain_prepend_buf(struct aws_byte_chain *chain, struct aws_byte_buf *buf);
+
+/**
+ * Drops the first `len` bytes of the chain, cleaning up the buffers the chain owns as they're used up. This is what
+ * to call with the result of a partial writev(). Raises AWS_ERROR_SHORT_BUFFER, and leaves the chain as is, if
+ * `len` is longer than the chain.
+ */
+AWS_COMMON_API
+int aws_byte_chain_consume(struct aws_byte_chain *chain, size_t len);
+
+/**
+ * Appends `len` bytes of `chain`, starting `offset` bytes in, to `out`. No bytes are copied: `out` only borrows them
+ * from `chain`'s segments, so they must stay valid for as long as `out` uses them. Raises AWS_ERROR_SHORT_BUFFER if
+ * the range goes past the end of `chain`. On failure, `out` is left as is.
+ */
+AWS_COMMON_API
+int aws_byte_chain_slice(
+    const struct aws_byte_chain *chain,
+    size_t offset,
+    size_t len,
+    struct aws_byte_chain *out);
+
+/**
+ * Fills `segments` with the first `max_count` or fewer segments of the chain, in order, and returns how many were
+ * filled in. Each one maps onto a struct iovec for writev() or a WSABUF for WSASend(); call
+ * aws_byte_chain_consume() with however many bytes were written, then call this again for the rest.
+ */
+AWS_COMMON_API
+size_t aws_byte_chain_get_segments(
+    const struct aws_byte_chain *chain,
+    struct aws_byte_cursor *segments,
+    size_t max_count);
+
+/**
+ * Returns a cursor at the start of the chain, covering all of it.
+ */
+AWS_COMMON_API
+struct aws_byte_chain_cursor aws_byte_chain_cursor_from_chain(const struct aws_byte_chain *chain);
+
+/**
+ * Sets `out` to the longest run of contiguous bytes at the cursor, up to `max_len`, and advances the cursor past it.
+ * This is the zero-copy way to walk the chain's bytes. Returns false, with `out` empty, if the cursor is at the end.
+ */
+AWS_COMMON_API
+bool aws_byte_chain_cursor_next(struct aws_byte_chain_cursor *cur, size_t max_len, struct aws_byte_cursor *out);
+
+/**
+ * Advances the cursor by `len` bytes. If there aren't that many left, returns false and leaves the cursor unchanged.
+ */
+AWS_COMMON_API
+bool aws_byte_chain_cursor_advance(struct aws_byte_chain_cursor *cur, size_t len);
+
+/**
+ * Copies the next `len` bytes to `dest`, wherever the segment boundaries are, and advances the cursor past them.
+ * If there aren't that many left, returns false and leaves the cursor unchanged.
+ */
+AWS_COMMON_API
+bool aws_byte_chain_cursor_read(struct aws_byte_chain_cursor *AWS_RESTRICT cur, void *AWS_RESTRICT dest, size_t len);
+
+/**
+ * Same as aws_byte_cursor_read_u8(), reading from a chain.
+ */
+AWS_COMMON_API
+bool aws_byte_chain_cursor_read_u8(struct aws_byte_chain_cursor *AWS_RESTRICT cur, uint8_t *AWS_RESTRICT var);
+
+/**
+ * Same as aws_byte_cursor_read_be16(), reading from a chain: the bytes may span segments.
+ */
+AWS_COMMON_API
+bool aws_byte_chain_cursor_read_be16(struct aws_byte_chain_cursor *cur, uint16_t *var);
+
+/**
+ * Same as aws_byte_cursor_read_be24(), reading from a chain: the bytes may span segments.
+ */
+AWS_COMMON_API
+bool aws_byte_chain_cursor_read_be24(struct aws_byte_chain_cursor *cur, uint32_t *var);
+
+/**
+ * Same as aws_byte_cursor_read_be32(), reading from a chain: the bytes may span segments.
+ */
+AWS_COMMON_API
+bool aws_byte_chain_cursor_read_be32(struct aws_byte_chain_cursor *cur, uint32_t *var);
+
+/**
+ * Same as aws_byte_cursor_read_be64(), reading from a chain: the bytes may span segments.
+ */
+AWS_COMMON_API
+bool aws_byte_chain_cursor_read_be64(struct aws_byte_chain_cursor *cur, uint64_t *var);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_COMMON_BYTE_CHAIN_H */
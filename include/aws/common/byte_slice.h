@@ -0,0 +1,101 @@
+#ifndef AWS_COMMON_BYTE_SLICE_H
+#define AWS_COMMON_BYTE_SLICE_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_buf.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+/**
+ * A reference counted, immutable buffer, for keeping parts of a large buffer alive without copying them: a parser can
+ * hand out slices of the buffer it received into, each of which holds a reference, and the memory goes
+ * away with the last of them.
+ *
+ * Fill the buffer before sharing it. Once there are slices of it, its bytes must not change. Acquiring and releasing
+ * references is thread safe, so slices can be kept or passed on by any thread.
+ */
+struct aws_shared_buffer;
+
+/**
+ * A range of bytes in an aws_shared_buffer, holding a reference on it. Read the bytes through `cursor`; don't copy the
+ * struct itself, use aws_byte_slice_init_copy() so the reference is counted, and aws_byte_slice_clean_up() when done.
+ */
+struct aws_byte_slice {
+    struct aws_shared_buffer *owner;
+    struct aws_byte_cursor cursor;
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Creates a shared buffer with room for `capacity` bytes, in a single allocation, with a reference count of 1.
+ * Fill it through aws_shared_buffer_get_buf() before taking slices of it.
+ */
+AWS_COMMON_API
+struct aws_shared_buffer *aws_shared_buffer_new(struct aws_allocator *allocator, size_t capacity);
+
+/**
+ * Creates a shared buffer, with a reference count of 1, that takes over the memory of `buf` without copying it: the
+ * buffer will be cleaned up with buf->allocator when the last reference goes. On success, `buf` is zeroed out and
+ * must not be used anymore; on failure, it's left as is and still belongs to the caller.
+ */
+AWS_COMMON_API
+struct aws_shared_buffer *aws_shared_buffer_new_from_buf(struct aws_allocator *allocator, struct aws_byte_buf *buf);
+
+/**
+ * Adds a reference to the shared buffer, and returns it.
+ */
+AWS_COMMON_API
+struct aws_shared_buffer *aws_shared_buffer_acquire(struct aws_shared_buffer *buffer);
+
+/**
+ * Releases a reference to the shared buffer. The memory is freed when the last reference, counting the ones held by
+ * slices, is released. Does nothing if `buffer` is NULL.
+ */
+AWS_COMMON_API
+void aws_shared_buffer_release(struct aws_shared_buffer *buffer);
+
+/**
+ * Returns the buffer's memory, for filling it in. Its length is where the data stops; its capacity is fixed, so don't
+ * append to it with the dynamic byte_buf functions. Only write to it before any slices are taken.
+ */
+AWS_COMMON_API
+struct aws_byte_buf *aws_shared_buffer_get_buf(struct aws_shared_buffer *buffer);
+
+/**
+ * Initializes `out` as a slice of `buffer` covering `range`, which must point into the buffer's data, and adds a
+ * reference to the buffer for it. Typically `range` is a cursor a parser found in the buffer.
+ * Raises AWS_ERROR_INVALID_ARGUMENT if `range` isn't within the buffer's data.
+ */
+AWS_COMMON_API
+int aws_byte_slice_init(struct aws_byte_slice *out, struct aws_shared_buffer *buffer, struct aws_byte_cursor range);
+
+/**
+ * Initializes `dest` as another slice of the same bytes as `src`, with its own reference. Never allocates.
+ */
+AWS_COMMON_API
+void aws_byte_slice_init_copy(struct aws_byte_slice *dest, const struct aws_byte_slice *src);
+
+/**
+ * Releases the slice's reference and zeroes it out. Safe to call on a zeroed out slice.
+ */
+AWS_COMMON_API
+void aws_byte_slice_clean_up(struct aws_byte_slice *slice);
+
+/**
+ * Copies the slice's bytes into a shared buffer of their own if the buffer they're in is more than `max_pinned_ratio`
+ * times their size, then releases the big one: a short header value shouldn't keep a 1MiB response alive. The
+ * slice's bytes are unchanged, only where they are. Other slices of the old buffer aren't affected.
+ *
+ * Does nothing, successfully, if the slice is already a reasonable part of its buffer.
+ */
+AWS_COMMON_API
+int aws_byte_slice_compact(struct aws_byte_slice *slice, struct aws_allocator *allocator, size_t max_pinned_ratio);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_COMMON_BYTE_SLICE_H */
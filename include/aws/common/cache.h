@@ -22,16 +22,31 @@ struct aws_cache_vtable {
 
 /**
  * Base stucture for caches, used the linked hash table implementation.
+ *
+ * The table is intrusive: nodes of evicted or removed entries are kept in `free_nodes` and reused by later puts, so
+ * once a cache has been filled it no longer allocates per entry.
  */
 struct aws_cache {
     struct aws_allocator *allocator;
     const struct aws_cache_vtable *vtable;
     struct aws_linked_hash_table table;
+    struct aws_linked_list free_nodes;
     size_t max_items;
 
     void *impl;
 };
 
+/* Shared setup and put used by all cache flavors */
+int aws_cache_base_init(
+    struct aws_cache *cache,
+    struct aws_allocator *allocator,
+    aws_hash_fn *hash_fn,
+    aws_hash_callback_eq_fn *equals_fn,
+    aws_hash_callback_destroy_fn *destroy_key_fn,
+    aws_hash_callback_destroy_fn *destroy_value_fn,
+    size_t max_items);
+int aws_cache_base_put(struct aws_cache *cache, const void *key, void *p_value);
+
 /* Default implementations */
 void aws_cache_base_default_destroy(struct aws_cache *cache);
 int aws_cache_base_default_find(struct aws_cache *cache, const void *key, void **p_value);
@@ -9,10 +9,22 @@
 
 AWS_PUSH_SANE_WARNING_LEVEL
 
+struct aws_linked_hash_table_node;
+
+/**
+ * Invoked when a caller-owned node leaves an intrusive table (remove, overwrite, clear or clean up). The node has
+ * already been unlinked from the table, so it is safe to free the struct it is embedded in.
+ */
+typedef void(aws_linked_hash_table_on_node_removed_fn)(struct aws_linked_hash_table_node *node);
+
 /**
  * Simple linked hash table. Preserves insertion order, and can be iterated in insertion order.
  *
  * You can also change the order safely without altering the shape of the underlying hash table.
+ *
+ * By default the table allocates a node per entry. A table initialized with aws_linked_hash_table_init_intrusive()
+ * instead uses nodes supplied by the caller (usually embedded in the value struct), so inserting, removing and
+ * reordering entries never allocates.
  */
 struct aws_linked_hash_table {
     struct aws_allocator *allocator;
@@ -20,6 +32,8 @@ struct aws_linked_hash_table {
     struct aws_hash_table table;
     aws_hash_callback_destroy_fn *user_on_value_destroy;
     aws_hash_callback_destroy_fn *user_on_key_destroy;
+    aws_linked_hash_table_on_node_removed_fn *user_on_node_removed;
+    bool is_intrusive;
 };
 
 /**
@@ -50,6 +64,24 @@ int aws_linked_hash_table_init(
     aws_hash_callback_destroy_fn *destroy_value_fn,
     size_t initial_item_count);
 
+/**
+ * Initializes an intrusive table. Entries are added with aws_linked_hash_table_put_node() using caller-owned nodes,
+ * and the table never allocates or frees nodes itself. When an entry leaves the table, `destroy_value_fn` (if set) is
+ * invoked on its value and then `on_node_removed_fn` (if set) is invoked on its node, at which point the node may be
+ * released or reused.
+ * For the other parameters, see aws_linked_hash_table_init().
+ */
+AWS_COMMON_API
+int aws_linked_hash_table_init_intrusive(
+    struct aws_linked_hash_table *table,
+    struct aws_allocator *allocator,
+    aws_hash_fn *hash_fn,
+    aws_hash_callback_eq_fn *equals_fn,
+    aws_hash_callback_destroy_fn *destroy_key_fn,
+    aws_hash_callback_destroy_fn *destroy_value_fn,
+    aws_linked_hash_table_on_node_removed_fn *on_node_removed_fn,
+    size_t initial_item_count);
+
 /**
  * Cleans up the table. Elements in the table will be evicted and cleanup
  * callbacks will be invoked.
@@ -79,10 +111,26 @@ int aws_linked_hash_table_find_and_move_to_back(struct aws_linked_hash_table *ta
 
 /**
  * Puts `p_value` at `key`. If an element is already stored at `key` it will be replaced.
+ *
+ * Not valid on an intrusive table, use aws_linked_hash_table_put_node() instead.
  */
 AWS_COMMON_API
 int aws_linked_hash_table_put(struct aws_linked_hash_table *table, const void *key, void *p_value);
 
+/**
+ * Puts `p_value` at `key` using the caller-owned `node`, without allocating. If an element is already stored at `key`
+ * it will be replaced. The node must stay valid until the table reports its removal through the on_node_removed
+ * callback.
+ *
+ * Only valid on a table initialized with aws_linked_hash_table_init_intrusive().
+ */
+AWS_COMMON_API
+int aws_linked_hash_table_put_node(
+    struct aws_linked_hash_table *table,
+    const void *key,
+    void *p_value,
+    struct aws_linked_hash_table_node *node);
+
 /**
  * Removes item at `key` from the table.
  */
@@ -0,0 +1,95 @@
+#ifndef AWS_COMMON_MPMC_QUEUE_H
+#define AWS_COMMON_MPMC_QUEUE_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/common.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+/**
+ * Bounded lock-free queue of pointers that any number of threads can push to and pop from at once.
+ *
+ * Items come out in the order their pushes claimed a slot, which for pushes from the same thread is the order they
+ * were made. A push or pop that has claimed a slot but not finished with it yet holds up the slots behind it, so the
+ * try_* calls may report the queue as full or empty while another thread is in the middle of an operation.
+ */
+struct aws_mpmc_queue;
+
+/**
+ * Timeout for aws_mpmc_queue_push_wait() and aws_mpmc_queue_pop_wait() that never expires.
+ */
+#define AWS_MPMC_QUEUE_WAIT_FOREVER UINT64_MAX
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Creates a queue that holds up to `capacity` items, rounded up to a power of two (and at least 2). Returns NULL on
+ * failure.
+ */
+AWS_COMMON_API
+struct aws_mpmc_queue *aws_mpmc_queue_new(struct aws_allocator *allocator, size_t capacity);
+
+/**
+ * Destroys the queue. No other thread may be using it anymore. Items still in the queue are dropped.
+ */
+AWS_COMMON_API void aws_mpmc_queue_destroy(struct aws_mpmc_queue *queue);
+
+/**
+ * Returns the number of items the queue holds when full.
+ */
+AWS_COMMON_API size_t aws_mpmc_queue_get_capacity(const struct aws_mpmc_queue *queue);
+
+/**
+ * Pushes `item` and returns true, or returns false if the queue is full.
+ */
+AWS_COMMON_API bool aws_mpmc_queue_try_push(struct aws_mpmc_queue *queue, void *item);
+
+/**
+ * Pops the oldest item into `item` and returns true, or returns false if the queue is empty.
+ */
+AWS_COMMON_API bool aws_mpmc_queue_try_pop(struct aws_mpmc_queue *queue, void **item);
+
+/**
+ * Pushes as many of the `count` items as fit, in order, and returns how many that was. The items pushed take
+ * consecutive slots, so they come out back to back.
+ */
+AWS_COMMON_API size_t aws_mpmc_queue_try_push_batch(struct aws_mpmc_queue *queue, void *const *items, size_t count);
+
+/**
+ * Pops up to `count` of the oldest items into `items`, oldest first, and returns how many that was.
+ */
+AWS_COMMON_API size_t aws_mpmc_queue_try_pop_batch(struct aws_mpmc_queue *queue, void **items, size_t count);
+
+/**
+ * Same as aws_mpmc_queue_try_push(), but if the queue is full, sleeps for up to timeout_ns nanoseconds waiting for a
+ * pop to make room.
+ */
+AWS_COMMON_API bool aws_mpmc_queue_push_wait(struct aws_mpmc_queue *queue, void *item, uint64_t timeout_ns);
+
+/**
+ * Same as aws_mpmc_queue_try_pop(), but if the queue is empty, sleeps for up to timeout_ns nanoseconds waiting for a
+ * push.
+ */
+AWS_COMMON_API bool aws_mpmc_queue_pop_wait(struct aws_mpmc_queue *queue, void **item, uint64_t timeout_ns);
+
+/**
+ * Same as aws_mpmc_queue_try_push_batch(), but sleeps for up to timeout_ns nanoseconds (in total) while the queue is
+ * full and items remain. Returns how many items were pushed.
+ */
+AWS_COMMON_API size_t
+    aws_mpmc_queue_push_batch_wait(struct aws_mpmc_queue *queue, void *const *items, size_t count, uint64_t timeout_ns);
+
+/**
+ * Same as aws_mpmc_queue_try_pop_batch(), but if the queue is empty, sleeps for up to timeout_ns nanoseconds waiting
+ * for a push. Returns as soon as at least one item was popped.
+ */
+AWS_COMMON_API size_t
+    aws_mpmc_queue_pop_batch_wait(struct aws_mpmc_queue *queue, void **items, size_t count, uint64_t timeout_ns);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_COMMON_MPMC_QUEUE_H */
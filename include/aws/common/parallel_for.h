@@ -0,0 +1,80 @@
+#ifndef AWS_COMMON_PARALLEL_FOR_H
+#define AWS_COMMON_PARALLEL_FOR_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/common.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+struct aws_thread_pool;
+
+/**
+ * Processes the elements in [begin, end). Called with disjoint sub-ranges of the whole range, possibly from several
+ * threads at once.
+ */
+typedef void(aws_parallel_for_fn)(size_t begin, size_t end, void *user_data);
+
+/**
+ * Accumulates the elements in [begin, end) into partial_result, which starts out as a copy of the identity passed to
+ * aws_parallel_reduce(). Called with disjoint sub-ranges of the whole range, possibly from several threads at once.
+ */
+typedef void(aws_parallel_reduce_fn)(size_t begin, size_t end, void *partial_result, void *user_data);
+
+/**
+ * Folds partial_result into result. Only ever called from the thread that called aws_parallel_reduce(), with the
+ * partial results in the order of the sub-ranges they cover, so the operation only needs to be associative.
+ */
+typedef void(aws_parallel_combine_fn)(void *result, const void *partial_result, void *user_data);
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Calls fn over [begin, end), split into chunks that run on the pool's workers and on the calling thread, and returns
+ * once every element has been processed.
+ *
+ * The range is split into about four chunks per thread, so that threads that finish early can pick up more, but no
+ * chunk is smaller than grain elements: grain should be the amount of work that is worth handing to another thread.
+ * If the whole range fits in one chunk, or pool is NULL, fn is called once on the calling thread.
+ *
+ * The calling thread always takes part, and never waits for a worker to become free, so this may be called from a
+ * task running on the pool itself. allocator is used for the bookkeeping shared with the workers. If that allocation
+ * fails, fn is called once on the calling thread.
+ */
+AWS_COMMON_API
+void aws_parallel_for(
+    struct aws_allocator *allocator,
+    struct aws_thread_pool *pool,
+    size_t begin,
+    size_t end,
+    size_t grain,
+    aws_parallel_for_fn *fn,
+    void *user_data);
+
+/**
+ * Reduces [begin, end) in parallel, chunked the same way as aws_parallel_for(). Each chunk is accumulated by reduce_fn
+ * into its own result_size bytes partial result, initialized from identity. The partial results are then folded into
+ * result, in order, with combine_fn. result should hold the initial value, usually the identity, when this is called.
+ *
+ * Returns AWS_OP_ERR if the partial results can't be allocated, in which case nothing has been called yet.
+ */
+AWS_COMMON_API
+int aws_parallel_reduce(
+    struct aws_allocator *allocator,
+    struct aws_thread_pool *pool,
+    size_t begin,
+    size_t end,
+    size_t grain,
+    size_t result_size,
+    const void *identity,
+    void *result,
+    aws_parallel_reduce_fn *reduce_fn,
+    aws_parallel_combine_fn *combine_fn,
+    void *user_data);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_COMMON_PARALLEL_FOR_H */
@@ -0,0 +1,130 @@
+#ifndef AWS_COMMON_PERSISTENT_RING_BUFFER_H
+#define AWS_COMMON_PERSISTENT_RING_BUFFER_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_buf.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+struct aws_persistent_ring_buffer;
+
+/**
+ * Sync interval used by AWS_PERSISTENT_RING_BUFFER_SYNC_PERIODIC when none is given.
+ */
+#define AWS_PERSISTENT_RING_BUFFER_DEFAULT_SYNC_INTERVAL_NS 1000000000ULL
+
+/**
+ * When the file is synced to stable storage. Everything pushed survives the process crashing regardless, since the
+ * file's pages live in the OS page cache; syncing is what makes it survive the OS crashing or losing power.
+ */
+enum aws_persistent_ring_buffer_sync_policy {
+    /**
+     * Never sync, except through aws_persistent_ring_buffer_sync(). The OS writes the pages back whenever it likes.
+     */
+    AWS_PERSISTENT_RING_BUFFER_SYNC_NEVER,
+    /**
+     * Sync everything from inside push or consume once sync_interval_ns has passed since the last sync.
+     */
+    AWS_PERSISTENT_RING_BUFFER_SYNC_PERIODIC,
+    /**
+     * Every push syncs its record and then the header before returning. Consumes are synced along with the next push.
+     */
+    AWS_PERSISTENT_RING_BUFFER_SYNC_PER_COMMIT,
+};
+
+struct aws_persistent_ring_buffer_options {
+    /**
+     * Path of the backing file. It is created if it doesn't exist.
+     */
+    struct aws_byte_cursor path;
+
+    /**
+     * Bytes of record storage, rounded up to a multiple of 4096. Only used when the file doesn't already hold a valid
+     * ring buffer; otherwise the capacity it was created with is kept.
+     */
+    size_t capacity;
+
+    enum aws_persistent_ring_buffer_sync_policy sync_policy;
+
+    /**
+     * Only used with AWS_PERSISTENT_RING_BUFFER_SYNC_PERIODIC. 0 means
+     * AWS_PERSISTENT_RING_BUFFER_DEFAULT_SYNC_INTERVAL_NS.
+     */
+    uint64_t sync_interval_ns;
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Opens a FIFO of variable-length records kept in a memory-mapped file, so that records pushed by one run of a process
+ * can be consumed by the next one.
+ *
+ * The file starts with a small header recording where the oldest and newest records are, kept twice so that a torn
+ * write to one copy falls back on the other. Each record carries a checksum of its contents and position. When an
+ * existing file is opened, every record between the two ends is checked, and the buffer is cut short at the first one
+ * that is torn or missing (from a crash or a truncated file). A file without a valid header starts over empty.
+ *
+ * Delivery is at-least-once: records consumed shortly before a crash can come back after it. The file format uses
+ * native byte order and isn't meant to move between machines.
+ *
+ * Not thread safe: calls must be serialized by the caller. Returns NULL on failure.
+ */
+AWS_COMMON_API
+struct aws_persistent_ring_buffer *aws_persistent_ring_buffer_new(
+    struct aws_allocator *allocator,
+    const struct aws_persistent_ring_buffer_options *options);
+
+/**
+ * Syncs the file (unless the policy is AWS_PERSISTENT_RING_BUFFER_SYNC_NEVER), unmaps it, and frees the buffer.
+ * Unconsumed records stay in the file.
+ */
+AWS_COMMON_API void aws_persistent_ring_buffer_destroy(struct aws_persistent_ring_buffer *buffer);
+
+/**
+ * Returns the bytes of record storage in the file.
+ */
+AWS_COMMON_API size_t aws_persistent_ring_buffer_get_capacity(const struct aws_persistent_ring_buffer *buffer);
+
+/**
+ * Returns the number of records pushed (or recovered) and not yet consumed.
+ */
+AWS_COMMON_API size_t aws_persistent_ring_buffer_get_record_count(const struct aws_persistent_ring_buffer *buffer);
+
+/**
+ * Copies `record` into the file as the newest record. Each record takes 16 bytes plus its size rounded up to 8, and
+ * one that doesn't fit before the end of the storage starts over at the beginning.
+ *
+ * Raises AWS_ERROR_OOM if there is not enough free space right now, and AWS_ERROR_INVALID_ARGUMENT if the record could
+ * never fit. A failed sync is raised too, but the record stays pushed, unless it was the sync that
+ * AWS_PERSISTENT_RING_BUFFER_SYNC_PER_COMMIT does before reusing space freed by unsynced consumes.
+ */
+AWS_COMMON_API int aws_persistent_ring_buffer_push(
+    struct aws_persistent_ring_buffer *buffer,
+    struct aws_byte_cursor record);
+
+/**
+ * Points `record` at the oldest record, in place, and returns true, or returns false if there is none. The record stays
+ * valid until it is consumed.
+ */
+AWS_COMMON_API bool aws_persistent_ring_buffer_peek(
+    const struct aws_persistent_ring_buffer *buffer,
+    struct aws_byte_cursor *record);
+
+/**
+ * Drops the oldest record, or raises AWS_ERROR_LIST_EMPTY if there is none. A failed sync under
+ * AWS_PERSISTENT_RING_BUFFER_SYNC_PERIODIC is raised too, but the record stays consumed.
+ */
+AWS_COMMON_API int aws_persistent_ring_buffer_consume(struct aws_persistent_ring_buffer *buffer);
+
+/**
+ * Syncs all records and then the header to stable storage, whatever the policy.
+ */
+AWS_COMMON_API int aws_persistent_ring_buffer_sync(struct aws_persistent_ring_buffer *buffer);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_COMMON_PERSISTENT_RING_BUFFER_H */
@@ -19,6 +19,9 @@ AWS_PUSH_SANE_WARNING_LEVEL
  */
 typedef int(aws_priority_queue_compare_fn)(const void *a, const void *b);
 
+/* Largest number of children per node supported by aws_priority_queue_init_dynamic_with_arity() */
+#define AWS_PRIORITY_QUEUE_MAX_ARITY 16
+
 struct aws_priority_queue {
     /**
      * predicate that determines the priority of the elements in the queue.
@@ -40,6 +43,11 @@ struct aws_priority_queue {
      * with information needed to locate and remove a specific node later on.
      */
     struct aws_array_list backpointers;
+
+    /**
+     * Number of children per heap node. 0 means the default binary heap.
+     */
+    size_t arity;
 };
 
 struct aws_priority_queue_node {
@@ -63,6 +71,23 @@ int aws_priority_queue_init_dynamic(
     size_t item_size,
     aws_priority_queue_compare_fn *pred);
 
+/**
+ * Same as aws_priority_queue_init_dynamic(), but lays the queue out as a d-ary heap with `arity` children per node
+ * (2 to AWS_PRIORITY_QUEUE_MAX_ARITY).
+ *
+ * Wider heaps are shallower, so push and remove touch fewer cache lines, and the siblings compared during a pop sit
+ * next to each other in memory. 4 or 8 work well for small items on large queues; pop does up to `arity` comparisons
+ * per level, so very wide heaps trade that away again.
+ */
+AWS_COMMON_API
+int aws_priority_queue_init_dynamic_with_arity(
+    struct aws_priority_queue *queue,
+    struct aws_allocator *alloc,
+    size_t default_size,
+    size_t item_size,
+    aws_priority_queue_compare_fn *pred,
+    size_t arity);
+
 /**
  * Initializes a priority queue struct for use. This mode will not allocate any additional memory. When the heap fills
  * new enqueue operations will fail with AWS_ERROR_PRIORITY_QUEUE_FULL.
@@ -138,6 +163,27 @@ int aws_priority_queue_push_ref(
     void *item,
     struct aws_priority_queue_node *backpointer);
 
+/**
+ * Copies `count` items, stored contiguously at `items`, into the queue. Complexity: O(n + count) when the batch is
+ * large relative to the queue, since the heap is then rebuilt bottom-up in one pass instead of sifting every item.
+ *
+ * Either all items are added or, on failure, none are.
+ */
+AWS_COMMON_API
+int aws_priority_queue_push_many(struct aws_priority_queue *queue, const void *items, size_t count);
+
+/**
+ * Same as aws_priority_queue_push_many(), but also tracks a backpointer per item. `backpointers` is an array of
+ * `count` pointers, where entry i belongs to item i and follows the rules of aws_priority_queue_push_ref(); NULL
+ * entries are allowed.
+ */
+AWS_COMMON_API
+int aws_priority_queue_push_many_ref(
+    struct aws_priority_queue *queue,
+    const void *items,
+    struct aws_priority_queue_node *const *backpointers,
+    size_t count);
+
 /**
  * Copies the element of the highest priority, and removes it from the queue.. Complexity: O(log(n)).
  * If queue is empty, AWS_ERROR_PRIORITY_QUEUE_EMPTY will be raised.
@@ -155,6 +201,17 @@ int aws_priority_queue_pop(struct aws_priority_queue *queue, void *item);
 AWS_COMMON_API
 int aws_priority_queue_remove(struct aws_priority_queue *queue, void *item, const struct aws_priority_queue_node *node);
 
+/**
+ * Restores heap order for a node whose priority changed while it was in the queue, moving it up or down in place.
+ * Complexity: O(log(n)).
+ *
+ * This is the cheap way to reschedule an element: the caller updates the key inside the stored item (for instance
+ * through a pointer it owns) and calls this, instead of a remove followed by a push.
+ * If the node is not in the queue, AWS_ERROR_PRIORITY_QUEUE_BAD_NODE will be raised.
+ */
+AWS_COMMON_API
+int aws_priority_queue_update(struct aws_priority_queue *queue, const struct aws_priority_queue_node *node);
+
 /**
  * Obtains a pointer to the element of the highest priority. Complexity: constant time.
  * If queue is empty, AWS_ERROR_PRIORITY_QUEUE_EMPTY will be raised.
@@ -7,6 +7,8 @@
 
 #include <aws/common/byte_buf.h>
 
+AWS_EXTERN_C_BEGIN
+
 /**
  * If index >= bound, bound > (SIZE_MAX / 2), or index > (SIZE_MAX / 2), returns
  * 0. Otherwise, returns UINTPTR_MAX.  This function is designed to return the correct
@@ -15,4 +17,49 @@
  */
 AWS_COMMON_API size_t aws_nospec_mask(size_t index, size_t bound);
 
+/*
+ * Vectorized kernels behind the byte cursor functions, in source/arch. Each one is only built when the matching
+ * USE_SIMD_*, USE_SSE2_* or USE_NEON_* definition is set, and the AVX2 ones may only be called if
+ * aws_common_private_has_avx2() returns true.
+ */
+
+/* Substring search for aws_byte_cursor_find_exact(), covering the start positions in whole 32 or 16 byte blocks.
+ * Returns the first match, or NULL with *scanned set to the number of start positions covered. */
+const uint8_t *aws_common_private_find_exact_avx2(
+    const uint8_t *haystack,
+    size_t haystack_len,
+    const uint8_t *needle,
+    size_t needle_len,
+    const size_t anchor_offsets[2],
+    size_t *scanned);
+const uint8_t *aws_common_private_find_exact_neon(
+    const uint8_t *haystack,
+    size_t haystack_len,
+    const uint8_t *needle,
+    size_t needle_len,
+    const size_t anchor_offsets[2],
+    size_t *scanned);
+
+/* First byte of input that is set in the 256 bit bitmap, in whole blocks. NULL with *scanned set if there is none. */
+const uint8_t *aws_common_private_find_delimiter_avx2(
+    const uint8_t *input,
+    size_t len,
+    const uint8_t bitmap[32],
+    size_t *scanned);
+const uint8_t *aws_common_private_find_delimiter_neon(
+    const uint8_t *input,
+    size_t len,
+    const uint8_t bitmap[32],
+    size_t *scanned);
+
+/* Length of the longest prefix, in whole blocks, on which a and b are equal ignoring ASCII case */
+size_t aws_common_private_case_equal_prefix_avx2(const uint8_t *a, const uint8_t *b, size_t len);
+size_t aws_common_private_case_equal_prefix_sse2(const uint8_t *a, const uint8_t *b, size_t len);
+size_t aws_common_private_case_equal_prefix_neon(const uint8_t *a, const uint8_t *b, size_t len);
+
+/* Defined in source/arch/intel/cpuid.c */
+bool aws_common_private_has_avx2(void);
+
+AWS_EXTERN_C_END
+
 #endif /* AWS_COMMON_PRIVATE_BYTE_BUF_H */
@@ -0,0 +1,37 @@
+#ifndef AWS_COMMON_PRIVATE_FUTEX_H
+#define AWS_COMMON_PRIVATE_FUTEX_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/atomics.h>
+
+/*
+ * Minimal wait/wake on the value of an aws_atomic_var, for lock-free structures that want to block occasionally
+ * without keeping a mutex and condition variable around for it.
+ *
+ * On Linux this is a private futex on the low 32 bits of the variable, so the waiter is only woken up by a change to
+ * those bits. Other platforms don't have an implementation: waiting just sleeps for a short while and waking up does
+ * nothing, which callers have to tolerate anyway since wakeups may be spurious.
+ */
+
+/** Timeout for aws_futex_wait() that never expires. */
+#define AWS_FUTEX_WAIT_FOREVER UINT64_MAX
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Sleeps as long as the low 32 bits of var are equal to those of expected_value, until woken up by
+ * aws_futex_wake_all() or until timeout_ns nanoseconds have passed. May return early for no reason.
+ */
+void aws_futex_wait(struct aws_atomic_var *var, size_t expected_value, uint64_t timeout_ns);
+
+/**
+ * Wakes up every thread waiting on var. Call it after changing var.
+ */
+void aws_futex_wake_all(struct aws_atomic_var *var);
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_COMMON_PRIVATE_FUTEX_H */
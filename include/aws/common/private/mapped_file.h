@@ -0,0 +1,50 @@
+#ifndef AWS_COMMON_PRIVATE_MAPPED_FILE_H
+#define AWS_COMMON_PRIVATE_MAPPED_FILE_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/common.h>
+
+/*
+ * Platform specific way to map a file into memory read/write and shared, for aws_persistent_ring_buffer.
+ * mmap()/msync() on POSIX, file mappings and FlushViewOfFile()/FlushFileBuffers() on Windows.
+ */
+
+struct aws_string;
+
+struct aws_mapped_file {
+    /* the mapping, NULL until aws_mapped_file_map() succeeds */
+    uint8_t *data;
+    size_t size;
+    /* platform handle to the open file */
+    void *handle;
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Opens the file at path for reading and writing, creating it if it doesn't exist, and reports its current size.
+ */
+int aws_mapped_file_open(struct aws_mapped_file *file, const struct aws_string *path, uint64_t *out_size);
+
+/**
+ * Maps the first `size` bytes of the file, replacing any previous mapping. The file grows (with zeroes) to `size` if it
+ * is shorter, but is never shrunk.
+ */
+int aws_mapped_file_map(struct aws_mapped_file *file, size_t size);
+
+/**
+ * Writes the mapped bytes in [offset, offset + length) back to the file and waits until they're on stable storage.
+ */
+int aws_mapped_file_sync(struct aws_mapped_file *file, size_t offset, size_t length);
+
+/**
+ * Unmaps and closes the file. Modified bytes still reach the file eventually, but without any guarantee of when.
+ */
+void aws_mapped_file_close(struct aws_mapped_file *file);
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_COMMON_PRIVATE_MAPPED_FILE_H */
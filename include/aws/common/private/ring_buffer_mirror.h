@@ -0,0 +1,32 @@
+#ifndef AWS_COMMON_PRIVATE_RING_BUFFER_MIRROR_H
+#define AWS_COMMON_PRIVATE_RING_BUFFER_MIRROR_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/common.h>
+
+/*
+ * Platform specific way to map the same pages twice in a row, for aws_ring_buffer_init_mirrored().
+ *
+ * On Linux the pages belong to a memfd, mapped twice into a reservation twice its size. Other platforms don't have an
+ * implementation, and aws_ring_buffer_mirror_map() raises AWS_ERROR_PLATFORM_NOT_SUPPORTED there.
+ */
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Maps *size bytes, rounded up to the page size (and *size updated to match), twice back-to-back. On success, the
+ * memory from the returned pointer to pointer + 2 * *size is usable, and the second half aliases the first.
+ */
+uint8_t *aws_ring_buffer_mirror_map(size_t *size);
+
+/**
+ * Unmaps memory returned by aws_ring_buffer_mirror_map(), given the size it returned.
+ */
+void aws_ring_buffer_mirror_unmap(uint8_t *allocation, size_t size);
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_COMMON_PRIVATE_RING_BUFFER_MIRROR_H */
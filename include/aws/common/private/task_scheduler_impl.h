@@ -0,0 +1,32 @@
+#ifndef AWS_COMMON_PRIVATE_TASK_SCHEDULER_IMPL_H
+#define AWS_COMMON_PRIVATE_TASK_SCHEDULER_IMPL_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/task_scheduler.h>
+
+/*
+ * Values of aws_task.abi_extension.thread_scheduler_state.
+ *
+ * A task handed to an aws_thread_scheduler goes from IDLE to PENDING while it sits on the submission stack, and from
+ * PENDING to QUEUED when the scheduler thread moves it into its task scheduler. From either, exactly one of two
+ * transitions wins: the thread (taking the submission, or aws_task_run() right before invoking the task) or
+ * aws_thread_scheduler_cancel_task() moving it to CANCELING.
+ *
+ * A task canceled while PENDING is still linked on the submission stack, so it's left there and the thread runs it
+ * canceled when it takes it. A task canceled while QUEUED is pushed on its scheduler's cancel stack, and the bits above
+ * the state hold the next task on that stack (tasks are at least 4 byte aligned, so the low two bits of their address
+ * are always zero, and a linked CANCELING state can't be mistaken for QUEUED).
+ */
+enum aws_task_thread_scheduler_state {
+    AWS_TASK_THREAD_SCHEDULER_STATE_IDLE = 0,
+    AWS_TASK_THREAD_SCHEDULER_STATE_PENDING = 1,
+    AWS_TASK_THREAD_SCHEDULER_STATE_CANCELING = 2,
+    AWS_TASK_THREAD_SCHEDULER_STATE_QUEUED = 3,
+};
+
+#define AWS_TASK_THREAD_SCHEDULER_STATE_MASK ((size_t)3)
+
+#endif /* AWS_COMMON_PRIVATE_TASK_SCHEDULER_IMPL_H */
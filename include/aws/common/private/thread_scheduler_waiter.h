@@ -0,0 +1,41 @@
+#ifndef AWS_COMMON_PRIVATE_THREAD_SCHEDULER_WAITER_H
+#define AWS_COMMON_PRIVATE_THREAD_SCHEDULER_WAITER_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/common.h>
+
+/*
+ * Platform specific way for an aws_thread_scheduler's thread to sleep until it is woken up or a timeout expires,
+ * used instead of the scheduler's condition variable where available.
+ *
+ * On Linux the thread waits in epoll_wait() on an eventfd, written to wake it up, and a CLOCK_MONOTONIC timerfd armed
+ * with the timeout. Unlike the condition variable's absolute CLOCK_REALTIME deadline, this isn't thrown off by wall
+ * clock changes, and waking up doesn't go through a mutex. Other platforms don't have an implementation, and
+ * aws_thread_scheduler_waiter_new() raises AWS_ERROR_PLATFORM_NOT_SUPPORTED there.
+ */
+struct aws_thread_scheduler_waiter;
+
+AWS_EXTERN_C_BEGIN
+
+struct aws_thread_scheduler_waiter *aws_thread_scheduler_waiter_new(struct aws_allocator *allocator);
+
+void aws_thread_scheduler_waiter_destroy(struct aws_thread_scheduler_waiter *waiter);
+
+/**
+ * Wakes up the thread waiting in aws_thread_scheduler_waiter_wait(), or makes its next wait return right away if it
+ * isn't waiting. Safe to call from any thread.
+ */
+void aws_thread_scheduler_waiter_wake(struct aws_thread_scheduler_waiter *waiter);
+
+/**
+ * Sleeps until woken up or until timeout_ns nanoseconds have passed, whichever comes first. May return early. Only
+ * one thread may wait at a time.
+ */
+void aws_thread_scheduler_waiter_wait(struct aws_thread_scheduler_waiter *waiter, uint64_t timeout_ns);
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_COMMON_PRIVATE_THREAD_SCHEDULER_WAITER_H */
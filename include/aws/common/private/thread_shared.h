@@ -36,4 +36,12 @@ AWS_COMMON_API void aws_thread_initialize_thread_management(void);
  */
 AWS_COMMON_API size_t aws_thread_get_managed_thread_count(void);
 
+/**
+ * Allocates *cpu_ids and fills it with the cpus of cpu_group that threads should be pinned to, preferring cpus that
+ * aren't suspected hyper-threads. Returns the number of cpus written, 0 (with *cpu_ids set to NULL) if there are none.
+ * The caller releases *cpu_ids with the same allocator.
+ */
+AWS_COMMON_API size_t
+    aws_thread_get_pinning_cpus_for_group(struct aws_allocator *allocator, uint16_t cpu_group, int32_t **cpu_ids);
+
 #endif /* AWS_COMMON_PRIVATE_THREAD_SHARED_H */
@@ -23,9 +23,14 @@ struct aws_ring_buffer {
     struct aws_atomic_var head;
     struct aws_atomic_var tail;
     uint8_t *allocation_end;
+    /* true if the allocation is mapped a second time right after allocation_end, see aws_ring_buffer_init_mirrored() */
+    bool mirrored;
+    /* end of the data before head last went back to the start of the allocation */
+    struct aws_atomic_var wrap_end;
 };
 
 struct aws_byte_buf;
+struct aws_byte_cursor;
 
 AWS_EXTERN_C_BEGIN
 
@@ -35,6 +40,25 @@ AWS_EXTERN_C_BEGIN
  */
 AWS_COMMON_API int aws_ring_buffer_init(struct aws_ring_buffer *ring_buf, struct aws_allocator *allocator, size_t size);
 
+/**
+ * Initializes a ring buffer whose memory is mapped twice, back-to-back, so that the bytes past `allocation_end` are the
+ * same bytes as the ones from `allocation` on. Buffers vended by acquire then never have to wrap around: any free
+ * region, up to the whole capacity, comes back as one contiguous buffer, which may extend past `allocation_end`.
+ * `size` is rounded up to a multiple of the page size.
+ *
+ * This is only supported on Linux (using memfd). Elsewhere, or if the mapping fails, this falls back to
+ * aws_ring_buffer_init() with `size` as is. Use aws_ring_buffer_is_mirrored() to tell which one happened.
+ */
+AWS_COMMON_API int aws_ring_buffer_init_mirrored(
+    struct aws_ring_buffer *ring_buf,
+    struct aws_allocator *allocator,
+    size_t size);
+
+/**
+ * Returns true if the ring buffer's memory is mirrored, see aws_ring_buffer_init_mirrored().
+ */
+AWS_COMMON_API bool aws_ring_buffer_is_mirrored(const struct aws_ring_buffer *ring_buf);
+
 /*
  * Checks whether atomic_ptr correctly points to a memory location within the bounds of the aws_ring_buffer
  */
@@ -77,6 +101,17 @@ AWS_COMMON_API int aws_ring_buffer_acquire_up_to(
     size_t requested_size,
     struct aws_byte_buf *dest);
 
+/**
+ * Acquires `count` buffers of `sizes[i]` bytes each into `dests`, with a single update to the ring buffer, as if by
+ * calling aws_ring_buffer_acquire() for each size in order. Either all of them are acquired or none are: returns
+ * AWS_OP_ERR, with AWS_ERROR_OOM, if they don't all fit.
+ */
+AWS_COMMON_API int aws_ring_buffer_acquire_many(
+    struct aws_ring_buffer *ring_buf,
+    const size_t *sizes,
+    size_t count,
+    struct aws_byte_buf *dests);
+
 /**
  * Releases `buf` back to the ring buffer for further use. RELEASE MUST HAPPEN in the SAME ORDER AS ACQUIRE.
  * If you do not, your application, and possibly computers within a thousand mile radius, may die terrible deaths,
@@ -85,6 +120,27 @@ AWS_COMMON_API int aws_ring_buffer_acquire_up_to(
  */
 AWS_COMMON_API void aws_ring_buffer_release(struct aws_ring_buffer *ring_buffer, struct aws_byte_buf *buf);
 
+/**
+ * Releases `count` buffers, which must be the oldest ones not yet released, in the order they were acquired, with a
+ * single update to the ring buffer.
+ */
+AWS_COMMON_API void aws_ring_buffer_release_many(
+    struct aws_ring_buffer *ring_buffer,
+    struct aws_byte_buf *bufs,
+    size_t count);
+
+/**
+ * Fills `regions`, an array of two cursors, with the memory of every buffer acquired and not yet released, oldest
+ * first, as at most two contiguous spans (only one for a mirrored ring buffer), and returns how many were filled in.
+ * The spans cover the buffers' whole capacity, whatever their length. They map one to one onto struct iovec for
+ * writev() or readv().
+ *
+ * Call it from the thread that acquires, or synchronize with it: nothing here orders reads of head with acquires.
+ */
+AWS_COMMON_API size_t aws_ring_buffer_get_acquired_regions(
+    const struct aws_ring_buffer *ring_buf,
+    struct aws_byte_cursor *regions);
+
 /**
  * Returns true if the memory in `buf` was vended by this ring buffer, false otherwise.
  * Make sure `buf->buffer` and `ring_buffer->allocation` refer to the same memory region.
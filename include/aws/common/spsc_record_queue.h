@@ -0,0 +1,133 @@
+#ifndef AWS_COMMON_SPSC_RECORD_QUEUE_H
+#define AWS_COMMON_SPSC_RECORD_QUEUE_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_buf.h>
+#include <aws/common/ring_buffer.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+/**
+ * Records are stored behind a header of this size and padded to a multiple of it.
+ */
+#define AWS_SPSC_RECORD_QUEUE_ALIGNMENT 8
+
+/**
+ * Timeout for the blocking calls that never expires.
+ */
+#define AWS_SPSC_RECORD_QUEUE_WAIT_FOREVER UINT64_MAX
+
+/**
+ * Lock-free queue of variable-length records between a single producer thread and a single consumer thread, built on
+ * an aws_ring_buffer.
+ *
+ * The producer reserves space for a record, writes the payload in place, and publishes every record reserved so far
+ * with one commit. The consumer reads committed records in place, in order, and hands their space back with one
+ * consume. Records are never split: one that doesn't fit before the end of the buffer starts over at the beginning,
+ * and the space it skipped goes unused for that lap.
+ *
+ * Both sides can block for the other one. On Linux, they sleep on a futex, and the other side only pays for a
+ * syscall when someone is actually sleeping.
+ *
+ * All fields are private.
+ */
+struct aws_spsc_record_queue {
+    struct aws_ring_buffer ring;
+
+    /* number of records committed so far, and the index of the last record that started over at the beginning of the
+     * buffer, both written by the producer */
+    struct aws_atomic_var committed_count;
+    struct aws_atomic_var wrapped_record;
+    /* set while either side is asleep */
+    struct aws_atomic_var consumer_waiting;
+    struct aws_atomic_var producer_waiting;
+
+    /* producer side: where the next record goes, and the number of records reserved so far */
+    uint8_t *reserve_position;
+    size_t reserved_count;
+
+    /* consumer side: where the next record is, the number of records read so far, and the last one read */
+    uint8_t *read_position;
+    size_t read_count;
+    uint8_t *last_read_record;
+    size_t last_read_record_size;
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Initializes a queue over `capacity` bytes of buffer, rounded down to AWS_SPSC_RECORD_QUEUE_ALIGNMENT. Each record
+ * takes its payload size rounded up to AWS_SPSC_RECORD_QUEUE_ALIGNMENT, plus AWS_SPSC_RECORD_QUEUE_ALIGNMENT bytes of
+ * header.
+ */
+AWS_COMMON_API int aws_spsc_record_queue_init(
+    struct aws_spsc_record_queue *queue,
+    struct aws_allocator *allocator,
+    size_t capacity);
+
+/**
+ * Cleans up the queue's resources. Neither side may be using it anymore.
+ */
+AWS_COMMON_API void aws_spsc_record_queue_clean_up(struct aws_spsc_record_queue *queue);
+
+/**
+ * Producer only. Reserves a record of exactly `size` bytes and points `dest` at its payload, with a capacity of `size`
+ * and a length of 0. The record isn't visible to the consumer until the next aws_spsc_record_queue_commit().
+ *
+ * Raises AWS_ERROR_OOM if there is not enough free space right now, and AWS_ERROR_INVALID_ARGUMENT if the record could
+ * never fit.
+ */
+AWS_COMMON_API int aws_spsc_record_queue_reserve(
+    struct aws_spsc_record_queue *queue,
+    size_t size,
+    struct aws_byte_buf *dest);
+
+/**
+ * Producer only. Same as aws_spsc_record_queue_reserve(), but sleeps for up to timeout_ns nanoseconds waiting for the
+ * consumer to free up enough space before raising AWS_ERROR_OOM. Anything reserved but not yet committed is committed
+ * first, so the consumer can't be left waiting on it.
+ */
+AWS_COMMON_API int aws_spsc_record_queue_reserve_wait(
+    struct aws_spsc_record_queue *queue,
+    size_t size,
+    uint64_t timeout_ns,
+    struct aws_byte_buf *dest);
+
+/**
+ * Producer only. Publishes every record reserved since the last commit, and wakes up the consumer if it's waiting.
+ */
+AWS_COMMON_API void aws_spsc_record_queue_commit(struct aws_spsc_record_queue *queue);
+
+/**
+ * Producer only. Copies `record` into a new record and commits it.
+ */
+AWS_COMMON_API int aws_spsc_record_queue_push(struct aws_spsc_record_queue *queue, struct aws_byte_cursor record);
+
+/**
+ * Consumer only. Points `record` at the payload of the next committed record and returns true, or returns false if
+ * there is none. The record stays valid, and its space in use, until the next aws_spsc_record_queue_consume().
+ */
+AWS_COMMON_API bool aws_spsc_record_queue_read(struct aws_spsc_record_queue *queue, struct aws_byte_cursor *record);
+
+/**
+ * Consumer only. Same as aws_spsc_record_queue_read(), but sleeps for up to timeout_ns nanoseconds waiting for the
+ * producer to commit a record. Records that were read but not consumed still take up space while the consumer
+ * sleeps, so consume them first if the producer might be waiting for it.
+ */
+AWS_COMMON_API bool aws_spsc_record_queue_read_wait(
+    struct aws_spsc_record_queue *queue,
+    uint64_t timeout_ns,
+    struct aws_byte_cursor *record);
+
+/**
+ * Consumer only. Releases every record read so far back to the producer, and wakes up the producer if it's waiting.
+ */
+AWS_COMMON_API void aws_spsc_record_queue_consume(struct aws_spsc_record_queue *queue);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_COMMON_SPSC_RECORD_QUEUE_H */
@@ -6,12 +6,14 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 
+#include <aws/common/atomics.h>
 #include <aws/common/common.h>
 #include <aws/common/linked_list.h>
 #include <aws/common/priority_queue.h>
 
 AWS_PUSH_SANE_WARNING_LEVEL
 
+struct aws_array_list;
 struct aws_task;
 
 typedef enum aws_task_status {
@@ -38,16 +40,134 @@ struct aws_task {
 
     /* honor the ABI compat */
     union {
+        /* No longer maintained: a task is in a scheduler's timed queue iff
+         * aws_priority_queue_node_is_in_queue(&task->priority_queue_node). */
         bool scheduled;
         size_t reserved;
+        /* Lets aws_thread_scheduler_cancel_task() race safely with the task running on the scheduler's thread. */
+        struct aws_atomic_var thread_scheduler_state;
     } abi_extension;
 };
 
+struct aws_task_timing_wheel;
+struct aws_task_scheduler_stats;
+
+/**
+ * Priority lanes for tasks scheduled to run as soon as possible, see aws_task_scheduler_schedule_now_with_priority().
+ */
+enum aws_task_priority {
+    /* Latency critical work, runs ahead of everything else that is ready. */
+    AWS_TASK_PRIORITY_HIGH,
+    /* Used by aws_task_scheduler_schedule_now(). Timed tasks that are due share this lane. */
+    AWS_TASK_PRIORITY_NORMAL,
+    /* Work that can wait, such as flushing stats or sweeping caches. */
+    AWS_TASK_PRIORITY_BACKGROUND,
+
+    AWS_TASK_PRIORITY_COUNT,
+};
+
+/**
+ * Data structure used to hold future tasks.
+ */
+enum aws_task_scheduler_timer_backend {
+    /**
+     * All future tasks live in a binary heap. schedule_future and cancel_task are O(log(n)).
+     */
+    AWS_TASK_SCHEDULER_TIMER_BACKEND_HEAP,
+
+    /**
+     * Future tasks live in a hierarchical timing wheel, and only move to the heap once their tick comes due.
+     * schedule_future and cancel_task are O(1), which pays off when many timeouts are scheduled and most of them are
+     * canceled before they fire. Tasks still run in exact timestamp order.
+     */
+    AWS_TASK_SCHEDULER_TIMER_BACKEND_TIMING_WHEEL,
+};
+
+/**
+ * Options for aws_task_scheduler_init_with_options(). Zeroed options give the same scheduler as
+ * aws_task_scheduler_init().
+ */
+struct aws_task_scheduler_options {
+    enum aws_task_scheduler_timer_backend timer_backend;
+
+    /**
+     * Width of one timing wheel tick, in the same units as task timestamps (normally nanoseconds).
+     * Tasks due within the same tick are sorted on the heap once the tick is reached, so this only affects how much
+     * work is spent cascading tasks, never the order in which they run. 0 uses a default of 1 millisecond.
+     * Ignored by the heap backend.
+     */
+    uint64_t timing_wheel_tick;
+
+    /**
+     * How aws_task_scheduler_run_some() shares its budget between priority lanes that all have ready tasks, indexed by
+     * aws_task_priority. Lanes get turns in proportion to their weight, and a lane with weight 0 only runs when every
+     * lane with a non-zero weight is empty. All zero (the default) means strict priority: a lane only runs once every
+     * higher priority lane is empty.
+     *
+     * aws_task_scheduler_run_all() always runs every ready task, highest priority first.
+     */
+    uint32_t priority_weights[AWS_TASK_PRIORITY_COUNT];
+
+    /**
+     * If true, the scheduler keeps per type_tag statistics about the tasks it runs, see aws_task_scheduler_get_stats().
+     * This costs two clock reads and a hash table lookup per task, so it is off by default.
+     *
+     * Durations are measured with aws_high_res_clock_get_ticks(). The queue delay of a timed task is measured from the
+     * time it was scheduled to run, so it is only meaningful if timestamps come from the same clock. Tasks scheduled to
+     * run as soon as possible have their timestamp set to the time they were scheduled.
+     */
+    bool enable_stats;
+};
+
+/**
+ * Number of buckets in the histograms of struct aws_task_type_stats.
+ */
+#define AWS_TASK_STATS_HISTOGRAM_BUCKETS 32
+
+/**
+ * What a scheduler has recorded about the tasks with a given type_tag. Histograms have power of two buckets: bucket i
+ * counts durations d with 2^i <= d < 2^(i+1) nanoseconds, bucket 0 also counts 0, and the last bucket also counts
+ * everything longer.
+ */
+struct aws_task_type_stats {
+    /* Owned by the scheduler, valid until its stats are reset or it is cleaned up. A NULL type_tag shows up as
+     * "unknown". */
+    const char *type_tag;
+
+    uint64_t run_count;
+    uint64_t canceled_count;
+
+    /* Time between a task becoming ready and starting to run */
+    uint64_t queue_delay_total_ns;
+    uint64_t queue_delay_max_ns;
+    uint64_t queue_delay_histogram[AWS_TASK_STATS_HISTOGRAM_BUCKETS];
+
+    /* Time spent in the task's function */
+    uint64_t run_time_total_ns;
+    uint64_t run_time_max_ns;
+    uint64_t run_time_histogram[AWS_TASK_STATS_HISTOGRAM_BUCKETS];
+};
+
 struct aws_task_scheduler {
     struct aws_allocator *alloc;
     struct aws_priority_queue timed_queue; /* Tasks scheduled to run at specific times */
     struct aws_linked_list timed_list;     /* If timed_queue runs out of memory, further timed tests are stored here */
     struct aws_linked_list asap_list;      /* Tasks scheduled to run as soon as possible */
+
+    /* Tasks scheduled with AWS_TASK_PRIORITY_HIGH and AWS_TASK_PRIORITY_BACKGROUND. asap_list holds
+     * AWS_TASK_PRIORITY_NORMAL. */
+    struct aws_linked_list high_priority_list;
+    struct aws_linked_list background_list;
+    uint32_t priority_weights[AWS_TASK_PRIORITY_COUNT];
+
+    /* Future tasks that are not due yet. NULL unless using AWS_TASK_SCHEDULER_TIMER_BACKEND_TIMING_WHEEL */
+    struct aws_task_timing_wheel *timing_wheel;
+
+    /* Per type_tag task statistics. NULL unless aws_task_scheduler_options.enable_stats was set */
+    struct aws_task_scheduler_stats *stats;
+
+    /* Number of tasks scheduled that haven't run or been canceled yet */
+    size_t task_count;
 };
 
 AWS_EXTERN_C_BEGIN
@@ -70,6 +190,16 @@ void aws_task_run(struct aws_task *task, enum aws_task_status status);
 AWS_COMMON_API
 int aws_task_scheduler_init(struct aws_task_scheduler *scheduler, struct aws_allocator *alloc);
 
+/**
+ * Initializes a task scheduler instance with the given options. options may be NULL, which is the same as calling
+ * aws_task_scheduler_init().
+ */
+AWS_COMMON_API
+int aws_task_scheduler_init_with_options(
+    struct aws_task_scheduler *scheduler,
+    struct aws_allocator *alloc,
+    const struct aws_task_scheduler_options *options);
+
 /**
  * Empties and executes all queued tasks, passing the AWS_TASK_STATUS_CANCELED status to the task function.
  * Cleans up any memory allocated, and prepares the instance for reuse or deletion.
@@ -84,10 +214,20 @@ bool aws_task_scheduler_is_valid(const struct aws_task_scheduler *scheduler);
  * Returns whether the scheduler has any scheduled tasks.
  * next_task_time (optional) will be set to time of the next task, note that 0 will be set if tasks were
  * added via aws_task_scheduler_schedule_now() and UINT64_MAX will be set if no tasks are scheduled at all.
+ *
+ * With the timing wheel backend, a task that is still far out may be reported at the start of the wheel slot holding
+ * it, which can be earlier than its actual time. Running the scheduler at that time is harmless and narrows the
+ * estimate down.
  */
 AWS_COMMON_API
 bool aws_task_scheduler_has_tasks(const struct aws_task_scheduler *scheduler, uint64_t *next_task_time);
 
+/**
+ * Returns the number of tasks scheduled that haven't run or been canceled yet, whether they are due or not.
+ */
+AWS_COMMON_API
+size_t aws_task_scheduler_get_task_count(const struct aws_task_scheduler *scheduler);
+
 /**
  * Schedules a task to run immediately.
  * The task should not be cleaned up or modified until its function is executed.
@@ -95,6 +235,17 @@ bool aws_task_scheduler_has_tasks(const struct aws_task_scheduler *scheduler, ui
 AWS_COMMON_API
 void aws_task_scheduler_schedule_now(struct aws_task_scheduler *scheduler, struct aws_task *task);
 
+/**
+ * Schedules a task to run as soon as possible in the given priority lane. Within a lane, tasks run in the order they
+ * were scheduled. aws_task_scheduler_schedule_now() is the same as using AWS_TASK_PRIORITY_NORMAL.
+ * The task should not be cleaned up or modified until its function is executed.
+ */
+AWS_COMMON_API
+void aws_task_scheduler_schedule_now_with_priority(
+    struct aws_task_scheduler *scheduler,
+    struct aws_task *task,
+    enum aws_task_priority priority);
+
 /**
  * Schedules a task to run at time_to_run.
  * The task should not be cleaned up or modified until its function is executed.
@@ -120,12 +271,48 @@ void aws_task_scheduler_cancel_task(struct aws_task_scheduler *scheduler, struct
 AWS_COMMON_API
 void aws_task_scheduler_run_all(struct aws_task_scheduler *scheduler, uint64_t current_time);
 
+/**
+ * Like aws_task_scheduler_run_all(), but stops once max_tasks tasks have run, or once max_nanos nanoseconds (measured
+ * with aws_high_res_clock_get_ticks()) have passed since the call started, whichever comes first. 0 means no limit.
+ * The time budget is checked between tasks, so a single long task can still overrun it, and at least one ready task
+ * runs no matter how small it is.
+ *
+ * Priority lanes share the budget as configured by aws_task_scheduler_options.priority_weights. Within the normal lane,
+ * tasks scheduled to run as soon as possible and timed tasks that are due take turns, so neither can starve the other.
+ * Ready tasks that didn't fit in the budget run first in their lane on the next call.
+ *
+ * Returns true if tasks are ready to run at current_time once this returns, meaning the caller should call this again
+ * soon rather than wait for the next timed task.
+ */
+AWS_COMMON_API
+bool aws_task_scheduler_run_some(
+    struct aws_task_scheduler *scheduler,
+    uint64_t current_time,
+    size_t max_tasks,
+    uint64_t max_nanos);
+
 /**
  * Convert a status value to a c-string suitable for logging
  */
 AWS_COMMON_API
 const char *aws_task_status_to_c_str(enum aws_task_status status);
 
+/**
+ * Appends a copy of the statistics recorded for every task type_tag seen so far to stats_list, which must be an
+ * initialized aws_array_list of struct aws_task_type_stats. Must be called from the thread that runs the scheduler.
+ *
+ * Raises AWS_ERROR_INVALID_STATE if the scheduler was not initialized with aws_task_scheduler_options.enable_stats.
+ */
+AWS_COMMON_API
+int aws_task_scheduler_get_stats(const struct aws_task_scheduler *scheduler, struct aws_array_list *stats_list);
+
+/**
+ * Forgets all statistics recorded so far. type_tag pointers from earlier calls to aws_task_scheduler_get_stats() are
+ * no longer valid afterwards. Does nothing if stats are not enabled.
+ */
+AWS_COMMON_API
+void aws_task_scheduler_reset_stats(struct aws_task_scheduler *scheduler);
+
 AWS_EXTERN_C_END
 AWS_POP_SANE_WARNING_LEVEL
 
@@ -0,0 +1,91 @@
+#ifndef AWS_COMMON_THREAD_POOL_H
+#define AWS_COMMON_THREAD_POOL_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/common.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+struct aws_thread_pool;
+struct aws_thread_options;
+struct aws_task;
+
+/**
+ * Default number of tasks each worker's local deque can hold before submissions from that worker spill over into the
+ * shared queue.
+ */
+#define AWS_THREAD_POOL_DEFAULT_DEQUE_CAPACITY 1024
+
+struct aws_thread_pool_options {
+    /**
+     * Number of worker threads. 0 means one worker per online processor.
+     */
+    size_t worker_count;
+
+    /**
+     * Capacity of each worker's local deque. It is rounded up to a power of two. 0 means
+     * AWS_THREAD_POOL_DEFAULT_DEQUE_CAPACITY.
+     */
+    size_t deque_capacity;
+
+    /**
+     * Optional. If set, worker i is pinned (via aws_thread_options.cpu_id) to the i-th cpu of this cpu group, wrapping
+     * around if there are more workers than cpus. Cpus suspected to be hyper-threads are used only if the group has
+     * nothing else.
+     */
+    const uint16_t *cpu_group;
+
+    /**
+     * Optional. Options used to launch each worker. cpu_id is overridden when cpu_group is set.
+     */
+    const struct aws_thread_options *thread_options;
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Creates a pool of worker threads that run aws_tasks. Each worker keeps a local work-stealing deque: tasks submitted
+ * from a worker go to its own deque, tasks submitted from any other thread go to a shared queue, and idle workers
+ * steal from each other before going to sleep. On success, this function returns an instance with a ref-count of 1.
+ * On failure it returns NULL.
+ *
+ * options are optional.
+ *
+ * Tasks run in no particular order, possibly in parallel with each other. Tasks still queued when the last reference
+ * is released are invoked with AWS_TASK_STATUS_CANCELED. The last reference must not be released from one of the
+ * pool's own workers.
+ */
+AWS_COMMON_API
+struct aws_thread_pool *aws_thread_pool_new(
+    struct aws_allocator *allocator,
+    const struct aws_thread_pool_options *options);
+
+/**
+ * Acquire a reference to the pool.
+ */
+AWS_COMMON_API void aws_thread_pool_acquire(struct aws_thread_pool *pool);
+
+/**
+ * Release a reference to the pool. Releasing the last reference waits for running tasks to finish and joins the
+ * workers.
+ */
+AWS_COMMON_API void aws_thread_pool_release(struct aws_thread_pool *pool);
+
+/**
+ * Returns the number of worker threads in the pool.
+ */
+AWS_COMMON_API size_t aws_thread_pool_get_worker_count(const struct aws_thread_pool *pool);
+
+/**
+ * Submits a task to run on one of the pool's workers as soon as possible. Safe to call from any thread, including
+ * from inside a task running on the pool.
+ */
+AWS_COMMON_API void aws_thread_pool_submit(struct aws_thread_pool *pool, struct aws_task *task);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_COMMON_THREAD_POOL_H */
@@ -13,6 +13,47 @@ struct aws_thread_scheduler;
 struct aws_thread_options;
 struct aws_task;
 
+/**
+ * How an aws_thread_scheduler's thread sleeps while it has nothing to run.
+ */
+enum aws_thread_scheduler_wakeup_backend {
+    /**
+     * AWS_THREAD_SCHEDULER_WAKEUP_BACKEND_EPOLL on Linux, unless it can't be set up.
+     * AWS_THREAD_SCHEDULER_WAKEUP_BACKEND_CONDITION_VARIABLE everywhere else.
+     */
+    AWS_THREAD_SCHEDULER_WAKEUP_BACKEND_DEFAULT,
+
+    /**
+     * Wait on a condition variable. Its timeout is an absolute CLOCK_REALTIME deadline on posix systems, so wall clock
+     * changes can make the thread wake up early or late.
+     */
+    AWS_THREAD_SCHEDULER_WAKEUP_BACKEND_CONDITION_VARIABLE,
+
+    /**
+     * Linux only. Wait in epoll_wait() on an eventfd that submitters write to and a CLOCK_MONOTONIC timerfd armed with
+     * the next task's time. aws_thread_scheduler_new_with_options() raises AWS_ERROR_PLATFORM_NOT_SUPPORTED on other
+     * platforms.
+     */
+    AWS_THREAD_SCHEDULER_WAKEUP_BACKEND_EPOLL,
+};
+
+struct aws_thread_scheduler_options {
+    /**
+     * Optional. Options used to launch the scheduler's thread.
+     */
+    const struct aws_thread_options *thread_options;
+
+    /**
+     * How late, in nanoseconds, a timed task may run so that it shares a wakeup with other timers. When set, the
+     * thread sleeps until the next task's time rounded up to a multiple of timer_slack_ns, then runs every task due by
+     * then in one pass. Timers scattered a few microseconds apart then cost one wakeup instead of one each. Tasks never
+     * run early. 0 means the thread wakes exactly when the next task is due.
+     */
+    uint64_t timer_slack_ns;
+
+    enum aws_thread_scheduler_wakeup_backend wakeup_backend;
+};
+
 AWS_EXTERN_C_BEGIN
 
 /**
@@ -28,6 +69,14 @@ struct aws_thread_scheduler *aws_thread_scheduler_new(
     struct aws_allocator *allocator,
     const struct aws_thread_options *thread_options);
 
+/**
+ * Same as aws_thread_scheduler_new(), with more options. options are optional.
+ */
+AWS_COMMON_API
+struct aws_thread_scheduler *aws_thread_scheduler_new_with_options(
+    struct aws_allocator *allocator,
+    const struct aws_thread_scheduler_options *options);
+
 /**
  * Acquire a reference to the scheduler.
  */
@@ -51,9 +100,17 @@ AWS_COMMON_API void aws_thread_scheduler_schedule_future(
  */
 AWS_COMMON_API void aws_thread_scheduler_schedule_now(struct aws_thread_scheduler *scheduler, struct aws_task *task);
 
+/**
+ * Returns the number of tasks submitted to the scheduler that haven't run or been canceled yet, including timed tasks
+ * that aren't due. Safe to call from any thread. The count is only updated by the scheduler's thread as it goes, so it
+ * may lag slightly behind and shouldn't be used for anything but metrics and load balancing.
+ */
+AWS_COMMON_API size_t aws_thread_scheduler_get_queue_depth(const struct aws_thread_scheduler *scheduler);
+
 /**
  * Cancel a task that has been scheduled. The cancellation callback will be invoked in the background thread.
- * This function is slow, so please don't do it in the hot path for your code.
+ * This is O(1), doesn't allocate and can be called from any thread. If the task has already started running (or has
+ * already been canceled), this does nothing: a task's function is always invoked exactly once.
  */
 AWS_COMMON_API void aws_thread_scheduler_cancel_task(struct aws_thread_scheduler *scheduler, struct aws_task *task);
 
@@ -0,0 +1,132 @@
+#ifndef AWS_COMMON_THREAD_SCHEDULER_GROUP_H
+#define AWS_COMMON_THREAD_SCHEDULER_GROUP_H
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/common.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+struct aws_thread_scheduler;
+struct aws_thread_scheduler_group;
+struct aws_thread_scheduler_options;
+struct aws_task;
+
+struct aws_thread_scheduler_group_options {
+    /**
+     * Number of schedulers, each with its own thread. 0 means one per cpu of cpu_group if it is set, or one per online
+     * processor otherwise.
+     */
+    size_t scheduler_count;
+
+    /**
+     * Optional. If set, scheduler i's thread is pinned (via aws_thread_options.cpu_id) to the i-th cpu of this cpu
+     * group, wrapping around if there are more schedulers than cpus. Cpus suspected to be hyper-threads are used only
+     * if the group has nothing else.
+     */
+    const uint16_t *cpu_group;
+
+    /**
+     * Optional. Options for each scheduler. The cpu_id of their thread_options is overridden when cpu_group is set.
+     */
+    const struct aws_thread_scheduler_options *scheduler_options;
+};
+
+/**
+ * Queue depths across a group's schedulers, see aws_thread_scheduler_get_queue_depth().
+ */
+struct aws_thread_scheduler_group_metrics {
+    /* Tasks queued across all schedulers */
+    size_t total_queue_depth;
+
+    /* The deepest scheduler's queue, and that scheduler's index */
+    size_t max_queue_depth;
+    size_t max_queue_depth_index;
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Creates a group of aws_thread_schedulers that tasks are routed to by key: every task scheduled with the same key
+ * goes to the same scheduler, so tasks for one key run one at a time, in order, on one thread, while different keys
+ * spread across threads. State that belongs to a key can then be used from its tasks without locking.
+ *
+ * On success, this function returns an instance with a ref-count of 1. On failure it returns NULL. options are
+ * optional.
+ */
+AWS_COMMON_API
+struct aws_thread_scheduler_group *aws_thread_scheduler_group_new(
+    struct aws_allocator *allocator,
+    const struct aws_thread_scheduler_group_options *options);
+
+/**
+ * Acquire a reference to the group.
+ */
+AWS_COMMON_API void aws_thread_scheduler_group_acquire(struct aws_thread_scheduler_group *group);
+
+/**
+ * Release a reference to the group. Releasing the last one releases every scheduler in it, which cancels their
+ * remaining tasks.
+ */
+AWS_COMMON_API void aws_thread_scheduler_group_release(struct aws_thread_scheduler_group *group);
+
+/**
+ * Returns the number of schedulers in the group.
+ */
+AWS_COMMON_API size_t aws_thread_scheduler_group_get_scheduler_count(const struct aws_thread_scheduler_group *group);
+
+/**
+ * Returns the scheduler at index, which must be less than aws_thread_scheduler_group_get_scheduler_count(). The group
+ * keeps its own reference to it.
+ */
+AWS_COMMON_API struct aws_thread_scheduler *aws_thread_scheduler_group_get_scheduler(
+    const struct aws_thread_scheduler_group *group,
+    size_t index);
+
+/**
+ * Returns the scheduler that tasks with this key go to. The mapping is a fixed hash of the key, so it never changes
+ * for the lifetime of the group. Pointers make good keys, e.g. (uint64_t)(uintptr_t)connection.
+ */
+AWS_COMMON_API struct aws_thread_scheduler *aws_thread_scheduler_group_get_scheduler_for_key(
+    const struct aws_thread_scheduler_group *group,
+    uint64_t key);
+
+/**
+ * Schedules a task to run as soon as possible on the key's scheduler.
+ */
+AWS_COMMON_API void aws_thread_scheduler_group_schedule_now(
+    struct aws_thread_scheduler_group *group,
+    uint64_t key,
+    struct aws_task *task);
+
+/**
+ * Schedules a task to run at time_to_run on the key's scheduler. time_to_run is the absolute time from the system
+ * hw_clock.
+ */
+AWS_COMMON_API void aws_thread_scheduler_group_schedule_future(
+    struct aws_thread_scheduler_group *group,
+    uint64_t key,
+    struct aws_task *task,
+    uint64_t time_to_run);
+
+/**
+ * Cancels a task scheduled with the same key, see aws_thread_scheduler_cancel_task().
+ */
+AWS_COMMON_API void aws_thread_scheduler_group_cancel_task(
+    struct aws_thread_scheduler_group *group,
+    uint64_t key,
+    struct aws_task *task);
+
+/**
+ * Fills metrics with the current queue depths of the group's schedulers. Safe to call from any thread.
+ */
+AWS_COMMON_API void aws_thread_scheduler_group_get_metrics(
+    const struct aws_thread_scheduler_group *group,
+    struct aws_thread_scheduler_group_metrics *metrics);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_COMMON_THREAD_SCHEDULER_GROUP_H */
@@ -0,0 +1,33 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <arm_neon.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <aws/common/private/byte_buf.h>
+
+/* Lowercases 'A' through 'Z' and leaves every other byte alone, like aws_lookup_table_to_lower_get(). */
+static inline uint8x16_t s_to_lower(uint8x16_t bytes) {
+    uint8x16_t upper = vcltq_u8(vsubq_u8(bytes, vdupq_n_u8('A')), vdupq_n_u8(26));
+    return vorrq_u8(bytes, vandq_u8(upper, vdupq_n_u8(0x20)));
+}
+
+/*
+ * Compares a and b ignoring ASCII case, 16 bytes at a time. Returns the offset of the first block that differs, or
+ * the number of bytes covered if none does; the caller compares what's left.
+ */
+size_t aws_common_private_case_equal_prefix_neon(const uint8_t *a, const uint8_t *b, size_t len) {
+    size_t offset = 0;
+    for (; offset + 16 <= len; offset += 16) {
+        uint8x16_t equal = vceqq_u8(s_to_lower(vld1q_u8(a + offset)), s_to_lower(vld1q_u8(b + offset)));
+        if (vminvq_u8(equal) != 0xFF) {
+            return offset;
+        }
+    }
+
+    return offset;
+}
@@ -0,0 +1,45 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <arm_neon.h>
+
+#include <stddef.h>
+
+#include <aws/common/math.h>
+#include <aws/common/private/byte_buf.h>
+
+/*
+ * Finds the first byte that's in a delimiter set, 16 bytes at a time. The set is a 256 bit bitmap, small enough for a
+ * single two register table lookup: the top 5 bits of a byte pick its bitmap byte and the bottom 3 the bit in it.
+ *
+ * Covers the input up to the largest multiple of 16 that fits, and leaves the rest to the caller. Returns the first
+ * delimiter, or NULL with *scanned set to the number of bytes covered.
+ */
+const uint8_t *aws_common_private_find_delimiter_neon(
+    const uint8_t *input,
+    size_t len,
+    const uint8_t bitmap[32],
+    size_t *scanned) {
+
+    static const uint8_t s_bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16x2_t table = {{vld1q_u8(bitmap), vld1q_u8(bitmap + 16)}};
+    uint8x16_t bits = vld1q_u8(s_bits);
+
+    size_t position = 0;
+    for (; position + 16 <= len; position += 16) {
+        uint8x16_t block = vld1q_u8(input + position);
+        uint8x16_t bitmap_bytes = vqtbl2q_u8(table, vshrq_n_u8(block, 3));
+        uint8x16_t hits = vtstq_u8(bitmap_bytes, vqtbl1q_u8(bits, vandq_u8(block, vdupq_n_u8(0x07))));
+
+        /* there's no movemask: narrowing each 16 bit lane by 4 leaves a nibble per byte instead */
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0);
+        if (mask) {
+            return input + position + aws_ctz_u64(mask) / 4;
+        }
+    }
+
+    *scanned = position;
+    return NULL;
+}
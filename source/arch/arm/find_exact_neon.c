@@ -0,0 +1,67 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <arm_neon.h>
+
+#include <string.h>
+
+#include <aws/common/math.h>
+#include <aws/common/private/byte_buf.h>
+
+/*
+ * Substring search filtering 16 candidate positions at a time on two anchor bytes of the needle: a position is only
+ * compared in full if the haystack has the right byte at both anchor offsets from it. NEON is part of the AArch64
+ * baseline, so there is nothing to detect at runtime.
+ *
+ * Covers every start position below the largest multiple of 16 that fits, and leaves the rest to the caller. Returns
+ * the first match, or NULL with *scanned set to the number of start positions covered.
+ */
+const uint8_t *aws_common_private_find_exact_neon(
+    const uint8_t *haystack,
+    size_t haystack_len,
+    const uint8_t *needle,
+    size_t needle_len,
+    const size_t anchor_offsets[2],
+    size_t *scanned) {
+
+    /* the loads reach at most anchor_offset + positions - 1 <= haystack_len - 1 */
+    size_t positions = haystack_len - needle_len + 1;
+    const uint8_t *anchor_a = haystack + anchor_offsets[0];
+    const uint8_t *anchor_b = haystack + anchor_offsets[1];
+    uint8x16_t byte_a = vdupq_n_u8(needle[anchor_offsets[0]]);
+    uint8x16_t byte_b = vdupq_n_u8(needle[anchor_offsets[1]]);
+
+    size_t position = 0;
+    while (position + 16 <= positions) {
+        /* find the next block with candidates in it, without calling anything that would clobber the vectors */
+        uint64_t mask = 0;
+        for (; position + 16 <= positions; position += 16) {
+            uint8x16_t candidates = vandq_u8(
+                vceqq_u8(vld1q_u8(anchor_a + position), byte_a), vceqq_u8(vld1q_u8(anchor_b + position), byte_b));
+
+            /* there's no movemask: narrowing each 16 bit lane by 4 leaves a nibble per byte instead */
+            mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(candidates), 4)), 0);
+            if (mask) {
+                break;
+            }
+        }
+        if (!mask) {
+            break;
+        }
+
+        do {
+            size_t index = aws_ctz_u64(mask) / 4;
+            const uint8_t *candidate = haystack + position + index;
+            if (!memcmp(candidate, needle, needle_len)) {
+                return candidate;
+            }
+            mask &= ~((uint64_t)0xF << (index * 4));
+        } while (mask);
+        position += 16;
+    }
+
+    *scanned = position;
+    return NULL;
+}
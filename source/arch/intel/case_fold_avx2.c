@@ -0,0 +1,53 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <immintrin.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <aws/common/private/byte_buf.h>
+
+/*
+ * Lowercases 'A' through 'Z' and leaves every other byte alone, like aws_lookup_table_to_lower_get(). Adding
+ * 0x80 - 'A' moves the uppercase letters to the bottom of the signed range, where one signed compare finds them.
+ */
+static inline __m256i s_to_lower_256(__m256i bytes) {
+    __m256i shifted = _mm256_add_epi8(bytes, _mm256_set1_epi8((char)(0x80 - 'A')));
+    __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(-128 + 26)), shifted);
+    return _mm256_or_si256(bytes, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+static inline __m128i s_to_lower_128(__m128i bytes) {
+    __m128i shifted = _mm_add_epi8(bytes, _mm_set1_epi8((char)(0x80 - 'A')));
+    __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8((char)(-128 + 26)), shifted);
+    return _mm_or_si128(bytes, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+/*
+ * Compares a and b ignoring ASCII case, 32 bytes at a time and then 16 if that many are left. Returns the offset of
+ * the first block that differs, or the number of bytes covered if none does; the caller compares what's left.
+ */
+size_t aws_common_private_case_equal_prefix_avx2(const uint8_t *a, const uint8_t *b, size_t len) {
+    size_t offset = 0;
+    for (; offset + 32 <= len; offset += 32) {
+        __m256i block_a = s_to_lower_256(_mm256_loadu_si256((const __m256i *)(a + offset)));
+        __m256i block_b = s_to_lower_256(_mm256_loadu_si256((const __m256i *)(b + offset)));
+        if ((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block_a, block_b)) != UINT32_MAX) {
+            return offset;
+        }
+    }
+
+    if (offset + 16 <= len) {
+        __m128i block_a = s_to_lower_128(_mm_loadu_si128((const __m128i *)(a + offset)));
+        __m128i block_b = s_to_lower_128(_mm_loadu_si128((const __m128i *)(b + offset)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(block_a, block_b)) != 0xFFFF) {
+            return offset;
+        }
+        offset += 16;
+    }
+
+    return offset;
+}
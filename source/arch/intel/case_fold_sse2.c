@@ -0,0 +1,39 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <emmintrin.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <aws/common/private/byte_buf.h>
+
+/*
+ * Lowercases 'A' through 'Z' and leaves every other byte alone, like aws_lookup_table_to_lower_get(). Adding
+ * 0x80 - 'A' moves the uppercase letters to the bottom of the signed range, where one signed compare finds them.
+ */
+static inline __m128i s_to_lower(__m128i bytes) {
+    __m128i shifted = _mm_add_epi8(bytes, _mm_set1_epi8((char)(0x80 - 'A')));
+    __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8((char)(-128 + 26)), shifted);
+    return _mm_or_si128(bytes, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+/*
+ * Compares a and b ignoring ASCII case, 16 bytes at a time. SSE2 is part of the x86-64 baseline, so this is what runs
+ * when AVX2 isn't available. Returns the offset of the first block that differs, or the number of bytes covered if
+ * none does; the caller compares what's left.
+ */
+size_t aws_common_private_case_equal_prefix_sse2(const uint8_t *a, const uint8_t *b, size_t len) {
+    size_t offset = 0;
+    for (; offset + 16 <= len; offset += 16) {
+        __m128i block_a = s_to_lower(_mm_loadu_si128((const __m128i *)(a + offset)));
+        __m128i block_b = s_to_lower(_mm_loadu_si128((const __m128i *)(b + offset)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(block_a, block_b)) != 0xFFFF) {
+            return offset;
+        }
+    }
+
+    return offset;
+}
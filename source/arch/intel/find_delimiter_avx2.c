@@ -0,0 +1,53 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <immintrin.h>
+
+#include <stddef.h>
+
+#include <aws/common/math.h>
+#include <aws/common/private/byte_buf.h>
+
+/*
+ * Finds the first byte that's in a delimiter set, 32 bytes at a time. The set is a 256 bit bitmap: bits 3-6 of a byte
+ * shuffle its bitmap byte out of the first or last 16 bytes, depending on bit 7, and bits 0-2 pick the bit in it.
+ *
+ * Covers the input up to the largest multiple of 32 that fits, and leaves the rest to the caller. Returns the first
+ * delimiter, or NULL with *scanned set to the number of bytes covered.
+ */
+const uint8_t *aws_common_private_find_delimiter_avx2(
+    const uint8_t *input,
+    size_t len,
+    const uint8_t bitmap[32],
+    size_t *scanned) {
+
+    __m256i bitmap_low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)bitmap));
+    __m256i bitmap_high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(bitmap + 16)));
+    __m256i bits = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, (char)128, 1, 2, 4, 8, 16, 32, 64, (char)128));
+
+    size_t position = 0;
+    for (; position + 32 <= len; position += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(input + position));
+
+        /* a shuffle index with its top bit set picks zero, so keeping the byte's top bit in the index makes each half
+         * of the bitmap only answer for its own bytes */
+        __m256i index = _mm256_or_si256(
+            _mm256_and_si256(_mm256_srli_epi16(block, 3), _mm256_set1_epi8(0x0F)),
+            _mm256_and_si256(block, _mm256_set1_epi8((char)0x80)));
+        __m256i bitmap_bytes = _mm256_or_si256(
+            _mm256_shuffle_epi8(bitmap_low, index),
+            _mm256_shuffle_epi8(bitmap_high, _mm256_xor_si256(index, _mm256_set1_epi8((char)0x80))));
+        __m256i bit = _mm256_shuffle_epi8(bits, _mm256_and_si256(block, _mm256_set1_epi8(0x07)));
+        __m256i misses = _mm256_cmpeq_epi8(_mm256_and_si256(bitmap_bytes, bit), _mm256_setzero_si256());
+        uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(misses);
+        if (mask) {
+            return input + position + aws_ctz_u32(mask);
+        }
+    }
+
+    *scanned = position;
+    return NULL;
+}
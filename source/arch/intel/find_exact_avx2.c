@@ -0,0 +1,65 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <immintrin.h>
+
+#include <string.h>
+
+#include <aws/common/math.h>
+#include <aws/common/private/byte_buf.h>
+
+/*
+ * Substring search filtering 32 candidate positions at a time on two anchor bytes of the needle: a position is only
+ * compared in full if the haystack has the right byte at both anchor offsets from it.
+ *
+ * Covers every start position below the largest multiple of 32 that fits, and leaves the rest to the caller. Returns
+ * the first match, or NULL with *scanned set to the number of start positions covered.
+ */
+const uint8_t *aws_common_private_find_exact_avx2(
+    const uint8_t *haystack,
+    size_t haystack_len,
+    const uint8_t *needle,
+    size_t needle_len,
+    const size_t anchor_offsets[2],
+    size_t *scanned) {
+
+    /* the loads reach at most anchor_offset + positions - 1 <= haystack_len - 1 */
+    size_t positions = haystack_len - needle_len + 1;
+    const uint8_t *anchor_a = haystack + anchor_offsets[0];
+    const uint8_t *anchor_b = haystack + anchor_offsets[1];
+    __m256i byte_a = _mm256_set1_epi8((char)needle[anchor_offsets[0]]);
+    __m256i byte_b = _mm256_set1_epi8((char)needle[anchor_offsets[1]]);
+
+    size_t position = 0;
+    while (position + 32 <= positions) {
+        /* find the next block with candidates in it, without calling anything that would clobber the vectors */
+        uint32_t mask = 0;
+        for (; position + 32 <= positions; position += 32) {
+            __m256i block_a = _mm256_loadu_si256((const __m256i *)(anchor_a + position));
+            __m256i block_b = _mm256_loadu_si256((const __m256i *)(anchor_b + position));
+            __m256i candidates =
+                _mm256_and_si256(_mm256_cmpeq_epi8(block_a, byte_a), _mm256_cmpeq_epi8(block_b, byte_b));
+            mask = (uint32_t)_mm256_movemask_epi8(candidates);
+            if (mask) {
+                break;
+            }
+        }
+        if (!mask) {
+            break;
+        }
+
+        do {
+            const uint8_t *candidate = haystack + position + aws_ctz_u32(mask);
+            if (!memcmp(candidate, needle, needle_len)) {
+                return candidate;
+            }
+            mask &= mask - 1;
+        } while (mask);
+        position += 32;
+    }
+
+    *scanned = position;
+    return NULL;
+}
@@ -193,13 +193,14 @@ int aws_byte_buf_init_cache_and_update_cursors(struct aws_byte_buf *dest, struct
     return AWS_OP_SUCCESS;
 }
 
-bool aws_byte_cursor_next_split(
+/*
+ * Moves substr past the previous split, so it covers the rest of input_str for the caller to search for the end of the
+ * next one. Returns false, with substr zeroed, once there are no more splits.
+ */
+static bool s_next_split_remainder(
     const struct aws_byte_cursor *AWS_RESTRICT input_str,
-    char split_on,
     struct aws_byte_cursor *AWS_RESTRICT substr) {
 
-    AWS_PRECONDITION(aws_byte_cursor_is_valid(input_str));
-
     /* If substr is zeroed-out, then this is the first run. */
     const bool first_run = substr->ptr == NULL;
 
@@ -241,6 +242,20 @@ bool aws_byte_cursor_next_split(
         substr->len = input_str->len - (substr->ptr - input_str->ptr);
     }
 
+    return true;
+}
+
+bool aws_byte_cursor_next_split(
+    const struct aws_byte_cursor *AWS_RESTRICT input_str,
+    char split_on,
+    struct aws_byte_cursor *AWS_RESTRICT substr) {
+
+    AWS_PRECONDITION(aws_byte_cursor_is_valid(input_str));
+
+    if (!s_next_split_remainder(input_str, substr)) {
+        return false;
+    }
+
     /* substr is now remainder of string, search for next split */
     uint8_t *new_location = memchr(substr->ptr, split_on, substr->len);
     if (new_location) {
@@ -253,6 +268,69 @@ bool aws_byte_cursor_next_split(
     return true;
 }
 
+void aws_byte_delimiter_set_init(struct aws_byte_delimiter_set *set, struct aws_byte_cursor delimiters) {
+    AWS_PRECONDITION(set);
+    AWS_PRECONDITION(aws_byte_cursor_is_valid(&delimiters));
+
+    AWS_ZERO_STRUCT(*set);
+    for (size_t i = 0; i < delimiters.len; ++i) {
+        set->bitmap[delimiters.ptr[i] >> 3] |= (uint8_t)(1u << (delimiters.ptr[i] & 0x07));
+    }
+}
+
+static bool s_is_delimiter(const struct aws_byte_delimiter_set *set, uint8_t byte) {
+    return (set->bitmap[byte >> 3] >> (byte & 0x07)) & 1;
+}
+
+static const uint8_t *s_find_delimiter(const uint8_t *input, size_t len, const struct aws_byte_delimiter_set *set) {
+    size_t position = 0;
+#if defined(USE_SIMD_FIND_DELIMITER) || defined(USE_NEON_FIND_DELIMITER)
+#    if defined(USE_SIMD_FIND_DELIMITER)
+    bool has_simd = aws_common_private_has_avx2();
+#    else
+    bool has_simd = true;
+#    endif
+    if (has_simd) {
+#    if defined(USE_SIMD_FIND_DELIMITER)
+        const uint8_t *found = aws_common_private_find_delimiter_avx2(input, len, set->bitmap, &position);
+#    else
+        const uint8_t *found = aws_common_private_find_delimiter_neon(input, len, set->bitmap, &position);
+#    endif
+        if (found) {
+            return found;
+        }
+    }
+#endif
+
+    for (; position < len; ++position) {
+        if (s_is_delimiter(set, input[position])) {
+            return input + position;
+        }
+    }
+    return NULL;
+}
+
+bool aws_byte_cursor_next_split_on_any(
+    const struct aws_byte_cursor *AWS_RESTRICT input_str,
+    const struct aws_byte_delimiter_set *delimiters,
+    struct aws_byte_cursor *AWS_RESTRICT substr) {
+
+    AWS_PRECONDITION(aws_byte_cursor_is_valid(input_str));
+    AWS_PRECONDITION(delimiters);
+
+    if (!s_next_split_remainder(input_str, substr)) {
+        return false;
+    }
+
+    const uint8_t *new_location = s_find_delimiter(substr->ptr, substr->len, delimiters);
+    if (new_location) {
+        substr->len = new_location - substr->ptr;
+    }
+
+    AWS_POSTCONDITION(aws_byte_cursor_is_valid(substr));
+    return true;
+}
+
 int aws_byte_cursor_split_on_char_n(
     const struct aws_byte_cursor *AWS_RESTRICT input_str,
     char split_on,
@@ -293,42 +371,202 @@ int aws_byte_cursor_split_on_char(
     return aws_byte_cursor_split_on_char_n(input_str, split_on, 0, output);
 }
 
-int aws_byte_cursor_find_exact(
-    const struct aws_byte_cursor *AWS_RESTRICT input_str,
-    const struct aws_byte_cursor *AWS_RESTRICT to_find,
-    struct aws_byte_cursor *first_find) {
-    if (to_find->len > input_str->len) {
-        return aws_raise_error(AWS_ERROR_STRING_MATCH_NOT_FOUND);
+/* Rough guess at how common a byte is in text and protocol data, higher being more common. */
+static int s_byte_frequency_class(uint8_t value) {
+    if (value == ' ' || value == 'e' || value == 't' || value == 'a' || value == 'o' || value == 'i' || value == 'n' ||
+        value == 's' || value == 'r') {
+        return 4;
+    }
+    if ((value >= 'a' && value <= 'z') || value == '\r' || value == '\n' || value == '\t' || value == '\0' ||
+        value == '-' || value == '/') {
+        return 3;
+    }
+    if ((value >= '0' && value <= '9') || value == '<' || value == '>' || value == '=' || value == '"' ||
+        value == '.' || value == ',' || value == ':' || value == '_') {
+        return 2;
+    }
+    /* upper case, other punctuation */
+    if (value >= 0x20 && value < 0x7F) {
+        return 1;
     }
+    /* control characters, and everything that isn't ASCII */
+    return 0;
+}
 
-    if (to_find->len < 1) {
+int aws_byte_find_pattern_init(struct aws_byte_find_pattern *pattern, struct aws_byte_cursor to_find) {
+    AWS_PRECONDITION(pattern);
+    AWS_ERROR_PRECONDITION(aws_byte_cursor_is_valid(&to_find));
+
+    if (to_find.len < 1) {
         return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
     }
 
-    struct aws_byte_cursor working_cur = *input_str;
+    /*
+     * Anchor on the rarest byte, and on the rarest byte with a different value from it. Among equally rare bytes this
+     * picks the first and the last, so a pattern like "\r\n\r\n" still filters on two different bytes.
+     */
+    size_t first = 0;
+    for (size_t i = 1; i < to_find.len; ++i) {
+        if (s_byte_frequency_class(to_find.ptr[i]) < s_byte_frequency_class(to_find.ptr[first])) {
+            first = i;
+        }
+    }
+
+    size_t second = to_find.len - 1;
+    bool second_differs = false;
+    for (size_t i = 0; i < to_find.len; ++i) {
+        if (to_find.ptr[i] == to_find.ptr[first]) {
+            continue;
+        }
+        if (!second_differs ||
+            s_byte_frequency_class(to_find.ptr[i]) <= s_byte_frequency_class(to_find.ptr[second])) {
+            second = i;
+            second_differs = true;
+        }
+    }
 
-    while (working_cur.len) {
-        uint8_t *first_char_location = memchr(working_cur.ptr, (char)*to_find->ptr, working_cur.len);
+    pattern->pattern = to_find;
+    pattern->anchor_offsets[0] = first;
+    pattern->anchor_offsets[1] = second;
+    return AWS_OP_SUCCESS;
+}
 
-        if (!first_char_location) {
-            return aws_raise_error(AWS_ERROR_STRING_MATCH_NOT_FOUND);
+/*
+ * Checks start positions from `start` on, using memchr() to jump between occurrences of the first anchor byte, and
+ * returns the first match or NULL with *resume set to the number of start positions there are.
+ *
+ * When the anchor byte turns out to be common, hopping from one occurrence to the next is slower than filtering every
+ * position with SIMD, so with `may_give_up` set this stops early once candidates that don't match come more often than
+ * once every 64 bytes, and sets *resume to the first start position it didn't check.
+ */
+static const uint8_t *s_find_pattern_scalar(
+    const uint8_t *haystack,
+    size_t haystack_len,
+    const struct aws_byte_find_pattern *pattern,
+    size_t start,
+    bool may_give_up,
+    size_t *resume) {
+
+    const uint8_t *needle = pattern->pattern.ptr;
+    size_t needle_len = pattern->pattern.len;
+    size_t anchor_a = pattern->anchor_offsets[0];
+    size_t anchor_b = pattern->anchor_offsets[1];
+    size_t positions = haystack_len - needle_len + 1;
+
+    /* occurrences of the first anchor byte in [search, end) are the candidates */
+    const uint8_t *search = haystack + start + anchor_a;
+    const uint8_t *end = haystack + positions + anchor_a;
+    size_t misses = 0;
+    while (search < end) {
+        const uint8_t *anchor = memchr(search, needle[anchor_a], (size_t)(end - search));
+        if (!anchor) {
+            break;
         }
 
-        aws_byte_cursor_advance(&working_cur, first_char_location - working_cur.ptr);
+        const uint8_t *candidate = anchor - anchor_a;
+        if (candidate[anchor_b] == needle[anchor_b] && !memcmp(candidate, needle, needle_len)) {
+            return candidate;
+        }
+        search = anchor + 1;
 
-        if (working_cur.len < to_find->len) {
-            return aws_raise_error(AWS_ERROR_STRING_MATCH_NOT_FOUND);
+        if (may_give_up && ++misses > 8 && misses * 64 > (size_t)(candidate - haystack) - start) {
+            *resume = (size_t)(candidate - haystack) + 1;
+            return NULL;
         }
+    }
 
-        if (!memcmp(working_cur.ptr, to_find->ptr, to_find->len)) {
-            *first_find = working_cur;
-            return AWS_OP_SUCCESS;
+    *resume = positions;
+    return NULL;
+}
+
+static const uint8_t *s_find_pattern(
+    const uint8_t *haystack,
+    size_t haystack_len,
+    const struct aws_byte_find_pattern *pattern) {
+
+    if (pattern->pattern.len == 1) {
+        return memchr(haystack, pattern->pattern.ptr[0], haystack_len);
+    }
+
+    size_t position = 0;
+    const uint8_t *found = NULL;
+#if defined(USE_SIMD_FIND_EXACT) || defined(USE_NEON_FIND_EXACT)
+#    if defined(USE_SIMD_FIND_EXACT)
+    bool has_simd = aws_common_private_has_avx2();
+#    else
+    bool has_simd = true;
+#    endif
+    if (has_simd) {
+        size_t positions = haystack_len - pattern->pattern.len + 1;
+        found = s_find_pattern_scalar(haystack, haystack_len, pattern, 0, true, &position);
+        if (found || position == positions) {
+            return found;
+        }
+
+        size_t scanned = 0;
+#    if defined(USE_SIMD_FIND_EXACT)
+        found = aws_common_private_find_exact_avx2(
+            haystack + position,
+            haystack_len - position,
+            pattern->pattern.ptr,
+            pattern->pattern.len,
+            pattern->anchor_offsets,
+            &scanned);
+#    else
+        found = aws_common_private_find_exact_neon(
+            haystack + position,
+            haystack_len - position,
+            pattern->pattern.ptr,
+            pattern->pattern.len,
+            pattern->anchor_offsets,
+            &scanned);
+#    endif
+        if (found) {
+            return found;
         }
+        position += scanned;
+    }
+#endif
+
+    return s_find_pattern_scalar(haystack, haystack_len, pattern, position, false, &position);
+}
+
+int aws_byte_cursor_find_pattern(
+    const struct aws_byte_cursor *AWS_RESTRICT input_str,
+    const struct aws_byte_find_pattern *AWS_RESTRICT pattern,
+    struct aws_byte_cursor *first_find) {
+    AWS_PRECONDITION(aws_byte_cursor_is_valid(input_str));
+    AWS_PRECONDITION(pattern && pattern->pattern.len > 0);
+    AWS_PRECONDITION(first_find);
+
+    if (pattern->pattern.len > input_str->len) {
+        return aws_raise_error(AWS_ERROR_STRING_MATCH_NOT_FOUND);
+    }
+
+    const uint8_t *found = s_find_pattern(input_str->ptr, input_str->len, pattern);
+    if (!found) {
+        return aws_raise_error(AWS_ERROR_STRING_MATCH_NOT_FOUND);
+    }
+
+    *first_find = *input_str;
+    aws_byte_cursor_advance(first_find, (size_t)(found - input_str->ptr));
+    return AWS_OP_SUCCESS;
+}
 
-        aws_byte_cursor_advance(&working_cur, 1);
+int aws_byte_cursor_find_exact(
+    const struct aws_byte_cursor *AWS_RESTRICT input_str,
+    const struct aws_byte_cursor *AWS_RESTRICT to_find,
+    struct aws_byte_cursor *first_find) {
+    if (to_find->len > input_str->len) {
+        return aws_raise_error(AWS_ERROR_STRING_MATCH_NOT_FOUND);
+    }
+
+    struct aws_byte_find_pattern pattern;
+    if (aws_byte_find_pattern_init(&pattern, *to_find)) {
+        return AWS_OP_ERR;
     }
 
-    return aws_raise_error(AWS_ERROR_STRING_MATCH_NOT_FOUND);
+    return aws_byte_cursor_find_pattern(input_str, &pattern, first_find);
 }
 
 int aws_byte_buf_cat(struct aws_byte_buf *dest, size_t number_of_args, ...) {
@@ -391,6 +629,67 @@ const uint8_t *aws_lookup_table_to_lower_get(void) {
     return s_tolower_table;
 }
 
+/*
+ * Lowercases the ASCII letters in 8 bytes at once and leaves every other byte alone, same as s_tolower_table.
+ * Each byte's high bit is cleared first so the additions can't carry into the next byte; after them, a byte's high
+ * bit says whether its low 7 bits are >= 'A' (ge_a) or > 'Z' (gt_z).
+ */
+static uint64_t s_to_lower_u64(uint64_t bytes) {
+    const uint64_t ones = 0x0101010101010101ULL;
+    uint64_t low_bits = bytes & (0x7F * ones);
+    uint64_t ge_a = low_bits + (0x80 - 'A') * ones;
+    uint64_t gt_z = low_bits + (0x80 - 'Z' - 1) * ones;
+    uint64_t upper = ge_a & ~gt_z & ~bytes & (0x80 * ones);
+    return bytes | (upper >> 2);
+}
+
+static bool s_case_equal_u64(const uint8_t *a, const uint8_t *b) {
+    uint64_t word_a;
+    uint64_t word_b;
+    memcpy(&word_a, a, sizeof(word_a));
+    memcpy(&word_b, b, sizeof(word_b));
+    return s_to_lower_u64(word_a) == s_to_lower_u64(word_b);
+}
+
+/*
+ * Returns the length of the longest common prefix of a and b, ignoring ASCII case. The SIMD kernels skip whole blocks
+ * that match, then whatever's left goes 8 bytes at a time, then byte by byte.
+ */
+static size_t s_case_equal_prefix(const uint8_t *a, const uint8_t *b, size_t len) {
+    size_t offset = 0;
+    if (len >= 16) {
+#if defined(USE_SIMD_CASE_FOLD)
+        if (aws_common_private_has_avx2()) {
+            offset = aws_common_private_case_equal_prefix_avx2(a, b, len);
+        } else
+#endif
+        {
+#if defined(USE_SSE2_CASE_FOLD)
+            offset = aws_common_private_case_equal_prefix_sse2(a, b, len);
+#elif defined(USE_NEON_CASE_FOLD)
+            offset = aws_common_private_case_equal_prefix_neon(a, b, len);
+#endif
+        }
+    }
+
+    for (; offset + 8 <= len; offset += 8) {
+        if (!s_case_equal_u64(a + offset, b + offset)) {
+            break;
+        }
+    }
+
+    /* a tail shorter than a word can be checked with a last word that overlaps the one before */
+    if (offset < len && len >= 8 && len - offset < 8 && s_case_equal_u64(a + len - 8, b + len - 8)) {
+        return len;
+    }
+
+    while (offset < len && s_tolower_table[a[offset]] == s_tolower_table[b[offset]]) {
+        ++offset;
+    }
+
+    return offset;
+}
+
 bool aws_array_eq_ignore_case(
     const void *const array_a,
     const size_t len_a,
@@ -405,15 +704,7 @@ bool aws_array_eq_ignore_case(
         return false;
     }
 
-    const uint8_t *bytes_a = array_a;
-    const uint8_t *bytes_b = array_b;
-    for (size_t i = 0; i < len_a; ++i) {
-        if (s_tolower_table[bytes_a[i]] != s_tolower_table[bytes_b[i]]) {
-            return false;
-        }
-    }
-
-    return true;
+    return s_case_equal_prefix(array_a, array_b, len_a) == len_a;
 }
 
 bool aws_array_eq(const void *const array_a, const size_t len_a, const void *const array_b, const size_t len_b) {
@@ -495,6 +786,9 @@ uint64_t aws_hash_array_ignore_case(const void *array, const size_t len) {
     const uint64_t fnv_offset_basis = 0xcbf29ce484222325ULL;
     const uint64_t fnv_prime = 0x100000001b3ULL;
 
+    /* each multiply waits on the one before, so unlike the comparisons there's nothing to gain from folding case
+     * several bytes at a time: the table lookups already run ahead of the multiplies */
+
     const uint8_t *i = array;
     const uint8_t *end = (i == NULL) ? NULL : (i + len);
 
@@ -912,6 +1206,13 @@ int aws_byte_cursor_compare_lookup(
     const uint8_t *rhs_curr = rhs->ptr;
     const uint8_t *rhs_end = rhs_curr + rhs->len;
 
+    if (lookup_table == s_tolower_table) {
+        /* case-insensitive comparison, the usual reason to be here, can skip the common prefix in bulk */
+        size_t common = s_case_equal_prefix(lhs_curr, rhs_curr, aws_min_size(lhs->len, rhs->len));
+        lhs_curr += common;
+        rhs_curr += common;
+    }
+
     while (lhs_curr < lhs_end && rhs_curr < rhs_end) {
         uint8_t lhc = lookup_table[*lhs_curr];
         uint8_t rhc = lookup_table[*rhs_curr];
@@ -0,0 +1,554 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_buf_pool.h>
+
+#include <aws/common/atomics.h>
+#include <aws/common/linked_list.h>
+#include <aws/common/mutex.h>
+#include <aws/common/ref_count.h>
+#include <aws/common/thread.h>
+
+/* the free lists keep their links in the idle buffers themselves */
+#define MIN_SIZE_CLASS 64
+
+enum byte_buf_pool_counter {
+    COUNTER_ACQUIRE,
+    COUNTER_HIT,
+    COUNTER_THREAD_CACHE_HIT,
+    COUNTER_RELEASE,
+    COUNTER_DISCARD,
+    COUNTER_COUNT,
+};
+
+/* A stack of idle buffers of one size class, linked through their first bytes. */
+struct free_list {
+    uint8_t *head;
+    size_t count;
+};
+
+struct byte_buf_pool_thread_cache {
+    struct aws_byte_buf_pool *pool;
+    /* the next of the owning thread's caches, for other pools */
+    struct byte_buf_pool_thread_cache *next;
+    /* in pool->thread_caches, under pool->lock */
+    struct aws_linked_list_node node;
+    /* only written by the owning thread, read by aws_byte_buf_pool_get_stats() */
+    struct aws_atomic_var counters[COUNTER_COUNT];
+    /* Bytes of pool->retained_bytes this cache has reserved for itself but isn't using for idle buffers: the cache
+     * takes its share of the limit in batches rather than touching the shared count for every buffer. Only written by
+     * the owning thread, read by aws_byte_buf_pool_get_stats() */
+    struct aws_atomic_var unused_reservation;
+    /* only touched by the owning thread, or by the thread closing the pool once nobody else can use it */
+    struct free_list free_lists[];
+};
+
+struct aws_byte_buf_pool {
+    struct aws_allocator *allocator;
+    /* references held by users */
+    struct aws_ref_count ref_count;
+    /* one for the users as a whole, plus one per thread cache: the struct goes away when the last thread that used
+     * the pool is done with it */
+    struct aws_atomic_var internal_ref_count;
+    /* set once the last user reference is gone. Read without the lock by threads looking for caches to get rid of */
+    struct aws_atomic_var closed;
+
+    size_t min_size_shift;
+    size_t size_class_count;
+    size_t max_retained_bytes;
+    size_t thread_cache_size;
+    bool disable_thread_caches;
+
+    /* bytes in idle buffers in the shared lists, plus what the thread caches have reserved */
+    struct aws_atomic_var retained_bytes;
+    /* how much a thread cache reserves at once, the largest size class */
+    size_t reservation_size;
+    /* counts from threads without a cache, and from caches that are gone */
+    struct aws_atomic_var counters[COUNTER_COUNT];
+
+    /* protects everything below, and moving buffers into or out of the thread caches' lists for other threads */
+    struct aws_mutex lock;
+    struct aws_linked_list thread_caches;
+    struct free_list free_lists[];
+};
+
+enum thread_cache_state {
+    THREAD_CACHE_STATE_UNKNOWN,
+    THREAD_CACHE_STATE_AVAILABLE,
+    /* not an aws_thread, or it's exiting: there's nothing to clean the caches up with */
+    THREAD_CACHE_STATE_UNAVAILABLE,
+};
+
+static AWS_THREAD_LOCAL struct byte_buf_pool_thread_cache *tl_thread_caches = NULL;
+static AWS_THREAD_LOCAL enum thread_cache_state tl_thread_cache_state = THREAD_CACHE_STATE_UNKNOWN;
+
+static void s_free_list_push(struct free_list *list, uint8_t *buffer) {
+    memcpy(buffer, &list->head, sizeof(list->head));
+    list->head = buffer;
+    ++list->count;
+}
+
+static uint8_t *s_free_list_pop(struct free_list *list) {
+    uint8_t *buffer = list->head;
+    if (buffer) {
+        memcpy(&list->head, buffer, sizeof(list->head));
+        --list->count;
+    }
+    return buffer;
+}
+
+static void s_free_list_clean_up(struct aws_byte_buf_pool *pool, struct free_list *list, size_t capacity) {
+    uint8_t *buffer = NULL;
+    while ((buffer = s_free_list_pop(list)) != NULL) {
+        aws_atomic_fetch_sub_explicit(&pool->retained_bytes, capacity, aws_memory_order_relaxed);
+        aws_mem_release(pool->allocator, buffer);
+    }
+}
+
+static size_t s_size_class_capacity(const struct aws_byte_buf_pool *pool, size_t size_class) {
+    return (size_t)1 << (pool->min_size_shift + size_class);
+}
+
+/* Returns false if nothing that big is pooled. */
+static bool s_size_class_for_request(const struct aws_byte_buf_pool *pool, size_t min_capacity, size_t *size_class) {
+    if (min_capacity > s_size_class_capacity(pool, pool->size_class_count - 1)) {
+        return false;
+    }
+
+    size_t capacity = 0;
+    aws_round_up_to_power_of_two(min_capacity, &capacity);
+    size_t shift = aws_ctz_u64(capacity);
+    *size_class = shift > pool->min_size_shift ? shift - pool->min_size_shift : 0;
+    return true;
+}
+
+/* Returns false if a buffer of that capacity can't go into any of the free lists. */
+static bool s_size_class_for_capacity(const struct aws_byte_buf_pool *pool, size_t capacity, size_t *size_class) {
+    if (!aws_is_power_of_two(capacity)) {
+        return false;
+    }
+
+    size_t shift = aws_ctz_u64(capacity);
+    if (shift < pool->min_size_shift) {
+        return false;
+    }
+    *size_class = shift - pool->min_size_shift;
+    return *size_class < pool->size_class_count;
+}
+
+/* Caches are only counted into by their own thread, so there's no need for an atomic add. */
+static void s_count(struct aws_byte_buf_pool *pool, struct byte_buf_pool_thread_cache *cache, size_t counter) {
+    if (cache) {
+        size_t count = aws_atomic_load_int_explicit(&cache->counters[counter], aws_memory_order_relaxed);
+        aws_atomic_store_int_explicit(&cache->counters[counter], count + 1, aws_memory_order_relaxed);
+    } else {
+        aws_atomic_fetch_add_explicit(&pool->counters[counter], 1, aws_memory_order_relaxed);
+    }
+}
+
+/* Reserves `size` bytes of the retained bytes limit, returns false if that would go over it. */
+static bool s_reserve(struct aws_byte_buf_pool *pool, size_t size) {
+    size_t retained = aws_atomic_fetch_add_explicit(&pool->retained_bytes, size, aws_memory_order_relaxed);
+    if (retained + size > pool->max_retained_bytes) {
+        aws_atomic_fetch_sub_explicit(&pool->retained_bytes, size, aws_memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+/* Makes room for one more idle buffer of `capacity` bytes in the cache. */
+static bool s_thread_cache_reserve(
+    struct aws_byte_buf_pool *pool,
+    struct byte_buf_pool_thread_cache *cache,
+    size_t capacity) {
+
+    size_t unused = aws_atomic_load_int_explicit(&cache->unused_reservation, aws_memory_order_relaxed);
+    if (unused < capacity) {
+        /* close to the limit, a batch may not fit where the buffer alone would */
+        if (s_reserve(pool, pool->reservation_size)) {
+            unused += pool->reservation_size;
+        } else if (s_reserve(pool, capacity)) {
+            unused += capacity;
+        } else {
+            return false;
+        }
+    }
+    aws_atomic_store_int_explicit(&cache->unused_reservation, unused - capacity, aws_memory_order_relaxed);
+    return true;
+}
+
+/* Called when an idle buffer of `capacity` bytes leaves the cache. */
+static void s_thread_cache_unreserve(
+    struct aws_byte_buf_pool *pool,
+    struct byte_buf_pool_thread_cache *cache,
+    size_t capacity) {
+
+    size_t unused = aws_atomic_load_int_explicit(&cache->unused_reservation, aws_memory_order_relaxed) + capacity;
+    /* keep one batch for the next releases, give the rest back */
+    if (unused > 2 * pool->reservation_size) {
+        aws_atomic_fetch_sub_explicit(
+            &pool->retained_bytes, unused - pool->reservation_size, aws_memory_order_relaxed);
+        unused = pool->reservation_size;
+    }
+    aws_atomic_store_int_explicit(&cache->unused_reservation, unused, aws_memory_order_relaxed);
+}
+
+static void s_release_internal(struct aws_byte_buf_pool *pool) {
+    if (aws_atomic_fetch_sub(&pool->internal_ref_count, 1) == 1) {
+        aws_mutex_clean_up(&pool->lock);
+        aws_mem_release(pool->allocator, pool);
+    }
+}
+
+/* Runs on the cache's own thread. If the pool is still in use, the idle buffers go back to its shared lists. */
+static void s_thread_cache_destroy(struct byte_buf_pool_thread_cache *cache) {
+    struct aws_byte_buf_pool *pool = cache->pool;
+
+    aws_mutex_lock(&pool->lock);
+    if (!aws_atomic_load_int(&pool->closed)) {
+        /* the buffers stay reserved, now in the shared lists */
+        for (size_t i = 0; i < pool->size_class_count; ++i) {
+            uint8_t *buffer = NULL;
+            while ((buffer = s_free_list_pop(&cache->free_lists[i])) != NULL) {
+                s_free_list_push(&pool->free_lists[i], buffer);
+            }
+        }
+        aws_atomic_fetch_sub_explicit(
+            &pool->retained_bytes,
+            aws_atomic_load_int_explicit(&cache->unused_reservation, aws_memory_order_relaxed),
+            aws_memory_order_relaxed);
+    }
+    aws_linked_list_remove(&cache->node);
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        aws_atomic_fetch_add_explicit(
+            &pool->counters[i],
+            aws_atomic_load_int_explicit(&cache->counters[i], aws_memory_order_relaxed),
+            aws_memory_order_relaxed);
+    }
+    aws_mutex_unlock(&pool->lock);
+
+    aws_mem_release(pool->allocator, cache);
+    s_release_internal(pool);
+}
+
+static void s_thread_caches_at_exit(void *user_data) {
+    (void)user_data;
+
+    /* other exit callbacks may still use pools, through the shared lists */
+    tl_thread_cache_state = THREAD_CACHE_STATE_UNAVAILABLE;
+    while (tl_thread_caches) {
+        struct byte_buf_pool_thread_cache *cache = tl_thread_caches;
+        tl_thread_caches = cache->next;
+        s_thread_cache_destroy(cache);
+    }
+}
+
+static struct byte_buf_pool_thread_cache *s_thread_cache_new(struct aws_byte_buf_pool *pool) {
+    if (tl_thread_cache_state == THREAD_CACHE_STATE_UNKNOWN) {
+        /* failing here is the normal case on threads that aren't aws_threads, and shouldn't show up as an error */
+        int last_error = aws_last_error();
+        tl_thread_cache_state = aws_thread_current_at_exit(s_thread_caches_at_exit, NULL)
+                                    ? THREAD_CACHE_STATE_UNAVAILABLE
+                                    : THREAD_CACHE_STATE_AVAILABLE;
+        aws_restore_error(last_error);
+    }
+    if (tl_thread_cache_state != THREAD_CACHE_STATE_AVAILABLE) {
+        return NULL;
+    }
+
+    /* a thread that goes through many short-lived pools would otherwise keep a cache for each of them */
+    struct byte_buf_pool_thread_cache **link = &tl_thread_caches;
+    while (*link) {
+        struct byte_buf_pool_thread_cache *cache = *link;
+        if (aws_atomic_load_int(&cache->pool->closed)) {
+            *link = cache->next;
+            s_thread_cache_destroy(cache);
+        } else {
+            link = &cache->next;
+        }
+    }
+
+    int last_error = aws_last_error();
+    size_t cache_size =
+        sizeof(struct byte_buf_pool_thread_cache) + pool->size_class_count * sizeof(struct free_list);
+    struct byte_buf_pool_thread_cache *cache = aws_mem_calloc(pool->allocator, 1, cache_size);
+    if (!cache) {
+        /* the shared lists will do */
+        aws_restore_error(last_error);
+        return NULL;
+    }
+
+    cache->pool = pool;
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        aws_atomic_init_int(&cache->counters[i], 0);
+    }
+    aws_atomic_init_int(&cache->unused_reservation, 0);
+    aws_atomic_fetch_add(&pool->internal_ref_count, 1);
+
+    aws_mutex_lock(&pool->lock);
+    aws_linked_list_push_back(&pool->thread_caches, &cache->node);
+    aws_mutex_unlock(&pool->lock);
+
+    cache->next = tl_thread_caches;
+    tl_thread_caches = cache;
+    return cache;
+}
+
+static struct byte_buf_pool_thread_cache *s_get_thread_cache(struct aws_byte_buf_pool *pool) {
+    for (struct byte_buf_pool_thread_cache *cache = tl_thread_caches; cache != NULL; cache = cache->next) {
+        if (cache->pool == pool) {
+            return cache;
+        }
+    }
+
+    if (pool->disable_thread_caches) {
+        return NULL;
+    }
+    return s_thread_cache_new(pool);
+}
+
+/* Moves a batch of buffers from the shared list into the cache's, so the next few acquires don't take the lock. */
+static void s_thread_cache_refill(
+    struct aws_byte_buf_pool *pool,
+    struct byte_buf_pool_thread_cache *cache,
+    size_t size_class) {
+
+    size_t batch = aws_max_size(pool->thread_cache_size / 2, 1);
+    aws_mutex_lock(&pool->lock);
+    uint8_t *buffer = NULL;
+    while (batch-- > 0 && (buffer = s_free_list_pop(&pool->free_lists[size_class])) != NULL) {
+        s_free_list_push(&cache->free_lists[size_class], buffer);
+    }
+    aws_mutex_unlock(&pool->lock);
+}
+
+/* Moves half the cache's buffers to the shared list, so the next few releases don't take the lock. */
+static void s_thread_cache_flush(
+    struct aws_byte_buf_pool *pool,
+    struct byte_buf_pool_thread_cache *cache,
+    size_t size_class) {
+
+    size_t batch = aws_max_size(cache->free_lists[size_class].count / 2, 1);
+    aws_mutex_lock(&pool->lock);
+    while (batch-- > 0) {
+        s_free_list_push(&pool->free_lists[size_class], s_free_list_pop(&cache->free_lists[size_class]));
+    }
+    aws_mutex_unlock(&pool->lock);
+}
+
+static void s_byte_buf_pool_close(void *arg) {
+    struct aws_byte_buf_pool *pool = arg;
+
+    /* Nobody can acquire or release buffers anymore, so the thread caches' buffers can go too. The caches themselves
+     * belong to their threads, which get rid of them when they exit or next look for a cache. */
+    aws_mutex_lock(&pool->lock);
+    aws_atomic_store_int(&pool->closed, 1);
+    for (size_t i = 0; i < pool->size_class_count; ++i) {
+        s_free_list_clean_up(pool, &pool->free_lists[i], s_size_class_capacity(pool, i));
+    }
+    for (struct aws_linked_list_node *node = aws_linked_list_begin(&pool->thread_caches);
+         node != aws_linked_list_end(&pool->thread_caches);
+         node = aws_linked_list_next(node)) {
+        struct byte_buf_pool_thread_cache *cache = AWS_CONTAINER_OF(node, struct byte_buf_pool_thread_cache, node);
+        for (size_t i = 0; i < pool->size_class_count; ++i) {
+            s_free_list_clean_up(pool, &cache->free_lists[i], s_size_class_capacity(pool, i));
+        }
+    }
+    aws_mutex_unlock(&pool->lock);
+
+    s_release_internal(pool);
+}
+
+struct aws_byte_buf_pool *aws_byte_buf_pool_new(
+    struct aws_allocator *allocator,
+    const struct aws_byte_buf_pool_options *options) {
+    AWS_PRECONDITION(allocator);
+
+    struct aws_byte_buf_pool_options default_options = {0};
+    if (!options) {
+        options = &default_options;
+    }
+
+    size_t min_buffer_size = options->min_buffer_size ? options->min_buffer_size
+                                                      : AWS_BYTE_BUF_POOL_DEFAULT_MIN_BUFFER_SIZE;
+    size_t max_buffer_size = options->max_buffer_size ? options->max_buffer_size
+                                                      : AWS_BYTE_BUF_POOL_DEFAULT_MAX_BUFFER_SIZE;
+    min_buffer_size = aws_max_size(min_buffer_size, MIN_SIZE_CLASS);
+    if (aws_round_up_to_power_of_two(min_buffer_size, &min_buffer_size) ||
+        aws_round_up_to_power_of_two(max_buffer_size, &max_buffer_size) || min_buffer_size > max_buffer_size) {
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    size_t min_size_shift = aws_ctz_u64(min_buffer_size);
+    size_t size_class_count = aws_ctz_u64(max_buffer_size) - min_size_shift + 1;
+
+    struct aws_byte_buf_pool *pool = aws_mem_calloc(
+        allocator, 1, sizeof(struct aws_byte_buf_pool) + size_class_count * sizeof(struct free_list));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->allocator = allocator;
+    if (aws_mutex_init(&pool->lock)) {
+        aws_mem_release(allocator, pool);
+        return NULL;
+    }
+    aws_ref_count_init(&pool->ref_count, pool, s_byte_buf_pool_close);
+    aws_atomic_init_int(&pool->internal_ref_count, 1);
+    aws_atomic_init_int(&pool->closed, 0);
+    aws_atomic_init_int(&pool->retained_bytes, 0);
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        aws_atomic_init_int(&pool->counters[i], 0);
+    }
+    aws_linked_list_init(&pool->thread_caches);
+
+    pool->min_size_shift = min_size_shift;
+    pool->size_class_count = size_class_count;
+    pool->reservation_size = max_buffer_size;
+    pool->max_retained_bytes = options->max_retained_bytes ? options->max_retained_bytes
+                                                           : AWS_BYTE_BUF_POOL_DEFAULT_MAX_RETAINED_BYTES;
+    pool->thread_cache_size = options->thread_cache_size ? options->thread_cache_size
+                                                         : AWS_BYTE_BUF_POOL_DEFAULT_THREAD_CACHE_SIZE;
+    pool->disable_thread_caches = options->disable_thread_caches;
+
+    return pool;
+}
+
+void aws_byte_buf_pool_acquire(struct aws_byte_buf_pool *pool) {
+    aws_ref_count_acquire(&pool->ref_count);
+}
+
+void aws_byte_buf_pool_release(struct aws_byte_buf_pool *pool) {
+    if (pool != NULL) {
+        aws_ref_count_release(&pool->ref_count);
+    }
+}
+
+int aws_byte_buf_pool_acquire_buf(struct aws_byte_buf_pool *pool, size_t min_capacity, struct aws_byte_buf *buf) {
+    AWS_PRECONDITION(pool);
+    AWS_PRECONDITION(buf);
+
+    AWS_ZERO_STRUCT(*buf);
+
+    size_t size_class = 0;
+    if (!s_size_class_for_request(pool, min_capacity, &size_class)) {
+        if (aws_byte_buf_init(buf, pool->allocator, min_capacity)) {
+            return AWS_OP_ERR;
+        }
+        s_count(pool, NULL, COUNTER_ACQUIRE);
+        return AWS_OP_SUCCESS;
+    }
+    size_t capacity = s_size_class_capacity(pool, size_class);
+
+    uint8_t *buffer = NULL;
+    struct byte_buf_pool_thread_cache *cache = s_get_thread_cache(pool);
+    if (cache) {
+        buffer = s_free_list_pop(&cache->free_lists[size_class]);
+        if (buffer) {
+            s_count(pool, cache, COUNTER_THREAD_CACHE_HIT);
+        } else {
+            s_thread_cache_refill(pool, cache, size_class);
+            buffer = s_free_list_pop(&cache->free_lists[size_class]);
+        }
+        if (buffer) {
+            s_thread_cache_unreserve(pool, cache, capacity);
+        }
+    } else {
+        aws_mutex_lock(&pool->lock);
+        buffer = s_free_list_pop(&pool->free_lists[size_class]);
+        aws_mutex_unlock(&pool->lock);
+        if (buffer) {
+            aws_atomic_fetch_sub_explicit(&pool->retained_bytes, capacity, aws_memory_order_relaxed);
+        }
+    }
+
+    if (buffer) {
+        s_count(pool, cache, COUNTER_HIT);
+    } else {
+        buffer = aws_mem_acquire(pool->allocator, capacity);
+        if (!buffer) {
+            return AWS_OP_ERR;
+        }
+    }
+    s_count(pool, cache, COUNTER_ACQUIRE);
+
+    buf->buffer = buffer;
+    buf->capacity = capacity;
+    buf->allocator = pool->allocator;
+    return AWS_OP_SUCCESS;
+}
+
+void aws_byte_buf_pool_release_buf(struct aws_byte_buf_pool *pool, struct aws_byte_buf *buf) {
+    AWS_PRECONDITION(pool);
+    AWS_PRECONDITION(aws_byte_buf_is_valid(buf));
+
+    if (buf->buffer == NULL) {
+        return;
+    }
+
+    size_t size_class = 0;
+    if (buf->allocator != pool->allocator || !s_size_class_for_capacity(pool, buf->capacity, &size_class)) {
+        goto discard;
+    }
+
+    struct byte_buf_pool_thread_cache *cache = s_get_thread_cache(pool);
+    if (cache) {
+        if (!s_thread_cache_reserve(pool, cache, buf->capacity)) {
+            goto discard;
+        }
+        if (cache->free_lists[size_class].count >= pool->thread_cache_size) {
+            s_thread_cache_flush(pool, cache, size_class);
+        }
+        s_free_list_push(&cache->free_lists[size_class], buf->buffer);
+    } else {
+        if (!s_reserve(pool, buf->capacity)) {
+            goto discard;
+        }
+        aws_mutex_lock(&pool->lock);
+        s_free_list_push(&pool->free_lists[size_class], buf->buffer);
+        aws_mutex_unlock(&pool->lock);
+    }
+
+    s_count(pool, cache, COUNTER_RELEASE);
+    AWS_ZERO_STRUCT(*buf);
+    return;
+
+discard:
+    s_count(pool, NULL, COUNTER_RELEASE);
+    s_count(pool, NULL, COUNTER_DISCARD);
+    aws_byte_buf_clean_up(buf);
+}
+
+void aws_byte_buf_pool_get_stats(struct aws_byte_buf_pool *pool, struct aws_byte_buf_pool_stats *stats) {
+    AWS_PRECONDITION(pool);
+    AWS_PRECONDITION(stats);
+
+    uint64_t counts[COUNTER_COUNT];
+    size_t unused_reservations = 0;
+    aws_mutex_lock(&pool->lock);
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        counts[i] = aws_atomic_load_int_explicit(&pool->counters[i], aws_memory_order_relaxed);
+    }
+    for (struct aws_linked_list_node *node = aws_linked_list_begin(&pool->thread_caches);
+         node != aws_linked_list_end(&pool->thread_caches);
+         node = aws_linked_list_next(node)) {
+        struct byte_buf_pool_thread_cache *cache = AWS_CONTAINER_OF(node, struct byte_buf_pool_thread_cache, node);
+        for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+            counts[i] += aws_atomic_load_int_explicit(&cache->counters[i], aws_memory_order_relaxed);
+        }
+        unused_reservations += aws_atomic_load_int_explicit(&cache->unused_reservation, aws_memory_order_relaxed);
+    }
+    size_t retained_bytes = aws_atomic_load_int_explicit(&pool->retained_bytes, aws_memory_order_relaxed);
+    aws_mutex_unlock(&pool->lock);
+
+    stats->acquire_count = counts[COUNTER_ACQUIRE];
+    stats->hit_count = counts[COUNTER_HIT];
+    stats->thread_cache_hit_count = counts[COUNTER_THREAD_CACHE_HIT];
+    stats->release_count = counts[COUNTER_RELEASE];
+    stats->discard_count = counts[COUNTER_DISCARD];
+    /* the caches' reservations can change while this runs, don't let that wrap around */
+    stats->retained_bytes = retained_bytes > unused_reservations ? retained_bytes - unused_reservations : 0;
+}
@@ -0,0 +1,295 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_chain.h>
+
+int aws_byte_chain_init(struct aws_byte_chain *chain, struct aws_allocator *allocator, size_t initial_segment_count) {
+    AWS_PRECONDITION(chain);
+    AWS_PRECONDITION(allocator);
+
+    AWS_ZERO_STRUCT(*chain);
+    if (aws_array_list_init_dynamic(
+            &chain->segments, allocator, initial_segment_count, sizeof(struct aws_byte_chain_segment))) {
+        return AWS_OP_ERR;
+    }
+
+    chain->allocator = allocator;
+    return AWS_OP_SUCCESS;
+}
+
+void aws_byte_chain_clean_up(struct aws_byte_chain *chain) {
+    AWS_PRECONDITION(chain);
+
+    size_t count = aws_array_list_length(&chain->segments);
+    for (size_t i = 0; i < count; ++i) {
+        struct aws_byte_chain_segment *segment = NULL;
+        aws_array_list_get_at_ptr(&chain->segments, (void **)&segment, i);
+        aws_byte_buf_clean_up(&segment->storage);
+    }
+
+    aws_array_list_clean_up(&chain->segments);
+    AWS_ZERO_STRUCT(*chain);
+}
+
+size_t aws_byte_chain_segment_count(const struct aws_byte_chain *chain) {
+    AWS_PRECONDITION(chain);
+    return aws_array_list_length(&chain->segments);
+}
+
+static int s_add_segment(struct aws_byte_chain *chain, const struct aws_byte_chain_segment *segment, bool at_front) {
+    int result = at_front ? aws_array_list_push_front(&chain->segments, segment)
+                          : aws_array_list_push_back(&chain->segments, segment);
+    if (result) {
+        return AWS_OP_ERR;
+    }
+
+    chain->len += segment->cursor.len;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_add_cursor(struct aws_byte_chain *chain, struct aws_byte_cursor cursor, bool at_front) {
+    AWS_PRECONDITION(chain);
+    AWS_PRECONDITION(aws_byte_cursor_is_valid(&cursor));
+
+    /* empty segments would only cost a slot in every writev() */
+    if (cursor.len == 0) {
+        return AWS_OP_SUCCESS;
+    }
+
+    struct aws_byte_chain_segment segment;
+    AWS_ZERO_STRUCT(segment);
+    segment.cursor = cursor;
+    return s_add_segment(chain, &segment, at_front);
+}
+
+static int s_add_buf(struct aws_byte_chain *chain, struct aws_byte_buf *buf, bool at_front) {
+    AWS_PRECONDITION(chain);
+    AWS_PRECONDITION(aws_byte_buf_is_valid(buf));
+
+    if (buf->len == 0) {
+        aws_byte_buf_clean_up(buf);
+        return AWS_OP_SUCCESS;
+    }
+
+    struct aws_byte_chain_segment segment = {
+        .cursor = aws_byte_cursor_from_buf(buf),
+        .storage = *buf,
+    };
+    if (s_add_segment(chain, &segment, at_front)) {
+        return AWS_OP_ERR;
+    }
+
+    AWS_ZERO_STRUCT(*buf);
+    return AWS_OP_SUCCESS;
+}
+
+int aws_byte_chain_append(struct aws_byte_chain *chain, struct aws_byte_cursor cursor) {
+    return s_add_cursor(chain, cursor, false);
+}
+
+int aws_byte_chain_prepend(struct aws_byte_chain *chain, struct aws_byte_cursor cursor) {
+    return s_add_cursor(chain, cursor, true);
+}
+
+int aws_byte_chain_append_buf(struct aws_byte_chain *chain, struct aws_byte_buf *buf) {
+    return s_add_buf(chain, buf, false);
+}
+
+int aws_byte_chain_prepend_buf(struct aws_byte_chain *chain, struct aws_byte_buf *buf) {
+    return s_add_buf(chain, buf, true);
+}
+
+int aws_byte_chain_consume(struct aws_byte_chain *chain, size_t len) {
+    AWS_PRECONDITION(chain);
+
+    if (len > chain->len) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    size_t remaining = len;
+    size_t used_up = 0;
+    struct aws_byte_chain_segment *segment = NULL;
+    while (remaining > 0) {
+        aws_array_list_get_at_ptr(&chain->segments, (void **)&segment, used_up);
+        if (remaining < segment->cursor.len) {
+            aws_byte_cursor_advance(&segment->cursor, remaining);
+            break;
+        }
+
+        remaining -= segment->cursor.len;
+        aws_byte_buf_clean_up(&segment->storage);
+        ++used_up;
+    }
+
+    aws_array_list_pop_front_n(&chain->segments, used_up);
+    chain->len -= len;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_byte_chain_slice(
+    const struct aws_byte_chain *chain,
+    size_t offset,
+    size_t len,
+    struct aws_byte_chain *out) {
+    AWS_PRECONDITION(chain);
+    AWS_PRECONDITION(out);
+    AWS_PRECONDITION(chain != out, "Slicing a chain into itself would grow it while reading it");
+
+    if (offset > chain->len || len > chain->len - offset) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    size_t original_count = aws_array_list_length(&out->segments);
+    size_t original_len = out->len;
+
+    struct aws_byte_chain_cursor cur = aws_byte_chain_cursor_from_chain(chain);
+    aws_byte_chain_cursor_advance(&cur, offset);
+
+    struct aws_byte_cursor piece;
+    size_t remaining = len;
+    while (remaining > 0 && aws_byte_chain_cursor_next(&cur, remaining, &piece)) {
+        if (aws_byte_chain_append(out, piece)) {
+            while (aws_array_list_length(&out->segments) > original_count) {
+                aws_array_list_pop_back(&out->segments);
+            }
+            out->len = original_len;
+            return AWS_OP_ERR;
+        }
+        remaining -= piece.len;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+size_t aws_byte_chain_get_segments(
+    const struct aws_byte_chain *chain,
+    struct aws_byte_cursor *segments,
+    size_t max_count) {
+    AWS_PRECONDITION(chain);
+    AWS_PRECONDITION(max_count == 0 || segments);
+
+    size_t count = aws_min_size(aws_array_list_length(&chain->segments), max_count);
+    for (size_t i = 0; i < count; ++i) {
+        struct aws_byte_chain_segment *segment = NULL;
+        aws_array_list_get_at_ptr(&chain->segments, (void **)&segment, i);
+        segments[i] = segment->cursor;
+    }
+
+    return count;
+}
+
+struct aws_byte_chain_cursor aws_byte_chain_cursor_from_chain(const struct aws_byte_chain *chain) {
+    AWS_PRECONDITION(chain);
+
+    struct aws_byte_chain_cursor cur = {
+        .chain = chain,
+        .segment_index = 0,
+        .segment_offset = 0,
+        .len = chain->len,
+    };
+    return cur;
+}
+
+bool aws_byte_chain_cursor_next(struct aws_byte_chain_cursor *cur, size_t max_len, struct aws_byte_cursor *out) {
+    AWS_PRECONDITION(cur);
+    AWS_PRECONDITION(out);
+
+    AWS_ZERO_STRUCT(*out);
+    if (cur->len == 0) {
+        return false;
+    }
+
+    /* segments are never empty, so this only skips the one the last read finished, if any */
+    struct aws_byte_chain_segment *segment = NULL;
+    aws_array_list_get_at_ptr(&cur->chain->segments, (void **)&segment, cur->segment_index);
+    if (cur->segment_offset == segment->cursor.len) {
+        ++cur->segment_index;
+        cur->segment_offset = 0;
+        aws_array_list_get_at_ptr(&cur->chain->segments, (void **)&segment, cur->segment_index);
+    }
+
+    size_t len = aws_min_size(aws_min_size(segment->cursor.len - cur->segment_offset, max_len), cur->len);
+    *out = aws_byte_cursor_from_array(segment->cursor.ptr + cur->segment_offset, len);
+    cur->segment_offset += len;
+    cur->len -= len;
+    return true;
+}
+
+bool aws_byte_chain_cursor_advance(struct aws_byte_chain_cursor *cur, size_t len) {
+    AWS_PRECONDITION(cur);
+
+    if (len > cur->len) {
+        return false;
+    }
+
+    struct aws_byte_cursor piece;
+    while (len > 0 && aws_byte_chain_cursor_next(cur, len, &piece)) {
+        len -= piece.len;
+    }
+    return true;
+}
+
+bool aws_byte_chain_cursor_read(struct aws_byte_chain_cursor *AWS_RESTRICT cur, void *AWS_RESTRICT dest, size_t len) {
+    AWS_PRECONDITION(cur);
+    AWS_PRECONDITION(AWS_MEM_IS_WRITABLE(dest, len));
+
+    if (len > cur->len) {
+        return false;
+    }
+
+    uint8_t *dest_bytes = dest;
+    struct aws_byte_cursor piece;
+    while (len > 0 && aws_byte_chain_cursor_next(cur, len, &piece)) {
+        memcpy(dest_bytes, piece.ptr, piece.len);
+        dest_bytes += piece.len;
+        len -= piece.len;
+    }
+    return true;
+}
+
+bool aws_byte_chain_cursor_read_u8(struct aws_byte_chain_cursor *AWS_RESTRICT cur, uint8_t *AWS_RESTRICT var) {
+    return aws_byte_chain_cursor_read(cur, var, 1);
+}
+
+bool aws_byte_chain_cursor_read_be16(struct aws_byte_chain_cursor *cur, uint16_t *var) {
+    AWS_PRECONDITION(AWS_OBJECT_PTR_IS_WRITABLE(var));
+
+    if (!aws_byte_chain_cursor_read(cur, var, 2)) {
+        return false;
+    }
+    *var = aws_ntoh16(*var);
+    return true;
+}
+
+bool aws_byte_chain_cursor_read_be24(struct aws_byte_chain_cursor *cur, uint32_t *var) {
+    AWS_PRECONDITION(AWS_OBJECT_PTR_IS_WRITABLE(var));
+
+    uint8_t bytes[3];
+    if (!aws_byte_chain_cursor_read(cur, bytes, sizeof(bytes))) {
+        return false;
+    }
+    *var = ((uint32_t)bytes[0] << 16) | ((uint32_t)bytes[1] << 8) | bytes[2];
+    return true;
+}
+
+bool aws_byte_chain_cursor_read_be32(struct aws_byte_chain_cursor *cur, uint32_t *var) {
+    AWS_PRECONDITION(AWS_OBJECT_PTR_IS_WRITABLE(var));
+
+    if (!aws_byte_chain_cursor_read(cur, var, 4)) {
+        return false;
+    }
+    *var = aws_ntoh32(*var);
+    return true;
+}
+
+bool aws_byte_chain_cursor_read_be64(struct aws_byte_chain_cursor *cur, uint64_t *var) {
+    AWS_PRECONDITION(AWS_OBJECT_PTR_IS_WRITABLE(var));
+
+    if (!aws_byte_chain_cursor_read(cur, var, 8)) {
+        return false;
+    }
+    *var = aws_ntoh64(*var);
+    return true;
+}
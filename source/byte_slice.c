@@ -0,0 +1,133 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_slice.h>
+
+#include <aws/common/ref_count.h>
+
+struct aws_shared_buffer {
+    struct aws_allocator *allocator;
+    struct aws_ref_count ref_count;
+    /* has no allocator of its own when the data was allocated along with this struct */
+    struct aws_byte_buf buf;
+};
+
+static void s_shared_buffer_destroy(void *object) {
+    struct aws_shared_buffer *buffer = object;
+    aws_byte_buf_clean_up(&buffer->buf);
+    aws_mem_release(buffer->allocator, buffer);
+}
+
+struct aws_shared_buffer *aws_shared_buffer_new(struct aws_allocator *allocator, size_t capacity) {
+    AWS_PRECONDITION(allocator);
+
+    size_t allocation_size = 0;
+    if (aws_add_size_checked(sizeof(struct aws_shared_buffer), capacity, &allocation_size)) {
+        return NULL;
+    }
+
+    struct aws_shared_buffer *buffer = aws_mem_acquire(allocator, allocation_size);
+    if (!buffer) {
+        return NULL;
+    }
+
+    buffer->allocator = allocator;
+    aws_ref_count_init(&buffer->ref_count, buffer, s_shared_buffer_destroy);
+    buffer->buf = aws_byte_buf_from_empty_array((uint8_t *)(buffer + 1), capacity);
+    return buffer;
+}
+
+struct aws_shared_buffer *aws_shared_buffer_new_from_buf(struct aws_allocator *allocator, struct aws_byte_buf *buf) {
+    AWS_PRECONDITION(allocator);
+    AWS_PRECONDITION(aws_byte_buf_is_valid(buf));
+
+    struct aws_shared_buffer *buffer = aws_mem_calloc(allocator, 1, sizeof(struct aws_shared_buffer));
+    if (!buffer) {
+        return NULL;
+    }
+
+    buffer->allocator = allocator;
+    aws_ref_count_init(&buffer->ref_count, buffer, s_shared_buffer_destroy);
+    buffer->buf = *buf;
+    AWS_ZERO_STRUCT(*buf);
+    return buffer;
+}
+
+struct aws_shared_buffer *aws_shared_buffer_acquire(struct aws_shared_buffer *buffer) {
+    aws_ref_count_acquire(&buffer->ref_count);
+    return buffer;
+}
+
+void aws_shared_buffer_release(struct aws_shared_buffer *buffer) {
+    if (buffer != NULL) {
+        aws_ref_count_release(&buffer->ref_count);
+    }
+}
+
+struct aws_byte_buf *aws_shared_buffer_get_buf(struct aws_shared_buffer *buffer) {
+    AWS_PRECONDITION(buffer);
+    return &buffer->buf;
+}
+
+int aws_byte_slice_init(struct aws_byte_slice *out, struct aws_shared_buffer *buffer, struct aws_byte_cursor range) {
+    AWS_PRECONDITION(out);
+    AWS_PRECONDITION(buffer);
+    AWS_PRECONDITION(aws_byte_cursor_is_valid(&range));
+
+    AWS_ZERO_STRUCT(*out);
+
+    /* compare as integers, pointers into different objects can't be compared portably */
+    uintptr_t start = (uintptr_t)buffer->buf.buffer;
+    uintptr_t range_start = (uintptr_t)range.ptr;
+    if (range_start < start || range_start - start > buffer->buf.len ||
+        range.len > buffer->buf.len - (range_start - start)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    out->owner = aws_shared_buffer_acquire(buffer);
+    out->cursor = range;
+    return AWS_OP_SUCCESS;
+}
+
+void aws_byte_slice_init_copy(struct aws_byte_slice *dest, const struct aws_byte_slice *src) {
+    AWS_PRECONDITION(dest);
+    AWS_PRECONDITION(src);
+
+    dest->owner = src->owner ? aws_shared_buffer_acquire(src->owner) : NULL;
+    dest->cursor = src->cursor;
+}
+
+void aws_byte_slice_clean_up(struct aws_byte_slice *slice) {
+    AWS_PRECONDITION(slice);
+
+    aws_shared_buffer_release(slice->owner);
+    AWS_ZERO_STRUCT(*slice);
+}
+
+int aws_byte_slice_compact(struct aws_byte_slice *slice, struct aws_allocator *allocator, size_t max_pinned_ratio) {
+    AWS_PRECONDITION(slice);
+    AWS_PRECONDITION(allocator);
+
+    if (slice->owner == NULL) {
+        return AWS_OP_SUCCESS;
+    }
+
+    /* what the slice keeps alive is the whole allocation, not just the bytes that were filled in */
+    size_t pinned = slice->owner->buf.capacity;
+    if (pinned <= aws_mul_size_saturating(slice->cursor.len, max_pinned_ratio)) {
+        return AWS_OP_SUCCESS;
+    }
+
+    struct aws_shared_buffer *compacted = aws_shared_buffer_new(allocator, slice->cursor.len);
+    if (!compacted) {
+        return AWS_OP_ERR;
+    }
+    aws_byte_buf_write_from_whole_cursor(&compacted->buf, slice->cursor);
+
+    aws_shared_buffer_release(slice->owner);
+    slice->owner = compacted;
+    slice->cursor = aws_byte_cursor_from_buf(&compacted->buf);
+    return AWS_OP_SUCCESS;
+}
@@ -34,8 +34,64 @@ size_t aws_cache_get_element_count(const struct aws_cache *cache) {
     return cache->vtable->get_element_count(cache);
 }
 
+static void s_cache_on_node_removed(struct aws_linked_hash_table_node *node) {
+    struct aws_cache *cache = AWS_CONTAINER_OF(node->table, struct aws_cache, table);
+    aws_linked_list_push_back(&cache->free_nodes, &node->node);
+}
+
+int aws_cache_base_init(
+    struct aws_cache *cache,
+    struct aws_allocator *allocator,
+    aws_hash_fn *hash_fn,
+    aws_hash_callback_eq_fn *equals_fn,
+    aws_hash_callback_destroy_fn *destroy_key_fn,
+    aws_hash_callback_destroy_fn *destroy_value_fn,
+    size_t max_items) {
+
+    cache->allocator = allocator;
+    cache->max_items = max_items;
+    aws_linked_list_init(&cache->free_nodes);
+
+    return aws_linked_hash_table_init_intrusive(
+        &cache->table,
+        allocator,
+        hash_fn,
+        equals_fn,
+        destroy_key_fn,
+        destroy_value_fn,
+        s_cache_on_node_removed,
+        max_items);
+}
+
+int aws_cache_base_put(struct aws_cache *cache, const void *key, void *p_value) {
+    struct aws_linked_hash_table_node *node = NULL;
+
+    if (!aws_linked_list_empty(&cache->free_nodes)) {
+        node = AWS_CONTAINER_OF(aws_linked_list_pop_back(&cache->free_nodes), struct aws_linked_hash_table_node, node);
+    } else {
+        node = aws_mem_calloc(cache->allocator, 1, sizeof(struct aws_linked_hash_table_node));
+        if (!node) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    if (aws_linked_hash_table_put_node(&cache->table, key, p_value, node)) {
+        aws_linked_list_push_back(&cache->free_nodes, &node->node);
+        return AWS_OP_ERR;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
 void aws_cache_base_default_destroy(struct aws_cache *cache) {
+    /* cleaning up the table hands every node back to the free list */
     aws_linked_hash_table_clean_up(&cache->table);
+
+    while (!aws_linked_list_empty(&cache->free_nodes)) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(&cache->free_nodes);
+        aws_mem_release(cache->allocator, AWS_CONTAINER_OF(node, struct aws_linked_hash_table_node, node));
+    }
+
     aws_mem_release(cache->allocator, cache);
 }
 
@@ -29,11 +29,9 @@ struct aws_cache *aws_cache_new_fifo(
     if (!fifo_cache) {
         return NULL;
     }
-    fifo_cache->allocator = allocator;
-    fifo_cache->max_items = max_items;
     fifo_cache->vtable = &s_fifo_cache_vtable;
-    if (aws_linked_hash_table_init(
-            &fifo_cache->table, allocator, hash_fn, equals_fn, destroy_key_fn, destroy_value_fn, max_items)) {
+    if (aws_cache_base_init(fifo_cache, allocator, hash_fn, equals_fn, destroy_key_fn, destroy_value_fn, max_items)) {
+        aws_mem_release(allocator, fifo_cache);
         return NULL;
     }
     return fifo_cache;
@@ -41,7 +39,7 @@ struct aws_cache *aws_cache_new_fifo(
 
 /* fifo cache put implementation */
 static int s_fifo_cache_put(struct aws_cache *cache, const void *key, void *p_value) {
-    if (aws_linked_hash_table_put(&cache->table, key, p_value)) {
+    if (aws_cache_base_put(cache, key, p_value)) {
         return AWS_OP_ERR;
     }
 
@@ -28,11 +28,9 @@ struct aws_cache *aws_cache_new_lifo(
     if (!lifo_cache) {
         return NULL;
     }
-    lifo_cache->allocator = allocator;
-    lifo_cache->max_items = max_items;
     lifo_cache->vtable = &s_lifo_cache_vtable;
-    if (aws_linked_hash_table_init(
-            &lifo_cache->table, allocator, hash_fn, equals_fn, destroy_key_fn, destroy_value_fn, max_items)) {
+    if (aws_cache_base_init(lifo_cache, allocator, hash_fn, equals_fn, destroy_key_fn, destroy_value_fn, max_items)) {
+        aws_mem_release(allocator, lifo_cache);
         return NULL;
     }
     return lifo_cache;
@@ -40,7 +38,7 @@ struct aws_cache *aws_cache_new_lifo(
 
 /* lifo cache put implementation */
 static int s_lifo_cache_put(struct aws_cache *cache, const void *key, void *p_value) {
-    if (aws_linked_hash_table_put(&cache->table, key, p_value)) {
+    if (aws_cache_base_put(cache, key, p_value)) {
         return AWS_OP_ERR;
     }
 
@@ -6,13 +6,20 @@
 
 static void s_element_destroy(void *value) {
     struct aws_linked_hash_table_node *node = value;
+    struct aws_linked_hash_table *table = node->table;
 
-    if (node->table->user_on_value_destroy) {
-        node->table->user_on_value_destroy(node->value);
+    aws_linked_list_remove(&node->node);
+
+    if (table->user_on_value_destroy) {
+        table->user_on_value_destroy(node->value);
     }
 
-    aws_linked_list_remove(&node->node);
-    aws_mem_release(node->table->allocator, node);
+    if (!table->is_intrusive) {
+        aws_mem_release(table->allocator, node);
+    } else if (table->user_on_node_removed) {
+        /* the node belongs to the caller, it may be freed from here on */
+        table->user_on_node_removed(node);
+    }
 }
 
 int aws_linked_hash_table_init(
@@ -31,12 +38,34 @@ int aws_linked_hash_table_init(
     table->allocator = allocator;
     table->user_on_value_destroy = destroy_value_fn;
     table->user_on_key_destroy = destroy_key_fn;
+    table->user_on_node_removed = NULL;
+    table->is_intrusive = false;
 
     aws_linked_list_init(&table->list);
     return aws_hash_table_init(
         &table->table, allocator, initial_item_count, hash_fn, equals_fn, destroy_key_fn, s_element_destroy);
 }
 
+int aws_linked_hash_table_init_intrusive(
+    struct aws_linked_hash_table *table,
+    struct aws_allocator *allocator,
+    aws_hash_fn *hash_fn,
+    aws_hash_callback_eq_fn *equals_fn,
+    aws_hash_callback_destroy_fn *destroy_key_fn,
+    aws_hash_callback_destroy_fn *destroy_value_fn,
+    aws_linked_hash_table_on_node_removed_fn *on_node_removed_fn,
+    size_t initial_item_count) {
+
+    if (aws_linked_hash_table_init(
+            table, allocator, hash_fn, equals_fn, destroy_key_fn, destroy_value_fn, initial_item_count)) {
+        return AWS_OP_ERR;
+    }
+
+    table->user_on_node_removed = on_node_removed_fn;
+    table->is_intrusive = true;
+    return AWS_OP_SUCCESS;
+}
+
 void aws_linked_hash_table_clean_up(struct aws_linked_hash_table *table) {
     /* clearing the table will remove all elements. That will also deallocate
      * any table entries we currently have. */
@@ -77,21 +106,17 @@ int aws_linked_hash_table_find_and_move_to_back(struct aws_linked_hash_table *ta
     return AWS_OP_SUCCESS;
 }
 
-int aws_linked_hash_table_put(struct aws_linked_hash_table *table, const void *key, void *p_value) {
-
-    struct aws_linked_hash_table_node *node =
-        aws_mem_calloc(table->allocator, 1, sizeof(struct aws_linked_hash_table_node));
-
-    if (!node) {
-        return AWS_OP_ERR;
-    }
+static int s_put_node(
+    struct aws_linked_hash_table *table,
+    const void *key,
+    void *p_value,
+    struct aws_linked_hash_table_node *node) {
 
     struct aws_hash_element *element = NULL;
     int was_added = 0;
     int err_val = aws_hash_table_create(&table->table, key, &element, &was_added);
 
     if (err_val) {
-        aws_mem_release(table->allocator, node);
         return err_val;
     }
 
@@ -131,6 +156,35 @@ int aws_linked_hash_table_put(struct aws_linked_hash_table *table, const void *k
     return AWS_OP_SUCCESS;
 }
 
+int aws_linked_hash_table_put(struct aws_linked_hash_table *table, const void *key, void *p_value) {
+    AWS_ERROR_PRECONDITION(!table->is_intrusive, AWS_ERROR_INVALID_STATE);
+
+    struct aws_linked_hash_table_node *node =
+        aws_mem_calloc(table->allocator, 1, sizeof(struct aws_linked_hash_table_node));
+
+    if (!node) {
+        return AWS_OP_ERR;
+    }
+
+    if (s_put_node(table, key, p_value, node)) {
+        aws_mem_release(table->allocator, node);
+        return AWS_OP_ERR;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_linked_hash_table_put_node(
+    struct aws_linked_hash_table *table,
+    const void *key,
+    void *p_value,
+    struct aws_linked_hash_table_node *node) {
+    AWS_ERROR_PRECONDITION(node);
+    AWS_ERROR_PRECONDITION(table->is_intrusive, AWS_ERROR_INVALID_STATE);
+
+    return s_put_node(table, key, p_value, node);
+}
+
 int aws_linked_hash_table_remove(struct aws_linked_hash_table *table, const void *key) {
     /* allocated table memory and the linked list entry will be removed in the
      * callback. */
@@ -0,0 +1,44 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#define _GNU_SOURCE /* NOLINT(bugprone-reserved-identifier) */
+
+#include <aws/common/private/futex.h>
+
+#include <aws/common/byte_order.h>
+#include <aws/common/clock.h>
+
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+/* The futex word is the low 32 bits of the atomic, wherever the byte order puts them. */
+static uint32_t *s_futex_word(struct aws_atomic_var *var) {
+    uint32_t *word = (uint32_t *)&var->value;
+    if (sizeof(var->value) > sizeof(uint32_t) && aws_is_big_endian()) {
+        word += sizeof(var->value) / sizeof(uint32_t) - 1;
+    }
+    return word;
+}
+
+void aws_futex_wait(struct aws_atomic_var *var, size_t expected_value, uint64_t timeout_ns) {
+    struct timespec timeout;
+    struct timespec *timeout_ptr = NULL;
+    if (timeout_ns != AWS_FUTEX_WAIT_FOREVER) {
+        uint64_t remainder = 0;
+        timeout.tv_sec = (time_t)aws_timestamp_convert(timeout_ns, AWS_TIMESTAMP_NANOS, AWS_TIMESTAMP_SECS, &remainder);
+        timeout.tv_nsec = (long)remainder;
+        timeout_ptr = &timeout;
+    }
+
+    /* EAGAIN (value already changed), EINTR and ETIMEDOUT all just mean "go look again" to the caller */
+    syscall(SYS_futex, s_futex_word(var), FUTEX_WAIT_PRIVATE, (uint32_t)expected_value, timeout_ptr, NULL, 0);
+}
+
+void aws_futex_wake_all(struct aws_atomic_var *var) {
+    syscall(SYS_futex, s_futex_word(var), FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
@@ -0,0 +1,91 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#define _GNU_SOURCE /* NOLINT(bugprone-reserved-identifier) */
+
+#include <aws/common/private/ring_buffer_mirror.h>
+
+#include <aws/common/logging.h>
+#include <aws/common/math.h>
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MFD_CLOEXEC
+#    define MFD_CLOEXEC 0x0001U
+#endif
+
+/* Goes through syscall() so this builds against C libraries that predate memfd_create(). */
+static int s_memfd_create(const char *name) {
+#ifdef SYS_memfd_create
+    return (int)syscall(SYS_memfd_create, name, MFD_CLOEXEC);
+#else
+    (void)name;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+uint8_t *aws_ring_buffer_mirror_map(size_t *size) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    size_t rounded_size = 0;
+    size_t reservation_size = 0;
+    if (page_size <= 0 || aws_add_size_checked(*size, (size_t)page_size - 1, &rounded_size)) {
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+    rounded_size -= rounded_size % (size_t)page_size;
+    if (aws_mul_size_checked(rounded_size, 2, &reservation_size)) {
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    int fd = s_memfd_create("aws_ring_buffer");
+    if (fd < 0) {
+        goto error;
+    }
+    if (ftruncate(fd, (off_t)rounded_size)) {
+        goto error;
+    }
+
+    /* reserve the whole range first, so nothing else can land in between the two halves */
+    uint8_t *reservation = mmap(NULL, reservation_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reservation == MAP_FAILED) {
+        goto error;
+    }
+
+    for (size_t half = 0; half < 2; ++half) {
+        void *mapped = mmap(
+            reservation + half * rounded_size,
+            rounded_size,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_FIXED,
+            fd,
+            0);
+        if (mapped == MAP_FAILED) {
+            munmap(reservation, reservation_size);
+            goto error;
+        }
+    }
+
+    /* the mappings keep the memory alive */
+    close(fd);
+    *size = rounded_size;
+    return reservation;
+
+error:
+    AWS_LOGF_DEBUG(AWS_LS_COMMON_GENERAL, "static: Failed to set up a mirrored ring buffer mapping, errno %d", errno);
+    if (fd >= 0) {
+        close(fd);
+    }
+    aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    return NULL;
+}
+
+void aws_ring_buffer_mirror_unmap(uint8_t *allocation, size_t size) {
+    munmap(allocation, 2 * size);
+}
@@ -0,0 +1,103 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/common/private/thread_scheduler_waiter.h>
+
+#include <aws/common/clock.h>
+#include <aws/common/logging.h>
+
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+struct aws_thread_scheduler_waiter {
+    struct aws_allocator *allocator;
+    int epoll_fd;
+    int wakeup_fd; /* eventfd */
+    int timer_fd;  /* CLOCK_MONOTONIC timerfd */
+};
+
+static int s_epoll_add(int epoll_fd, int fd) {
+    struct epoll_event event = {
+        .events = EPOLLIN,
+        .data = {.fd = fd},
+    };
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+}
+
+struct aws_thread_scheduler_waiter *aws_thread_scheduler_waiter_new(struct aws_allocator *allocator) {
+    struct aws_thread_scheduler_waiter *waiter =
+        aws_mem_calloc(allocator, 1, sizeof(struct aws_thread_scheduler_waiter));
+    if (!waiter) {
+        return NULL;
+    }
+
+    waiter->allocator = allocator;
+    waiter->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    waiter->wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    waiter->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+
+    if (waiter->epoll_fd < 0 || waiter->wakeup_fd < 0 || waiter->timer_fd < 0 ||
+        s_epoll_add(waiter->epoll_fd, waiter->wakeup_fd) || s_epoll_add(waiter->epoll_fd, waiter->timer_fd)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_COMMON_TASK_SCHEDULER,
+            "id=%p: Failed to set up epoll based thread scheduler wakeups, errno %d",
+            (void *)waiter,
+            errno);
+        aws_thread_scheduler_waiter_destroy(waiter);
+        aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+        return NULL;
+    }
+
+    return waiter;
+}
+
+void aws_thread_scheduler_waiter_destroy(struct aws_thread_scheduler_waiter *waiter) {
+    if (!waiter) {
+        return;
+    }
+
+    int fds[] = {waiter->timer_fd, waiter->wakeup_fd, waiter->epoll_fd};
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(fds); ++i) {
+        if (fds[i] >= 0) {
+            close(fds[i]);
+        }
+    }
+    aws_mem_release(waiter->allocator, waiter);
+}
+
+void aws_thread_scheduler_waiter_wake(struct aws_thread_scheduler_waiter *waiter) {
+    uint64_t one = 1;
+    /* EAGAIN means the counter is about to overflow, i.e. a wakeup is already pending */
+    ssize_t written = 0;
+    do {
+        written = write(waiter->wakeup_fd, &one, sizeof(one));
+    } while (written < 0 && errno == EINTR);
+}
+
+void aws_thread_scheduler_waiter_wait(struct aws_thread_scheduler_waiter *waiter, uint64_t timeout_ns) {
+    /* a zeroed it_value would disarm the timer rather than fire it right away */
+    timeout_ns = aws_max_u64(timeout_ns, 1);
+    struct itimerspec timer_spec = {
+        .it_value =
+            {
+                .tv_sec = (time_t)(timeout_ns / AWS_TIMESTAMP_NANOS),
+                .tv_nsec = (long)(timeout_ns % AWS_TIMESTAMP_NANOS),
+            },
+    };
+    AWS_FATAL_ASSERT(!timerfd_settime(waiter->timer_fd, 0, &timer_spec, NULL) && "timerfd_settime failed!");
+
+    struct epoll_event events[2];
+    int event_count = epoll_wait(waiter->epoll_fd, events, AWS_ARRAY_SIZE(events), -1);
+
+    /* Both fds are non-blocking: reading resets the eventfd counter and the timerfd expiration count, whichever of the
+     * two actually fired. */
+    for (int i = 0; i < event_count; ++i) {
+        uint64_t count = 0;
+        ssize_t bytes_read = read(events[i].data.fd, &count, sizeof(count));
+        (void)bytes_read;
+    }
+}
@@ -40,12 +40,10 @@ struct aws_cache *aws_cache_new_lru(
     }
     impl->use_lru_element = s_lru_cache_use_lru_element;
     impl->get_mru_element = s_lru_cache_get_mru_element;
-    lru_cache->allocator = allocator;
-    lru_cache->max_items = max_items;
     lru_cache->vtable = &s_lru_cache_vtable;
     lru_cache->impl = impl;
-    if (aws_linked_hash_table_init(
-            &lru_cache->table, allocator, hash_fn, equals_fn, destroy_key_fn, destroy_value_fn, max_items)) {
+    if (aws_cache_base_init(lru_cache, allocator, hash_fn, equals_fn, destroy_key_fn, destroy_value_fn, max_items)) {
+        aws_mem_release(allocator, lru_cache);
         return NULL;
     }
     return lru_cache;
@@ -54,7 +52,7 @@ struct aws_cache *aws_cache_new_lru(
 /* implementation for lru cache put */
 static int s_lru_cache_put(struct aws_cache *cache, const void *key, void *p_value) {
 
-    if (aws_linked_hash_table_put(&cache->table, key, p_value)) {
+    if (aws_cache_base_put(cache, key, p_value)) {
         return AWS_OP_ERR;
     }
 
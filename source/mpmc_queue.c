@@ -0,0 +1,263 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/mpmc_queue.h>
+
+#include <aws/common/atomics.h>
+#include <aws/common/clock.h>
+#include <aws/common/math.h>
+#include <aws/common/private/futex.h>
+
+/*
+ * Dmitry Vyukov's bounded MPMC queue. Every slot carries a sequence number saying whose turn it is: a slot at
+ * position `pos` can be pushed to once its sequence is `pos`, and popped from once its sequence is `pos + 1`. Pushers
+ * claim positions by advancing tail with a CAS, poppers by advancing head, and nobody ever waits on anyone else's
+ * CAS. Batches check that a run of consecutive slots is ready and claim all of it with a single CAS.
+ *
+ * Blocking waits use an eventcount per side: a waiter reads the epoch, raises the sleeping flag, tries once more and
+ * sleeps on the epoch with aws_futex_wait(). After making progress, the other side only bumps the epoch and makes the
+ * wake syscall if it is the one to lower the flag. Sleeping on tail or head themselves wouldn't work, since they move
+ * when a slot is claimed, before the item in it is published.
+ */
+struct mpmc_slot {
+    struct aws_atomic_var sequence;
+    void *item;
+};
+
+struct aws_mpmc_queue {
+    struct aws_allocator *allocator;
+    struct mpmc_slot *slots;
+    size_t mask;
+
+    /* tail is written by pushers and head by poppers, keep them on separate cache lines, each next to the eventcount
+     * of the side waiting on it. */
+    uint8_t tail_padding[AWS_CACHE_LINE];
+    struct aws_atomic_var tail;
+    struct aws_atomic_var pop_epoch;
+    struct aws_atomic_var pop_sleeping;
+    uint8_t head_padding[AWS_CACHE_LINE - 3 * sizeof(struct aws_atomic_var)];
+    struct aws_atomic_var head;
+    struct aws_atomic_var push_epoch;
+    struct aws_atomic_var push_sleeping;
+    uint8_t end_padding[AWS_CACHE_LINE - 3 * sizeof(struct aws_atomic_var)];
+};
+
+struct aws_mpmc_queue *aws_mpmc_queue_new(struct aws_allocator *allocator, size_t capacity) {
+    AWS_PRECONDITION(allocator);
+
+    size_t slot_count = 0;
+    if (aws_round_up_to_power_of_two(aws_max_size(capacity, 2), &slot_count)) {
+        return NULL;
+    }
+
+    struct aws_mpmc_queue *queue = NULL;
+    struct mpmc_slot *slots = NULL;
+    if (!aws_mem_acquire_many(
+            allocator,
+            2,
+            &queue,
+            sizeof(struct aws_mpmc_queue),
+            &slots,
+            slot_count * sizeof(struct mpmc_slot))) {
+        return NULL;
+    }
+
+    AWS_ZERO_STRUCT(*queue);
+    queue->allocator = allocator;
+    queue->slots = slots;
+    queue->mask = slot_count - 1;
+    for (size_t i = 0; i < slot_count; ++i) {
+        aws_atomic_init_int(&slots[i].sequence, i);
+        slots[i].item = NULL;
+    }
+    aws_atomic_init_int(&queue->tail, 0);
+    aws_atomic_init_int(&queue->head, 0);
+    aws_atomic_init_int(&queue->pop_epoch, 0);
+    aws_atomic_init_int(&queue->pop_sleeping, 0);
+    aws_atomic_init_int(&queue->push_epoch, 0);
+    aws_atomic_init_int(&queue->push_sleeping, 0);
+
+    return queue;
+}
+
+void aws_mpmc_queue_destroy(struct aws_mpmc_queue *queue) {
+    if (!queue) {
+        return;
+    }
+    aws_mem_release(queue->allocator, queue);
+}
+
+size_t aws_mpmc_queue_get_capacity(const struct aws_mpmc_queue *queue) {
+    AWS_PRECONDITION(queue);
+    return queue->mask + 1;
+}
+
+/*
+ * Claims up to max consecutive positions from `position`, counting a slot as ready when its sequence is its position
+ * plus sequence_offset. Returns how many were claimed, starting at *first.
+ */
+static size_t s_claim(
+    struct aws_mpmc_queue *queue,
+    struct aws_atomic_var *position,
+    size_t sequence_offset,
+    size_t max,
+    size_t *first) {
+
+    size_t pos = aws_atomic_load_int_explicit(position, aws_memory_order_relaxed);
+    for (;;) {
+        size_t ready = 0;
+        bool stale = false;
+        while (ready < max) {
+            struct mpmc_slot *slot = &queue->slots[(pos + ready) & queue->mask];
+            size_t sequence = aws_atomic_load_int_explicit(&slot->sequence, aws_memory_order_acquire);
+            ptrdiff_t diff = (ptrdiff_t)(sequence - (pos + ready + sequence_offset));
+            if (diff != 0) {
+                /* ahead of us means someone else already claimed this position */
+                stale = diff > 0;
+                break;
+            }
+            ++ready;
+        }
+
+        if (ready == 0) {
+            if (!stale) {
+                return 0;
+            }
+            pos = aws_atomic_load_int_explicit(position, aws_memory_order_relaxed);
+            continue;
+        }
+
+        /* on failure, pos is reloaded with the current value */
+        if (aws_atomic_compare_exchange_int_explicit(
+                position, &pos, pos + ready, aws_memory_order_relaxed, aws_memory_order_relaxed)) {
+            *first = pos;
+            return ready;
+        }
+    }
+}
+
+/* Called after publishing progress that the other side might be sleeping on. */
+static void s_wake_sleepers(struct aws_atomic_var *sleeping, struct aws_atomic_var *epoch) {
+    aws_atomic_thread_fence(aws_memory_order_seq_cst);
+    if (aws_atomic_load_int_explicit(sleeping, aws_memory_order_relaxed) && aws_atomic_exchange_int(sleeping, 0)) {
+        aws_atomic_fetch_add(epoch, 1);
+        aws_futex_wake_all(epoch);
+    }
+}
+
+size_t aws_mpmc_queue_try_push_batch(struct aws_mpmc_queue *queue, void *const *items, size_t count) {
+    AWS_PRECONDITION(queue);
+    AWS_PRECONDITION(items || count == 0);
+
+    size_t first = 0;
+    size_t claimed = s_claim(queue, &queue->tail, 0, count, &first);
+    for (size_t i = 0; i < claimed; ++i) {
+        struct mpmc_slot *slot = &queue->slots[(first + i) & queue->mask];
+        slot->item = items[i];
+        aws_atomic_store_int_explicit(&slot->sequence, first + i + 1, aws_memory_order_release);
+    }
+
+    if (claimed) {
+        s_wake_sleepers(&queue->pop_sleeping, &queue->pop_epoch);
+    }
+    return claimed;
+}
+
+size_t aws_mpmc_queue_try_pop_batch(struct aws_mpmc_queue *queue, void **items, size_t count) {
+    AWS_PRECONDITION(queue);
+    AWS_PRECONDITION(items || count == 0);
+
+    size_t first = 0;
+    size_t claimed = s_claim(queue, &queue->head, 1, count, &first);
+    for (size_t i = 0; i < claimed; ++i) {
+        struct mpmc_slot *slot = &queue->slots[(first + i) & queue->mask];
+        items[i] = slot->item;
+        /* the slot's next turn is a push, one lap later */
+        aws_atomic_store_int_explicit(&slot->sequence, first + i + queue->mask + 1, aws_memory_order_release);
+    }
+
+    if (claimed) {
+        s_wake_sleepers(&queue->push_sleeping, &queue->push_epoch);
+    }
+    return claimed;
+}
+
+bool aws_mpmc_queue_try_push(struct aws_mpmc_queue *queue, void *item) {
+    return aws_mpmc_queue_try_push_batch(queue, &item, 1) == 1;
+}
+
+bool aws_mpmc_queue_try_pop(struct aws_mpmc_queue *queue, void **item) {
+    return aws_mpmc_queue_try_pop_batch(queue, item, 1) == 1;
+}
+
+/*
+ * Pushes (or pops) until `count` items are done, or for a pop, until any are, sleeping on the eventcount in between.
+ * Any waker that lowers the flag after the epoch was read bumps the epoch, so the futex wait returns right away.
+ * Otherwise the flag is still up when the next waker looks, and that waker published its progress before looking.
+ */
+static size_t s_batch_wait(struct aws_mpmc_queue *queue, bool push, void **items, size_t count, uint64_t timeout_ns) {
+    size_t done = push ? aws_mpmc_queue_try_push_batch(queue, items, count)
+                       : aws_mpmc_queue_try_pop_batch(queue, items, count);
+    if (done == count || (!push && done > 0)) {
+        return done;
+    }
+
+    uint64_t deadline = UINT64_MAX;
+    if (timeout_ns != AWS_MPMC_QUEUE_WAIT_FOREVER) {
+        uint64_t now = 0;
+        aws_high_res_clock_get_ticks(&now);
+        deadline = aws_add_u64_saturating(now, timeout_ns);
+    }
+
+    struct aws_atomic_var *epoch = push ? &queue->push_epoch : &queue->pop_epoch;
+    struct aws_atomic_var *sleeping = push ? &queue->push_sleeping : &queue->pop_sleeping;
+
+    for (;;) {
+        size_t observed = aws_atomic_load_int(epoch);
+        aws_atomic_store_int(sleeping, 1);
+        aws_atomic_thread_fence(aws_memory_order_seq_cst);
+        done += push ? aws_mpmc_queue_try_push_batch(queue, items + done, count - done)
+                     : aws_mpmc_queue_try_pop_batch(queue, items + done, count - done);
+        if (done == count || (!push && done > 0)) {
+            break;
+        }
+
+        uint64_t time_left = AWS_FUTEX_WAIT_FOREVER;
+        if (deadline != UINT64_MAX) {
+            uint64_t now = 0;
+            aws_high_res_clock_get_ticks(&now);
+            if (now >= deadline) {
+                break;
+            }
+            time_left = deadline - now;
+        }
+        aws_futex_wait(epoch, observed, time_left);
+    }
+
+    return done;
+}
+
+size_t aws_mpmc_queue_push_batch_wait(
+    struct aws_mpmc_queue *queue,
+    void *const *items,
+    size_t count,
+    uint64_t timeout_ns) {
+    AWS_PRECONDITION(queue);
+    /* pushes only ever read from items */
+    return s_batch_wait(queue, true, (void **)items, count, timeout_ns);
+}
+
+size_t aws_mpmc_queue_pop_batch_wait(struct aws_mpmc_queue *queue, void **items, size_t count, uint64_t timeout_ns) {
+    AWS_PRECONDITION(queue);
+    return s_batch_wait(queue, false, items, count, timeout_ns);
+}
+
+bool aws_mpmc_queue_push_wait(struct aws_mpmc_queue *queue, void *item, uint64_t timeout_ns) {
+    return aws_mpmc_queue_push_batch_wait(queue, &item, 1, timeout_ns) == 1;
+}
+
+bool aws_mpmc_queue_pop_wait(struct aws_mpmc_queue *queue, void **item, uint64_t timeout_ns) {
+    return aws_mpmc_queue_pop_batch_wait(queue, item, 1, timeout_ns) == 1;
+}
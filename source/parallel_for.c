@@ -0,0 +1,237 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/common/parallel_for.h>
+
+#include <aws/common/atomics.h>
+#include <aws/common/condition_variable.h>
+#include <aws/common/math.h>
+#include <aws/common/mutex.h>
+#include <aws/common/ref_count.h>
+#include <aws/common/task_scheduler.h>
+#include <aws/common/thread_pool.h>
+
+/* How many chunks each participating thread should get on average, so that faster threads can make up for slower ones
+ * without every chunk paying for the hand-off. */
+enum { CHUNKS_PER_THREAD = 4 };
+
+/*
+ * One aws_parallel_for() call. Heap allocated and ref counted, since helper tasks submitted to the pool may only get
+ * to run after the caller has returned (e.g. when every worker is busy and the caller did all the work itself). Those
+ * late helpers find no chunks left and just drop their reference.
+ */
+struct parallel_for_job {
+    struct aws_allocator *allocator;
+    struct aws_ref_count ref_count;
+
+    aws_parallel_for_fn *fn;
+    void *user_data;
+    size_t begin;
+    size_t end;
+    size_t chunk_size;
+    size_t chunk_count;
+
+    struct aws_atomic_var next_chunk;
+    struct aws_atomic_var completed_chunks;
+
+    struct aws_mutex mutex;
+    struct aws_condition_variable c_var;
+
+    /* helper_count tasks follow the struct in the same allocation */
+    size_t helper_count;
+};
+
+static size_t s_chunk_size(const struct aws_thread_pool *pool, size_t count, size_t grain) {
+    size_t thread_count = pool ? aws_thread_pool_get_worker_count(pool) + 1 : 1;
+    size_t target_chunk_count = aws_mul_size_saturating(thread_count, CHUNKS_PER_THREAD);
+    size_t chunk_size = count / target_chunk_count + (count % target_chunk_count != 0);
+    return aws_max_size(chunk_size, aws_max_size(grain, 1));
+}
+
+static void s_job_destroy(void *arg) {
+    struct parallel_for_job *job = arg;
+    aws_condition_variable_clean_up(&job->c_var);
+    aws_mutex_clean_up(&job->mutex);
+    aws_mem_release(job->allocator, job);
+}
+
+static void s_run_chunks(struct parallel_for_job *job) {
+    while (true) {
+        size_t chunk = aws_atomic_fetch_add(&job->next_chunk, 1);
+        if (chunk >= job->chunk_count) {
+            return;
+        }
+
+        size_t chunk_begin = job->begin + chunk * job->chunk_size;
+        size_t chunk_end = aws_min_size(job->end, chunk_begin + job->chunk_size);
+        job->fn(chunk_begin, chunk_end, job->user_data);
+
+        if (aws_atomic_fetch_add(&job->completed_chunks, 1) + 1 == job->chunk_count) {
+            AWS_FATAL_ASSERT(!aws_mutex_lock(&job->mutex) && "mutex lock failed!");
+            aws_condition_variable_notify_all(&job->c_var);
+            AWS_FATAL_ASSERT(!aws_mutex_unlock(&job->mutex) && "mutex unlock failed!");
+        }
+    }
+}
+
+static void s_helper_task_fn(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    struct parallel_for_job *job = arg;
+
+    /* a canceled helper leaves its share to the others, the caller always finishes whatever is left */
+    if (status == AWS_TASK_STATUS_RUN_READY) {
+        s_run_chunks(job);
+    }
+
+    aws_ref_count_release(&job->ref_count);
+}
+
+static bool s_job_done_pred(void *arg) {
+    struct parallel_for_job *job = arg;
+    return aws_atomic_load_int(&job->completed_chunks) == job->chunk_count;
+}
+
+void aws_parallel_for(
+    struct aws_allocator *allocator,
+    struct aws_thread_pool *pool,
+    size_t begin,
+    size_t end,
+    size_t grain,
+    aws_parallel_for_fn *fn,
+    void *user_data) {
+    AWS_PRECONDITION(allocator);
+    AWS_PRECONDITION(begin <= end);
+    AWS_PRECONDITION(fn);
+
+    if (begin == end) {
+        return;
+    }
+
+    size_t count = end - begin;
+    size_t chunk_size = s_chunk_size(pool, count, grain);
+    if (!pool || chunk_size >= count) {
+        fn(begin, end, user_data);
+        return;
+    }
+
+    size_t chunk_count = count / chunk_size + (count % chunk_size != 0);
+    size_t helper_count = aws_min_size(aws_thread_pool_get_worker_count(pool), chunk_count - 1);
+
+    struct parallel_for_job *job =
+        aws_mem_calloc(allocator, 1, sizeof(struct parallel_for_job) + helper_count * sizeof(struct aws_task));
+    if (!job) {
+        /* still correct, just not parallel */
+        fn(begin, end, user_data);
+        return;
+    }
+
+    job->allocator = allocator;
+    job->fn = fn;
+    job->user_data = user_data;
+    job->begin = begin;
+    job->end = end;
+    job->chunk_size = chunk_size;
+    job->chunk_count = chunk_count;
+    job->helper_count = helper_count;
+    aws_atomic_init_int(&job->next_chunk, 0);
+    aws_atomic_init_int(&job->completed_chunks, 0);
+    AWS_FATAL_ASSERT(!aws_mutex_init(&job->mutex) && "mutex init failed!");
+    AWS_FATAL_ASSERT(!aws_condition_variable_init(&job->c_var) && "condition variable init failed!");
+
+    /* one reference for the caller, one for each helper */
+    aws_ref_count_init(&job->ref_count, job, s_job_destroy);
+    struct aws_task *helpers = (struct aws_task *)(job + 1);
+    for (size_t i = 0; i < helper_count; ++i) {
+        aws_ref_count_acquire(&job->ref_count);
+        aws_task_init(&helpers[i], s_helper_task_fn, job, "parallel_for_helper");
+        aws_thread_pool_submit(pool, &helpers[i]);
+    }
+
+    s_run_chunks(job);
+
+    AWS_FATAL_ASSERT(!aws_mutex_lock(&job->mutex) && "mutex lock failed!");
+    aws_condition_variable_wait_pred(&job->c_var, &job->mutex, s_job_done_pred, job);
+    AWS_FATAL_ASSERT(!aws_mutex_unlock(&job->mutex) && "mutex unlock failed!");
+
+    aws_ref_count_release(&job->ref_count);
+}
+
+struct parallel_reduce_context {
+    size_t begin;
+    size_t end;
+    size_t chunk_size;
+    size_t result_size;
+    const void *identity;
+    uint8_t *partial_results;
+    aws_parallel_reduce_fn *reduce_fn;
+    void *user_data;
+};
+
+/* Reduces chunks [first_chunk, last_chunk) into their own partial results. */
+static void s_reduce_chunks(size_t first_chunk, size_t last_chunk, void *user_data) {
+    struct parallel_reduce_context *context = user_data;
+    for (size_t chunk = first_chunk; chunk < last_chunk; ++chunk) {
+        void *partial_result = context->partial_results + chunk * context->result_size;
+        memcpy(partial_result, context->identity, context->result_size);
+
+        size_t chunk_begin = context->begin + chunk * context->chunk_size;
+        size_t chunk_end = aws_min_size(context->end, chunk_begin + context->chunk_size);
+        context->reduce_fn(chunk_begin, chunk_end, partial_result, context->user_data);
+    }
+}
+
+int aws_parallel_reduce(
+    struct aws_allocator *allocator,
+    struct aws_thread_pool *pool,
+    size_t begin,
+    size_t end,
+    size_t grain,
+    size_t result_size,
+    const void *identity,
+    void *result,
+    aws_parallel_reduce_fn *reduce_fn,
+    aws_parallel_combine_fn *combine_fn,
+    void *user_data) {
+    AWS_PRECONDITION(allocator);
+    AWS_PRECONDITION(begin <= end);
+    AWS_PRECONDITION(result_size > 0 && identity && result);
+    AWS_PRECONDITION(reduce_fn && combine_fn);
+
+    if (begin == end) {
+        return AWS_OP_SUCCESS;
+    }
+
+    size_t count = end - begin;
+    size_t chunk_size = s_chunk_size(pool, count, grain);
+    size_t chunk_count = count / chunk_size + (count % chunk_size != 0);
+
+    size_t partials_size = 0;
+    if (aws_mul_size_checked(chunk_count, result_size, &partials_size)) {
+        return AWS_OP_ERR;
+    }
+
+    struct parallel_reduce_context context = {
+        .begin = begin,
+        .end = end,
+        .chunk_size = chunk_size,
+        .result_size = result_size,
+        .identity = identity,
+        .partial_results = aws_mem_acquire(allocator, partials_size),
+        .reduce_fn = reduce_fn,
+        .user_data = user_data,
+    };
+    if (!context.partial_results) {
+        return AWS_OP_ERR;
+    }
+
+    /* every chunk is already worth a thread on its own, so hand them out one at a time */
+    aws_parallel_for(allocator, pool, 0, chunk_count, 1, s_reduce_chunks, &context);
+
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        combine_fn(result, context.partial_results + chunk * result_size, user_data);
+    }
+
+    aws_mem_release(allocator, context.partial_results);
+    return AWS_OP_SUCCESS;
+}
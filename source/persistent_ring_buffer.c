@@ -0,0 +1,463 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/persistent_ring_buffer.h>
+
+#include <aws/common/clock.h>
+#include <aws/common/hash_table.h>
+#include <aws/common/logging.h>
+#include <aws/common/math.h>
+#include <aws/common/private/mapped_file.h>
+#include <aws/common/string.h>
+
+#include <inttypes.h>
+
+/*
+ * File layout: a 4096 byte header region holding two copies of the header, one per 512 byte sector so a torn write
+ * can't reach both, followed by the record storage.
+ *
+ * head and tail are positions in an endless stream of bytes; the byte at position p lives at p % capacity in the
+ * record storage. Each header write goes to the copy the previous one didn't, with a higher sequence number, and the
+ * valid copy with the highest sequence number wins when the file is opened.
+ *
+ * Records are a record_header followed by the payload, padded to a multiple of 8. A record that doesn't fit before the
+ * end of the storage moves to the start of the next lap, and the gap it leaves is marked with a record header whose
+ * size is WRAP_MARKER (when the gap is too small to even hold that, readers skip it without one).
+ */
+
+#define HEADER_REGION_SIZE 4096
+#define HEADER_SLOT_SIZE 512
+#define CAPACITY_GRANULARITY 4096
+#define RECORD_ALIGNMENT 8
+#define WRAP_MARKER UINT32_MAX
+
+/* "AWSPRB01" */
+static const uint64_t s_magic = 0x4157535052423031ULL;
+static const uint32_t s_version = 1;
+
+struct persistent_header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t capacity;
+    uint64_t sequence;
+    uint64_t head;
+    uint64_t tail;
+    /* of every field above */
+    uint64_t checksum;
+};
+AWS_STATIC_ASSERT(sizeof(struct persistent_header) <= HEADER_SLOT_SIZE);
+
+struct record_header {
+    uint32_t size;
+    uint32_t reserved;
+    /* of the payload, its size, and its position */
+    uint64_t checksum;
+};
+
+struct aws_persistent_ring_buffer {
+    struct aws_allocator *allocator;
+    struct aws_mapped_file file;
+    uint8_t *storage;
+    uint64_t capacity;
+
+    uint64_t head;
+    uint64_t tail;
+    uint64_t sequence;
+    size_t record_count;
+    /* tail as of the last header that was synced. Until a newer header is synced, recovery may start reading there */
+    uint64_t synced_tail;
+
+    enum aws_persistent_ring_buffer_sync_policy sync_policy;
+    uint64_t sync_interval_ns;
+    uint64_t last_sync_ns;
+};
+
+static uint64_t s_checksum(const void *data, size_t size) {
+    struct aws_byte_cursor cursor = aws_byte_cursor_from_array(data, size);
+    return aws_hash_byte_cursor_ptr(&cursor);
+}
+
+static uint64_t s_record_checksum(uint64_t position, uint32_t size, const uint8_t *payload) {
+    uint64_t fields[3] = {position, size, payload ? s_checksum(payload, size) : 0};
+    return s_checksum(fields, sizeof(fields));
+}
+
+static uint64_t s_header_checksum(const struct persistent_header *header) {
+    return s_checksum(header, offsetof(struct persistent_header, checksum));
+}
+
+static uint64_t s_record_footprint(uint64_t size) {
+    return sizeof(struct record_header) + ((size + RECORD_ALIGNMENT - 1) & ~(uint64_t)(RECORD_ALIGNMENT - 1));
+}
+
+static uint64_t s_space_before_wrap(const struct aws_persistent_ring_buffer *buffer, uint64_t position) {
+    return buffer->capacity - position % buffer->capacity;
+}
+
+static struct record_header *s_record_header_at(const struct aws_persistent_ring_buffer *buffer, uint64_t position) {
+    return (struct record_header *)(buffer->storage + position % buffer->capacity);
+}
+
+/* Moves *position past the end-of-lap gap, if it is at one. Returns false if the gap's marker is corrupt, which only
+ * matters during recovery. */
+static bool s_skip_wrap(const struct aws_persistent_ring_buffer *buffer, uint64_t *position) {
+    uint64_t space = s_space_before_wrap(buffer, *position);
+    if (space < sizeof(struct record_header)) {
+        *position += space;
+        return true;
+    }
+
+    struct record_header header;
+    memcpy(&header, s_record_header_at(buffer, *position), sizeof(header));
+    if (header.size != WRAP_MARKER) {
+        return true;
+    }
+    if (header.checksum != s_record_checksum(*position, WRAP_MARKER, NULL)) {
+        return false;
+    }
+
+    *position += space;
+    return true;
+}
+
+static void s_write_header(struct aws_persistent_ring_buffer *buffer) {
+    struct persistent_header header = {
+        .magic = s_magic,
+        .version = s_version,
+        .capacity = buffer->capacity,
+        .sequence = ++buffer->sequence,
+        .head = buffer->head,
+        .tail = buffer->tail,
+    };
+    header.checksum = s_header_checksum(&header);
+
+    memcpy(buffer->file.data + (buffer->sequence % 2) * HEADER_SLOT_SIZE, &header, sizeof(header));
+}
+
+static int s_sync_header(struct aws_persistent_ring_buffer *buffer) {
+    if (aws_mapped_file_sync(&buffer->file, 0, HEADER_REGION_SIZE)) {
+        return AWS_OP_ERR;
+    }
+
+    /* every change writes the header right away, so the newest one always has the current tail */
+    buffer->synced_tail = buffer->tail;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_sync_all(struct aws_persistent_ring_buffer *buffer) {
+    /* records first, so the header never points at records that aren't on disk yet */
+    if (aws_mapped_file_sync(&buffer->file, HEADER_REGION_SIZE, (size_t)buffer->capacity) || s_sync_header(buffer)) {
+        return AWS_OP_ERR;
+    }
+
+    aws_high_res_clock_get_ticks(&buffer->last_sync_ns);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_sync_periodically(struct aws_persistent_ring_buffer *buffer) {
+    if (buffer->sync_policy != AWS_PERSISTENT_RING_BUFFER_SYNC_PERIODIC) {
+        return AWS_OP_SUCCESS;
+    }
+
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    if (now - buffer->last_sync_ns < buffer->sync_interval_ns) {
+        return AWS_OP_SUCCESS;
+    }
+
+    return s_sync_all(buffer);
+}
+
+/* Syncs the storage between two positions, which are less than a lap apart. */
+static int s_sync_range(struct aws_persistent_ring_buffer *buffer, uint64_t begin, uint64_t end) {
+    uint64_t space = s_space_before_wrap(buffer, begin);
+    size_t offset = (size_t)(begin % buffer->capacity);
+    if (end - begin <= space) {
+        return aws_mapped_file_sync(&buffer->file, HEADER_REGION_SIZE + offset, (size_t)(end - begin));
+    }
+
+    if (aws_mapped_file_sync(&buffer->file, HEADER_REGION_SIZE + offset, (size_t)space)) {
+        return AWS_OP_ERR;
+    }
+    return aws_mapped_file_sync(&buffer->file, HEADER_REGION_SIZE, (size_t)(end - begin - space));
+}
+
+/* Picks the newest valid copy of the header, or returns false if neither is valid. */
+static bool s_read_header(const struct aws_mapped_file *file, struct persistent_header *out_header) {
+    bool found = false;
+    for (size_t slot = 0; slot < 2; ++slot) {
+        struct persistent_header header;
+        memcpy(&header, file->data + slot * HEADER_SLOT_SIZE, sizeof(header));
+
+        if (header.magic != s_magic || header.version != s_version || header.checksum != s_header_checksum(&header)) {
+            continue;
+        }
+        if (header.capacity == 0 || header.capacity % CAPACITY_GRANULARITY != 0 ||
+            header.capacity > SIZE_MAX - HEADER_REGION_SIZE || header.tail > header.head ||
+            header.head - header.tail > header.capacity) {
+            continue;
+        }
+
+        if (!found || header.sequence > out_header->sequence) {
+            *out_header = header;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+/* Walks the records from tail to head, and cuts head short at the first one that doesn't check out. */
+static void s_recover_records(struct aws_persistent_ring_buffer *buffer) {
+    uint64_t position = buffer->tail;
+    size_t record_count = 0;
+
+    while (position < buffer->head) {
+        if (!s_skip_wrap(buffer, &position) || position >= buffer->head) {
+            break;
+        }
+
+        struct record_header header;
+        memcpy(&header, s_record_header_at(buffer, position), sizeof(header));
+        if (header.size == WRAP_MARKER) {
+            break;
+        }
+        uint64_t footprint = s_record_footprint(header.size);
+        if (footprint > s_space_before_wrap(buffer, position) || footprint > buffer->head - position) {
+            break;
+        }
+        const uint8_t *payload = (const uint8_t *)s_record_header_at(buffer, position) + sizeof(header);
+        if (header.checksum != s_record_checksum(position, header.size, payload)) {
+            break;
+        }
+
+        position += footprint;
+        ++record_count;
+    }
+
+    if (position < buffer->head) {
+        AWS_LOGF_WARN(
+            AWS_LS_COMMON_IO,
+            "id=%p: Persistent ring buffer is damaged at position %" PRIu64 ", dropping the last %" PRIu64
+            " bytes of records",
+            (void *)buffer,
+            position,
+            buffer->head - position);
+        buffer->head = position;
+    }
+    buffer->record_count = record_count;
+}
+
+static int s_open(struct aws_persistent_ring_buffer *buffer, const struct aws_persistent_ring_buffer_options *options) {
+    struct aws_string *path = aws_string_new_from_cursor(buffer->allocator, &options->path);
+    if (!path) {
+        return AWS_OP_ERR;
+    }
+    uint64_t file_size = 0;
+    int result = aws_mapped_file_open(&buffer->file, path, &file_size);
+    aws_string_destroy(path);
+    if (result) {
+        return AWS_OP_ERR;
+    }
+
+    /* look at the header first, to learn how much storage follows it */
+    if (aws_mapped_file_map(&buffer->file, HEADER_REGION_SIZE)) {
+        goto error;
+    }
+
+    struct persistent_header header;
+    AWS_ZERO_STRUCT(header);
+    bool recovered = s_read_header(&buffer->file, &header);
+    if (recovered) {
+        buffer->capacity = header.capacity;
+        buffer->head = header.head;
+        buffer->tail = header.tail;
+        buffer->sequence = header.sequence;
+        buffer->synced_tail = header.tail;
+    } else {
+        if (file_size > 0) {
+            AWS_LOGF_WARN(
+                AWS_LS_COMMON_IO,
+                "id=%p: Persistent ring buffer file has no valid header, starting over empty",
+                (void *)buffer);
+        }
+        if (options->capacity == 0 || options->capacity > SIZE_MAX - HEADER_REGION_SIZE - CAPACITY_GRANULARITY) {
+            aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            goto error;
+        }
+        buffer->capacity = (options->capacity + CAPACITY_GRANULARITY - 1) & ~(uint64_t)(CAPACITY_GRANULARITY - 1);
+    }
+
+    /* a truncated file grows back with zeroes here, which no record checksum will match */
+    if (aws_mapped_file_map(&buffer->file, HEADER_REGION_SIZE + (size_t)buffer->capacity)) {
+        goto error;
+    }
+    buffer->storage = buffer->file.data + HEADER_REGION_SIZE;
+
+    if (recovered) {
+        s_recover_records(buffer);
+    }
+    s_write_header(buffer);
+    if (buffer->sync_policy != AWS_PERSISTENT_RING_BUFFER_SYNC_NEVER && s_sync_all(buffer)) {
+        goto error;
+    }
+
+    return AWS_OP_SUCCESS;
+
+error:
+    aws_mapped_file_close(&buffer->file);
+    return AWS_OP_ERR;
+}
+
+struct aws_persistent_ring_buffer *aws_persistent_ring_buffer_new(
+    struct aws_allocator *allocator,
+    const struct aws_persistent_ring_buffer_options *options) {
+    AWS_PRECONDITION(allocator);
+    AWS_PRECONDITION(options);
+
+    if (options->path.len == 0) {
+        aws_raise_error(AWS_ERROR_FILE_INVALID_PATH);
+        return NULL;
+    }
+
+    struct aws_persistent_ring_buffer *buffer = aws_mem_calloc(allocator, 1, sizeof(struct aws_persistent_ring_buffer));
+    buffer->allocator = allocator;
+    buffer->sync_policy = options->sync_policy;
+    buffer->sync_interval_ns =
+        options->sync_interval_ns ? options->sync_interval_ns : AWS_PERSISTENT_RING_BUFFER_DEFAULT_SYNC_INTERVAL_NS;
+    aws_high_res_clock_get_ticks(&buffer->last_sync_ns);
+
+    if (s_open(buffer, options)) {
+        aws_mem_release(allocator, buffer);
+        return NULL;
+    }
+
+    return buffer;
+}
+
+void aws_persistent_ring_buffer_destroy(struct aws_persistent_ring_buffer *buffer) {
+    if (!buffer) {
+        return;
+    }
+
+    if (buffer->sync_policy != AWS_PERSISTENT_RING_BUFFER_SYNC_NEVER && s_sync_all(buffer)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_COMMON_IO,
+            "id=%p: Failed to sync persistent ring buffer on destroy, error %d(%s)",
+            (void *)buffer,
+            aws_last_error(),
+            aws_error_name(aws_last_error()));
+    }
+
+    aws_mapped_file_close(&buffer->file);
+    aws_mem_release(buffer->allocator, buffer);
+}
+
+size_t aws_persistent_ring_buffer_get_capacity(const struct aws_persistent_ring_buffer *buffer) {
+    return (size_t)buffer->capacity;
+}
+
+size_t aws_persistent_ring_buffer_get_record_count(const struct aws_persistent_ring_buffer *buffer) {
+    return buffer->record_count;
+}
+
+int aws_persistent_ring_buffer_push(struct aws_persistent_ring_buffer *buffer, struct aws_byte_cursor record) {
+    AWS_PRECONDITION(aws_byte_cursor_is_valid(&record));
+
+    if (record.len >= WRAP_MARKER || record.len > buffer->capacity ||
+        s_record_footprint(record.len) > buffer->capacity) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    uint64_t footprint = s_record_footprint(record.len);
+    uint64_t space = s_space_before_wrap(buffer, buffer->head);
+    uint64_t gap = footprint > space ? space : 0;
+    if (buffer->head - buffer->tail + gap + footprint > buffer->capacity) {
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+
+    uint64_t begin = buffer->head;
+    if (buffer->sync_policy == AWS_PERSISTENT_RING_BUFFER_SYNC_PER_COMMIT &&
+        begin + gap + footprint > buffer->synced_tail + buffer->capacity) {
+        /* Consumes aren't synced, so the header on disk may still count the bytes about to be overwritten as records.
+         * If the power went out after syncing the new record but before its header, recovery would find garbage right
+         * at the tail and drop every record after it. Move the tail on disk past them first. */
+        s_write_header(buffer);
+        if (s_sync_header(buffer)) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    if (gap >= sizeof(struct record_header)) {
+        struct record_header marker = {
+            .size = WRAP_MARKER,
+            .checksum = s_record_checksum(buffer->head, WRAP_MARKER, NULL),
+        };
+        memcpy(s_record_header_at(buffer, buffer->head), &marker, sizeof(marker));
+    }
+    buffer->head += gap;
+
+    struct record_header header = {
+        .size = (uint32_t)record.len,
+        .checksum = s_record_checksum(buffer->head, (uint32_t)record.len, record.ptr),
+    };
+    uint8_t *dest = (uint8_t *)s_record_header_at(buffer, buffer->head);
+    memcpy(dest, &header, sizeof(header));
+    if (record.len > 0) {
+        memcpy(dest + sizeof(header), record.ptr, record.len);
+    }
+    buffer->head += footprint;
+    ++buffer->record_count;
+
+    if (buffer->sync_policy == AWS_PERSISTENT_RING_BUFFER_SYNC_PER_COMMIT) {
+        /* the record has to be on disk before the header that points at it */
+        if (s_sync_range(buffer, begin, buffer->head)) {
+            s_write_header(buffer);
+            return AWS_OP_ERR;
+        }
+        s_write_header(buffer);
+        return s_sync_header(buffer);
+    }
+
+    s_write_header(buffer);
+    return s_sync_periodically(buffer);
+}
+
+bool aws_persistent_ring_buffer_peek(const struct aws_persistent_ring_buffer *buffer, struct aws_byte_cursor *record) {
+    AWS_PRECONDITION(record);
+
+    if (buffer->record_count == 0) {
+        return false;
+    }
+
+    uint64_t position = buffer->tail;
+    s_skip_wrap(buffer, &position);
+    const uint8_t *header = (const uint8_t *)s_record_header_at(buffer, position);
+    uint32_t size = 0;
+    memcpy(&size, header + offsetof(struct record_header, size), sizeof(size));
+
+    *record = aws_byte_cursor_from_array(header + sizeof(struct record_header), size);
+    return true;
+}
+
+int aws_persistent_ring_buffer_consume(struct aws_persistent_ring_buffer *buffer) {
+    if (buffer->record_count == 0) {
+        return aws_raise_error(AWS_ERROR_LIST_EMPTY);
+    }
+
+    s_skip_wrap(buffer, &buffer->tail);
+    uint32_t size = 0;
+    memcpy(&size, (const uint8_t *)s_record_header_at(buffer, buffer->tail), sizeof(size));
+    buffer->tail += s_record_footprint(size);
+    --buffer->record_count;
+
+    s_write_header(buffer);
+    return s_sync_periodically(buffer);
+}
+
+int aws_persistent_ring_buffer_sync(struct aws_persistent_ring_buffer *buffer) {
+    return s_sync_all(buffer);
+}
@@ -0,0 +1,22 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/common/private/futex.h>
+
+#include <aws/common/math.h>
+#include <aws/common/thread.h>
+
+/* Waiters poll at this interval, since nothing wakes them up. */
+#define FUTEX_FALLBACK_POLL_NS (100 * 1000)
+
+void aws_futex_wait(struct aws_atomic_var *var, size_t expected_value, uint64_t timeout_ns) {
+    if (aws_atomic_load_int(var) != expected_value) {
+        return;
+    }
+    aws_thread_current_sleep(aws_min_u64(timeout_ns, FUTEX_FALLBACK_POLL_NS));
+}
+
+void aws_futex_wake_all(struct aws_atomic_var *var) {
+    (void)var;
+}
@@ -0,0 +1,16 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/common/private/ring_buffer_mirror.h>
+
+uint8_t *aws_ring_buffer_mirror_map(size_t *size) {
+    (void)size;
+    aws_raise_error(AWS_ERROR_PLATFORM_NOT_SUPPORTED);
+    return NULL;
+}
+
+void aws_ring_buffer_mirror_unmap(uint8_t *allocation, size_t size) {
+    (void)allocation;
+    (void)size;
+}
@@ -0,0 +1,24 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/common/private/thread_scheduler_waiter.h>
+
+struct aws_thread_scheduler_waiter *aws_thread_scheduler_waiter_new(struct aws_allocator *allocator) {
+    (void)allocator;
+    aws_raise_error(AWS_ERROR_PLATFORM_NOT_SUPPORTED);
+    return NULL;
+}
+
+void aws_thread_scheduler_waiter_destroy(struct aws_thread_scheduler_waiter *waiter) {
+    (void)waiter;
+}
+
+void aws_thread_scheduler_waiter_wake(struct aws_thread_scheduler_waiter *waiter) {
+    (void)waiter;
+}
+
+void aws_thread_scheduler_waiter_wait(struct aws_thread_scheduler_waiter *waiter, uint64_t timeout_ns) {
+    (void)waiter;
+    (void)timeout_ns;
+}
@@ -0,0 +1,97 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/private/mapped_file.h>
+
+#include <aws/common/logging.h>
+#include <aws/common/string.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static int s_fd(const struct aws_mapped_file *file) {
+    return (int)(intptr_t)file->handle;
+}
+
+int aws_mapped_file_open(struct aws_mapped_file *file, const struct aws_string *path, uint64_t *out_size) {
+    AWS_ZERO_STRUCT(*file);
+
+    int fd = open(aws_string_c_str(path), O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        int errno_cpy = errno; /* Always cache errno before potential side-effect */
+        aws_translate_and_raise_io_error_or(errno_cpy, AWS_ERROR_FILE_OPEN_FAILURE);
+        AWS_LOGF_ERROR(
+            AWS_LS_COMMON_IO,
+            "static: Failed to open file for mapping. path:'%s' errno:%d aws-error:%d(%s)",
+            aws_string_c_str(path),
+            errno_cpy,
+            aws_last_error(),
+            aws_error_name(aws_last_error()));
+        return AWS_OP_ERR;
+    }
+
+    struct stat file_info;
+    if (fstat(fd, &file_info)) {
+        int errno_cpy = errno;
+        close(fd);
+        return aws_translate_and_raise_io_error(errno_cpy);
+    }
+
+    file->handle = (void *)(intptr_t)fd;
+    *out_size = (uint64_t)file_info.st_size;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_mapped_file_map(struct aws_mapped_file *file, size_t size) {
+    AWS_PRECONDITION(size > 0);
+
+    if (file->data) {
+        munmap(file->data, file->size);
+        file->data = NULL;
+        file->size = 0;
+    }
+
+    struct stat file_info;
+    if (fstat(s_fd(file), &file_info)) {
+        return aws_translate_and_raise_io_error(errno);
+    }
+    if ((uint64_t)file_info.st_size < size && ftruncate(s_fd(file), (off_t)size)) {
+        return aws_translate_and_raise_io_error(errno);
+    }
+
+    void *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, s_fd(file), 0);
+    if (data == MAP_FAILED) {
+        AWS_LOGF_ERROR(AWS_LS_COMMON_IO, "static: Failed to map %zu bytes of file, errno %d", size, errno);
+        return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    }
+
+    file->data = data;
+    file->size = size;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_mapped_file_sync(struct aws_mapped_file *file, size_t offset, size_t length) {
+    AWS_PRECONDITION(offset + length <= file->size);
+
+    /* msync() wants a page aligned address, and the mapping itself is page aligned */
+    long page_size = sysconf(_SC_PAGESIZE);
+    size_t misalignment = page_size > 0 ? offset % (size_t)page_size : 0;
+    if (msync(file->data + offset - misalignment, length + misalignment, MS_SYNC)) {
+        return aws_translate_and_raise_io_error(errno);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_mapped_file_close(struct aws_mapped_file *file) {
+    if (file->data) {
+        munmap(file->data, file->size);
+    }
+    close(s_fd(file));
+    AWS_ZERO_STRUCT(*file);
+}
@@ -7,9 +7,12 @@
 
 #include <string.h>
 
-#define PARENT_OF(index) (((index)&1) ? (index) >> 1 : (index) > 1 ? ((index)-2) >> 1 : 0)
-#define LEFT_OF(index) (((index) << 1) + 1)
-#define RIGHT_OF(index) (((index) << 1) + 2)
+#define PARENT_OF(index, arity) (((index)-1) / (arity))
+#define FIRST_CHILD_OF(index, arity) ((index) * (arity) + 1)
+
+static size_t s_arity(const struct aws_priority_queue *queue) {
+    return queue->arity ? queue->arity : 2;
+}
 
 static void s_swap(struct aws_priority_queue *queue, size_t a, size_t b) {
     AWS_PRECONDITION(aws_priority_queue_is_valid(queue));
@@ -54,29 +57,24 @@ static bool s_sift_down(struct aws_priority_queue *queue, size_t root) {
     bool did_move = false;
 
     size_t len = aws_array_list_length(&queue->container);
+    size_t arity = s_arity(queue);
 
-    while (LEFT_OF(root) < len) {
-        size_t left = LEFT_OF(root);
-        size_t right = RIGHT_OF(root);
+    while (FIRST_CHILD_OF(root, arity) < len) {
+        size_t child = FIRST_CHILD_OF(root, arity);
+        size_t last_child = aws_min_size(child + arity, len);
         size_t first = root;
         void *first_item = NULL;
         void *other_item = NULL;
 
         aws_array_list_get_at_ptr(&queue->container, &first_item, root);
-        aws_array_list_get_at_ptr(&queue->container, &other_item, left);
 
-        if (queue->pred(first_item, other_item) > 0) {
-            first = left;
-            first_item = other_item;
-        }
+        /* choose the largest/smallest of the root and its children in case of a max/min heap respectively. The
+         * children are contiguous, so this scan stays within a cache line or two for small items. */
+        for (; child < last_child; ++child) {
+            aws_array_list_get_at_ptr(&queue->container, &other_item, child);
 
-        if (right < len) {
-            aws_array_list_get_at_ptr(&queue->container, &other_item, right);
-
-            /* choose the larger/smaller of the two in case of a max/min heap
-             * respectively */
             if (queue->pred(first_item, other_item) > 0) {
-                first = right;
+                first = child;
                 first_item = other_item;
             }
         }
@@ -101,9 +99,10 @@ static bool s_sift_up(struct aws_priority_queue *queue, size_t index) {
 
     bool did_move = false;
 
+    size_t arity = s_arity(queue);
     void *parent_item = NULL;
     void *child_item = NULL;
-    size_t parent = PARENT_OF(index);
+    size_t parent = index ? PARENT_OF(index, arity) : 0;
     while (index) {
         /*
          * These get_ats are guaranteed to be successful; if they are not, we have
@@ -119,7 +118,7 @@ static bool s_sift_up(struct aws_priority_queue *queue, size_t index) {
             s_swap(queue, index, parent);
             did_move = true;
             index = parent;
-            parent = PARENT_OF(index);
+            parent = index ? PARENT_OF(index, arity) : 0;
         } else {
             break;
         }
@@ -156,6 +155,7 @@ int aws_priority_queue_init_dynamic(
     AWS_FATAL_PRECONDITION(item_size > 0);
 
     queue->pred = pred;
+    queue->arity = 0;
     AWS_ZERO_STRUCT(queue->backpointers);
 
     int ret = aws_array_list_init_dynamic(&queue->container, alloc, default_size, item_size);
@@ -168,6 +168,25 @@ int aws_priority_queue_init_dynamic(
     return ret;
 }
 
+int aws_priority_queue_init_dynamic_with_arity(
+    struct aws_priority_queue *queue,
+    struct aws_allocator *alloc,
+    size_t default_size,
+    size_t item_size,
+    aws_priority_queue_compare_fn *pred,
+    size_t arity) {
+
+    AWS_ERROR_PRECONDITION(arity >= 2 && arity <= AWS_PRIORITY_QUEUE_MAX_ARITY);
+
+    if (aws_priority_queue_init_dynamic(queue, alloc, default_size, item_size, pred)) {
+        return AWS_OP_ERR;
+    }
+
+    queue->arity = arity;
+    AWS_POSTCONDITION(aws_priority_queue_is_valid(queue));
+    return AWS_OP_SUCCESS;
+}
+
 void aws_priority_queue_init_static(
     struct aws_priority_queue *queue,
     void *heap,
@@ -181,6 +200,7 @@ void aws_priority_queue_init_static(
     AWS_FATAL_PRECONDITION(item_size > 0);
 
     queue->pred = pred;
+    queue->arity = 0;
     AWS_ZERO_STRUCT(queue->backpointers);
 
     aws_array_list_init_static(&queue->container, heap, item_count, item_size);
@@ -251,10 +271,11 @@ bool aws_priority_queue_is_valid(const struct aws_priority_queue *const queue) {
         return false;
     }
     bool pred_is_valid = (queue->pred != NULL);
+    bool arity_is_valid = queue->arity == 0 || (queue->arity >= 2 && queue->arity <= AWS_PRIORITY_QUEUE_MAX_ARITY);
     bool container_is_valid = aws_array_list_is_valid(&queue->container);
 
     bool backpointers_valid = aws_priority_queue_backpointers_valid(queue);
-    return pred_is_valid && container_is_valid && backpointers_valid;
+    return pred_is_valid && arity_is_valid && container_is_valid && backpointers_valid;
 }
 
 void aws_priority_queue_clean_up(struct aws_priority_queue *queue) {
@@ -328,6 +349,95 @@ backpointer_update_failed:
     return AWS_OP_ERR;
 }
 
+static int s_push_many(
+    struct aws_priority_queue *queue,
+    const void *items,
+    struct aws_priority_queue_node *const *backpointers,
+    size_t count) {
+    AWS_PRECONDITION(aws_priority_queue_is_valid(queue));
+    AWS_PRECONDITION(items && AWS_MEM_IS_READABLE(items, count * queue->container.item_size));
+
+    if (count == 0) {
+        return AWS_OP_SUCCESS;
+    }
+
+    size_t old_length = aws_array_list_length(&queue->container);
+    size_t new_length = 0;
+    if (aws_add_size_checked(old_length, count, &new_length)) {
+        return AWS_OP_ERR;
+    }
+
+    /* Reserve all the room we need up front, so that nothing below can fail halfway through the batch */
+    if (aws_array_list_ensure_capacity(&queue->container, new_length - 1)) {
+        if (aws_last_error() == AWS_ERROR_INVALID_INDEX && !queue->container.alloc) {
+            return aws_raise_error(AWS_ERROR_LIST_EXCEEDS_MAX_SIZE);
+        }
+        return AWS_OP_ERR;
+    }
+
+    if (backpointers && !queue->backpointers.alloc) {
+        if (!queue->container.alloc) {
+            return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+        }
+
+        if (aws_array_list_init_dynamic(
+                &queue->backpointers, queue->container.alloc, new_length, sizeof(struct aws_priority_queue_node *))) {
+            return AWS_OP_ERR;
+        }
+
+        /* When we initialize the backpointers array we need to zero out all existing entries */
+        memset(queue->backpointers.data, 0, queue->backpointers.current_size);
+        queue->backpointers.length = old_length;
+    }
+
+    if (!AWS_IS_ZEROED(queue->backpointers)) {
+        if (aws_array_list_ensure_capacity(&queue->backpointers, new_length - 1)) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    const uint8_t *item = items;
+    for (size_t i = 0; i < count; ++i, item += queue->container.item_size) {
+        size_t index = old_length + i;
+        aws_array_list_push_back(&queue->container, item);
+
+        if (!AWS_IS_ZEROED(queue->backpointers)) {
+            struct aws_priority_queue_node *backpointer = backpointers ? backpointers[i] : NULL;
+            aws_array_list_push_back(&queue->backpointers, &backpointer);
+            if (backpointer) {
+                backpointer->current_index = index;
+            }
+        }
+    }
+
+    if (count <= old_length) {
+        for (size_t index = old_length; index < new_length; ++index) {
+            s_sift_up(queue, index);
+        }
+    } else if (new_length > 1) {
+        /* The batch dominates, so rebuilding the whole heap bottom-up (O(n)) beats sifting each new item up */
+        size_t parent = PARENT_OF(new_length - 1, s_arity(queue));
+        do {
+            s_sift_down(queue, parent);
+        } while (parent-- > 0);
+    }
+
+    AWS_POSTCONDITION(aws_priority_queue_is_valid(queue));
+    return AWS_OP_SUCCESS;
+}
+
+int aws_priority_queue_push_many(struct aws_priority_queue *queue, const void *items, size_t count) {
+    return s_push_many(queue, items, NULL, count);
+}
+
+int aws_priority_queue_push_many_ref(
+    struct aws_priority_queue *queue,
+    const void *items,
+    struct aws_priority_queue_node *const *backpointers,
+    size_t count) {
+    return s_push_many(queue, items, backpointers, count);
+}
+
 static int s_remove_node(struct aws_priority_queue *queue, void *item, size_t item_index) {
     AWS_PRECONDITION(aws_priority_queue_is_valid(queue));
     AWS_PRECONDITION(item && AWS_MEM_IS_WRITABLE(item, queue->container.item_size));
@@ -378,6 +488,19 @@ int aws_priority_queue_remove(
     return rval;
 }
 
+int aws_priority_queue_update(struct aws_priority_queue *queue, const struct aws_priority_queue_node *node) {
+    AWS_PRECONDITION(aws_priority_queue_is_valid(queue));
+    AWS_PRECONDITION(node && AWS_MEM_IS_READABLE(node, sizeof(struct aws_priority_queue_node)));
+    AWS_ERROR_PRECONDITION(
+        node->current_index < aws_array_list_length(&queue->container), AWS_ERROR_PRIORITY_QUEUE_BAD_NODE);
+    AWS_ERROR_PRECONDITION(queue->backpointers.data, AWS_ERROR_PRIORITY_QUEUE_BAD_NODE);
+
+    s_sift_either(queue, node->current_index);
+
+    AWS_POSTCONDITION(aws_priority_queue_is_valid(queue));
+    return AWS_OP_SUCCESS;
+}
+
 int aws_priority_queue_pop(struct aws_priority_queue *queue, void *item) {
     AWS_PRECONDITION(aws_priority_queue_is_valid(queue));
     AWS_PRECONDITION(item && AWS_MEM_IS_WRITABLE(item, queue->container.item_size));
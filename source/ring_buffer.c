@@ -6,6 +6,7 @@
 #include <aws/common/ring_buffer.h>
 
 #include <aws/common/byte_buf.h>
+#include <aws/common/private/ring_buffer_mirror.h>
 
 #ifdef CBMC
 #    define AWS_ATOMIC_LOAD_PTR(ring_buf, dest_ptr, atomic_ptr, memory_order)                                          \
@@ -29,6 +30,11 @@
     AWS_ATOMIC_LOAD_PTR(ring_buf, dest_ptr, &(ring_buf)->head, aws_memory_order_relaxed);
 #define AWS_ATOMIC_STORE_HEAD_PTR(ring_buf, src_ptr)                                                                   \
     AWS_ATOMIC_STORE_PTR(ring_buf, &(ring_buf)->head, src_ptr, aws_memory_order_relaxed);
+#define AWS_ATOMIC_LOAD_WRAP_END_PTR(ring_buf, dest_ptr)                                                               \
+    AWS_ATOMIC_LOAD_PTR(ring_buf, dest_ptr, &(ring_buf)->wrap_end, aws_memory_order_relaxed);
+/* Remembers where the data stops when acquire goes back to the start, see aws_ring_buffer_get_acquired_regions(). */
+#define AWS_ATOMIC_STORE_WRAP_END_PTR(ring_buf, src_ptr)                                                               \
+    AWS_ATOMIC_STORE_PTR(ring_buf, &(ring_buf)->wrap_end, src_ptr, aws_memory_order_relaxed);
 
 int aws_ring_buffer_init(struct aws_ring_buffer *ring_buf, struct aws_allocator *allocator, size_t size) {
     AWS_PRECONDITION(ring_buf != NULL);
@@ -47,25 +53,110 @@ int aws_ring_buffer_init(struct aws_ring_buffer *ring_buf, struct aws_allocator
     aws_atomic_init_ptr(&ring_buf->head, ring_buf->allocation);
     aws_atomic_init_ptr(&ring_buf->tail, ring_buf->allocation);
     ring_buf->allocation_end = ring_buf->allocation + size;
+    aws_atomic_init_ptr(&ring_buf->wrap_end, ring_buf->allocation_end);
 
     AWS_POSTCONDITION(aws_ring_buffer_is_valid(ring_buf));
     return AWS_OP_SUCCESS;
 }
 
+int aws_ring_buffer_init_mirrored(struct aws_ring_buffer *ring_buf, struct aws_allocator *allocator, size_t size) {
+    AWS_PRECONDITION(ring_buf != NULL);
+    AWS_PRECONDITION(allocator != NULL);
+    AWS_PRECONDITION(size > 0);
+
+    AWS_ZERO_STRUCT(*ring_buf);
+
+    size_t mapped_size = size;
+    ring_buf->allocation = aws_ring_buffer_mirror_map(&mapped_size);
+    if (!ring_buf->allocation) {
+        return aws_ring_buffer_init(ring_buf, allocator, size);
+    }
+
+    ring_buf->allocator = allocator;
+    ring_buf->mirrored = true;
+    aws_atomic_init_ptr(&ring_buf->head, ring_buf->allocation);
+    aws_atomic_init_ptr(&ring_buf->tail, ring_buf->allocation);
+    ring_buf->allocation_end = ring_buf->allocation + mapped_size;
+    aws_atomic_init_ptr(&ring_buf->wrap_end, ring_buf->allocation_end);
+
+    AWS_POSTCONDITION(aws_ring_buffer_is_valid(ring_buf));
+    return AWS_OP_SUCCESS;
+}
+
+bool aws_ring_buffer_is_mirrored(const struct aws_ring_buffer *ring_buf) {
+    AWS_PRECONDITION(ring_buf != NULL);
+    return ring_buf->mirrored;
+}
+
 void aws_ring_buffer_clean_up(struct aws_ring_buffer *ring_buf) {
     AWS_PRECONDITION(aws_ring_buffer_is_valid(ring_buf));
-    if (ring_buf->allocation) {
+    if (ring_buf->allocation && ring_buf->mirrored) {
+        aws_ring_buffer_mirror_unmap(ring_buf->allocation, ring_buf->allocation_end - ring_buf->allocation);
+    } else if (ring_buf->allocation) {
         aws_mem_release(ring_buf->allocator, ring_buf->allocation);
     }
 
     AWS_ZERO_STRUCT(*ring_buf);
 }
 
+/*
+ * Acquire for mirrored ring buffers: whatever is free after head is contiguous, so there's never a reason to go back
+ * to the start of the allocation, except to reset an empty buffer like the regular path does. Vended buffers may
+ * extend past allocation_end, and head wraps back into [allocation, allocation_end] once they do.
+ */
+static int s_mirrored_acquire(
+    struct aws_ring_buffer *ring_buf,
+    size_t minimum_size,
+    size_t requested_size,
+    struct aws_byte_buf *dest) {
+
+    uint8_t *tail_cpy;
+    uint8_t *head_cpy;
+    AWS_ATOMIC_LOAD_TAIL_PTR(ring_buf, tail_cpy);
+    AWS_ATOMIC_LOAD_HEAD_PTR(ring_buf, head_cpy);
+
+    size_t ring_space = ring_buf->allocation_end - ring_buf->allocation;
+
+    if (head_cpy == tail_cpy) {
+        size_t allocation_size = ring_space > requested_size ? requested_size : ring_space;
+        if (allocation_size < minimum_size) {
+            return aws_raise_error(AWS_ERROR_OOM);
+        }
+        AWS_ATOMIC_STORE_HEAD_PTR(ring_buf, ring_buf->allocation + allocation_size);
+        AWS_ATOMIC_STORE_TAIL_PTR(ring_buf, ring_buf->allocation);
+        *dest = aws_byte_buf_from_empty_array(ring_buf->allocation, allocation_size);
+        return AWS_OP_SUCCESS;
+    }
+
+    /* same as the regular path, one byte stays free so a full buffer doesn't look empty */
+    size_t used = head_cpy > tail_cpy ? (size_t)(head_cpy - tail_cpy) : ring_space - (size_t)(tail_cpy - head_cpy);
+    size_t space = used < ring_space ? ring_space - used - 1 : 0;
+    size_t allocation_size = space > requested_size ? requested_size : space;
+    if (allocation_size < minimum_size) {
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+
+    uint8_t *new_head = head_cpy + allocation_size;
+    if (new_head > ring_buf->allocation_end) {
+        new_head -= ring_space;
+    }
+    AWS_ATOMIC_STORE_HEAD_PTR(ring_buf, new_head);
+    *dest = aws_byte_buf_from_empty_array(head_cpy, allocation_size);
+    return AWS_OP_SUCCESS;
+}
+
 int aws_ring_buffer_acquire(struct aws_ring_buffer *ring_buf, size_t requested_size, struct aws_byte_buf *dest) {
     AWS_PRECONDITION(aws_ring_buffer_is_valid(ring_buf));
     AWS_PRECONDITION(aws_byte_buf_is_valid(dest));
     AWS_ERROR_PRECONDITION(requested_size != 0);
 
+    if (ring_buf->mirrored) {
+        int result = s_mirrored_acquire(ring_buf, requested_size, requested_size, dest);
+        AWS_POSTCONDITION(aws_ring_buffer_is_valid(ring_buf));
+        AWS_POSTCONDITION(aws_byte_buf_is_valid(dest));
+        return result;
+    }
+
     uint8_t *tail_cpy;
     uint8_t *head_cpy;
     AWS_ATOMIC_LOAD_TAIL_PTR(ring_buf, tail_cpy);
@@ -112,6 +203,7 @@ int aws_ring_buffer_acquire(struct aws_ring_buffer *ring_buf, size_t requested_s
         }
 
         if ((size_t)(tail_cpy - ring_buf->allocation) > requested_size) {
+            AWS_ATOMIC_STORE_WRAP_END_PTR(ring_buf, head_cpy);
             AWS_ATOMIC_STORE_HEAD_PTR(ring_buf, ring_buf->allocation + requested_size);
             *dest = aws_byte_buf_from_empty_array(ring_buf->allocation, requested_size);
             AWS_POSTCONDITION(aws_ring_buffer_is_valid(ring_buf));
@@ -140,6 +232,13 @@ int aws_ring_buffer_acquire_up_to(
         return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
     }
 
+    if (ring_buf->mirrored) {
+        int result = s_mirrored_acquire(ring_buf, minimum_size, requested_size, dest);
+        AWS_POSTCONDITION(aws_ring_buffer_is_valid(ring_buf));
+        AWS_POSTCONDITION(aws_byte_buf_is_valid(dest));
+        return result;
+    }
+
     uint8_t *tail_cpy;
     uint8_t *head_cpy;
     AWS_ATOMIC_LOAD_TAIL_PTR(ring_buf, tail_cpy);
@@ -198,6 +297,7 @@ int aws_ring_buffer_acquire_up_to(
         }
 
         if (tail_space > requested_size) {
+            AWS_ATOMIC_STORE_WRAP_END_PTR(ring_buf, head_cpy);
             AWS_ATOMIC_STORE_HEAD_PTR(ring_buf, ring_buf->allocation + requested_size);
             *dest = aws_byte_buf_from_empty_array(ring_buf->allocation, requested_size);
             AWS_POSTCONDITION(aws_ring_buffer_is_valid(ring_buf));
@@ -215,6 +315,7 @@ int aws_ring_buffer_acquire_up_to(
         }
 
         if (tail_space > minimum_size) {
+            AWS_ATOMIC_STORE_WRAP_END_PTR(ring_buf, head_cpy);
             AWS_ATOMIC_STORE_HEAD_PTR(ring_buf, ring_buf->allocation + tail_space - 1);
             *dest = aws_byte_buf_from_empty_array(ring_buf->allocation, tail_space - 1);
             AWS_POSTCONDITION(aws_ring_buffer_is_valid(ring_buf));
@@ -228,6 +329,107 @@ int aws_ring_buffer_acquire_up_to(
     return aws_raise_error(AWS_ERROR_OOM);
 }
 
+/*
+ * Works out where aws_ring_buffer_acquire() would put `size` bytes, given `tail` and `head`, without touching the ring
+ * buffer. Returns NULL if they don't fit, otherwise the start of the space, with *new_head set to where head ends up.
+ */
+static uint8_t *s_find_space(
+    const struct aws_ring_buffer *ring_buf,
+    uint8_t *tail,
+    uint8_t *head,
+    size_t size,
+    uint8_t **new_head) {
+
+    size_t ring_space = ring_buf->allocation_end - ring_buf->allocation;
+
+    if (head == tail) {
+        if (size > ring_space) {
+            return NULL;
+        }
+        *new_head = ring_buf->allocation + size;
+        return ring_buf->allocation;
+    }
+
+    if (ring_buf->mirrored) {
+        size_t used = head > tail ? (size_t)(head - tail) : ring_space - (size_t)(tail - head);
+        size_t space = used < ring_space ? ring_space - used - 1 : 0;
+        if (space < size) {
+            return NULL;
+        }
+        *new_head = head + size > ring_buf->allocation_end ? head + size - ring_space : head + size;
+        return head;
+    }
+
+    if (tail > head) {
+        if ((size_t)(tail - head - 1) < size) {
+            return NULL;
+        }
+        *new_head = head + size;
+        return head;
+    }
+
+    if ((size_t)(ring_buf->allocation_end - head) >= size) {
+        *new_head = head + size;
+        return head;
+    }
+    if ((size_t)(tail - ring_buf->allocation) > size) {
+        *new_head = ring_buf->allocation + size;
+        return ring_buf->allocation;
+    }
+    return NULL;
+}
+
+int aws_ring_buffer_acquire_many(
+    struct aws_ring_buffer *ring_buf,
+    const size_t *sizes,
+    size_t count,
+    struct aws_byte_buf *dests) {
+    AWS_PRECONDITION(aws_ring_buffer_is_valid(ring_buf));
+    AWS_PRECONDITION(sizes && dests);
+    AWS_ERROR_PRECONDITION(count != 0);
+
+    uint8_t *tail_cpy;
+    uint8_t *head_cpy;
+    AWS_ATOMIC_LOAD_TAIL_PTR(ring_buf, tail_cpy);
+    AWS_ATOMIC_LOAD_HEAD_PTR(ring_buf, head_cpy);
+
+    /* an empty ring buffer starts over at the beginning, the same as for a single acquire */
+    bool reset = head_cpy == tail_cpy;
+    uint8_t *tail = reset ? ring_buf->allocation : tail_cpy;
+    uint8_t *head = reset ? ring_buf->allocation : head_cpy;
+    uint8_t *wrap_end = NULL;
+
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t *new_head = NULL;
+        uint8_t *space = sizes[i] == 0 ? NULL : s_find_space(ring_buf, tail, head, sizes[i], &new_head);
+        if (!space) {
+            int error = sizes[i] == 0 ? AWS_ERROR_INVALID_ARGUMENT : AWS_ERROR_OOM;
+            for (size_t j = 0; j < i; ++j) {
+                AWS_ZERO_STRUCT(dests[j]);
+            }
+            AWS_POSTCONDITION(aws_ring_buffer_is_valid(ring_buf));
+            return aws_raise_error(error);
+        }
+        if (space != head) {
+            wrap_end = head;
+        }
+        dests[i] = aws_byte_buf_from_empty_array(space, sizes[i]);
+        head = new_head;
+    }
+
+    /* one update for the whole batch */
+    if (wrap_end) {
+        AWS_ATOMIC_STORE_WRAP_END_PTR(ring_buf, wrap_end);
+    }
+    AWS_ATOMIC_STORE_HEAD_PTR(ring_buf, head);
+    if (reset) {
+        AWS_ATOMIC_STORE_TAIL_PTR(ring_buf, ring_buf->allocation);
+    }
+
+    AWS_POSTCONDITION(aws_ring_buffer_is_valid(ring_buf));
+    return AWS_OP_SUCCESS;
+}
+
 static inline bool s_buf_belongs_to_pool(const struct aws_ring_buffer *ring_buffer, const struct aws_byte_buf *buf) {
 #ifdef CBMC
     /* only continue if buf points-into ring_buffer because comparison of pointers to different objects is undefined
@@ -238,19 +440,80 @@ static inline bool s_buf_belongs_to_pool(const struct aws_ring_buffer *ring_buff
             ring_buffer->allocation_end != NULL, __CPROVER_same_object(buf->buffer, ring_buffer->allocation_end - 1)));
 
 #endif
-    return buf->buffer && ring_buffer->allocation && ring_buffer->allocation_end &&
-           buf->buffer >= ring_buffer->allocation && buf->buffer + buf->capacity <= ring_buffer->allocation_end;
+    if (!buf->buffer || !ring_buffer->allocation || !ring_buffer->allocation_end) {
+        return false;
+    }
+    if (ring_buffer->mirrored) {
+        /* buffers start in the first copy, but may run into the second one */
+        size_t ring_space = ring_buffer->allocation_end - ring_buffer->allocation;
+        return buf->buffer >= ring_buffer->allocation && buf->buffer <= ring_buffer->allocation_end &&
+               buf->capacity <= ring_space && buf->buffer + buf->capacity <= ring_buffer->allocation_end + ring_space;
+    }
+    return buf->buffer >= ring_buffer->allocation && buf->buffer + buf->capacity <= ring_buffer->allocation_end;
 }
 
 void aws_ring_buffer_release(struct aws_ring_buffer *ring_buffer, struct aws_byte_buf *buf) {
     AWS_PRECONDITION(aws_ring_buffer_is_valid(ring_buffer));
     AWS_PRECONDITION(aws_byte_buf_is_valid(buf));
     AWS_PRECONDITION(s_buf_belongs_to_pool(ring_buffer, buf));
-    AWS_ATOMIC_STORE_TAIL_PTR(ring_buffer, buf->buffer + buf->capacity);
+    uint8_t *new_tail = buf->buffer + buf->capacity;
+    if (new_tail > ring_buffer->allocation_end) {
+        /* mirrored, and the buffer ran into the second copy */
+        new_tail -= ring_buffer->allocation_end - ring_buffer->allocation;
+    }
+    AWS_ATOMIC_STORE_TAIL_PTR(ring_buffer, new_tail);
     AWS_ZERO_STRUCT(*buf);
     AWS_POSTCONDITION(aws_ring_buffer_is_valid(ring_buffer));
 }
 
+void aws_ring_buffer_release_many(struct aws_ring_buffer *ring_buffer, struct aws_byte_buf *bufs, size_t count) {
+    AWS_PRECONDITION(aws_ring_buffer_is_valid(ring_buffer));
+    AWS_PRECONDITION(bufs && count > 0);
+
+    /* releasing the last one moves tail past all of them */
+    for (size_t i = 0; i + 1 < count; ++i) {
+        AWS_PRECONDITION(s_buf_belongs_to_pool(ring_buffer, &bufs[i]));
+        AWS_ZERO_STRUCT(bufs[i]);
+    }
+    aws_ring_buffer_release(ring_buffer, &bufs[count - 1]);
+}
+
+size_t aws_ring_buffer_get_acquired_regions(const struct aws_ring_buffer *ring_buf, struct aws_byte_cursor *regions) {
+    AWS_PRECONDITION(aws_ring_buffer_is_valid(ring_buf));
+    AWS_PRECONDITION(regions);
+
+    uint8_t *tail_cpy;
+    uint8_t *head_cpy;
+    AWS_ATOMIC_LOAD_TAIL_PTR(ring_buf, tail_cpy);
+    AWS_ATOMIC_LOAD_HEAD_PTR(ring_buf, head_cpy);
+
+    if (head_cpy == tail_cpy) {
+        return 0;
+    }
+    if (head_cpy > tail_cpy) {
+        regions[0] = aws_byte_cursor_from_array(tail_cpy, head_cpy - tail_cpy);
+        return 1;
+    }
+
+    size_t ring_space = ring_buf->allocation_end - ring_buf->allocation;
+    if (ring_buf->mirrored) {
+        regions[0] = aws_byte_cursor_from_array(tail_cpy, ring_space - (size_t)(tail_cpy - head_cpy));
+        return 1;
+    }
+
+    /* head went back to the start: the data runs from tail to wherever it stopped, then from the start to head */
+    uint8_t *wrap_end;
+    AWS_ATOMIC_LOAD_WRAP_END_PTR(ring_buf, wrap_end);
+    size_t region_count = 0;
+    if (wrap_end > tail_cpy) {
+        regions[region_count++] = aws_byte_cursor_from_array(tail_cpy, wrap_end - tail_cpy);
+    }
+    if (head_cpy > ring_buf->allocation) {
+        regions[region_count++] = aws_byte_cursor_from_array(ring_buf->allocation, head_cpy - ring_buf->allocation);
+    }
+    return region_count;
+}
+
 bool aws_ring_buffer_buf_belongs_to_pool(const struct aws_ring_buffer *ring_buffer, const struct aws_byte_buf *buf) {
     AWS_PRECONDITION(aws_ring_buffer_is_valid(ring_buffer));
     AWS_PRECONDITION(aws_byte_buf_is_valid(buf));
@@ -0,0 +1,264 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/spsc_record_queue.h>
+
+#include <aws/common/clock.h>
+#include <aws/common/private/futex.h>
+
+/*
+ * Every record starts with a header, at an AWS_SPSC_RECORD_QUEUE_ALIGNMENT aligned address, and normally follows the
+ * previous one. The ring buffer vends space back at the start of the buffer when the record doesn't fit before the end,
+ * and also whenever it runs empty. The producer then publishes the record's index as wrapped_record, and the consumer
+ * looks for that record at the start of the buffer instead.
+ *
+ * Only one wrap is ever pending: the ring buffer can't wrap around again until the wrapped record has been released,
+ * or, if it ran empty, until everything has been, so the latest wrapped_record is the only one the consumer can still
+ * be looking for. For the same reason the consumer can't tell whether there is anything to read from the positions
+ * alone (the producer may commit right back to where it is), so it counts records instead.
+ */
+struct record_header {
+    uint64_t size;
+};
+
+AWS_STATIC_ASSERT(sizeof(struct record_header) == AWS_SPSC_RECORD_QUEUE_ALIGNMENT);
+
+static size_t s_record_total_size(size_t size) {
+    return sizeof(struct record_header) +
+           ((size + AWS_SPSC_RECORD_QUEUE_ALIGNMENT - 1) & ~(size_t)(AWS_SPSC_RECORD_QUEUE_ALIGNMENT - 1));
+}
+
+int aws_spsc_record_queue_init(
+    struct aws_spsc_record_queue *queue,
+    struct aws_allocator *allocator,
+    size_t capacity) {
+    AWS_PRECONDITION(queue);
+    AWS_PRECONDITION(allocator);
+
+    AWS_ZERO_STRUCT(*queue);
+
+    capacity &= ~(size_t)(AWS_SPSC_RECORD_QUEUE_ALIGNMENT - 1);
+    if (capacity < 2 * sizeof(struct record_header)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (aws_ring_buffer_init(&queue->ring, allocator, capacity)) {
+        return AWS_OP_ERR;
+    }
+
+    aws_atomic_init_int(&queue->committed_count, 0);
+    aws_atomic_init_int(&queue->wrapped_record, 0);
+    aws_atomic_init_int(&queue->consumer_waiting, 0);
+    aws_atomic_init_int(&queue->producer_waiting, 0);
+    queue->reserve_position = queue->ring.allocation;
+    queue->read_position = queue->ring.allocation;
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_spsc_record_queue_clean_up(struct aws_spsc_record_queue *queue) {
+    AWS_PRECONDITION(queue);
+
+    if (queue->ring.allocation) {
+        aws_ring_buffer_clean_up(&queue->ring);
+    }
+    AWS_ZERO_STRUCT(*queue);
+}
+
+int aws_spsc_record_queue_reserve(struct aws_spsc_record_queue *queue, size_t size, struct aws_byte_buf *dest) {
+    AWS_PRECONDITION(queue);
+    AWS_PRECONDITION(dest);
+
+    size_t ring_size = (size_t)(queue->ring.allocation_end - queue->ring.allocation);
+    if (size > ring_size - sizeof(struct record_header)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    size_t total_size = s_record_total_size(size);
+    struct aws_byte_buf record;
+    AWS_ZERO_STRUCT(record);
+    if (aws_ring_buffer_acquire(&queue->ring, total_size, &record)) {
+        return AWS_OP_ERR;
+    }
+
+    if (record.buffer != queue->reserve_position) {
+        /* published by the next commit */
+        aws_atomic_store_int_explicit(&queue->wrapped_record, queue->reserved_count, aws_memory_order_relaxed);
+    }
+
+    struct record_header header = {.size = size};
+    memcpy(record.buffer, &header, sizeof(header));
+
+    queue->reserve_position = record.buffer + total_size;
+    ++queue->reserved_count;
+
+    *dest = aws_byte_buf_from_empty_array(record.buffer + sizeof(header), size);
+    return AWS_OP_SUCCESS;
+}
+
+static uint64_t s_deadline(uint64_t timeout_ns) {
+    if (timeout_ns == AWS_SPSC_RECORD_QUEUE_WAIT_FOREVER) {
+        return UINT64_MAX;
+    }
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    return aws_add_u64_saturating(now, timeout_ns);
+}
+
+/* Returns how long to sleep until the deadline, or 0 once it has passed. */
+static uint64_t s_time_left(uint64_t deadline) {
+    if (deadline == UINT64_MAX) {
+        return AWS_FUTEX_WAIT_FOREVER;
+    }
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    return now < deadline ? deadline - now : 0;
+}
+
+int aws_spsc_record_queue_reserve_wait(
+    struct aws_spsc_record_queue *queue,
+    size_t size,
+    uint64_t timeout_ns,
+    struct aws_byte_buf *dest) {
+
+    if (!aws_spsc_record_queue_reserve(queue, size, dest)) {
+        return AWS_OP_SUCCESS;
+    }
+    if (aws_last_error() != AWS_ERROR_OOM) {
+        return AWS_OP_ERR;
+    }
+
+    aws_spsc_record_queue_commit(queue);
+
+    uint64_t deadline = s_deadline(timeout_ns);
+    int result = AWS_OP_ERR;
+    for (;;) {
+        /* announce the wait before looking at the tail, so the consumer either sees us or we see its release */
+        aws_atomic_store_int(&queue->producer_waiting, 1);
+        size_t tail = aws_atomic_load_int(&queue->ring.tail);
+
+        if (!aws_spsc_record_queue_reserve(queue, size, dest)) {
+            result = AWS_OP_SUCCESS;
+            break;
+        }
+
+        uint64_t time_left = s_time_left(deadline);
+        if (time_left == 0) {
+            aws_raise_error(AWS_ERROR_OOM);
+            break;
+        }
+        aws_futex_wait(&queue->ring.tail, tail, time_left);
+    }
+
+    aws_atomic_store_int(&queue->producer_waiting, 0);
+    return result;
+}
+
+void aws_spsc_record_queue_commit(struct aws_spsc_record_queue *queue) {
+    AWS_PRECONDITION(queue);
+
+    if (aws_atomic_load_int_explicit(&queue->committed_count, aws_memory_order_relaxed) == queue->reserved_count) {
+        return;
+    }
+
+    aws_atomic_store_int(&queue->committed_count, queue->reserved_count);
+    if (aws_atomic_load_int(&queue->consumer_waiting)) {
+        aws_futex_wake_all(&queue->committed_count);
+    }
+}
+
+int aws_spsc_record_queue_push(struct aws_spsc_record_queue *queue, struct aws_byte_cursor record) {
+    struct aws_byte_buf dest;
+    if (aws_spsc_record_queue_reserve(queue, record.len, &dest)) {
+        return AWS_OP_ERR;
+    }
+    aws_byte_buf_write_from_whole_cursor(&dest, record);
+    aws_spsc_record_queue_commit(queue);
+    return AWS_OP_SUCCESS;
+}
+
+/* Reads the next record, once the caller has seen that it's committed. */
+static void s_read_committed(struct aws_spsc_record_queue *queue, struct aws_byte_cursor *record) {
+    uint8_t *position = queue->read_position;
+    if (aws_atomic_load_int_explicit(&queue->wrapped_record, aws_memory_order_relaxed) == queue->read_count) {
+        position = queue->ring.allocation;
+    }
+
+    struct record_header header;
+    memcpy(&header, position, sizeof(header));
+
+    size_t total_size = s_record_total_size(header.size);
+    *record = aws_byte_cursor_from_array(position + sizeof(header), header.size);
+
+    queue->last_read_record = position;
+    queue->last_read_record_size = total_size;
+    queue->read_position = position + total_size;
+    ++queue->read_count;
+}
+
+bool aws_spsc_record_queue_read(struct aws_spsc_record_queue *queue, struct aws_byte_cursor *record) {
+    AWS_PRECONDITION(queue);
+    AWS_PRECONDITION(record);
+
+    if (aws_atomic_load_int_explicit(&queue->committed_count, aws_memory_order_acquire) == queue->read_count) {
+        return false;
+    }
+
+    s_read_committed(queue, record);
+    return true;
+}
+
+bool aws_spsc_record_queue_read_wait(
+    struct aws_spsc_record_queue *queue,
+    uint64_t timeout_ns,
+    struct aws_byte_cursor *record) {
+
+    if (aws_spsc_record_queue_read(queue, record)) {
+        return true;
+    }
+
+    uint64_t deadline = s_deadline(timeout_ns);
+    bool found = false;
+    for (;;) {
+        /* announce the wait before looking at the count, so the producer either sees us or we see its commit */
+        aws_atomic_store_int(&queue->consumer_waiting, 1);
+        size_t committed_count = aws_atomic_load_int(&queue->committed_count);
+
+        if (committed_count != queue->read_count) {
+            s_read_committed(queue, record);
+            found = true;
+            break;
+        }
+
+        uint64_t time_left = s_time_left(deadline);
+        if (time_left == 0) {
+            break;
+        }
+        aws_futex_wait(&queue->committed_count, committed_count, time_left);
+    }
+
+    aws_atomic_store_int(&queue->consumer_waiting, 0);
+    return found;
+}
+
+void aws_spsc_record_queue_consume(struct aws_spsc_record_queue *queue) {
+    AWS_PRECONDITION(queue);
+
+    if (!queue->last_read_record) {
+        return;
+    }
+
+    /* releasing the last record read hands back everything before it too */
+    struct aws_byte_buf last_record =
+        aws_byte_buf_from_empty_array(queue->last_read_record, queue->last_read_record_size);
+    aws_ring_buffer_release(&queue->ring, &last_record);
+    queue->last_read_record = NULL;
+    queue->last_read_record_size = 0;
+
+    aws_atomic_thread_fence(aws_memory_order_seq_cst);
+    if (aws_atomic_load_int(&queue->producer_waiting)) {
+        aws_futex_wake_all(&queue->ring.tail);
+    }
+}
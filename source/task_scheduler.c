@@ -5,14 +5,198 @@
 
 #include <aws/common/task_scheduler.h>
 
+#include <aws/common/array_list.h>
+#include <aws/common/clock.h>
+#include <aws/common/hash_table.h>
 #include <aws/common/logging.h>
+#include <aws/common/private/task_scheduler_impl.h>
 
 #include <inttypes.h>
 
 static const size_t DEFAULT_QUEUE_SIZE = 7;
 
+/* 1 millisecond, assuming nanosecond timestamps */
+static const uint64_t DEFAULT_TIMING_WHEEL_TICK = 1000000;
+
+/*
+ * Hierarchical timing wheel.
+ *
+ * Each level has 64 slots and covers 6 more bits of the tick number than the level below it. A task lives at the
+ * level of the highest 6-bit digit where its tick differs from current_tick, in the slot named by that digit. All
+ * digits above that level are equal to current_tick's, so every task in the wheel is strictly in the future, level 0
+ * holds everything due before the next level 1 boundary, and so on.
+ *
+ * When current_tick reaches the start of an occupied slot, the slot is emptied and its tasks are placed again relative
+ * to the new current_tick: either into a lower level, or into the scheduler's timed_queue once their tick is due. The
+ * heap then provides exact timestamp order among due tasks, so it only ever holds about one tick worth of tasks.
+ *
+ * Tasks are linked into slots through aws_task.node, so canceling a task is a plain O(1) list removal. That can
+ * leave a slot empty with its occupied bit still set; such stale bits are skipped on lookup and dropped when the slot
+ * is reached.
+ */
+#define TIMING_WHEEL_SLOT_BITS 6
+#define TIMING_WHEEL_SLOT_COUNT (1 << TIMING_WHEEL_SLOT_BITS)
+
+struct aws_task_timing_wheel_level {
+    uint64_t occupied; /* bit i is set if slots[i] may be non-empty */
+    struct aws_linked_list slots[TIMING_WHEEL_SLOT_COUNT];
+};
+
+struct aws_task_timing_wheel {
+    uint64_t tick;
+    uint64_t current_tick;
+    size_t level_count;
+    struct aws_task_timing_wheel_level *levels;
+};
+
+static size_t s_timing_wheel_digit(uint64_t tick, size_t level) {
+    return (size_t)((tick >> (level * TIMING_WHEEL_SLOT_BITS)) & (TIMING_WHEEL_SLOT_COUNT - 1));
+}
+
+static struct aws_task_timing_wheel *s_timing_wheel_new(struct aws_allocator *alloc, uint64_t tick) {
+    /* enough levels to place any tick a 64-bit timestamp can map to */
+    size_t tick_bits = 64 - aws_clz_u64(UINT64_MAX / tick);
+    size_t level_count = (tick_bits + TIMING_WHEEL_SLOT_BITS - 1) / TIMING_WHEEL_SLOT_BITS;
+
+    struct aws_task_timing_wheel *wheel = NULL;
+    struct aws_task_timing_wheel_level *levels = NULL;
+    if (!aws_mem_acquire_many(
+            alloc,
+            2,
+            &wheel,
+            sizeof(struct aws_task_timing_wheel),
+            &levels,
+            level_count * sizeof(struct aws_task_timing_wheel_level))) {
+        return NULL;
+    }
+
+    wheel->tick = tick;
+    wheel->current_tick = 0;
+    wheel->level_count = level_count;
+    wheel->levels = levels;
+
+    for (size_t level = 0; level < level_count; ++level) {
+        levels[level].occupied = 0;
+        for (size_t slot = 0; slot < TIMING_WHEEL_SLOT_COUNT; ++slot) {
+            aws_linked_list_init(&levels[level].slots[slot]);
+        }
+    }
+
+    return wheel;
+}
+
+/* Precondition: the task's tick is after current_tick */
+static void s_timing_wheel_insert(struct aws_task_timing_wheel *wheel, struct aws_task *task) {
+    uint64_t tick = task->timestamp / wheel->tick;
+    AWS_ASSERT(tick > wheel->current_tick);
+
+    size_t level = (63 - aws_clz_u64(tick ^ wheel->current_tick)) / TIMING_WHEEL_SLOT_BITS;
+    size_t slot = s_timing_wheel_digit(tick, level);
+
+    aws_linked_list_push_back(&wheel->levels[level].slots[slot], &task->node);
+    wheel->levels[level].occupied |= (uint64_t)1 << slot;
+}
+
+/*
+ * Finds the earliest non-empty slot. Levels are strictly ordered in time, so this is the first occupied slot after
+ * current_tick's digit on the lowest level that has one. start_tick is set to the first tick the slot covers.
+ */
+static bool s_timing_wheel_next_slot(
+    const struct aws_task_timing_wheel *wheel,
+    size_t *out_level,
+    size_t *out_slot,
+    uint64_t *out_start_tick) {
+
+    for (size_t level = 0; level < wheel->level_count; ++level) {
+        size_t digit = s_timing_wheel_digit(wheel->current_tick, level);
+        uint64_t candidates = digit == TIMING_WHEEL_SLOT_COUNT - 1 ? 0 : wheel->levels[level].occupied >> (digit + 1);
+
+        while (candidates) {
+            size_t slot = digit + 1 + aws_ctz_u64(candidates);
+            candidates &= candidates - 1;
+
+            if (aws_linked_list_empty(&wheel->levels[level].slots[slot])) {
+                continue;
+            }
+
+            size_t level_shift = level * TIMING_WHEEL_SLOT_BITS;
+            size_t upper_shift = level_shift + TIMING_WHEEL_SLOT_BITS;
+            uint64_t upper = upper_shift < 64 ? (wheel->current_tick >> upper_shift) << upper_shift : 0;
+
+            *out_level = level;
+            *out_slot = slot;
+            *out_start_tick = upper | ((uint64_t)slot << level_shift);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void s_push_timed(struct aws_task_scheduler *scheduler, struct aws_task *task);
+
+/* Moves the wheel forward to target_tick, handing every task whose tick is reached to the timed_queue */
+static void s_timing_wheel_advance(struct aws_task_scheduler *scheduler, uint64_t target_tick) {
+    struct aws_task_timing_wheel *wheel = scheduler->timing_wheel;
+
+    while (wheel->current_tick < target_tick) {
+        size_t level = 0;
+        size_t slot = 0;
+        uint64_t start_tick = 0;
+        if (!s_timing_wheel_next_slot(wheel, &level, &slot, &start_tick) || start_tick > target_tick) {
+            /* nothing due in between, so every task keeps its place relative to target_tick */
+            wheel->current_tick = target_tick;
+            break;
+        }
+
+        wheel->current_tick = start_tick;
+
+        struct aws_linked_list cascade;
+        aws_linked_list_init(&cascade);
+        aws_linked_list_swap_contents(&cascade, &wheel->levels[level].slots[slot]);
+        wheel->levels[level].occupied &= ~((uint64_t)1 << slot);
+
+        while (!aws_linked_list_empty(&cascade)) {
+            struct aws_task *task = AWS_CONTAINER_OF(aws_linked_list_pop_front(&cascade), struct aws_task, node);
+            aws_linked_list_node_reset(&task->node);
+
+            if (task->timestamp / wheel->tick <= wheel->current_tick) {
+                s_push_timed(scheduler, task);
+            } else {
+                s_timing_wheel_insert(wheel, task);
+            }
+        }
+    }
+}
+
+/* Earliest time a task in the wheel can be due: exact for level 0, the slot start otherwise */
+static bool s_timing_wheel_next_time(const struct aws_task_timing_wheel *wheel, uint64_t *next_time) {
+    size_t level = 0;
+    size_t slot = 0;
+    uint64_t start_tick = 0;
+    if (!s_timing_wheel_next_slot(wheel, &level, &slot, &start_tick)) {
+        return false;
+    }
+
+    *next_time = start_tick * wheel->tick;
+
+    if (level == 0) {
+        /* everything in a level 0 slot shares one tick, which is usually a handful of tasks */
+        const struct aws_linked_list *list = &wheel->levels[0].slots[slot];
+        uint64_t earliest = UINT64_MAX;
+        for (struct aws_linked_list_node *node = aws_linked_list_begin(list); node != aws_linked_list_end(list);
+             node = aws_linked_list_next(node)) {
+            earliest = aws_min_u64(earliest, AWS_CONTAINER_OF(node, struct aws_task, node)->timestamp);
+        }
+        *next_time = earliest;
+    }
+
+    return true;
+}
+
 void aws_task_init(struct aws_task *task, aws_task_fn *fn, void *arg, const char *type_tag) {
     AWS_ZERO_STRUCT(*task);
+    aws_priority_queue_node_init(&task->priority_queue_node);
     task->fn = fn;
     task->arg = arg;
     task->type_tag = type_tag;
@@ -31,8 +215,26 @@ const char *aws_task_status_to_c_str(enum aws_task_status status) {
     }
 }
 
+/* Returns false if the task was handed to an aws_thread_scheduler and canceled from another thread in the meantime. The
+ * cancellation then owns the task and will run it with AWS_TASK_STATUS_CANCELED itself. */
+static bool s_claim_task_for_run(struct aws_task *task) {
+    size_t state =
+        aws_atomic_load_int_explicit(&task->abi_extension.thread_scheduler_state, aws_memory_order_relaxed);
+    if (state == AWS_TASK_THREAD_SCHEDULER_STATE_IDLE) {
+        return true;
+    }
+
+    size_t expected = AWS_TASK_THREAD_SCHEDULER_STATE_QUEUED;
+    return aws_atomic_compare_exchange_int(
+        &task->abi_extension.thread_scheduler_state, &expected, AWS_TASK_THREAD_SCHEDULER_STATE_IDLE);
+}
+
 void aws_task_run(struct aws_task *task, enum aws_task_status status) {
     AWS_ASSERT(task->fn);
+    if (!s_claim_task_for_run(task)) {
+        return;
+    }
+
     AWS_LOGF_DEBUG(
         AWS_LS_COMMON_TASK_SCHEDULER,
         "id=%p: Running %s task with %s status",
@@ -40,10 +242,140 @@ void aws_task_run(struct aws_task *task, enum aws_task_status status) {
         task->type_tag,
         aws_task_status_to_c_str(status));
 
-    task->abi_extension.scheduled = false;
     task->fn(task, task->arg, status);
 }
 
+/*
+ * Per type_tag task statistics. Entries are keyed by a copy of the type_tag, stored right after the entry in the same
+ * allocation, so that snapshots stay valid even if the task's own string doesn't outlive the task.
+ */
+struct aws_task_scheduler_stats {
+    struct aws_allocator *alloc;
+    struct aws_hash_table by_type_tag; /* const char * -> struct aws_task_type_stats * */
+};
+
+static void s_stats_clear(struct aws_task_scheduler_stats *stats) {
+    for (struct aws_hash_iter iter = aws_hash_iter_begin(&stats->by_type_tag); !aws_hash_iter_done(&iter);
+         aws_hash_iter_next(&iter)) {
+        struct aws_task_type_stats *entry = iter.element.value;
+        aws_hash_iter_delete(&iter, false);
+        aws_mem_release(stats->alloc, entry);
+    }
+}
+
+static struct aws_task_scheduler_stats *s_stats_new(struct aws_allocator *alloc) {
+    struct aws_task_scheduler_stats *stats = aws_mem_calloc(alloc, 1, sizeof(struct aws_task_scheduler_stats));
+    if (!stats) {
+        return NULL;
+    }
+
+    stats->alloc = alloc;
+    if (aws_hash_table_init(
+            &stats->by_type_tag,
+            alloc,
+            16,
+            aws_hash_c_string,
+            aws_hash_callback_c_str_eq,
+            NULL,
+            NULL)) {
+        aws_mem_release(alloc, stats);
+        return NULL;
+    }
+
+    return stats;
+}
+
+static void s_stats_destroy(struct aws_task_scheduler_stats *stats) {
+    s_stats_clear(stats);
+    aws_hash_table_clean_up(&stats->by_type_tag);
+    aws_mem_release(stats->alloc, stats);
+}
+
+static struct aws_task_type_stats *s_stats_find_or_add(struct aws_task_scheduler_stats *stats, const char *type_tag) {
+    if (!type_tag) {
+        type_tag = "unknown";
+    }
+
+    struct aws_hash_element *elem = NULL;
+    aws_hash_table_find(&stats->by_type_tag, type_tag, &elem);
+    if (elem) {
+        return elem->value;
+    }
+
+    size_t tag_len = strlen(type_tag);
+    struct aws_task_type_stats *entry =
+        aws_mem_calloc(stats->alloc, 1, sizeof(struct aws_task_type_stats) + tag_len + 1);
+    if (!entry) {
+        return NULL;
+    }
+
+    char *tag_copy = (char *)(entry + 1);
+    memcpy(tag_copy, type_tag, tag_len);
+    entry->type_tag = tag_copy;
+
+    if (aws_hash_table_put(&stats->by_type_tag, tag_copy, entry, NULL)) {
+        aws_mem_release(stats->alloc, entry);
+        return NULL;
+    }
+
+    return entry;
+}
+
+static void s_histogram_record(uint64_t *histogram, uint64_t *total, uint64_t *max, uint64_t duration) {
+    size_t bucket = duration > 1 ? 63 - aws_clz_u64(duration) : 0;
+    histogram[aws_min_size(bucket, AWS_TASK_STATS_HISTOGRAM_BUCKETS - 1)]++;
+    *total += duration;
+    *max = aws_max_u64(*max, duration);
+}
+
+/* Runs a task through aws_task_run(), recording its stats if they are enabled. */
+static void s_run_task(struct aws_task_scheduler *scheduler, struct aws_task *task, enum aws_task_status status) {
+    if (AWS_LIKELY(!scheduler->stats)) {
+        aws_task_run(task, status);
+        return;
+    }
+
+    /* Claiming first keeps tasks canceled by an aws_thread_scheduler out of the stats. Once claimed, aws_task_run()
+     * can't fail to claim them again. The task may be freed by its function, so read what we need from it up front. */
+    if (!s_claim_task_for_run(task)) {
+        return;
+    }
+
+    const char *type_tag = task->type_tag;
+    uint64_t ready_time = task->timestamp;
+    uint64_t start_time = 0;
+    aws_high_res_clock_get_ticks(&start_time);
+
+    aws_task_run(task, status);
+
+    /* the task may have cleaned up the scheduler */
+    if (!scheduler->stats) {
+        return;
+    }
+
+    struct aws_task_type_stats *entry = s_stats_find_or_add(scheduler->stats, type_tag);
+    if (!entry) {
+        return;
+    }
+
+    if (status == AWS_TASK_STATUS_CANCELED) {
+        entry->canceled_count++;
+        return;
+    }
+
+    uint64_t end_time = 0;
+    aws_high_res_clock_get_ticks(&end_time);
+
+    entry->run_count++;
+    s_histogram_record(
+        entry->queue_delay_histogram,
+        &entry->queue_delay_total_ns,
+        &entry->queue_delay_max_ns,
+        start_time > ready_time ? start_time - ready_time : 0);
+    s_histogram_record(
+        entry->run_time_histogram, &entry->run_time_total_ns, &entry->run_time_max_ns, end_time - start_time);
+}
+
 static int s_compare_timestamps(const void *a, const void *b) {
     uint64_t a_time = (*(struct aws_task **)a)->timestamp;
     uint64_t b_time = (*(struct aws_task **)b)->timestamp;
@@ -52,19 +384,65 @@ static int s_compare_timestamps(const void *a, const void *b) {
 
 static void s_run_all(struct aws_task_scheduler *scheduler, uint64_t current_time, enum aws_task_status status);
 
+static bool s_budget_exceeded(uint64_t start_time, uint64_t max_nanos) {
+    if (!max_nanos) {
+        return false;
+    }
+
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    return now - start_time >= max_nanos;
+}
+
 int aws_task_scheduler_init(struct aws_task_scheduler *scheduler, struct aws_allocator *alloc) {
+    return aws_task_scheduler_init_with_options(scheduler, alloc, NULL);
+}
+
+int aws_task_scheduler_init_with_options(
+    struct aws_task_scheduler *scheduler,
+    struct aws_allocator *alloc,
+    const struct aws_task_scheduler_options *options) {
     AWS_ASSERT(alloc);
 
     AWS_ZERO_STRUCT(*scheduler);
 
+    struct aws_task_scheduler_options default_options;
+    AWS_ZERO_STRUCT(default_options);
+    if (!options) {
+        options = &default_options;
+    }
+
     if (aws_priority_queue_init_dynamic(
             &scheduler->timed_queue, alloc, DEFAULT_QUEUE_SIZE, sizeof(struct aws_task *), &s_compare_timestamps)) {
         return AWS_OP_ERR;
     };
 
+    if (options->timer_backend == AWS_TASK_SCHEDULER_TIMER_BACKEND_TIMING_WHEEL) {
+        uint64_t tick = options->timing_wheel_tick ? options->timing_wheel_tick : DEFAULT_TIMING_WHEEL_TICK;
+        scheduler->timing_wheel = s_timing_wheel_new(alloc, tick);
+        if (!scheduler->timing_wheel) {
+            aws_priority_queue_clean_up(&scheduler->timed_queue);
+            AWS_ZERO_STRUCT(*scheduler);
+            return AWS_OP_ERR;
+        }
+    }
+
     scheduler->alloc = alloc;
     aws_linked_list_init(&scheduler->timed_list);
     aws_linked_list_init(&scheduler->asap_list);
+    aws_linked_list_init(&scheduler->high_priority_list);
+    aws_linked_list_init(&scheduler->background_list);
+    for (size_t i = 0; i < AWS_TASK_PRIORITY_COUNT; ++i) {
+        scheduler->priority_weights[i] = options->priority_weights[i];
+    }
+
+    if (options->enable_stats) {
+        scheduler->stats = s_stats_new(alloc);
+        if (!scheduler->stats) {
+            aws_task_scheduler_clean_up(scheduler);
+            return AWS_OP_ERR;
+        }
+    }
 
     AWS_POSTCONDITION(aws_task_scheduler_is_valid(scheduler));
     return AWS_OP_SUCCESS;
@@ -82,12 +460,20 @@ void aws_task_scheduler_clean_up(struct aws_task_scheduler *scheduler) {
     }
 
     aws_priority_queue_clean_up(&scheduler->timed_queue);
+    if (scheduler->timing_wheel) {
+        aws_mem_release(scheduler->alloc, scheduler->timing_wheel);
+    }
+    if (scheduler->stats) {
+        s_stats_destroy(scheduler->stats);
+    }
     AWS_ZERO_STRUCT(*scheduler);
 }
 
 bool aws_task_scheduler_is_valid(const struct aws_task_scheduler *scheduler) {
     return scheduler && scheduler->alloc && aws_priority_queue_is_valid(&scheduler->timed_queue) &&
-           aws_linked_list_is_valid(&scheduler->asap_list) && aws_linked_list_is_valid(&scheduler->timed_list);
+           aws_linked_list_is_valid(&scheduler->asap_list) && aws_linked_list_is_valid(&scheduler->timed_list) &&
+           aws_linked_list_is_valid(&scheduler->high_priority_list) &&
+           aws_linked_list_is_valid(&scheduler->background_list);
 }
 
 bool aws_task_scheduler_has_tasks(const struct aws_task_scheduler *scheduler, uint64_t *next_task_time) {
@@ -96,7 +482,8 @@ bool aws_task_scheduler_has_tasks(const struct aws_task_scheduler *scheduler, ui
     uint64_t timestamp = UINT64_MAX;
     bool has_tasks = false;
 
-    if (!aws_linked_list_empty(&scheduler->asap_list)) {
+    if (!aws_linked_list_empty(&scheduler->asap_list) || !aws_linked_list_empty(&scheduler->high_priority_list) ||
+        !aws_linked_list_empty(&scheduler->background_list)) {
         timestamp = 0;
         has_tasks = true;
 
@@ -116,6 +503,11 @@ bool aws_task_scheduler_has_tasks(const struct aws_task_scheduler *scheduler, ui
             }
             has_tasks = true;
         }
+
+        /* Anything still in the timing wheel is due after everything in timed_queue and timed_list */
+        if (!has_tasks && scheduler->timing_wheel) {
+            has_tasks = s_timing_wheel_next_time(scheduler->timing_wheel, &timestamp);
+        }
     }
 
     if (next_task_time) {
@@ -124,10 +516,31 @@ bool aws_task_scheduler_has_tasks(const struct aws_task_scheduler *scheduler, ui
     return has_tasks;
 }
 
+static struct aws_linked_list *s_asap_list_for_priority(
+    struct aws_task_scheduler *scheduler,
+    enum aws_task_priority priority) {
+    switch (priority) {
+        case AWS_TASK_PRIORITY_HIGH:
+            return &scheduler->high_priority_list;
+        case AWS_TASK_PRIORITY_BACKGROUND:
+            return &scheduler->background_list;
+        default:
+            return &scheduler->asap_list;
+    }
+}
+
 void aws_task_scheduler_schedule_now(struct aws_task_scheduler *scheduler, struct aws_task *task) {
+    aws_task_scheduler_schedule_now_with_priority(scheduler, task, AWS_TASK_PRIORITY_NORMAL);
+}
+
+void aws_task_scheduler_schedule_now_with_priority(
+    struct aws_task_scheduler *scheduler,
+    struct aws_task *task,
+    enum aws_task_priority priority) {
     AWS_ASSERT(scheduler);
     AWS_ASSERT(task);
     AWS_ASSERT(task->fn);
+    AWS_ASSERT(priority < AWS_TASK_PRIORITY_COUNT);
 
     AWS_LOGF_DEBUG(
         AWS_LS_COMMON_TASK_SCHEDULER,
@@ -138,9 +551,12 @@ void aws_task_scheduler_schedule_now(struct aws_task_scheduler *scheduler, struc
     aws_priority_queue_node_init(&task->priority_queue_node);
     aws_linked_list_node_reset(&task->node);
     task->timestamp = 0;
+    if (scheduler->stats) {
+        aws_high_res_clock_get_ticks(&task->timestamp);
+    }
 
-    aws_linked_list_push_back(&scheduler->asap_list, &task->node);
-    task->abi_extension.scheduled = true;
+    aws_linked_list_push_back(s_asap_list_for_priority(scheduler, priority), &task->node);
+    ++scheduler->task_count;
 }
 
 void aws_task_scheduler_schedule_future(
@@ -163,6 +579,18 @@ void aws_task_scheduler_schedule_future(
 
     aws_priority_queue_node_init(&task->priority_queue_node);
     aws_linked_list_node_reset(&task->node);
+
+    struct aws_task_timing_wheel *wheel = scheduler->timing_wheel;
+    if (wheel && time_to_run / wheel->tick > wheel->current_tick) {
+        s_timing_wheel_insert(wheel, task);
+    } else {
+        s_push_timed(scheduler, task);
+    }
+    ++scheduler->task_count;
+}
+
+/* Puts a task into timed_queue, or timed_list if that fails */
+static void s_push_timed(struct aws_task_scheduler *scheduler, struct aws_task *task) {
     int err = aws_priority_queue_push_ref(&scheduler->timed_queue, &task, &task->priority_queue_node);
     if (AWS_UNLIKELY(err)) {
         /* In the (very unlikely) case that we can't push into the timed_queue,
@@ -173,13 +601,12 @@ void aws_task_scheduler_schedule_future(
              node_i = aws_linked_list_next(node_i)) {
 
             struct aws_task *task_i = AWS_CONTAINER_OF(node_i, struct aws_task, node);
-            if (task_i->timestamp > time_to_run) {
+            if (task_i->timestamp > task->timestamp) {
                 break;
             }
         }
         aws_linked_list_insert_before(node_i, &task->node);
     }
-    task->abi_extension.scheduled = true;
 }
 
 void aws_task_scheduler_run_all(struct aws_task_scheduler *scheduler, uint64_t current_time) {
@@ -188,18 +615,18 @@ void aws_task_scheduler_run_all(struct aws_task_scheduler *scheduler, uint64_t c
     s_run_all(scheduler, current_time, AWS_TASK_STATUS_RUN_READY);
 }
 
-static void s_run_all(struct aws_task_scheduler *scheduler, uint64_t current_time, enum aws_task_status status) {
-
-    /* Move scheduled tasks to running_list before executing.
-     * This gives us the desired behavior that: if executing a task results in another task being scheduled,
-     * that new task is not executed until the next time run() is invoked. */
-    struct aws_linked_list running_list;
-    aws_linked_list_init(&running_list);
+/* Moves every timed task due at or before current_time to the back of list, in timestamp order. */
+static void s_take_due_timed_tasks(
+    struct aws_task_scheduler *scheduler,
+    uint64_t current_time,
+    struct aws_linked_list *list) {
 
-    /* First move everything from asap_list */
-    aws_linked_list_swap_contents(&running_list, &scheduler->asap_list);
+    /* Hand every timing wheel task that is due by now over to timed_queue, which orders them exactly */
+    if (scheduler->timing_wheel) {
+        s_timing_wheel_advance(scheduler, current_time / scheduler->timing_wheel->tick);
+    }
 
-    /* Next move tasks from timed_queue and timed_list, based on whichever's next-task is sooner.
+    /* Move tasks from timed_queue and timed_list, based on whichever's next-task is sooner.
      * It's very unlikely that any tasks are in timed_list, so once it has no more valid tasks,
      * break out of this complex loop in favor of a simpler one. */
     while (AWS_UNLIKELY(!aws_linked_list_empty(&scheduler->timed_list))) {
@@ -219,7 +646,7 @@ static void s_run_all(struct aws_task_scheduler *scheduler, uint64_t current_tim
                     /* Take task from timed_queue */
                     struct aws_task *timed_queue_task;
                     aws_priority_queue_pop(&scheduler->timed_queue, &timed_queue_task);
-                    aws_linked_list_push_back(&running_list, &timed_queue_task->node);
+                    aws_linked_list_push_back(list, &timed_queue_task->node);
                     continue;
                 }
             }
@@ -227,7 +654,7 @@ static void s_run_all(struct aws_task_scheduler *scheduler, uint64_t current_tim
 
         /* Take task from timed_list */
         aws_linked_list_pop_front(&scheduler->timed_list);
-        aws_linked_list_push_back(&running_list, &timed_list_task->node);
+        aws_linked_list_push_back(list, &timed_list_task->node);
     }
 
     /* Simpler loop that moves remaining valid tasks from timed_queue */
@@ -239,15 +666,158 @@ static void s_run_all(struct aws_task_scheduler *scheduler, uint64_t current_tim
 
         struct aws_task *next_timed_task;
         aws_priority_queue_pop(&scheduler->timed_queue, &next_timed_task);
-        aws_linked_list_push_back(&running_list, &next_timed_task->node);
+        aws_linked_list_push_back(list, &next_timed_task->node);
     }
+}
+
+static void s_run_all(struct aws_task_scheduler *scheduler, uint64_t current_time, enum aws_task_status status) {
+
+    /* Move scheduled tasks to running_list before executing.
+     * This gives us the desired behavior that: if executing a task results in another task being scheduled,
+     * that new task is not executed until the next time run() is invoked. */
+    struct aws_linked_list running_list;
+    aws_linked_list_init(&running_list);
+
+    /* First move everything from the high priority lane, then from asap_list */
+    aws_linked_list_swap_contents(&running_list, &scheduler->high_priority_list);
+    aws_linked_list_move_all_back(&running_list, &scheduler->asap_list);
+
+    /* Next move tasks from the timed structures */
+    s_take_due_timed_tasks(scheduler, current_time, &running_list);
+
+    /* Background tasks go last */
+    aws_linked_list_move_all_back(&running_list, &scheduler->background_list);
 
     /* Run tasks */
     while (!aws_linked_list_empty(&running_list)) {
         struct aws_linked_list_node *task_node = aws_linked_list_pop_front(&running_list);
+        --scheduler->task_count;
         struct aws_task *task = AWS_CONTAINER_OF(task_node, struct aws_task, node);
-        aws_task_run(task, status);
+        s_run_task(scheduler, task, status);
+    }
+}
+
+/* Picks the priority lane to take the next task from, using smooth weighted round robin over the lanes that have
+ * tasks. Lanes with weight 0 only get picked when no weighted lane has tasks. Returns AWS_TASK_PRIORITY_COUNT if every
+ * lane is empty. */
+static enum aws_task_priority s_pick_lane(
+    const struct aws_task_scheduler *scheduler,
+    const bool *lane_has_tasks,
+    int64_t *credits) {
+
+    int64_t total_weight = 0;
+    enum aws_task_priority picked = AWS_TASK_PRIORITY_COUNT;
+    for (int lane = 0; lane < AWS_TASK_PRIORITY_COUNT; ++lane) {
+        uint32_t weight = scheduler->priority_weights[lane];
+        if (!lane_has_tasks[lane] || weight == 0) {
+            continue;
+        }
+
+        credits[lane] += weight;
+        total_weight += weight;
+        if (picked == AWS_TASK_PRIORITY_COUNT || credits[lane] > credits[picked]) {
+            picked = (enum aws_task_priority)lane;
+        }
+    }
+
+    if (picked != AWS_TASK_PRIORITY_COUNT) {
+        credits[picked] -= total_weight;
+        return picked;
+    }
+
+    for (int lane = 0; lane < AWS_TASK_PRIORITY_COUNT; ++lane) {
+        if (lane_has_tasks[lane]) {
+            return (enum aws_task_priority)lane;
+        }
+    }
+
+    return AWS_TASK_PRIORITY_COUNT;
+}
+
+bool aws_task_scheduler_run_some(
+    struct aws_task_scheduler *scheduler,
+    uint64_t current_time,
+    size_t max_tasks,
+    uint64_t max_nanos) {
+    AWS_ASSERT(scheduler);
+
+    uint64_t start_time = 0;
+    if (max_nanos) {
+        aws_high_res_clock_get_ticks(&start_time);
+    }
+
+    /* Same snapshot as s_run_all(), but every lane is kept apart so that they can take turns. Due timed tasks are part
+     * of the normal lane, where they alternate with asap_list. */
+    struct aws_linked_list lanes[AWS_TASK_PRIORITY_COUNT];
+    for (int lane = 0; lane < AWS_TASK_PRIORITY_COUNT; ++lane) {
+        aws_linked_list_init(&lanes[lane]);
+        aws_linked_list_swap_contents(&lanes[lane], s_asap_list_for_priority(scheduler, (enum aws_task_priority)lane));
+    }
+
+    struct aws_linked_list timed_running;
+    aws_linked_list_init(&timed_running);
+    s_take_due_timed_tasks(scheduler, current_time, &timed_running);
+
+    int64_t credits[AWS_TASK_PRIORITY_COUNT] = {0};
+    size_t tasks_run = 0;
+    bool take_timed = false;
+    /* the first task runs regardless of the time budget, so that a budget smaller than the clock's resolution (or than
+     * the time it takes to get here) can't keep a caller from ever making progress */
+    while (!(max_tasks && tasks_run >= max_tasks) && (tasks_run == 0 || !s_budget_exceeded(start_time, max_nanos))) {
+        bool lane_has_tasks[AWS_TASK_PRIORITY_COUNT];
+        for (int lane = 0; lane < AWS_TASK_PRIORITY_COUNT; ++lane) {
+            lane_has_tasks[lane] = !aws_linked_list_empty(&lanes[lane]);
+        }
+        lane_has_tasks[AWS_TASK_PRIORITY_NORMAL] |= !aws_linked_list_empty(&timed_running);
+
+        enum aws_task_priority lane = s_pick_lane(scheduler, lane_has_tasks, credits);
+        if (lane == AWS_TASK_PRIORITY_COUNT) {
+            break;
+        }
+
+        struct aws_linked_list *source = &lanes[lane];
+        if (lane == AWS_TASK_PRIORITY_NORMAL) {
+            source = take_timed ? &timed_running : &lanes[lane];
+            if (aws_linked_list_empty(source)) {
+                source = take_timed ? &lanes[lane] : &timed_running;
+            }
+            take_timed = !take_timed;
+        }
+
+        struct aws_linked_list_node *task_node = aws_linked_list_pop_front(source);
+        --scheduler->task_count;
+        s_run_task(scheduler, AWS_CONTAINER_OF(task_node, struct aws_task, node), AWS_TASK_STATUS_RUN_READY);
+        ++tasks_run;
     }
+
+    /* Whatever didn't fit in the budget is overdue, so it goes back to the front of its lane, ahead of anything
+     * scheduled while running. Overdue timed tasks go first, since they've been waiting the longest. */
+    for (int lane = 0; lane < AWS_TASK_PRIORITY_COUNT; ++lane) {
+        aws_linked_list_move_all_front(s_asap_list_for_priority(scheduler, (enum aws_task_priority)lane), &lanes[lane]);
+    }
+    aws_linked_list_move_all_front(&scheduler->asap_list, &timed_running);
+
+    uint64_t next_task_time = 0;
+    return aws_task_scheduler_has_tasks(scheduler, &next_task_time) && next_task_time <= current_time;
+}
+
+size_t aws_task_scheduler_get_task_count(const struct aws_task_scheduler *scheduler) {
+    AWS_PRECONDITION(aws_task_scheduler_is_valid(scheduler));
+    return scheduler->task_count;
+}
+
+/* Tasks that never went through aws_task_init() or a schedule call, such as zeroed ones, can have any index in their
+ * priority_queue_node, so the index alone can't be trusted: the queue has to point back at the task too. */
+static bool s_is_in_timed_queue(const struct aws_task_scheduler *scheduler, const struct aws_task *task) {
+    size_t index = task->priority_queue_node.current_index;
+    const struct aws_array_list *backpointers = &scheduler->timed_queue.backpointers;
+    if (index >= aws_priority_queue_size(&scheduler->timed_queue) || index >= aws_array_list_length(backpointers)) {
+        return false;
+    }
+
+    struct aws_priority_queue_node *backpointer = NULL;
+    aws_array_list_get_at(backpointers, &backpointer, index);
+    return backpointer == &task->priority_queue_node;
 }
 
 void aws_task_scheduler_cancel_task(struct aws_task_scheduler *scheduler, struct aws_task *task) {
@@ -256,12 +826,40 @@ void aws_task_scheduler_cancel_task(struct aws_task_scheduler *scheduler, struct
      */
     if (task->node.next) {
         aws_linked_list_remove(&task->node);
-    } else if (task->abi_extension.scheduled) {
+        --scheduler->task_count;
+    } else if (s_is_in_timed_queue(scheduler, task)) {
         aws_priority_queue_remove(&scheduler->timed_queue, &task, &task->priority_queue_node);
+        --scheduler->task_count;
     }
 
     /*
      * No need to log cancellation specially; it will get logged during the run call with the canceled status
      */
-    aws_task_run(task, AWS_TASK_STATUS_CANCELED);
+    s_run_task(scheduler, task, AWS_TASK_STATUS_CANCELED);
+}
+
+int aws_task_scheduler_get_stats(const struct aws_task_scheduler *scheduler, struct aws_array_list *stats_list) {
+    AWS_PRECONDITION(aws_task_scheduler_is_valid(scheduler));
+    AWS_PRECONDITION(stats_list && stats_list->item_size == sizeof(struct aws_task_type_stats));
+
+    if (!scheduler->stats) {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    for (struct aws_hash_iter iter = aws_hash_iter_begin(&scheduler->stats->by_type_tag); !aws_hash_iter_done(&iter);
+         aws_hash_iter_next(&iter)) {
+        if (aws_array_list_push_back(stats_list, iter.element.value)) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_task_scheduler_reset_stats(struct aws_task_scheduler *scheduler) {
+    AWS_PRECONDITION(aws_task_scheduler_is_valid(scheduler));
+
+    if (scheduler->stats) {
+        s_stats_clear(scheduler->stats);
+    }
 }
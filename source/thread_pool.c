@@ -0,0 +1,452 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/common/thread_pool.h>
+
+#include <aws/common/atomics.h>
+#include <aws/common/condition_variable.h>
+#include <aws/common/math.h>
+#include <aws/common/mutex.h>
+#include <aws/common/private/thread_shared.h>
+#include <aws/common/ref_count.h>
+#include <aws/common/system_info.h>
+#include <aws/common/task_scheduler.h>
+#include <aws/common/thread.h>
+
+/* Max number of tasks a worker moves from the shared queue into its own deque in one go. */
+#define INJECTION_BATCH_SIZE 16
+
+/*
+ * Each worker owns a fixed-size Chase-Lev deque ("Dynamic Circular Work-Stealing Deque", Chase & Lev 2005, with the
+ * memory orderings from Le et al. 2013). The owner pushes and pops at the bottom, thieves take from the top. The deque
+ * does not grow: when it is full, submissions from the owner go to the shared queue instead, which avoids having to
+ * reclaim old buffers while thieves may still be reading them.
+ */
+struct aws_thread_pool_worker {
+    struct aws_thread_pool *pool;
+    struct aws_thread thread;
+    struct aws_atomic_var *slots;
+    size_t mask;
+    uint64_t steal_seed;
+
+    /* top is written by thieves and bottom by the owner, keep them on separate cache lines. */
+    uint8_t top_padding[AWS_CACHE_LINE];
+    struct aws_atomic_var top;
+    uint8_t bottom_padding[AWS_CACHE_LINE - sizeof(struct aws_atomic_var)];
+    struct aws_atomic_var bottom;
+};
+
+struct aws_thread_pool {
+    struct aws_allocator *allocator;
+    struct aws_ref_count ref_count;
+    struct aws_thread_pool_worker *workers;
+    size_t worker_count;
+    size_t launched_count;
+    struct aws_atomic_var should_exit;
+    struct aws_atomic_var sleeping_count;
+    struct aws_atomic_var injection_queue_size;
+
+    struct {
+        struct aws_linked_list injection_queue;
+        struct aws_mutex mutex;
+        struct aws_condition_variable c_var;
+    } thread_data;
+};
+
+static AWS_THREAD_LOCAL struct aws_thread_pool_worker *tl_current_worker = NULL;
+
+/* Owner only. Returns false if the deque is full. */
+static bool s_deque_push(struct aws_thread_pool_worker *worker, struct aws_task *task) {
+    size_t bottom = aws_atomic_load_int_explicit(&worker->bottom, aws_memory_order_relaxed);
+    size_t top = aws_atomic_load_int_explicit(&worker->top, aws_memory_order_acquire);
+    if (bottom - top > worker->mask) {
+        return false;
+    }
+
+    aws_atomic_store_ptr_explicit(&worker->slots[bottom & worker->mask], task, aws_memory_order_relaxed);
+    aws_atomic_thread_fence(aws_memory_order_release);
+    aws_atomic_store_int_explicit(&worker->bottom, bottom + 1, aws_memory_order_relaxed);
+    return true;
+}
+
+/* Owner only. */
+static struct aws_task *s_deque_pop(struct aws_thread_pool_worker *worker) {
+    size_t bottom = aws_atomic_load_int_explicit(&worker->bottom, aws_memory_order_relaxed) - 1;
+    aws_atomic_store_int_explicit(&worker->bottom, bottom, aws_memory_order_relaxed);
+    aws_atomic_thread_fence(aws_memory_order_seq_cst);
+    size_t top = aws_atomic_load_int_explicit(&worker->top, aws_memory_order_relaxed);
+
+    /* indices only ever grow, so the signed difference is the number of items left, or -1 if the deque was empty */
+    if ((ptrdiff_t)(bottom - top) < 0) {
+        aws_atomic_store_int_explicit(&worker->bottom, bottom + 1, aws_memory_order_relaxed);
+        return NULL;
+    }
+
+    struct aws_task *task =
+        aws_atomic_load_ptr_explicit(&worker->slots[bottom & worker->mask], aws_memory_order_relaxed);
+    if (bottom == top) {
+        /* last item, race the thieves for it */
+        if (!aws_atomic_compare_exchange_int_explicit(
+                &worker->top, &top, top + 1, aws_memory_order_seq_cst, aws_memory_order_relaxed)) {
+            task = NULL;
+        }
+        aws_atomic_store_int_explicit(&worker->bottom, bottom + 1, aws_memory_order_relaxed);
+    }
+
+    return task;
+}
+
+/* Any thread. May return NULL if it lost a race even though the deque is not empty. */
+static struct aws_task *s_deque_steal(struct aws_thread_pool_worker *worker) {
+    size_t top = aws_atomic_load_int_explicit(&worker->top, aws_memory_order_acquire);
+    aws_atomic_thread_fence(aws_memory_order_seq_cst);
+    size_t bottom = aws_atomic_load_int_explicit(&worker->bottom, aws_memory_order_acquire);
+
+    if ((ptrdiff_t)(bottom - top) <= 0) {
+        return NULL;
+    }
+
+    struct aws_task *task = aws_atomic_load_ptr_explicit(&worker->slots[top & worker->mask], aws_memory_order_relaxed);
+    if (!aws_atomic_compare_exchange_int_explicit(
+            &worker->top, &top, top + 1, aws_memory_order_seq_cst, aws_memory_order_relaxed)) {
+        return NULL;
+    }
+
+    return task;
+}
+
+static bool s_deque_is_empty(struct aws_thread_pool_worker *worker) {
+    size_t top = aws_atomic_load_int(&worker->top);
+    size_t bottom = aws_atomic_load_int(&worker->bottom);
+    return (ptrdiff_t)(bottom - top) <= 0;
+}
+
+static bool s_has_work(struct aws_thread_pool *pool) {
+    if (aws_atomic_load_int(&pool->injection_queue_size) > 0) {
+        return true;
+    }
+
+    for (size_t i = 0; i < pool->worker_count; ++i) {
+        if (!s_deque_is_empty(&pool->workers[i])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Called after making work available. Only takes the lock if some worker may be asleep. */
+static void s_wake_one(struct aws_thread_pool *pool) {
+    /* pairs with the increment of sleeping_count in s_park(): either we see the sleeper, or it sees the work. */
+    aws_atomic_thread_fence(aws_memory_order_seq_cst);
+    if (aws_atomic_load_int(&pool->sleeping_count) == 0) {
+        return;
+    }
+
+    AWS_FATAL_ASSERT(!aws_mutex_lock(&pool->thread_data.mutex) && "mutex lock failed!");
+    aws_condition_variable_notify_one(&pool->thread_data.c_var);
+    AWS_FATAL_ASSERT(!aws_mutex_unlock(&pool->thread_data.mutex) && "mutex unlock failed!");
+}
+
+/* Takes one task from the shared queue to run and moves a small batch more into the worker's own deque, where its
+ * peers can steal them. */
+static struct aws_task *s_take_injected(struct aws_thread_pool_worker *worker) {
+    struct aws_thread_pool *pool = worker->pool;
+    if (aws_atomic_load_int(&pool->injection_queue_size) == 0) {
+        return NULL;
+    }
+
+    struct aws_task *task = NULL;
+    size_t moved = 0;
+
+    AWS_FATAL_ASSERT(!aws_mutex_lock(&pool->thread_data.mutex) && "mutex lock failed!");
+    struct aws_linked_list *queue = &pool->thread_data.injection_queue;
+    if (!aws_linked_list_empty(queue)) {
+        task = AWS_CONTAINER_OF(aws_linked_list_pop_front(queue), struct aws_task, node);
+        ++moved;
+
+        while (moved < INJECTION_BATCH_SIZE && !aws_linked_list_empty(queue)) {
+            struct aws_task *next = AWS_CONTAINER_OF(aws_linked_list_front(queue), struct aws_task, node);
+            if (!s_deque_push(worker, next)) {
+                break;
+            }
+            aws_linked_list_pop_front(queue);
+            ++moved;
+        }
+        aws_atomic_fetch_sub(&pool->injection_queue_size, moved);
+    }
+    AWS_FATAL_ASSERT(!aws_mutex_unlock(&pool->thread_data.mutex) && "mutex unlock failed!");
+
+    if (moved > 1) {
+        s_wake_one(pool);
+    }
+
+    return task;
+}
+
+static struct aws_task *s_steal(struct aws_thread_pool_worker *worker) {
+    struct aws_thread_pool *pool = worker->pool;
+    if (pool->worker_count < 2) {
+        return NULL;
+    }
+
+    /* xorshift, so that idle workers don't all go after the same victim */
+    uint64_t seed = worker->steal_seed;
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    worker->steal_seed = seed;
+
+    size_t start = (size_t)(seed % pool->worker_count);
+    for (size_t i = 0; i < pool->worker_count; ++i) {
+        struct aws_thread_pool_worker *victim = &pool->workers[(start + i) % pool->worker_count];
+        if (victim == worker) {
+            continue;
+        }
+
+        struct aws_task *task = s_deque_steal(victim);
+        if (task) {
+            return task;
+        }
+    }
+
+    return NULL;
+}
+
+static bool s_worker_should_wake(void *arg) {
+    struct aws_thread_pool *pool = arg;
+    return aws_atomic_load_int(&pool->should_exit) || s_has_work(pool);
+}
+
+static void s_park(struct aws_thread_pool_worker *worker) {
+    struct aws_thread_pool *pool = worker->pool;
+
+    AWS_FATAL_ASSERT(!aws_mutex_lock(&pool->thread_data.mutex) && "mutex lock failed!");
+    aws_atomic_fetch_add(&pool->sleeping_count, 1);
+    aws_condition_variable_wait_pred(&pool->thread_data.c_var, &pool->thread_data.mutex, s_worker_should_wake, pool);
+    aws_atomic_fetch_sub(&pool->sleeping_count, 1);
+    AWS_FATAL_ASSERT(!aws_mutex_unlock(&pool->thread_data.mutex) && "mutex unlock failed!");
+}
+
+static void s_worker_fn(void *arg) {
+    struct aws_thread_pool_worker *worker = arg;
+    struct aws_thread_pool *pool = worker->pool;
+    tl_current_worker = worker;
+
+    while (!aws_atomic_load_int(&pool->should_exit)) {
+        struct aws_task *task = s_deque_pop(worker);
+        if (!task) {
+            task = s_take_injected(worker);
+        }
+        if (!task) {
+            task = s_steal(worker);
+        }
+
+        if (task) {
+            aws_task_run(task, AWS_TASK_STATUS_RUN_READY);
+        } else {
+            s_park(worker);
+        }
+    }
+
+    tl_current_worker = NULL;
+}
+
+/* Runs everything still queued with a canceled status. Only called once all workers have been joined. Canceled tasks
+ * may submit more tasks, so keep going until everything is empty. */
+static void s_cancel_pending_tasks(struct aws_thread_pool *pool) {
+    bool found = true;
+    while (found) {
+        found = false;
+
+        for (size_t i = 0; i < pool->worker_count; ++i) {
+            struct aws_task *task = NULL;
+            while ((task = s_deque_pop(&pool->workers[i])) != NULL) {
+                found = true;
+                aws_task_run(task, AWS_TASK_STATUS_CANCELED);
+            }
+        }
+
+        struct aws_linked_list cancel_list;
+        aws_linked_list_init(&cancel_list);
+        AWS_FATAL_ASSERT(!aws_mutex_lock(&pool->thread_data.mutex) && "mutex lock failed!");
+        aws_linked_list_swap_contents(&pool->thread_data.injection_queue, &cancel_list);
+        aws_atomic_store_int(&pool->injection_queue_size, 0);
+        AWS_FATAL_ASSERT(!aws_mutex_unlock(&pool->thread_data.mutex) && "mutex unlock failed!");
+
+        while (!aws_linked_list_empty(&cancel_list)) {
+            found = true;
+            struct aws_task *task = AWS_CONTAINER_OF(aws_linked_list_pop_front(&cancel_list), struct aws_task, node);
+            aws_task_run(task, AWS_TASK_STATUS_CANCELED);
+        }
+    }
+}
+
+static void s_thread_pool_destroy(struct aws_thread_pool *pool) {
+    aws_atomic_store_int(&pool->should_exit, 1U);
+    AWS_FATAL_ASSERT(!aws_mutex_lock(&pool->thread_data.mutex) && "mutex lock failed!");
+    aws_condition_variable_notify_all(&pool->thread_data.c_var);
+    AWS_FATAL_ASSERT(!aws_mutex_unlock(&pool->thread_data.mutex) && "mutex unlock failed!");
+
+    for (size_t i = 0; i < pool->launched_count; ++i) {
+        aws_thread_join(&pool->workers[i].thread);
+    }
+
+    s_cancel_pending_tasks(pool);
+
+    for (size_t i = 0; i < pool->worker_count; ++i) {
+        aws_thread_clean_up(&pool->workers[i].thread);
+        aws_mem_release(pool->allocator, pool->workers[i].slots);
+    }
+
+    aws_condition_variable_clean_up(&pool->thread_data.c_var);
+    aws_mutex_clean_up(&pool->thread_data.mutex);
+    aws_mem_release(pool->allocator, pool->workers);
+    aws_mem_release(pool->allocator, pool);
+}
+
+static void s_destroy_callback(void *arg) {
+    struct aws_thread_pool *pool = arg;
+    AWS_FATAL_ASSERT(
+        (tl_current_worker == NULL || tl_current_worker->pool != pool) &&
+        "the last reference to a thread pool cannot be released from one of its workers");
+    s_thread_pool_destroy(pool);
+}
+
+struct aws_thread_pool *aws_thread_pool_new(
+    struct aws_allocator *allocator,
+    const struct aws_thread_pool_options *options) {
+    AWS_PRECONDITION(allocator);
+
+    struct aws_thread_pool_options default_options = {0};
+    if (!options) {
+        options = &default_options;
+    }
+
+    size_t worker_count = options->worker_count;
+    if (worker_count == 0) {
+        worker_count = aws_system_info_processor_count();
+        if (worker_count == 0) {
+            worker_count = 1;
+        }
+    }
+
+    size_t deque_capacity = options->deque_capacity ? options->deque_capacity : AWS_THREAD_POOL_DEFAULT_DEQUE_CAPACITY;
+    if (aws_round_up_to_power_of_two(deque_capacity, &deque_capacity)) {
+        return NULL;
+    }
+
+    struct aws_thread_pool *pool = aws_mem_calloc(allocator, 1, sizeof(struct aws_thread_pool));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->allocator = allocator;
+    pool->worker_count = worker_count;
+    aws_atomic_init_int(&pool->should_exit, 0U);
+    aws_atomic_init_int(&pool->sleeping_count, 0U);
+    aws_atomic_init_int(&pool->injection_queue_size, 0U);
+    aws_linked_list_init(&pool->thread_data.injection_queue);
+    AWS_FATAL_ASSERT(!aws_mutex_init(&pool->thread_data.mutex) && "mutex init failed!");
+    AWS_FATAL_ASSERT(!aws_condition_variable_init(&pool->thread_data.c_var) && "condition variable init failed!");
+
+    pool->workers = aws_mem_calloc(allocator, worker_count, sizeof(struct aws_thread_pool_worker));
+    if (!pool->workers) {
+        goto sync_init;
+    }
+
+    for (size_t i = 0; i < worker_count; ++i) {
+        struct aws_thread_pool_worker *worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->mask = deque_capacity - 1;
+        worker->steal_seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+        aws_atomic_init_int(&worker->top, 0U);
+        aws_atomic_init_int(&worker->bottom, 0U);
+        aws_thread_init(&worker->thread, allocator);
+
+        worker->slots = aws_mem_calloc(allocator, deque_capacity, sizeof(struct aws_atomic_var));
+        if (!worker->slots) {
+            goto destroy;
+        }
+    }
+
+    struct aws_thread_options thread_options = *aws_default_thread_options();
+    if (options->thread_options) {
+        thread_options = *options->thread_options;
+    }
+    if (thread_options.name.len == 0) {
+        thread_options.name = aws_byte_cursor_from_c_str("AwsThreadPool");
+    }
+
+    int32_t *cpu_ids = NULL;
+    size_t cpu_id_count = 0;
+    if (options->cpu_group) {
+        cpu_id_count = aws_thread_get_pinning_cpus_for_group(allocator, *options->cpu_group, &cpu_ids);
+    }
+
+    /* the ref count must be usable before any worker runs a task that may acquire it */
+    aws_ref_count_init(&pool->ref_count, pool, s_destroy_callback);
+
+    for (size_t i = 0; i < worker_count; ++i) {
+        if (cpu_id_count > 0) {
+            thread_options.cpu_id = cpu_ids[i % cpu_id_count];
+        }
+
+        if (aws_thread_launch(&pool->workers[i].thread, s_worker_fn, &pool->workers[i], &thread_options)) {
+            aws_mem_release(allocator, cpu_ids);
+            goto destroy;
+        }
+        ++pool->launched_count;
+    }
+
+    aws_mem_release(allocator, cpu_ids);
+    return pool;
+
+destroy:
+    /* s_thread_pool_destroy() expects every worker's thread to be initialized */
+    for (size_t i = 0; i < worker_count; ++i) {
+        if (pool->workers[i].thread.allocator == NULL) {
+            aws_thread_init(&pool->workers[i].thread, allocator);
+        }
+    }
+    s_thread_pool_destroy(pool);
+    return NULL;
+
+sync_init:
+    aws_condition_variable_clean_up(&pool->thread_data.c_var);
+    aws_mutex_clean_up(&pool->thread_data.mutex);
+    aws_mem_release(allocator, pool);
+    return NULL;
+}
+
+void aws_thread_pool_acquire(struct aws_thread_pool *pool) {
+    aws_ref_count_acquire(&pool->ref_count);
+}
+
+void aws_thread_pool_release(struct aws_thread_pool *pool) {
+    aws_ref_count_release(&pool->ref_count);
+}
+
+size_t aws_thread_pool_get_worker_count(const struct aws_thread_pool *pool) {
+    return pool->worker_count;
+}
+
+void aws_thread_pool_submit(struct aws_thread_pool *pool, struct aws_task *task) {
+    AWS_PRECONDITION(pool);
+    AWS_PRECONDITION(task);
+
+    struct aws_thread_pool_worker *worker = tl_current_worker;
+    if (worker && worker->pool == pool && s_deque_push(worker, task)) {
+        s_wake_one(pool);
+        return;
+    }
+
+    AWS_FATAL_ASSERT(!aws_mutex_lock(&pool->thread_data.mutex) && "mutex lock failed!");
+    aws_linked_list_push_back(&pool->thread_data.injection_queue, &task->node);
+    aws_atomic_fetch_add(&pool->injection_queue_size, 1);
+    if (aws_atomic_load_int(&pool->sleeping_count) > 0) {
+        aws_condition_variable_notify_one(&pool->thread_data.c_var);
+    }
+    AWS_FATAL_ASSERT(!aws_mutex_unlock(&pool->thread_data.mutex) && "mutex unlock failed!");
+}
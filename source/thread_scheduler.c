@@ -5,6 +5,8 @@
 #include <aws/common/clock.h>
 #include <aws/common/condition_variable.h>
 #include <aws/common/mutex.h>
+#include <aws/common/private/task_scheduler_impl.h>
+#include <aws/common/private/thread_scheduler_waiter.h>
 #include <aws/common/ref_count.h>
 #include <aws/common/task_scheduler.h>
 #include <aws/common/thread.h>
@@ -17,42 +19,170 @@ struct aws_thread_scheduler {
     struct aws_task_scheduler scheduler;
     struct aws_atomic_var should_exit;
 
+    /*
+     * Lock-free submission stack of aws_task.node, linked through node.next. Any thread pushes with a CAS, the
+     * scheduler thread takes everything at once with an exchange and reverses it back into submission order. Since
+     * nodes are never popped one at a time there is no ABA problem.
+     */
+    struct aws_atomic_var submission_head;
+
+    /*
+     * Lock-free stack of tasks to cancel. A task is linked through its own abi_extension.thread_scheduler_state, see
+     * task_scheduler_impl.h, so canceling neither allocates nor searches.
+     */
+    struct aws_atomic_var cancel_head;
+
+    /* Set by the scheduler thread while it waits on c_var, so that submitters only signal when there's someone to
+     * wake up. */
+    struct aws_atomic_var is_sleeping;
+
+    /* For aws_thread_scheduler_get_queue_depth(): tasks pushed on submission_head that the thread hasn't taken yet, and
+     * the task scheduler's task count as of the thread's last pass. */
+    struct aws_atomic_var submitted_count;
+    struct aws_atomic_var scheduled_count;
+
+    /* Timed tasks may run this late so that nearby timers share a wakeup, see aws_thread_scheduler_options */
+    uint64_t timer_slack_ns;
+
+    /* If set, the thread sleeps on this instead of thread_data.c_var */
+    struct aws_thread_scheduler_waiter *waiter;
+
     struct {
-        struct aws_linked_list scheduling_queue;
-        struct aws_linked_list cancel_queue;
         struct aws_mutex mutex;
         struct aws_condition_variable c_var;
     } thread_data;
 };
 
-struct cancellation_node {
-    struct aws_task *task_to_cancel;
-    struct aws_linked_list_node node;
-};
+static void s_push_submission(struct aws_thread_scheduler *scheduler, struct aws_task *task) {
+    aws_atomic_store_int(&task->abi_extension.thread_scheduler_state, AWS_TASK_THREAD_SCHEDULER_STATE_PENDING);
+
+    /* counted before the push, so that the thread never takes more than was counted */
+    aws_atomic_fetch_add_explicit(&scheduler->submitted_count, 1, aws_memory_order_relaxed);
+
+    void *head = aws_atomic_load_ptr_explicit(&scheduler->submission_head, aws_memory_order_relaxed);
+    do {
+        task->node.next = head;
+        task->node.prev = NULL;
+    } while (!aws_atomic_compare_exchange_ptr(&scheduler->submission_head, &head, &task->node));
+}
+
+static void s_publish_scheduled_count(struct aws_thread_scheduler *scheduler) {
+    aws_atomic_store_int_explicit(
+        &scheduler->scheduled_count,
+        aws_task_scheduler_get_task_count(&scheduler->scheduler),
+        aws_memory_order_relaxed);
+}
+
+/* Moves everything submitted so far into the task scheduler, oldest first. Only called from the scheduler thread. */
+static void s_schedule_submitted_tasks(struct aws_thread_scheduler *scheduler) {
+    struct aws_linked_list_node *node = aws_atomic_exchange_ptr(&scheduler->submission_head, NULL);
+
+    struct aws_linked_list submitted;
+    aws_linked_list_init(&submitted);
+    size_t submitted_count = 0;
+    while (node != NULL) {
+        struct aws_linked_list_node *next = node->next;
+        aws_linked_list_push_front(&submitted, node);
+        node = next;
+        ++submitted_count;
+    }
+
+    while (!aws_linked_list_empty(&submitted)) {
+        struct aws_linked_list_node *submitted_node = aws_linked_list_pop_front(&submitted);
+        struct aws_task *task = AWS_CONTAINER_OF(submitted_node, struct aws_task, node);
+
+        size_t expected = AWS_TASK_THREAD_SCHEDULER_STATE_PENDING;
+        if (!aws_atomic_compare_exchange_int(
+                &task->abi_extension.thread_scheduler_state, &expected, AWS_TASK_THREAD_SCHEDULER_STATE_QUEUED)) {
+            /* canceled before it got here, and nobody else holds it: it's unlinked and not in the task scheduler */
+            AWS_ASSERT(expected == AWS_TASK_THREAD_SCHEDULER_STATE_CANCELING);
+            aws_atomic_store_int(&task->abi_extension.thread_scheduler_state, AWS_TASK_THREAD_SCHEDULER_STATE_IDLE);
+            aws_task_scheduler_cancel_task(&scheduler->scheduler, task);
+            continue;
+        }
+
+        if (task->timestamp) {
+            aws_task_scheduler_schedule_future(&scheduler->scheduler, task, task->timestamp);
+        } else {
+            aws_task_scheduler_schedule_now(&scheduler->scheduler, task);
+        }
+    }
+
+    /* publish the new scheduled count first, so that readers may briefly see these tasks twice but never miss them */
+    s_publish_scheduled_count(scheduler);
+    aws_atomic_fetch_sub_explicit(&scheduler->submitted_count, submitted_count, aws_memory_order_relaxed);
+}
+
+/* Cancels every task on the stack taken from cancel_head. The tasks were QUEUED when they were canceled, so they are
+ * in the task scheduler, or were taken out of it to run. */
+static void s_cancel_tasks(struct aws_thread_scheduler *scheduler, struct aws_task *task) {
+    while (task != NULL) {
+        size_t state = aws_atomic_load_int(&task->abi_extension.thread_scheduler_state);
+        struct aws_task *next = (struct aws_task *)(state & ~AWS_TASK_THREAD_SCHEDULER_STATE_MASK);
+
+        /* this thread owns the task now, let aws_task_run() through */
+        aws_atomic_store_int(&task->abi_extension.thread_scheduler_state, AWS_TASK_THREAD_SCHEDULER_STATE_IDLE);
+        aws_task_scheduler_cancel_task(&scheduler->scheduler, task);
+        task = next;
+    }
+}
+
+/* Only QUEUED tasks go on the cancel stack, and only this thread makes tasks QUEUED, while moving them into the task
+ * scheduler. So every task on the stack is already in the task scheduler (or was taken out of it to run) by the time
+ * the stack is taken. Tasks canceled before that are run canceled while taking the submissions. */
+static void s_process_submissions_and_cancellations(struct aws_thread_scheduler *scheduler) {
+    struct aws_task *canceled = aws_atomic_exchange_ptr(&scheduler->cancel_head, NULL);
+    s_schedule_submitted_tasks(scheduler);
+    s_cancel_tasks(scheduler, canceled);
+}
 
 static void s_destroy_callback(void *arg) {
     struct aws_thread_scheduler *scheduler = arg;
     aws_atomic_store_int(&scheduler->should_exit, 1U);
-    aws_condition_variable_notify_all(&scheduler->thread_data.c_var);
+    if (scheduler->waiter) {
+        aws_thread_scheduler_waiter_wake(scheduler->waiter);
+    } else {
+        aws_condition_variable_notify_all(&scheduler->thread_data.c_var);
+    }
     aws_thread_join(&scheduler->thread);
+    /* hand anything that was submitted after the thread's last pass to the scheduler, so that it gets canceled. */
+    s_process_submissions_and_cancellations(scheduler);
     aws_task_scheduler_clean_up(&scheduler->scheduler);
+    aws_thread_scheduler_waiter_destroy(scheduler->waiter);
     aws_condition_variable_clean_up(&scheduler->thread_data.c_var);
     aws_mutex_clean_up(&scheduler->thread_data.mutex);
     aws_thread_clean_up(&scheduler->thread);
     aws_mem_release(scheduler->allocator, scheduler);
 }
 
+/* Returns when the thread should next run its tasks: the next task's time, rounded up to a multiple of the timer slack
+ * so that every timer in the same slack window fires in one wakeup. UINT64_MAX if there are no tasks. */
+static uint64_t s_next_wakeup_time(const struct aws_thread_scheduler *scheduler) {
+    uint64_t next_scheduled_task = 0;
+    aws_task_scheduler_has_tasks(&scheduler->scheduler, &next_scheduled_task);
+
+    uint64_t slack = scheduler->timer_slack_ns;
+    if (slack <= 1 || next_scheduled_task == 0) {
+        return next_scheduled_task;
+    }
+
+    uint64_t remainder = next_scheduled_task % slack;
+    if (remainder == 0) {
+        return next_scheduled_task;
+    }
+
+    return aws_add_u64_saturating(next_scheduled_task, slack - remainder);
+}
+
 static bool s_thread_should_wake(void *arg) {
     struct aws_thread_scheduler *scheduler = arg;
 
     uint64_t current_time = 0;
     aws_high_res_clock_get_ticks(&current_time);
 
-    uint64_t next_scheduled_task = 0;
-    aws_task_scheduler_has_tasks(&scheduler->scheduler, &next_scheduled_task);
     return aws_atomic_load_int(&scheduler->should_exit) ||
-           !aws_linked_list_empty(&scheduler->thread_data.scheduling_queue) ||
-           !aws_linked_list_empty(&scheduler->thread_data.cancel_queue) || (next_scheduled_task <= current_time);
+           aws_atomic_load_ptr(&scheduler->submission_head) != NULL ||
+           aws_atomic_load_ptr(&scheduler->cancel_head) != NULL || (s_next_wakeup_time(scheduler) <= current_time);
 }
 
 static void s_thread_fn(void *arg) {
@@ -60,58 +190,41 @@ static void s_thread_fn(void *arg) {
 
     while (!aws_atomic_load_int(&scheduler->should_exit)) {
 
-        /* move tasks from the mutex protected list to the scheduler. This is because we don't want to hold the lock
-         * for the scheduler during run_all and then try and acquire the lock from another thread to schedule something
-         * because that potentially would block the calling thread. */
-        struct aws_linked_list list_cpy;
-        aws_linked_list_init(&list_cpy);
-        struct aws_linked_list cancel_list_cpy;
-        aws_linked_list_init(&cancel_list_cpy);
-
-        AWS_FATAL_ASSERT(!aws_mutex_lock(&scheduler->thread_data.mutex) && "mutex lock failed!");
-        aws_linked_list_swap_contents(&scheduler->thread_data.scheduling_queue, &list_cpy);
-        aws_linked_list_swap_contents(&scheduler->thread_data.cancel_queue, &cancel_list_cpy);
-        AWS_FATAL_ASSERT(!aws_mutex_unlock(&scheduler->thread_data.mutex) && "mutex unlock failed!");
-
-        while (!aws_linked_list_empty(&list_cpy)) {
-            struct aws_linked_list_node *node = aws_linked_list_pop_front(&list_cpy);
-            struct aws_task *task = AWS_CONTAINER_OF(node, struct aws_task, node);
-            if (task->timestamp) {
-                aws_task_scheduler_schedule_future(&scheduler->scheduler, task, task->timestamp);
-            } else {
-                aws_task_scheduler_schedule_now(&scheduler->scheduler, task);
-            }
-        }
-
-        /* now cancel the tasks. */
-        while (!aws_linked_list_empty(&cancel_list_cpy)) {
-            struct aws_linked_list_node *node = aws_linked_list_pop_front(&cancel_list_cpy);
-            struct cancellation_node *cancellation_node = AWS_CONTAINER_OF(node, struct cancellation_node, node);
-            aws_task_scheduler_cancel_task(&scheduler->scheduler, cancellation_node->task_to_cancel);
-            aws_mem_release(scheduler->allocator, cancellation_node);
-        }
+        s_process_submissions_and_cancellations(scheduler);
 
         /* now run everything */
         uint64_t current_time = 0;
         aws_high_res_clock_get_ticks(&current_time);
         aws_task_scheduler_run_all(&scheduler->scheduler, current_time);
+        s_publish_scheduled_count(scheduler);
 
-        uint64_t next_scheduled_task = 0;
-        aws_task_scheduler_has_tasks(&scheduler->scheduler, &next_scheduled_task);
+        uint64_t next_wakeup = s_next_wakeup_time(scheduler);
 
         int64_t timeout = 0;
-        if (next_scheduled_task == UINT64_MAX) {
+        if (next_wakeup == UINT64_MAX) {
             /* at least wake up once per 30 seconds. */
             timeout = (int64_t)30 * (int64_t)AWS_TIMESTAMP_NANOS;
         } else {
-            timeout = (int64_t)(next_scheduled_task - current_time);
+            timeout = (int64_t)(next_wakeup - current_time);
         }
 
-        if (timeout > 0) {
+        if (timeout > 0 && scheduler->waiter) {
+            /* same handshake with s_notify_if_sleeping() as below, minus the mutex: a wakeup that lands between the
+             * predicate and the wait leaves the eventfd readable, so the wait returns right away. */
+            aws_atomic_store_int(&scheduler->is_sleeping, 1U);
+            if (!s_thread_should_wake(scheduler)) {
+                aws_thread_scheduler_waiter_wait(scheduler->waiter, (uint64_t)timeout);
+            }
+            aws_atomic_store_int(&scheduler->is_sleeping, 0U);
+        } else if (timeout > 0) {
             AWS_FATAL_ASSERT(!aws_mutex_lock(&scheduler->thread_data.mutex) && "mutex lock failed!");
 
+            /* pairs with the load in s_notify_if_sleeping(): the sequentially consistent store here and the push there
+             * guarantee that either the submitter sees the flag, or the predicate sees the submission. */
+            aws_atomic_store_int(&scheduler->is_sleeping, 1U);
             aws_condition_variable_wait_for_pred(
                 &scheduler->thread_data.c_var, &scheduler->thread_data.mutex, timeout, s_thread_should_wake, scheduler);
+            aws_atomic_store_int(&scheduler->is_sleeping, 0U);
             AWS_FATAL_ASSERT(!aws_mutex_unlock(&scheduler->thread_data.mutex) && "mutex unlock failed!");
         }
     }
@@ -120,6 +233,19 @@ static void s_thread_fn(void *arg) {
 struct aws_thread_scheduler *aws_thread_scheduler_new(
     struct aws_allocator *allocator,
     const struct aws_thread_options *thread_options) {
+    struct aws_thread_scheduler_options options = {.thread_options = thread_options};
+    return aws_thread_scheduler_new_with_options(allocator, &options);
+}
+
+struct aws_thread_scheduler *aws_thread_scheduler_new_with_options(
+    struct aws_allocator *allocator,
+    const struct aws_thread_scheduler_options *options) {
+    struct aws_thread_scheduler_options default_options;
+    AWS_ZERO_STRUCT(default_options);
+    if (!options) {
+        options = &default_options;
+    }
+
     struct aws_thread_scheduler *scheduler = aws_mem_calloc(allocator, 1, sizeof(struct aws_thread_scheduler));
 
     if (!scheduler) {
@@ -137,19 +263,44 @@ struct aws_thread_scheduler *aws_thread_scheduler_new(
         goto thread_init;
     }
 
+    switch (options->wakeup_backend) {
+        case AWS_THREAD_SCHEDULER_WAKEUP_BACKEND_EPOLL:
+            scheduler->waiter = aws_thread_scheduler_waiter_new(allocator);
+            if (!scheduler->waiter) {
+                goto scheduler_init;
+            }
+            break;
+
+        case AWS_THREAD_SCHEDULER_WAKEUP_BACKEND_DEFAULT:
+            /* NULL (on other platforms, or if we're out of fds) just means using the condition variable */
+            scheduler->waiter = aws_thread_scheduler_waiter_new(allocator);
+            if (!scheduler->waiter) {
+                aws_reset_error();
+            }
+            break;
+
+        default:
+            break;
+    }
+
     scheduler->allocator = allocator;
+    scheduler->timer_slack_ns = options->timer_slack_ns;
     aws_atomic_init_int(&scheduler->should_exit, 0U);
+    aws_atomic_init_ptr(&scheduler->submission_head, NULL);
+    aws_atomic_init_ptr(&scheduler->cancel_head, NULL);
+    aws_atomic_init_int(&scheduler->is_sleeping, 0U);
+    aws_atomic_init_int(&scheduler->submitted_count, 0U);
+    aws_atomic_init_int(&scheduler->scheduled_count, 0U);
     aws_ref_count_init(&scheduler->ref_count, scheduler, s_destroy_callback);
-    aws_linked_list_init(&scheduler->thread_data.scheduling_queue);
-    aws_linked_list_init(&scheduler->thread_data.cancel_queue);
 
-    if (aws_thread_launch(&scheduler->thread, s_thread_fn, scheduler, thread_options)) {
+    if (aws_thread_launch(&scheduler->thread, s_thread_fn, scheduler, options->thread_options)) {
         goto scheduler_init;
     }
 
     return scheduler;
 
 scheduler_init:
+    aws_thread_scheduler_waiter_destroy(scheduler->waiter);
     aws_task_scheduler_clean_up(&scheduler->scheduler);
 
 thread_init:
@@ -171,55 +322,66 @@ void aws_thread_scheduler_release(const struct aws_thread_scheduler *scheduler)
     aws_ref_count_release((struct aws_ref_count *)&scheduler->ref_count);
 }
 
+size_t aws_thread_scheduler_get_queue_depth(const struct aws_thread_scheduler *scheduler) {
+    return aws_atomic_load_int_explicit(&scheduler->submitted_count, aws_memory_order_relaxed) +
+           aws_atomic_load_int_explicit(&scheduler->scheduled_count, aws_memory_order_relaxed);
+}
+
+static void s_notify_if_sleeping(struct aws_thread_scheduler *scheduler) {
+    if (!aws_atomic_load_int(&scheduler->is_sleeping)) {
+        return;
+    }
+
+    if (scheduler->waiter) {
+        aws_thread_scheduler_waiter_wake(scheduler->waiter);
+        return;
+    }
+
+    /* taking the lock makes sure the thread is either already waiting or hasn't evaluated its predicate yet. */
+    AWS_FATAL_ASSERT(!aws_mutex_lock(&scheduler->thread_data.mutex) && "mutex lock failed!");
+    aws_condition_variable_notify_one(&scheduler->thread_data.c_var);
+    AWS_FATAL_ASSERT(!aws_mutex_unlock(&scheduler->thread_data.mutex) && "mutex unlock failed!");
+}
+
 void aws_thread_scheduler_schedule_future(
     struct aws_thread_scheduler *scheduler,
     struct aws_task *task,
     uint64_t time_to_run) {
     task->timestamp = time_to_run;
-    AWS_FATAL_ASSERT(!aws_mutex_lock(&scheduler->thread_data.mutex) && "mutex lock failed!");
-    aws_linked_list_push_back(&scheduler->thread_data.scheduling_queue, &task->node);
-    AWS_FATAL_ASSERT(!aws_mutex_unlock(&scheduler->thread_data.mutex) && "mutex unlock failed!");
-    aws_condition_variable_notify_one(&scheduler->thread_data.c_var);
+    s_push_submission(scheduler, task);
+    s_notify_if_sleeping(scheduler);
 }
 void aws_thread_scheduler_schedule_now(struct aws_thread_scheduler *scheduler, struct aws_task *task) {
     aws_thread_scheduler_schedule_future(scheduler, task, 0U);
 }
 
 void aws_thread_scheduler_cancel_task(struct aws_thread_scheduler *scheduler, struct aws_task *task) {
-    struct cancellation_node *cancellation_node =
-        aws_mem_calloc(scheduler->allocator, 1, sizeof(struct cancellation_node));
-    AWS_FATAL_ASSERT(cancellation_node && "allocation failed for cancellation node!");
-    AWS_FATAL_ASSERT(!aws_mutex_lock(&scheduler->thread_data.mutex) && "mutex lock failed!");
-    struct aws_task *found_task = NULL;
-
-    /* remove tasks that are still in the scheduling queue, but haven't made it to the scheduler yet. */
-    struct aws_linked_list_node *node = aws_linked_list_empty(&scheduler->thread_data.scheduling_queue)
-                                            ? NULL
-                                            : aws_linked_list_front(&scheduler->thread_data.scheduling_queue);
-    while (node != NULL) {
-        struct aws_task *potential_task = AWS_CONTAINER_OF(node, struct aws_task, node);
-
-        if (potential_task == task) {
-            found_task = potential_task;
-            break;
+    size_t state = aws_atomic_load_int(&task->abi_extension.thread_scheduler_state);
+    while (true) {
+        if (state != AWS_TASK_THREAD_SCHEDULER_STATE_PENDING && state != AWS_TASK_THREAD_SCHEDULER_STATE_QUEUED) {
+            /* the task already ran or started running, or someone else is canceling it. */
+            return;
         }
-
-        if (aws_linked_list_node_next_is_valid(node)) {
-            node = aws_linked_list_next(node);
-        } else {
-            node = NULL;
+        if (aws_atomic_compare_exchange_int(
+                &task->abi_extension.thread_scheduler_state, &state, AWS_TASK_THREAD_SCHEDULER_STATE_CANCELING)) {
+            break;
         }
     }
 
-    if (found_task) {
-        aws_linked_list_remove(&found_task->node);
+    if (state == AWS_TASK_THREAD_SCHEDULER_STATE_PENDING) {
+        /* the task may not even be linked on the submission stack yet. The thread runs it canceled when it takes it,
+         * and the submitter wakes the thread up for that. */
+        return;
     }
 
-    cancellation_node->task_to_cancel = task;
+    /* the task can no longer run with AWS_TASK_STATUS_RUN_READY, hand it to the thread to run it canceled. */
+    void *head = aws_atomic_load_ptr_explicit(&scheduler->cancel_head, aws_memory_order_relaxed);
+    do {
+        aws_atomic_store_int_explicit(
+            &task->abi_extension.thread_scheduler_state,
+            (size_t)head | AWS_TASK_THREAD_SCHEDULER_STATE_CANCELING,
+            aws_memory_order_relaxed);
+    } while (!aws_atomic_compare_exchange_ptr(&scheduler->cancel_head, &head, task));
 
-    /* regardless put it in the cancel queue so the thread can call the task with canceled status. */
-    aws_linked_list_push_back(&scheduler->thread_data.cancel_queue, &cancellation_node->node);
-    AWS_FATAL_ASSERT(!aws_mutex_unlock(&scheduler->thread_data.mutex) && "mutex unlock failed!");
-    /* notify so the loop knows to wakeup and process the cancellations. */
-    aws_condition_variable_notify_one(&scheduler->thread_data.c_var);
+    s_notify_if_sleeping(scheduler);
 }
@@ -0,0 +1,185 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+#include <aws/common/thread_scheduler_group.h>
+
+#include <aws/common/private/thread_shared.h>
+#include <aws/common/ref_count.h>
+#include <aws/common/system_info.h>
+#include <aws/common/thread.h>
+#include <aws/common/thread_scheduler.h>
+
+struct aws_thread_scheduler_group {
+    struct aws_allocator *allocator;
+    struct aws_ref_count ref_count;
+    size_t scheduler_count;
+    struct aws_thread_scheduler **schedulers;
+};
+
+static void s_thread_scheduler_group_destroy(struct aws_thread_scheduler_group *group) {
+    for (size_t i = 0; i < group->scheduler_count; ++i) {
+        if (group->schedulers[i]) {
+            aws_thread_scheduler_release(group->schedulers[i]);
+        }
+    }
+
+    aws_mem_release(group->allocator, group->schedulers);
+    aws_mem_release(group->allocator, group);
+}
+
+static void s_destroy_callback(void *arg) {
+    s_thread_scheduler_group_destroy(arg);
+}
+
+/* The splitmix64 finalizer: keys are often pointers or sequential ids, whose low bits alone would spread badly. */
+static size_t s_scheduler_index_for_key(const struct aws_thread_scheduler_group *group, uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xBF58476D1CE4E5B9ULL;
+    key ^= key >> 27;
+    key *= 0x94D049BB133111EBULL;
+    key ^= key >> 31;
+    return (size_t)(key % group->scheduler_count);
+}
+
+struct aws_thread_scheduler_group *aws_thread_scheduler_group_new(
+    struct aws_allocator *allocator,
+    const struct aws_thread_scheduler_group_options *options) {
+    AWS_PRECONDITION(allocator);
+
+    struct aws_thread_scheduler_group_options default_options;
+    AWS_ZERO_STRUCT(default_options);
+    if (!options) {
+        options = &default_options;
+    }
+
+    int32_t *cpu_ids = NULL;
+    size_t cpu_id_count = 0;
+    if (options->cpu_group) {
+        cpu_id_count = aws_thread_get_pinning_cpus_for_group(allocator, *options->cpu_group, &cpu_ids);
+    }
+
+    size_t scheduler_count = options->scheduler_count;
+    if (scheduler_count == 0) {
+        scheduler_count = cpu_id_count ? cpu_id_count : aws_system_info_processor_count();
+        if (scheduler_count == 0) {
+            scheduler_count = 1;
+        }
+    }
+
+    struct aws_thread_scheduler_group *group = aws_mem_calloc(allocator, 1, sizeof(struct aws_thread_scheduler_group));
+    if (!group) {
+        goto on_error;
+    }
+
+    group->allocator = allocator;
+    group->scheduler_count = scheduler_count;
+    aws_ref_count_init(&group->ref_count, group, s_destroy_callback);
+
+    group->schedulers = aws_mem_calloc(allocator, scheduler_count, sizeof(struct aws_thread_scheduler *));
+    if (!group->schedulers) {
+        goto on_error;
+    }
+
+    struct aws_thread_scheduler_options scheduler_options;
+    AWS_ZERO_STRUCT(scheduler_options);
+    if (options->scheduler_options) {
+        scheduler_options = *options->scheduler_options;
+    }
+
+    struct aws_thread_options thread_options = *aws_default_thread_options();
+    if (scheduler_options.thread_options) {
+        thread_options = *scheduler_options.thread_options;
+    }
+    if (thread_options.name.len == 0) {
+        thread_options.name = aws_byte_cursor_from_c_str("AwsSchedGroup");
+    }
+    scheduler_options.thread_options = &thread_options;
+
+    for (size_t i = 0; i < scheduler_count; ++i) {
+        if (cpu_id_count > 0) {
+            thread_options.cpu_id = cpu_ids[i % cpu_id_count];
+        }
+
+        group->schedulers[i] = aws_thread_scheduler_new_with_options(allocator, &scheduler_options);
+        if (!group->schedulers[i]) {
+            goto on_error;
+        }
+    }
+
+    aws_mem_release(allocator, cpu_ids);
+    return group;
+
+on_error:
+    aws_mem_release(allocator, cpu_ids);
+    if (group) {
+        if (group->schedulers) {
+            s_thread_scheduler_group_destroy(group);
+        } else {
+            aws_mem_release(allocator, group);
+        }
+    }
+    return NULL;
+}
+
+void aws_thread_scheduler_group_acquire(struct aws_thread_scheduler_group *group) {
+    aws_ref_count_acquire(&group->ref_count);
+}
+
+void aws_thread_scheduler_group_release(struct aws_thread_scheduler_group *group) {
+    aws_ref_count_release(&group->ref_count);
+}
+
+size_t aws_thread_scheduler_group_get_scheduler_count(const struct aws_thread_scheduler_group *group) {
+    return group->scheduler_count;
+}
+
+struct aws_thread_scheduler *aws_thread_scheduler_group_get_scheduler(
+    const struct aws_thread_scheduler_group *group,
+    size_t index) {
+    AWS_PRECONDITION(index < group->scheduler_count);
+    return group->schedulers[index];
+}
+
+struct aws_thread_scheduler *aws_thread_scheduler_group_get_scheduler_for_key(
+    const struct aws_thread_scheduler_group *group,
+    uint64_t key) {
+    return group->schedulers[s_scheduler_index_for_key(group, key)];
+}
+
+void aws_thread_scheduler_group_schedule_now(
+    struct aws_thread_scheduler_group *group,
+    uint64_t key,
+    struct aws_task *task) {
+    aws_thread_scheduler_schedule_now(aws_thread_scheduler_group_get_scheduler_for_key(group, key), task);
+}
+
+void aws_thread_scheduler_group_schedule_future(
+    struct aws_thread_scheduler_group *group,
+    uint64_t key,
+    struct aws_task *task,
+    uint64_t time_to_run) {
+    aws_thread_scheduler_schedule_future(
+        aws_thread_scheduler_group_get_scheduler_for_key(group, key), task, time_to_run);
+}
+
+void aws_thread_scheduler_group_cancel_task(
+    struct aws_thread_scheduler_group *group,
+    uint64_t key,
+    struct aws_task *task) {
+    aws_thread_scheduler_cancel_task(aws_thread_scheduler_group_get_scheduler_for_key(group, key), task);
+}
+
+void aws_thread_scheduler_group_get_metrics(
+    const struct aws_thread_scheduler_group *group,
+    struct aws_thread_scheduler_group_metrics *metrics) {
+    AWS_ZERO_STRUCT(*metrics);
+    for (size_t i = 0; i < group->scheduler_count; ++i) {
+        size_t depth = aws_thread_scheduler_get_queue_depth(group->schedulers[i]);
+        metrics->total_queue_depth += depth;
+        if (depth > metrics->max_queue_depth) {
+            metrics->max_queue_depth = depth;
+            metrics->max_queue_depth_index = i;
+        }
+    }
+}
@@ -9,6 +9,7 @@
 #include <aws/common/condition_variable.h>
 #include <aws/common/linked_list.h>
 #include <aws/common/mutex.h>
+#include <aws/common/system_info.h>
 
 /*
  * lock guarding the unjoined thread count and pending join list
@@ -165,3 +166,38 @@ void aws_thread_pending_join_add(struct aws_linked_list_node *node) {
 void aws_thread_initialize_thread_management(void) {
     aws_linked_list_init(&s_pending_join_managed_threads);
 }
+
+size_t aws_thread_get_pinning_cpus_for_group(struct aws_allocator *allocator, uint16_t cpu_group, int32_t **cpu_ids) {
+    *cpu_ids = NULL;
+    size_t cpu_count = aws_get_cpu_count_for_group(cpu_group);
+    if (cpu_count == 0) {
+        return 0;
+    }
+
+    struct aws_cpu_info *cpu_infos = aws_mem_calloc(allocator, cpu_count, sizeof(struct aws_cpu_info));
+    *cpu_ids = aws_mem_calloc(allocator, cpu_count, sizeof(int32_t));
+    if (!cpu_infos || !*cpu_ids) {
+        aws_mem_release(allocator, cpu_infos);
+        aws_mem_release(allocator, *cpu_ids);
+        *cpu_ids = NULL;
+        return 0;
+    }
+
+    aws_get_cpu_ids_for_group(cpu_group, cpu_infos, cpu_count);
+
+    size_t usable = 0;
+    for (size_t i = 0; i < cpu_count; ++i) {
+        if (!cpu_infos[i].suspected_hyper_thread) {
+            (*cpu_ids)[usable++] = cpu_infos[i].cpu_id;
+        }
+    }
+
+    if (usable == 0) {
+        for (size_t i = 0; i < cpu_count; ++i) {
+            (*cpu_ids)[usable++] = cpu_infos[i].cpu_id;
+        }
+    }
+
+    aws_mem_release(allocator, cpu_infos);
+    return usable;
+}
@@ -0,0 +1,119 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/private/mapped_file.h>
+
+#include <aws/common/logging.h>
+#include <aws/common/string.h>
+
+#include <windows.h>
+
+int aws_mapped_file_open(struct aws_mapped_file *file, const struct aws_string *path, uint64_t *out_size) {
+    AWS_ZERO_STRUCT(*file);
+
+    if (path == NULL || path->len == 0) {
+        return aws_raise_error(AWS_ERROR_FILE_INVALID_PATH);
+    }
+
+    struct aws_wstring *w_path = aws_string_convert_to_wstring(aws_default_allocator(), path);
+    if (!w_path) {
+        return AWS_OP_ERR;
+    }
+    HANDLE handle = CreateFileW(
+        aws_wstring_c_str(w_path),
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+    aws_wstring_destroy(w_path);
+
+    if (handle == INVALID_HANDLE_VALUE) {
+        DWORD error = GetLastError();
+        AWS_LOGF_ERROR(
+            AWS_LS_COMMON_IO,
+            "static: Failed to open file for mapping. path:'%s' error:%lu",
+            aws_string_c_str(path),
+            (unsigned long)error);
+        if (error == ERROR_ACCESS_DENIED) {
+            return aws_raise_error(AWS_ERROR_NO_PERMISSION);
+        }
+        if (error == ERROR_PATH_NOT_FOUND) {
+            return aws_raise_error(AWS_ERROR_FILE_INVALID_PATH);
+        }
+        return aws_raise_error(AWS_ERROR_FILE_OPEN_FAILURE);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size)) {
+        CloseHandle(handle);
+        return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    }
+
+    file->handle = handle;
+    *out_size = (uint64_t)size.QuadPart;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_mapped_file_map(struct aws_mapped_file *file, size_t size) {
+    AWS_PRECONDITION(size > 0);
+
+    if (file->data) {
+        UnmapViewOfFile(file->data);
+        file->data = NULL;
+        file->size = 0;
+    }
+
+    LARGE_INTEGER current_size;
+    if (!GetFileSizeEx(file->handle, &current_size)) {
+        return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    }
+
+    /* a mapping larger than the file grows the file, a mapping size of 0 means the whole file */
+    uint64_t mapping_size = (uint64_t)current_size.QuadPart < size ? (uint64_t)size : 0;
+    HANDLE mapping = CreateFileMappingW(
+        file->handle, NULL, PAGE_READWRITE, (DWORD)(mapping_size >> 32), (DWORD)(mapping_size & 0xFFFFFFFF), NULL);
+    if (!mapping) {
+        AWS_LOGF_ERROR(
+            AWS_LS_COMMON_IO, "static: Failed to create file mapping, error %lu", (unsigned long)GetLastError());
+        return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    }
+
+    /* the view keeps the mapping object alive */
+    void *data = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+    CloseHandle(mapping);
+    if (!data) {
+        AWS_LOGF_ERROR(
+            AWS_LS_COMMON_IO,
+            "static: Failed to map %zu bytes of file, error %lu",
+            size,
+            (unsigned long)GetLastError());
+        return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    }
+
+    file->data = data;
+    file->size = size;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_mapped_file_sync(struct aws_mapped_file *file, size_t offset, size_t length) {
+    AWS_PRECONDITION(offset + length <= file->size);
+
+    /* FlushViewOfFile() only starts the writes, FlushFileBuffers() waits for them */
+    if (!FlushViewOfFile(file->data + offset, length) || !FlushFileBuffers(file->handle)) {
+        return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_mapped_file_close(struct aws_mapped_file *file) {
+    if (file->data) {
+        UnmapViewOfFile(file->data);
+    }
+    CloseHandle(file->handle);
+    AWS_ZERO_STRUCT(*file);
+}
@@ -0,0 +1,347 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_buf_pool.h>
+
+#include <aws/common/atomics.h>
+#include <aws/common/thread.h>
+#include <aws/testing/aws_test_harness.h>
+
+/* The test's own thread isn't an aws_thread, so everything here goes through the shared free lists. */
+static int s_byte_buf_pool_reuses_buffers(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_buf_pool *pool = aws_byte_buf_pool_new(allocator, NULL);
+    ASSERT_NOT_NULL(pool);
+
+    struct aws_byte_buf buf;
+    ASSERT_SUCCESS(aws_byte_buf_pool_acquire_buf(pool, 5000, &buf));
+    ASSERT_UINT_EQUALS(8192, buf.capacity);
+    ASSERT_UINT_EQUALS(0, buf.len);
+    ASSERT_PTR_EQUALS(allocator, buf.allocator);
+    ASSERT_TRUE(aws_byte_buf_write_u8_n(&buf, 'a', buf.capacity));
+    uint8_t *memory = buf.buffer;
+    aws_byte_buf_pool_release_buf(pool, &buf);
+    ASSERT_NULL(buf.buffer);
+
+    /* same size class, same memory */
+    ASSERT_SUCCESS(aws_byte_buf_pool_acquire_buf(pool, 8192, &buf));
+    ASSERT_PTR_EQUALS(memory, buf.buffer);
+    ASSERT_UINT_EQUALS(0, buf.len);
+    aws_byte_buf_pool_release_buf(pool, &buf);
+
+    /* small requests get the smallest size class, which is a miss here */
+    ASSERT_SUCCESS(aws_byte_buf_pool_acquire_buf(pool, 0, &buf));
+    ASSERT_UINT_EQUALS(AWS_BYTE_BUF_POOL_DEFAULT_MIN_BUFFER_SIZE, buf.capacity);
+    aws_byte_buf_pool_release_buf(pool, &buf);
+
+    /* requests past the largest size class aren't pooled */
+    ASSERT_SUCCESS(aws_byte_buf_pool_acquire_buf(pool, AWS_BYTE_BUF_POOL_DEFAULT_MAX_BUFFER_SIZE + 1, &buf));
+    ASSERT_UINT_EQUALS(AWS_BYTE_BUF_POOL_DEFAULT_MAX_BUFFER_SIZE + 1, buf.capacity);
+    aws_byte_buf_pool_release_buf(pool, &buf);
+    ASSERT_NULL(buf.buffer);
+
+    /* releasing a zeroed buffer does nothing */
+    aws_byte_buf_pool_release_buf(pool, &buf);
+
+    struct aws_byte_buf_pool_stats stats;
+    aws_byte_buf_pool_get_stats(pool, &stats);
+    ASSERT_UINT_EQUALS(4, stats.acquire_count);
+    ASSERT_UINT_EQUALS(1, stats.hit_count);
+    ASSERT_UINT_EQUALS(0, stats.thread_cache_hit_count);
+    ASSERT_UINT_EQUALS(4, stats.release_count);
+    ASSERT_UINT_EQUALS(1, stats.discard_count);
+    ASSERT_UINT_EQUALS(8192 + AWS_BYTE_BUF_POOL_DEFAULT_MIN_BUFFER_SIZE, stats.retained_bytes);
+
+    aws_byte_buf_pool_release(pool);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(byte_buf_pool_reuses_buffers, s_byte_buf_pool_reuses_buffers)
+
+static int s_check_max_retained_bytes(struct aws_allocator *allocator) {
+    struct aws_byte_buf_pool_options options = {
+        .min_buffer_size = 1000,
+        .max_buffer_size = 4096,
+        .max_retained_bytes = 4 * 1024,
+    };
+    struct aws_byte_buf_pool *pool = aws_byte_buf_pool_new(allocator, &options);
+    ASSERT_NOT_NULL(pool);
+
+    struct aws_byte_buf bufs[5];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(bufs); ++i) {
+        ASSERT_SUCCESS(aws_byte_buf_pool_acquire_buf(pool, 1, &bufs[i]));
+        ASSERT_UINT_EQUALS(1024, bufs[i].capacity);
+    }
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(bufs); ++i) {
+        aws_byte_buf_pool_release_buf(pool, &bufs[i]);
+    }
+
+    struct aws_byte_buf_pool_stats stats;
+    aws_byte_buf_pool_get_stats(pool, &stats);
+    ASSERT_UINT_EQUALS(4096, stats.retained_bytes);
+    ASSERT_UINT_EQUALS(1, stats.discard_count);
+
+    /* taking one out makes room for one more */
+    struct aws_byte_buf buf;
+    ASSERT_SUCCESS(aws_byte_buf_pool_acquire_buf(pool, 1024, &buf));
+    aws_byte_buf_pool_get_stats(pool, &stats);
+    ASSERT_UINT_EQUALS(3072, stats.retained_bytes);
+    aws_byte_buf_pool_release_buf(pool, &buf);
+    aws_byte_buf_pool_get_stats(pool, &stats);
+    ASSERT_UINT_EQUALS(4096, stats.retained_bytes);
+    ASSERT_UINT_EQUALS(1, stats.discard_count);
+
+    aws_byte_buf_pool_release(pool);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_byte_buf_pool_max_retained_bytes(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    return s_check_max_retained_bytes(allocator);
+}
+
+AWS_TEST_CASE(byte_buf_pool_max_retained_bytes, s_byte_buf_pool_max_retained_bytes)
+
+struct max_retained_thread_data {
+    struct aws_allocator *allocator;
+    int result;
+};
+
+static void s_max_retained_thread_fn(void *arg) {
+    struct max_retained_thread_data *data = arg;
+    data->result = s_check_max_retained_bytes(data->allocator);
+}
+
+/* Same as above, from a thread with a cache, which reserves its share of the limit in batches. */
+static int s_byte_buf_pool_thread_cache_max_retained_bytes(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct max_retained_thread_data data = {
+        .allocator = allocator,
+        .result = AWS_OP_ERR,
+    };
+    struct aws_thread thread;
+    ASSERT_SUCCESS(aws_thread_init(&thread, allocator));
+    ASSERT_SUCCESS(aws_thread_launch(&thread, s_max_retained_thread_fn, &data, NULL));
+    ASSERT_SUCCESS(aws_thread_join(&thread));
+    aws_thread_clean_up(&thread);
+    ASSERT_SUCCESS(data.result);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(byte_buf_pool_thread_cache_max_retained_bytes, s_byte_buf_pool_thread_cache_max_retained_bytes)
+
+static int s_byte_buf_pool_foreign_buffers(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_buf_pool *pool = aws_byte_buf_pool_new(allocator, NULL);
+    ASSERT_NOT_NULL(pool);
+
+    /* not the capacity of a size class */
+    struct aws_byte_buf buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&buf, allocator, 5000));
+    aws_byte_buf_pool_release_buf(pool, &buf);
+    ASSERT_NULL(buf.buffer);
+
+    /* grown past the largest size class */
+    ASSERT_SUCCESS(aws_byte_buf_pool_acquire_buf(pool, 1, &buf));
+    ASSERT_SUCCESS(aws_byte_buf_reserve(&buf, 2 * AWS_BYTE_BUF_POOL_DEFAULT_MAX_BUFFER_SIZE));
+    aws_byte_buf_pool_release_buf(pool, &buf);
+
+    /* a size class's capacity from the pool's allocator is as good as the pool's own */
+    ASSERT_SUCCESS(aws_byte_buf_init(&buf, allocator, 16 * 1024));
+    aws_byte_buf_pool_release_buf(pool, &buf);
+
+    struct aws_byte_buf_pool_stats stats;
+    aws_byte_buf_pool_get_stats(pool, &stats);
+    ASSERT_UINT_EQUALS(3, stats.release_count);
+    ASSERT_UINT_EQUALS(2, stats.discard_count);
+    ASSERT_UINT_EQUALS(16 * 1024, stats.retained_bytes);
+
+    aws_byte_buf_pool_release(pool);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(byte_buf_pool_foreign_buffers, s_byte_buf_pool_foreign_buffers)
+
+static int s_byte_buf_pool_invalid_options(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_buf_pool_options options = {
+        .min_buffer_size = 64 * 1024,
+        .max_buffer_size = 4 * 1024,
+    };
+    ASSERT_NULL(aws_byte_buf_pool_new(allocator, &options));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    /* the smallest size class is 64 bytes, whatever the options say */
+    options.min_buffer_size = 1;
+    options.max_buffer_size = 1;
+    ASSERT_NULL(aws_byte_buf_pool_new(allocator, &options));
+
+    options.max_buffer_size = 64;
+    struct aws_byte_buf_pool *pool = aws_byte_buf_pool_new(allocator, &options);
+    ASSERT_NOT_NULL(pool);
+    struct aws_byte_buf buf;
+    ASSERT_SUCCESS(aws_byte_buf_pool_acquire_buf(pool, 1, &buf));
+    ASSERT_UINT_EQUALS(64, buf.capacity);
+    aws_byte_buf_pool_release_buf(pool, &buf);
+    aws_byte_buf_pool_release(pool);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(byte_buf_pool_invalid_options, s_byte_buf_pool_invalid_options)
+
+enum {
+    THREAD_COUNT = 4,
+    ITERATIONS_PER_THREAD = 10000,
+};
+
+struct pool_thread_data {
+    struct aws_byte_buf_pool *pool;
+    /* set by the test once the thread may exit */
+    struct aws_atomic_var *may_exit;
+    struct aws_atomic_var *done_count;
+    bool failed;
+};
+
+static bool s_pool_thread_work(struct aws_byte_buf_pool *pool) {
+    struct aws_byte_buf bufs[3];
+    for (size_t i = 0; i < ITERATIONS_PER_THREAD; ++i) {
+        for (size_t j = 0; j < AWS_ARRAY_SIZE(bufs); ++j) {
+            if (aws_byte_buf_pool_acquire_buf(pool, (size_t)1024 << j, &bufs[j]) ||
+                !aws_byte_buf_write_u8_n(&bufs[j], (uint8_t)i, bufs[j].capacity)) {
+                return false;
+            }
+        }
+        for (size_t j = 0; j < AWS_ARRAY_SIZE(bufs); ++j) {
+            aws_byte_buf_pool_release_buf(pool, &bufs[j]);
+        }
+    }
+
+    /* leave a buffer in this thread's cache */
+    if (aws_byte_buf_pool_acquire_buf(pool, 1, &bufs[0])) {
+        return false;
+    }
+    aws_byte_buf_pool_release_buf(pool, &bufs[0]);
+    return true;
+}
+
+static void s_pool_thread_fn(void *arg) {
+    struct pool_thread_data *data = arg;
+
+    data->failed = !s_pool_thread_work(data->pool);
+
+    /* stay alive, cache and all, until the test says otherwise */
+    aws_atomic_fetch_add(data->done_count, 1);
+    while (!aws_atomic_load_int(data->may_exit)) {
+        aws_thread_current_sleep(1000000);
+    }
+}
+
+static int s_run_pool_threads(struct aws_allocator *allocator, bool release_pool_first) {
+    struct aws_byte_buf_pool_options options = {
+        .min_buffer_size = 1024,
+    };
+    struct aws_byte_buf_pool *pool = aws_byte_buf_pool_new(allocator, &options);
+    ASSERT_NOT_NULL(pool);
+
+    struct aws_atomic_var may_exit;
+    aws_atomic_init_int(&may_exit, 0);
+    struct aws_atomic_var done_count;
+    aws_atomic_init_int(&done_count, 0);
+
+    struct aws_thread threads[THREAD_COUNT];
+    struct pool_thread_data thread_data[THREAD_COUNT];
+    for (size_t i = 0; i < THREAD_COUNT; ++i) {
+        thread_data[i] = (struct pool_thread_data){
+            .pool = pool,
+            .may_exit = &may_exit,
+            .done_count = &done_count,
+        };
+        ASSERT_SUCCESS(aws_thread_init(&threads[i], allocator));
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], s_pool_thread_fn, &thread_data[i], NULL));
+    }
+    while (aws_atomic_load_int(&done_count) < THREAD_COUNT) {
+        aws_thread_current_sleep(1000000);
+    }
+    for (size_t i = 0; i < THREAD_COUNT; ++i) {
+        ASSERT_FALSE(thread_data[i].failed);
+    }
+
+    struct aws_byte_buf_pool_stats stats;
+    aws_byte_buf_pool_get_stats(pool, &stats);
+    ASSERT_UINT_EQUALS(THREAD_COUNT * (ITERATIONS_PER_THREAD * 3 + 1), stats.acquire_count);
+    ASSERT_UINT_EQUALS(stats.acquire_count, stats.release_count);
+    /* each thread allocates its first three buffers, and after that only misses if other threads took the rest */
+    ASSERT_TRUE(stats.hit_count >= stats.acquire_count - THREAD_COUNT * 4);
+    ASSERT_TRUE(stats.thread_cache_hit_count >= stats.acquire_count / 2);
+    ASSERT_TRUE(stats.retained_bytes > 0);
+
+    if (release_pool_first) {
+        /* the threads' caches still hold buffers, which have to go with the pool */
+        aws_byte_buf_pool_release(pool);
+        pool = NULL;
+    }
+
+    aws_atomic_store_int(&may_exit, 1);
+    for (size_t i = 0; i < THREAD_COUNT; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]));
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    if (pool) {
+        /* the exiting threads handed their cached buffers back */
+        struct aws_byte_buf_pool_stats after_exit;
+        aws_byte_buf_pool_get_stats(pool, &after_exit);
+        ASSERT_UINT_EQUALS(stats.acquire_count, after_exit.acquire_count);
+        ASSERT_UINT_EQUALS(stats.retained_bytes, after_exit.retained_bytes);
+
+        struct aws_byte_buf buf;
+        ASSERT_SUCCESS(aws_byte_buf_pool_acquire_buf(pool, 4096, &buf));
+        aws_byte_buf_pool_release_buf(pool, &buf);
+        aws_byte_buf_pool_get_stats(pool, &after_exit);
+        ASSERT_UINT_EQUALS(stats.hit_count + 1, after_exit.hit_count);
+
+        aws_byte_buf_pool_release(pool);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_byte_buf_pool_thread_caches(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    return s_run_pool_threads(allocator, false);
+}
+
+AWS_TEST_CASE(byte_buf_pool_thread_caches, s_byte_buf_pool_thread_caches)
+
+static int s_byte_buf_pool_released_before_threads_exit(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    return s_run_pool_threads(allocator, true);
+}
+
+AWS_TEST_CASE(byte_buf_pool_released_before_threads_exit, s_byte_buf_pool_released_before_threads_exit)
+
+static int s_byte_buf_pool_buffers_outlive_pool(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_buf_pool *pool = aws_byte_buf_pool_new(allocator, NULL);
+    ASSERT_NOT_NULL(pool);
+
+    struct aws_byte_buf buf;
+    ASSERT_SUCCESS(aws_byte_buf_pool_acquire_buf(pool, 100, &buf));
+    aws_byte_buf_pool_release(pool);
+
+    ASSERT_TRUE(aws_byte_buf_write_from_whole_cursor(&buf, aws_byte_cursor_from_c_str("still mine")));
+    aws_byte_buf_clean_up(&buf);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(byte_buf_pool_buffers_outlive_pool, s_byte_buf_pool_buffers_outlive_pool)
@@ -935,6 +935,81 @@ static int s_test_byte_cursor_compare_lookup(struct aws_allocator *allocator, vo
 }
 AWS_TEST_CASE(test_byte_cursor_compare_lookup, s_test_byte_cursor_compare_lookup)
 
+static uint64_t s_next_random(uint64_t *state) {
+    /* xorshift64, so the test is the same on every run */
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/* The byte-at-a-time comparison the vectorized one must agree with. */
+static int s_compare_ignore_case_naive(struct aws_byte_cursor lhs, struct aws_byte_cursor rhs) {
+    const uint8_t *table = aws_lookup_table_to_lower_get();
+    for (size_t i = 0; i < lhs.len && i < rhs.len; ++i) {
+        if (table[lhs.ptr[i]] != table[rhs.ptr[i]]) {
+            return table[lhs.ptr[i]] < table[rhs.ptr[i]] ? -1 : 1;
+        }
+    }
+    if (lhs.len == rhs.len) {
+        return 0;
+    }
+    return lhs.len < rhs.len ? -1 : 1;
+}
+
+/*
+ * Pairs of strings that mostly differ only in case, with the occasional byte changed or length cut short, drawn from
+ * the bytes on either side of the letter ranges where case folding could go wrong.
+ */
+static int s_test_byte_cursor_ignore_case_matches_naive(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const uint8_t alphabet[] = {
+        '@', 'A', 'M', 'Z', '[', '`', 'a', 'm', 'z', '{', '-', '0', 0x7F, 0x80, 0xC1, 0xDA, 0xE1};
+    const uint8_t *to_lower = aws_lookup_table_to_lower_get();
+    uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+
+    for (size_t iteration = 0; iteration < 10000; ++iteration) {
+        /* exactly sized allocations, so reading past either end would show up under a sanitizer */
+        size_t len = (size_t)(s_next_random(&random_state) % 100);
+        uint8_t *lhs = aws_mem_acquire(allocator, len + 1);
+        uint8_t *rhs = aws_mem_acquire(allocator, len + 1);
+        for (size_t i = 0; i < len; ++i) {
+            lhs[i] = alphabet[s_next_random(&random_state) % AWS_ARRAY_SIZE(alphabet)];
+            rhs[i] = lhs[i];
+            if (aws_isalpha(lhs[i]) && s_next_random(&random_state) % 2) {
+                rhs[i] ^= 0x20;
+            }
+        }
+
+        size_t rhs_len = len;
+        uint64_t mutation = s_next_random(&random_state) % 4;
+        if (len > 0 && mutation == 1) {
+            rhs[s_next_random(&random_state) % len] = alphabet[s_next_random(&random_state) % AWS_ARRAY_SIZE(alphabet)];
+        } else if (len > 0 && mutation == 2) {
+            rhs_len = (size_t)(s_next_random(&random_state) % len);
+        }
+
+        struct aws_byte_cursor lhs_cur = aws_byte_cursor_from_array(lhs, len);
+        struct aws_byte_cursor rhs_cur = aws_byte_cursor_from_array(rhs, rhs_len);
+        int expected = s_compare_ignore_case_naive(lhs_cur, rhs_cur);
+
+        ASSERT_INT_EQUALS(expected, aws_byte_cursor_compare_lookup(&lhs_cur, &rhs_cur, to_lower));
+        ASSERT_INT_EQUALS(-expected, aws_byte_cursor_compare_lookup(&rhs_cur, &lhs_cur, to_lower));
+        ASSERT_TRUE(aws_byte_cursor_eq_ignore_case(&lhs_cur, &rhs_cur) == (expected == 0));
+        ASSERT_TRUE(aws_array_eq_ignore_case(rhs, rhs_len, lhs, len) == (expected == 0));
+        if (expected == 0) {
+            ASSERT_UINT_EQUALS(aws_hash_array_ignore_case(lhs, len), aws_hash_array_ignore_case(rhs, rhs_len));
+        }
+
+        aws_mem_release(allocator, rhs);
+        aws_mem_release(allocator, lhs);
+    }
+
+    return 0;
+}
+AWS_TEST_CASE(test_byte_cursor_ignore_case_matches_naive, s_test_byte_cursor_ignore_case_matches_naive)
+
 static int s_test_byte_buf_init_cache_and_update_cursors(struct aws_allocator *allocator, void *ctx) {
     (void)ctx;
 
@@ -0,0 +1,231 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_chain.h>
+
+#include <aws/testing/aws_test_harness.h>
+
+/* Reads the whole chain through a cursor and checks it against `expected`. */
+static int s_check_chain_contents(const struct aws_byte_chain *chain, const char *expected) {
+    size_t expected_len = strlen(expected);
+    ASSERT_UINT_EQUALS(expected_len, chain->len);
+
+    uint8_t contents[256];
+    ASSERT_TRUE(expected_len <= sizeof(contents));
+    struct aws_byte_chain_cursor cur = aws_byte_chain_cursor_from_chain(chain);
+    ASSERT_TRUE(aws_byte_chain_cursor_read(&cur, contents, expected_len));
+    ASSERT_UINT_EQUALS(0, cur.len);
+    ASSERT_BIN_ARRAYS_EQUALS(expected, expected_len, contents, expected_len);
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_byte_chain_append_prepend(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_chain chain;
+    ASSERT_SUCCESS(aws_byte_chain_init(&chain, allocator, 1));
+
+    const char *body = "{\"key\":\"value\"}";
+    ASSERT_SUCCESS(aws_byte_chain_append(&chain, aws_byte_cursor_from_c_str("Content-Length: 15\r\n")));
+    ASSERT_SUCCESS(aws_byte_chain_append(&chain, aws_byte_cursor_from_c_str("\r\n")));
+    ASSERT_SUCCESS(aws_byte_chain_append(&chain, aws_byte_cursor_from_c_str("")));
+    ASSERT_SUCCESS(aws_byte_chain_append(&chain, aws_byte_cursor_from_c_str(body)));
+    ASSERT_SUCCESS(aws_byte_chain_prepend(&chain, aws_byte_cursor_from_c_str("PUT / HTTP/1.1\r\n")));
+
+    /* nothing was copied, and the empty cursor didn't make a segment */
+    ASSERT_UINT_EQUALS(4, aws_byte_chain_segment_count(&chain));
+    struct aws_byte_cursor segments[8];
+    ASSERT_UINT_EQUALS(4, aws_byte_chain_get_segments(&chain, segments, AWS_ARRAY_SIZE(segments)));
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(segments[0], "PUT / HTTP/1.1\r\n");
+    ASSERT_PTR_EQUALS(body, segments[3].ptr);
+    ASSERT_UINT_EQUALS(2, aws_byte_chain_get_segments(&chain, segments, 2));
+
+    ASSERT_SUCCESS(
+        s_check_chain_contents(&chain, "PUT / HTTP/1.1\r\nContent-Length: 15\r\n\r\n{\"key\":\"value\"}"));
+
+    aws_byte_chain_clean_up(&chain);
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(byte_chain_append_prepend, s_byte_chain_append_prepend)
+
+static int s_byte_chain_owned_buffers(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_chain chain;
+    ASSERT_SUCCESS(aws_byte_chain_init(&chain, allocator, 0));
+
+    struct aws_byte_buf body;
+    ASSERT_SUCCESS(aws_byte_buf_init_copy_from_cursor(&body, allocator, aws_byte_cursor_from_c_str("body")));
+    ASSERT_SUCCESS(aws_byte_chain_append_buf(&chain, &body));
+    ASSERT_NULL(body.buffer);
+
+    struct aws_byte_buf headers;
+    ASSERT_SUCCESS(aws_byte_buf_init_copy_from_cursor(&headers, allocator, aws_byte_cursor_from_c_str("head;")));
+    ASSERT_SUCCESS(aws_byte_chain_prepend_buf(&chain, &headers));
+    ASSERT_NULL(headers.buffer);
+
+    /* an empty buffer is cleaned up right away */
+    struct aws_byte_buf empty;
+    ASSERT_SUCCESS(aws_byte_buf_init(&empty, allocator, 16));
+    ASSERT_SUCCESS(aws_byte_chain_append_buf(&chain, &empty));
+    ASSERT_NULL(empty.buffer);
+    ASSERT_UINT_EQUALS(2, aws_byte_chain_segment_count(&chain));
+
+    ASSERT_SUCCESS(aws_byte_chain_append(&chain, aws_byte_cursor_from_c_str(";tail")));
+    ASSERT_SUCCESS(s_check_chain_contents(&chain, "head;body;tail"));
+
+    /* the test allocator reports a leak if consuming or cleaning up misses an owned buffer */
+    ASSERT_SUCCESS(aws_byte_chain_consume(&chain, 7));
+    ASSERT_UINT_EQUALS(2, aws_byte_chain_segment_count(&chain));
+    ASSERT_SUCCESS(s_check_chain_contents(&chain, "dy;tail"));
+
+    aws_byte_chain_clean_up(&chain);
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(byte_chain_owned_buffers, s_byte_chain_owned_buffers)
+
+static int s_byte_chain_cursor_reads_across_segments(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    /* every value straddles a segment boundary */
+    const uint8_t bytes[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A,
+                             0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14};
+    const size_t boundaries[] = {0, 1, 4, 5, 9, 18, 20};
+
+    struct aws_byte_chain chain;
+    ASSERT_SUCCESS(aws_byte_chain_init(&chain, allocator, 4));
+    for (size_t i = 0; i + 1 < AWS_ARRAY_SIZE(boundaries); ++i) {
+        ASSERT_SUCCESS(aws_byte_chain_append(
+            &chain, aws_byte_cursor_from_array(bytes + boundaries[i], boundaries[i + 1] - boundaries[i])));
+    }
+
+    struct aws_byte_chain_cursor cur = aws_byte_chain_cursor_from_chain(&chain);
+    uint8_t u8 = 0;
+    uint16_t u16 = 0;
+    uint32_t u32 = 0;
+    uint64_t u64 = 0;
+    ASSERT_TRUE(aws_byte_chain_cursor_read_u8(&cur, &u8));
+    ASSERT_UINT_EQUALS(0x01, u8);
+    ASSERT_TRUE(aws_byte_chain_cursor_read_be16(&cur, &u16));
+    ASSERT_UINT_EQUALS(0x0203, u16);
+    ASSERT_TRUE(aws_byte_chain_cursor_read_be24(&cur, &u32));
+    ASSERT_UINT_EQUALS(0x040506, u32);
+    ASSERT_TRUE(aws_byte_chain_cursor_read_be32(&cur, &u32));
+    ASSERT_UINT_EQUALS(0x0708090A, u32);
+    ASSERT_TRUE(aws_byte_chain_cursor_read_be64(&cur, &u64));
+    ASSERT_UINT_EQUALS(0x0B0C0D0E0F101112ULL, u64);
+    ASSERT_UINT_EQUALS(2, cur.len);
+
+    /* a read that doesn't fit leaves the cursor where it was */
+    struct aws_byte_chain_cursor before = cur;
+    ASSERT_FALSE(aws_byte_chain_cursor_read_be32(&cur, &u32));
+    ASSERT_FALSE(aws_byte_chain_cursor_advance(&cur, 3));
+    ASSERT_UINT_EQUALS(before.len, cur.len);
+    ASSERT_UINT_EQUALS(before.segment_index, cur.segment_index);
+    ASSERT_UINT_EQUALS(before.segment_offset, cur.segment_offset);
+    ASSERT_TRUE(aws_byte_chain_cursor_read_be16(&cur, &u16));
+    ASSERT_UINT_EQUALS(0x1314, u16);
+    ASSERT_FALSE(aws_byte_chain_cursor_read_u8(&cur, &u8));
+
+    /* next() hands out the contiguous runs without copying them */
+    cur = aws_byte_chain_cursor_from_chain(&chain);
+    ASSERT_TRUE(aws_byte_chain_cursor_advance(&cur, 2));
+    struct aws_byte_cursor piece;
+    ASSERT_TRUE(aws_byte_chain_cursor_next(&cur, SIZE_MAX, &piece));
+    ASSERT_PTR_EQUALS(bytes + 2, piece.ptr);
+    ASSERT_UINT_EQUALS(2, piece.len);
+    ASSERT_TRUE(aws_byte_chain_cursor_next(&cur, 3, &piece));
+    ASSERT_PTR_EQUALS(bytes + 4, piece.ptr);
+    ASSERT_UINT_EQUALS(1, piece.len);
+    ASSERT_TRUE(aws_byte_chain_cursor_next(&cur, 3, &piece));
+    ASSERT_PTR_EQUALS(bytes + 5, piece.ptr);
+    ASSERT_UINT_EQUALS(3, piece.len);
+    ASSERT_TRUE(aws_byte_chain_cursor_advance(&cur, cur.len));
+    ASSERT_FALSE(aws_byte_chain_cursor_next(&cur, SIZE_MAX, &piece));
+    ASSERT_UINT_EQUALS(0, piece.len);
+
+    aws_byte_chain_clean_up(&chain);
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(byte_chain_cursor_reads_across_segments, s_byte_chain_cursor_reads_across_segments)
+
+static int s_byte_chain_slice(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_chain chain;
+    ASSERT_SUCCESS(aws_byte_chain_init(&chain, allocator, 4));
+    ASSERT_SUCCESS(aws_byte_chain_append(&chain, aws_byte_cursor_from_c_str("abc")));
+    ASSERT_SUCCESS(aws_byte_chain_append(&chain, aws_byte_cursor_from_c_str("defg")));
+    ASSERT_SUCCESS(aws_byte_chain_append(&chain, aws_byte_cursor_from_c_str("hi")));
+
+    struct aws_byte_chain slice;
+    ASSERT_SUCCESS(aws_byte_chain_init(&slice, allocator, 0));
+
+    ASSERT_SUCCESS(aws_byte_chain_slice(&chain, 2, 6, &slice));
+    ASSERT_UINT_EQUALS(3, aws_byte_chain_segment_count(&slice));
+    ASSERT_SUCCESS(s_check_chain_contents(&slice, "cdefgh"));
+
+    /* slices append, and can land inside one segment or be empty */
+    ASSERT_SUCCESS(aws_byte_chain_slice(&chain, 4, 2, &slice));
+    ASSERT_SUCCESS(aws_byte_chain_slice(&chain, 9, 0, &slice));
+    ASSERT_SUCCESS(s_check_chain_contents(&slice, "cdefghef"));
+
+    ASSERT_ERROR(AWS_ERROR_SHORT_BUFFER, aws_byte_chain_slice(&chain, 8, 2, &slice));
+    ASSERT_ERROR(AWS_ERROR_SHORT_BUFFER, aws_byte_chain_slice(&chain, 10, 0, &slice));
+    ASSERT_ERROR(AWS_ERROR_SHORT_BUFFER, aws_byte_chain_slice(&chain, 1, SIZE_MAX, &slice));
+    ASSERT_SUCCESS(s_check_chain_contents(&slice, "cdefghef"));
+
+    aws_byte_chain_clean_up(&slice);
+    aws_byte_chain_clean_up(&chain);
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(byte_chain_slice, s_byte_chain_slice)
+
+/* The writev() loop the chain is built for: export a few segments, "write" some of them, consume what was written. */
+static int s_byte_chain_partial_writes(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const char *pieces[] = {"GET /", "object", " HTTP/1.1\r\n", "Host: example.com\r\n", "\r\n"};
+    struct aws_byte_chain chain;
+    ASSERT_SUCCESS(aws_byte_chain_init(&chain, allocator, AWS_ARRAY_SIZE(pieces)));
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(pieces); ++i) {
+        struct aws_byte_buf buf;
+        ASSERT_SUCCESS(aws_byte_buf_init_copy_from_cursor(&buf, allocator, aws_byte_cursor_from_c_str(pieces[i])));
+        ASSERT_SUCCESS(aws_byte_chain_append_buf(&chain, &buf));
+    }
+
+    struct aws_byte_buf written;
+    ASSERT_SUCCESS(aws_byte_buf_init(&written, allocator, chain.len));
+    size_t write_sizes[] = {3, 10, 1, 100};
+    for (size_t i = 0; chain.len > 0; ++i) {
+        struct aws_byte_cursor iov[2];
+        size_t iov_count = aws_byte_chain_get_segments(&chain, iov, AWS_ARRAY_SIZE(iov));
+        ASSERT_TRUE(iov_count > 0);
+
+        size_t budget = write_sizes[i % AWS_ARRAY_SIZE(write_sizes)];
+        size_t total = 0;
+        for (size_t j = 0; j < iov_count && budget > 0; ++j) {
+            struct aws_byte_cursor part = aws_byte_cursor_advance(&iov[j], aws_min_size(budget, iov[j].len));
+            ASSERT_SUCCESS(aws_byte_buf_append(&written, &part));
+            budget -= part.len;
+            total += part.len;
+        }
+        ASSERT_SUCCESS(aws_byte_chain_consume(&chain, total));
+    }
+
+    ASSERT_BIN_ARRAYS_EQUALS(
+        "GET /object HTTP/1.1\r\nHost: example.com\r\n\r\n",
+        strlen("GET /object HTTP/1.1\r\nHost: example.com\r\n\r\n"),
+        written.buffer,
+        written.len);
+    ASSERT_UINT_EQUALS(0, aws_byte_chain_segment_count(&chain));
+    ASSERT_ERROR(AWS_ERROR_SHORT_BUFFER, aws_byte_chain_consume(&chain, 1));
+
+    aws_byte_buf_clean_up(&written);
+    aws_byte_chain_clean_up(&chain);
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(byte_chain_partial_writes, s_byte_chain_partial_writes)
@@ -70,3 +70,110 @@ static int s_test_byte_cursor_find_str_longer_than_input_fn(struct aws_allocator
 }
 
 AWS_TEST_CASE(test_byte_cursor_find_str_longer_than_input, s_test_byte_cursor_find_str_longer_than_input_fn)
+
+static uint64_t s_next_random(uint64_t *state) {
+    /* xorshift64, so the test is the same on every run */
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static const uint8_t *s_find_naive(struct aws_byte_cursor haystack, struct aws_byte_cursor needle) {
+    for (size_t i = 0; i + needle.len <= haystack.len; ++i) {
+        if (!memcmp(haystack.ptr + i, needle.ptr, needle.len)) {
+            return haystack.ptr + i;
+        }
+    }
+    return NULL;
+}
+
+/* Small alphabets make for lots of near misses, which is where the vectorized and scalar paths can go wrong. */
+static int s_test_byte_cursor_find_pattern_matches_naive_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const char *alphabets[] = {"ab", "\r\n-x", "<>/Key", "abcdefghijklmnopqrstuvwxyz0123456789"};
+    uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+
+    for (size_t iteration = 0; iteration < 4000; ++iteration) {
+        const char *alphabet = alphabets[iteration % AWS_ARRAY_SIZE(alphabets)];
+        size_t alphabet_len = strlen(alphabet);
+
+        /* exactly sized allocations, so reading past either end would show up under a sanitizer */
+        size_t haystack_len = (size_t)(s_next_random(&random_state) % 300);
+        size_t needle_len = 1 + (size_t)(s_next_random(&random_state) % 40);
+        uint8_t *haystack = aws_mem_acquire(allocator, haystack_len + 1);
+        uint8_t *needle = aws_mem_acquire(allocator, needle_len);
+        for (size_t i = 0; i < haystack_len; ++i) {
+            haystack[i] = (uint8_t)alphabet[s_next_random(&random_state) % alphabet_len];
+        }
+        for (size_t i = 0; i < needle_len; ++i) {
+            needle[i] = (uint8_t)alphabet[s_next_random(&random_state) % alphabet_len];
+        }
+        /* and half the time, plant the needle somewhere, often right at the end */
+        if (needle_len <= haystack_len && s_next_random(&random_state) % 2) {
+            size_t offset = s_next_random(&random_state) % 3 == 0
+                                ? haystack_len - needle_len
+                                : (size_t)(s_next_random(&random_state) % (haystack_len - needle_len + 1));
+            memcpy(haystack + offset, needle, needle_len);
+        }
+
+        struct aws_byte_cursor haystack_cur = aws_byte_cursor_from_array(haystack, haystack_len);
+        struct aws_byte_cursor needle_cur = aws_byte_cursor_from_array(needle, needle_len);
+        const uint8_t *expected = s_find_naive(haystack_cur, needle_cur);
+
+        struct aws_byte_cursor found;
+        AWS_ZERO_STRUCT(found);
+        if (expected) {
+            ASSERT_SUCCESS(aws_byte_cursor_find_exact(&haystack_cur, &needle_cur, &found));
+            ASSERT_PTR_EQUALS(expected, found.ptr);
+            ASSERT_UINT_EQUALS(haystack_len - (size_t)(expected - haystack), found.len);
+        } else {
+            ASSERT_ERROR(
+                AWS_ERROR_STRING_MATCH_NOT_FOUND, aws_byte_cursor_find_exact(&haystack_cur, &needle_cur, &found));
+        }
+
+        aws_mem_release(allocator, needle);
+        aws_mem_release(allocator, haystack);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(test_byte_cursor_find_pattern_matches_naive, s_test_byte_cursor_find_pattern_matches_naive_fn)
+
+static int s_test_byte_cursor_find_pattern_reuse_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)allocator;
+    (void)ctx;
+
+    struct aws_byte_find_pattern pattern;
+    ASSERT_ERROR(AWS_ERROR_SHORT_BUFFER, aws_byte_find_pattern_init(&pattern, aws_byte_cursor_from_c_str("")));
+
+    /* a repetitive pattern still gets two anchors with different bytes */
+    ASSERT_SUCCESS(aws_byte_find_pattern_init(&pattern, aws_byte_cursor_from_c_str("\r\n\r\n")));
+    ASSERT_TRUE(pattern.pattern.ptr[pattern.anchor_offsets[0]] != pattern.pattern.ptr[pattern.anchor_offsets[1]]);
+
+    const char *requests[] = {
+        "GET / HTTP/1.1\r\nHost: example.com\r\nAccept: */*\r\n\r\nbody",
+        "\r\n\r\n",
+        "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n",
+        "no line breaks at all, but long enough to take the vectorized path for a little while",
+    };
+    const size_t header_lengths[] = {46, 0, SIZE_MAX, SIZE_MAX};
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(requests); ++i) {
+        struct aws_byte_cursor request = aws_byte_cursor_from_c_str(requests[i]);
+        struct aws_byte_cursor found;
+        if (header_lengths[i] == SIZE_MAX) {
+            ASSERT_ERROR(AWS_ERROR_STRING_MATCH_NOT_FOUND, aws_byte_cursor_find_pattern(&request, &pattern, &found));
+        } else {
+            ASSERT_SUCCESS(aws_byte_cursor_find_pattern(&request, &pattern, &found));
+            ASSERT_UINT_EQUALS(header_lengths[i], (size_t)(found.ptr - request.ptr));
+            ASSERT_UINT_EQUALS(request.len - header_lengths[i], found.len);
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(test_byte_cursor_find_pattern_reuse, s_test_byte_cursor_find_pattern_reuse_fn)
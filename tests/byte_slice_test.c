@@ -0,0 +1,223 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/byte_slice.h>
+#include <aws/common/thread.h>
+
+#include <aws/testing/aws_test_harness.h>
+
+static struct aws_shared_buffer *s_new_filled_buffer(
+    struct aws_allocator *allocator,
+    size_t capacity,
+    const char *str) {
+    struct aws_shared_buffer *buffer = aws_shared_buffer_new(allocator, capacity);
+    if (buffer) {
+        aws_byte_buf_write_from_whole_cursor(aws_shared_buffer_get_buf(buffer), aws_byte_cursor_from_c_str(str));
+    }
+    return buffer;
+}
+
+/* The harness fails the test on leaks, so these also check that the last reference frees the buffer. */
+static int s_byte_slice_outlives_buffer(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_shared_buffer *buffer = s_new_filled_buffer(allocator, 64, "HTTP/1.1 200 OK\r\nserver: test\r\n");
+    ASSERT_NOT_NULL(buffer);
+    struct aws_byte_cursor response = aws_byte_cursor_from_buf(aws_shared_buffer_get_buf(buffer));
+
+    struct aws_byte_cursor status = response;
+    aws_byte_cursor_advance(&status, 9);
+    status.len = 6;
+    struct aws_byte_cursor server = response;
+    aws_byte_cursor_advance(&server, 25);
+    server.len = 4;
+
+    struct aws_byte_slice status_slice;
+    struct aws_byte_slice server_slice;
+    ASSERT_SUCCESS(aws_byte_slice_init(&status_slice, buffer, status));
+    ASSERT_SUCCESS(aws_byte_slice_init(&server_slice, buffer, server));
+    aws_shared_buffer_release(buffer);
+
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(status_slice.cursor, "200 OK");
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(server_slice.cursor, "test");
+
+    struct aws_byte_slice copy;
+    aws_byte_slice_init_copy(&copy, &status_slice);
+    aws_byte_slice_clean_up(&status_slice);
+    ASSERT_NULL(status_slice.owner);
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(copy.cursor, "200 OK");
+
+    aws_byte_slice_clean_up(&server_slice);
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(copy.cursor, "200 OK");
+    aws_byte_slice_clean_up(&copy);
+
+    /* cleaning up twice, or a zeroed slice, is fine */
+    aws_byte_slice_clean_up(&copy);
+    aws_shared_buffer_release(NULL);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(byte_slice_outlives_buffer, s_byte_slice_outlives_buffer)
+
+static int s_byte_slice_from_buf(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_buf buf;
+    ASSERT_SUCCESS(aws_byte_buf_init_copy_from_cursor(&buf, allocator, aws_byte_cursor_from_c_str("key=value")));
+    const uint8_t *memory = buf.buffer;
+
+    struct aws_shared_buffer *buffer = aws_shared_buffer_new_from_buf(allocator, &buf);
+    ASSERT_NOT_NULL(buffer);
+    ASSERT_NULL(buf.buffer);
+    ASSERT_PTR_EQUALS(memory, aws_shared_buffer_get_buf(buffer)->buffer);
+
+    struct aws_byte_slice slice;
+    ASSERT_SUCCESS(aws_byte_slice_init(&slice, buffer, aws_byte_cursor_from_array(memory + 4, 5)));
+    aws_shared_buffer_release(buffer);
+    ASSERT_PTR_EQUALS(memory + 4, slice.cursor.ptr);
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(slice.cursor, "value");
+    aws_byte_slice_clean_up(&slice);
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(byte_slice_from_buf, s_byte_slice_from_buf)
+
+static int s_byte_slice_invalid_range(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_shared_buffer *buffer = s_new_filled_buffer(allocator, 32, "0123456789");
+    ASSERT_NOT_NULL(buffer);
+    uint8_t *data = aws_shared_buffer_get_buf(buffer)->buffer;
+    struct aws_byte_slice slice;
+
+    /* past the data, though still within the capacity */
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_byte_slice_init(&slice, buffer, aws_byte_cursor_from_array(data, 11)));
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT, aws_byte_slice_init(&slice, buffer, aws_byte_cursor_from_array(data + 8, 3)));
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT, aws_byte_slice_init(&slice, buffer, aws_byte_cursor_from_array(data + 11, 0)));
+
+    /* somewhere else entirely */
+    uint8_t elsewhere[4] = {0};
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT,
+        aws_byte_slice_init(&slice, buffer, aws_byte_cursor_from_array(elsewhere, sizeof(elsewhere))));
+    ASSERT_NULL(slice.owner);
+
+    /* the edges are fine */
+    ASSERT_SUCCESS(aws_byte_slice_init(&slice, buffer, aws_byte_cursor_from_array(data, 10)));
+    aws_byte_slice_clean_up(&slice);
+    ASSERT_SUCCESS(aws_byte_slice_init(&slice, buffer, aws_byte_cursor_from_array(data + 10, 0)));
+    aws_byte_slice_clean_up(&slice);
+
+    aws_shared_buffer_release(buffer);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(byte_slice_invalid_range, s_byte_slice_invalid_range)
+
+static int s_byte_slice_compact(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_shared_buffer *buffer = aws_shared_buffer_new(allocator, 1024 * 1024);
+    ASSERT_NOT_NULL(buffer);
+    struct aws_byte_buf *buf = aws_shared_buffer_get_buf(buffer);
+    ASSERT_TRUE(aws_byte_buf_write_u8_n(buf, 'x', 1000));
+    ASSERT_TRUE(aws_byte_buf_write_from_whole_cursor(buf, aws_byte_cursor_from_c_str("application/json")));
+
+    struct aws_byte_slice small;
+    ASSERT_SUCCESS(aws_byte_slice_init(&small, buffer, aws_byte_cursor_from_array(buf->buffer + 1000, 16)));
+    struct aws_byte_slice large;
+    ASSERT_SUCCESS(aws_byte_slice_init(&large, buffer, aws_byte_cursor_from_buf(buf)));
+    aws_shared_buffer_release(buffer);
+
+    /* 1016 bytes of a 1MiB buffer is within a ratio of 2048, but not of 1024 */
+    ASSERT_SUCCESS(aws_byte_slice_compact(&large, allocator, 2048));
+    ASSERT_PTR_EQUALS(buffer, large.owner);
+    ASSERT_SUCCESS(aws_byte_slice_compact(&small, allocator, 1024));
+    ASSERT_TRUE(small.owner != buffer);
+    ASSERT_UINT_EQUALS(16, aws_shared_buffer_get_buf(small.owner)->capacity);
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(small.cursor, "application/json");
+
+    /* compacting the other slice frees the big buffer */
+    ASSERT_SUCCESS(aws_byte_slice_compact(&large, allocator, 2));
+    ASSERT_TRUE(large.owner != buffer);
+    ASSERT_UINT_EQUALS(1016, large.cursor.len);
+    ASSERT_BIN_ARRAYS_EQUALS("application/json", 16, large.cursor.ptr + 1000, 16);
+
+    /* nothing left to gain */
+    struct aws_shared_buffer *compacted = small.owner;
+    ASSERT_SUCCESS(aws_byte_slice_compact(&small, allocator, 1));
+    ASSERT_PTR_EQUALS(compacted, small.owner);
+
+    aws_byte_slice_clean_up(&small);
+    aws_byte_slice_clean_up(&large);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(byte_slice_compact, s_byte_slice_compact)
+
+enum { s_thread_count = 8, s_slices_per_thread = 1000 };
+
+struct slice_thread_data {
+    struct aws_byte_slice slice;
+    bool contents_matched;
+};
+
+static void s_slice_thread_fn(void *arg) {
+    struct slice_thread_data *data = arg;
+
+    struct aws_byte_slice copies[16];
+    data->contents_matched = true;
+    for (size_t i = 0; i < s_slices_per_thread; ++i) {
+        struct aws_byte_slice *copy = &copies[i % AWS_ARRAY_SIZE(copies)];
+        if (i >= AWS_ARRAY_SIZE(copies)) {
+            aws_byte_slice_clean_up(copy);
+        }
+        aws_byte_slice_init_copy(copy, &data->slice);
+        data->contents_matched &= aws_byte_cursor_eq_c_str(&copy->cursor, "shared");
+    }
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(copies); ++i) {
+        aws_byte_slice_clean_up(&copies[i]);
+    }
+    /* the thread owns the slice it was handed */
+    aws_byte_slice_clean_up(&data->slice);
+}
+
+static int s_byte_slice_across_threads(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_shared_buffer *buffer = s_new_filled_buffer(allocator, 16, "a shared buffer");
+    ASSERT_NOT_NULL(buffer);
+    struct aws_byte_cursor shared = aws_byte_cursor_from_buf(aws_shared_buffer_get_buf(buffer));
+    aws_byte_cursor_advance(&shared, 2);
+    shared.len = 6;
+
+    struct aws_thread threads[s_thread_count];
+    struct slice_thread_data thread_data[s_thread_count];
+    for (size_t i = 0; i < s_thread_count; ++i) {
+        ASSERT_SUCCESS(aws_byte_slice_init(&thread_data[i].slice, buffer, shared));
+        thread_data[i].contents_matched = false;
+    }
+    /* the threads hold the only references from here on */
+    aws_shared_buffer_release(buffer);
+
+    for (size_t i = 0; i < s_thread_count; ++i) {
+        ASSERT_SUCCESS(aws_thread_init(&threads[i], allocator));
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], s_slice_thread_fn, &thread_data[i], NULL));
+    }
+    for (size_t i = 0; i < s_thread_count; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]));
+        aws_thread_clean_up(&threads[i]);
+        ASSERT_TRUE(thread_data[i].contents_matched);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(byte_slice_across_threads, s_byte_slice_across_threads)
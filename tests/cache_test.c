@@ -367,3 +367,40 @@ static int s_test_cache_entries_overwrite_fn(struct aws_allocator *allocator, vo
 }
 
 AWS_TEST_CASE(test_cache_entries_overwrite, s_test_cache_entries_overwrite_fn)
+
+static int s_test_cache_reuses_nodes_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_allocator *tracer = aws_mem_tracer_new(allocator, NULL, AWS_MEMTRACE_BYTES, 0);
+
+    /* take lru cache as example, others share the same put path */
+    struct aws_cache *cache = aws_cache_new_lru(tracer, aws_hash_c_string, aws_hash_callback_c_str_eq, NULL, NULL, 2);
+    ASSERT_NOT_NULL(cache);
+
+    const char *keys[] = {"first", "second", "third", "fourth", "fifth"};
+    int values[AWS_ARRAY_SIZE(keys)] = {1, 2, 3, 4, 5};
+
+    /* fill the cache and evict once, so that every node the cache will ever need exists */
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_SUCCESS(aws_cache_put(cache, keys[i], &values[i]));
+    }
+    ASSERT_INT_EQUALS(2, aws_cache_get_element_count(cache));
+
+    size_t allocations = aws_mem_tracer_count(tracer);
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(keys); ++i) {
+        ASSERT_SUCCESS(aws_cache_put(cache, keys[i], &values[i]));
+        int *value = NULL;
+        ASSERT_SUCCESS(aws_cache_find(cache, keys[i], (void **)&value));
+        ASSERT_PTR_EQUALS(&values[i], value);
+    }
+    ASSERT_SUCCESS(aws_cache_remove(cache, keys[4]));
+    ASSERT_SUCCESS(aws_cache_put(cache, keys[0], &values[0]));
+    ASSERT_UINT_EQUALS(allocations, aws_mem_tracer_count(tracer));
+
+    aws_cache_destroy(cache);
+    ASSERT_UINT_EQUALS(0, aws_mem_tracer_count(tracer));
+    aws_mem_tracer_destroy(tracer);
+    return 0;
+}
+
+AWS_TEST_CASE(test_cache_reuses_nodes, s_test_cache_reuses_nodes_fn)
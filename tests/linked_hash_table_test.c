@@ -311,3 +311,81 @@ static int s_test_linked_hash_table_entries_overwrite_backed_cursor_fn(struct aw
 AWS_TEST_CASE(
     test_linked_hash_table_entries_overwrite_backed_cursor,
     s_test_linked_hash_table_entries_overwrite_backed_cursor_fn)
+
+struct linked_hash_table_test_intrusive_element {
+    int value;
+    size_t removed_count;
+    struct aws_linked_hash_table_node node;
+};
+
+static void s_linked_hash_table_on_node_removed(struct aws_linked_hash_table_node *node) {
+    struct linked_hash_table_test_intrusive_element *element =
+        AWS_CONTAINER_OF(node, struct linked_hash_table_test_intrusive_element, node);
+    element->removed_count++;
+}
+
+static int s_test_linked_hash_table_intrusive_fn(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_allocator *tracer = aws_mem_tracer_new(allocator, NULL, AWS_MEMTRACE_BYTES, 0);
+
+    struct aws_linked_hash_table table;
+    ASSERT_SUCCESS(aws_linked_hash_table_init_intrusive(
+        &table,
+        tracer,
+        aws_hash_c_string,
+        aws_hash_callback_c_str_eq,
+        NULL,
+        NULL,
+        s_linked_hash_table_on_node_removed,
+        4));
+
+    /* plain put is not allowed on an intrusive table */
+    int plain = 0;
+    ASSERT_ERROR(AWS_ERROR_INVALID_STATE, aws_linked_hash_table_put(&table, "plain", &plain));
+
+    struct linked_hash_table_test_intrusive_element first = {.value = 1};
+    struct linked_hash_table_test_intrusive_element second = {.value = 2};
+    struct linked_hash_table_test_intrusive_element third = {.value = 3};
+    struct linked_hash_table_test_intrusive_element replacement = {.value = 4};
+
+    /* inserting, reordering, replacing and removing entries must not allocate */
+    size_t allocations = aws_mem_tracer_count(tracer);
+
+    ASSERT_SUCCESS(aws_linked_hash_table_put_node(&table, "first", &first, &first.node));
+    ASSERT_SUCCESS(aws_linked_hash_table_put_node(&table, "second", &second, &second.node));
+    ASSERT_SUCCESS(aws_linked_hash_table_put_node(&table, "third", &third, &third.node));
+    ASSERT_INT_EQUALS(3, aws_linked_hash_table_get_element_count(&table));
+
+    struct linked_hash_table_test_intrusive_element *value = NULL;
+    ASSERT_SUCCESS(aws_linked_hash_table_find_and_move_to_back(&table, "first", (void **)&value));
+    ASSERT_PTR_EQUALS(&first, value);
+
+    const struct aws_linked_list *list = aws_linked_hash_table_get_iteration_list(&table);
+    ASSERT_PTR_EQUALS(&second.node.node, aws_linked_list_front(list));
+    ASSERT_PTR_EQUALS(&first.node.node, aws_linked_list_back(list));
+
+    ASSERT_SUCCESS(aws_linked_hash_table_put_node(&table, "second", &replacement, &replacement.node));
+    ASSERT_UINT_EQUALS(1, second.removed_count);
+    ASSERT_INT_EQUALS(3, aws_linked_hash_table_get_element_count(&table));
+    ASSERT_PTR_EQUALS(&replacement.node.node, aws_linked_list_back(list));
+
+    ASSERT_SUCCESS(aws_linked_hash_table_remove(&table, "third"));
+    ASSERT_UINT_EQUALS(1, third.removed_count);
+    ASSERT_SUCCESS(aws_linked_hash_table_find(&table, "third", (void **)&value));
+    ASSERT_NULL(value);
+
+    ASSERT_UINT_EQUALS(allocations, aws_mem_tracer_count(tracer));
+
+    aws_linked_hash_table_clear(&table);
+    ASSERT_UINT_EQUALS(1, first.removed_count);
+    ASSERT_UINT_EQUALS(1, replacement.removed_count);
+    ASSERT_UINT_EQUALS(0, aws_linked_hash_table_get_element_count(&table));
+
+    aws_linked_hash_table_clean_up(&table);
+    ASSERT_UINT_EQUALS(0, aws_mem_tracer_count(tracer));
+    aws_mem_tracer_destroy(tracer);
+    return 0;
+}
+
+AWS_TEST_CASE(test_linked_hash_table_intrusive, s_test_linked_hash_table_intrusive_fn)
@@ -0,0 +1,205 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/mpmc_queue.h>
+
+#include <aws/common/atomics.h>
+#include <aws/common/thread.h>
+#include <aws/testing/aws_test_harness.h>
+
+static int s_test_mpmc_queue_single_threaded(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_mpmc_queue *queue = aws_mpmc_queue_new(allocator, 5);
+    ASSERT_NOT_NULL(queue);
+    ASSERT_UINT_EQUALS(8, aws_mpmc_queue_get_capacity(queue));
+
+    void *item = NULL;
+    ASSERT_FALSE(aws_mpmc_queue_try_pop(queue, &item));
+
+    /* go around the ring a few times, in and out of order with the slots */
+    uintptr_t next_push = 1;
+    uintptr_t next_pop = 1;
+    for (size_t round = 0; round < 10; ++round) {
+        for (size_t i = 0; i < 5; ++i) {
+            ASSERT_TRUE(aws_mpmc_queue_try_push(queue, (void *)next_push++));
+        }
+        for (size_t i = 0; i < 3; ++i) {
+            ASSERT_TRUE(aws_mpmc_queue_try_pop(queue, &item));
+            ASSERT_PTR_EQUALS((void *)next_pop++, item);
+        }
+        for (size_t i = 0; i < 2; ++i) {
+            ASSERT_TRUE(aws_mpmc_queue_try_pop(queue, &item));
+            ASSERT_PTR_EQUALS((void *)next_pop++, item);
+        }
+        ASSERT_FALSE(aws_mpmc_queue_try_pop(queue, &item));
+    }
+
+    /* fill it up */
+    for (size_t i = 0; i < 8; ++i) {
+        ASSERT_TRUE(aws_mpmc_queue_try_push(queue, (void *)next_push++));
+    }
+    ASSERT_FALSE(aws_mpmc_queue_try_push(queue, (void *)next_push));
+    ASSERT_FALSE(aws_mpmc_queue_push_wait(queue, (void *)next_push, 1000000));
+
+    /* batches stop where the queue is full or empty */
+    void *batch[16];
+    ASSERT_UINT_EQUALS(3, aws_mpmc_queue_try_pop_batch(queue, batch, 3));
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_PTR_EQUALS((void *)next_pop++, batch[i]);
+    }
+    for (size_t i = 0; i < 16; ++i) {
+        batch[i] = (void *)(next_push + i);
+    }
+    ASSERT_UINT_EQUALS(3, aws_mpmc_queue_try_push_batch(queue, batch, 16));
+    next_push += 3;
+    ASSERT_UINT_EQUALS(0, aws_mpmc_queue_try_push_batch(queue, batch, 16));
+
+    ASSERT_UINT_EQUALS(8, aws_mpmc_queue_pop_batch_wait(queue, batch, 16, AWS_MPMC_QUEUE_WAIT_FOREVER));
+    for (size_t i = 0; i < 8; ++i) {
+        ASSERT_PTR_EQUALS((void *)next_pop++, batch[i]);
+    }
+    ASSERT_UINT_EQUALS(next_push, next_pop);
+
+    ASSERT_UINT_EQUALS(0, aws_mpmc_queue_try_pop_batch(queue, batch, 16));
+    ASSERT_FALSE(aws_mpmc_queue_pop_wait(queue, &item, 1000000));
+
+    aws_mpmc_queue_destroy(queue);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(mpmc_queue_single_threaded, s_test_mpmc_queue_single_threaded)
+
+enum {
+    THREADED_PRODUCERS = 4,
+    THREADED_CONSUMERS = 4,
+    THREADED_ITEMS_PER_PRODUCER = 50000,
+    THREADED_BATCH_SIZE = 5,
+};
+
+/* item = producer index in the high bits, sequence number (from 1) in the low bits, so NULL is free to mean stop */
+#define ITEM_PRODUCER_SHIFT 24
+
+struct threaded_test_data {
+    struct aws_mpmc_queue *queue;
+    uint8_t *seen; /* one per item */
+    struct aws_atomic_var errors;
+};
+
+struct producer_args {
+    struct threaded_test_data *data;
+    uintptr_t producer;
+};
+
+struct consumer_args {
+    struct threaded_test_data *data;
+    /* last sequence number this consumer saw from each producer */
+    uintptr_t last_seen[THREADED_PRODUCERS];
+};
+
+static void s_producer_fn(void *arg) {
+    struct producer_args *args = arg;
+    struct aws_mpmc_queue *queue = args->data->queue;
+
+    /* half the producers push one at a time, the other half in batches */
+    uintptr_t sequence = 1;
+    while (sequence <= THREADED_ITEMS_PER_PRODUCER) {
+        void *batch[THREADED_BATCH_SIZE];
+        size_t count = args->producer % 2 ? THREADED_BATCH_SIZE : 1;
+        count = aws_min_size(count, THREADED_ITEMS_PER_PRODUCER + 1 - (size_t)sequence);
+        for (size_t i = 0; i < count; ++i) {
+            batch[i] = (void *)(uintptr_t)((args->producer << ITEM_PRODUCER_SHIFT) | (sequence + i));
+        }
+        if (aws_mpmc_queue_push_batch_wait(queue, batch, count, AWS_MPMC_QUEUE_WAIT_FOREVER) != count) {
+            aws_atomic_fetch_add(&args->data->errors, 1);
+            return;
+        }
+        sequence += count;
+    }
+}
+
+static void s_consumer_fn(void *arg) {
+    struct consumer_args *args = arg;
+    struct threaded_test_data *data = args->data;
+
+    for (;;) {
+        void *batch[THREADED_BATCH_SIZE];
+        size_t count =
+            aws_mpmc_queue_pop_batch_wait(data->queue, batch, THREADED_BATCH_SIZE, AWS_MPMC_QUEUE_WAIT_FOREVER);
+        for (size_t i = 0; i < count; ++i) {
+            uintptr_t item = (uintptr_t)batch[i];
+            if (item == 0) {
+                /* only stop items are left, hand back the ones meant for other consumers */
+                for (size_t extra = i + 1; extra < count; ++extra) {
+                    aws_mpmc_queue_push_wait(data->queue, NULL, AWS_MPMC_QUEUE_WAIT_FOREVER);
+                }
+                return;
+            }
+            uintptr_t producer = item >> ITEM_PRODUCER_SHIFT;
+            uintptr_t sequence = item & (((uintptr_t)1 << ITEM_PRODUCER_SHIFT) - 1);
+
+            /* items from one producer come out in order, whoever pops them */
+            if (sequence <= args->last_seen[producer]) {
+                aws_atomic_fetch_add(&data->errors, 1);
+            }
+            args->last_seen[producer] = sequence;
+            data->seen[producer * THREADED_ITEMS_PER_PRODUCER + sequence - 1]++;
+        }
+    }
+}
+
+static int s_test_mpmc_queue_multi_threaded(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    struct threaded_test_data data;
+    AWS_ZERO_STRUCT(data);
+    aws_atomic_init_int(&data.errors, 0);
+    /* small, so everyone spends plenty of time full or empty */
+    data.queue = aws_mpmc_queue_new(allocator, 16);
+    ASSERT_NOT_NULL(data.queue);
+    data.seen = aws_mem_calloc(allocator, THREADED_PRODUCERS * THREADED_ITEMS_PER_PRODUCER, 1);
+    ASSERT_NOT_NULL(data.seen);
+
+    struct aws_thread producers[THREADED_PRODUCERS];
+    struct producer_args producer_args[THREADED_PRODUCERS];
+    struct aws_thread consumers[THREADED_CONSUMERS];
+    struct consumer_args consumer_args[THREADED_CONSUMERS];
+
+    for (size_t i = 0; i < THREADED_CONSUMERS; ++i) {
+        AWS_ZERO_STRUCT(consumer_args[i]);
+        consumer_args[i].data = &data;
+        ASSERT_SUCCESS(aws_thread_init(&consumers[i], allocator));
+        ASSERT_SUCCESS(aws_thread_launch(&consumers[i], s_consumer_fn, &consumer_args[i], NULL));
+    }
+    for (size_t i = 0; i < THREADED_PRODUCERS; ++i) {
+        producer_args[i].data = &data;
+        producer_args[i].producer = i;
+        ASSERT_SUCCESS(aws_thread_init(&producers[i], allocator));
+        ASSERT_SUCCESS(aws_thread_launch(&producers[i], s_producer_fn, &producer_args[i], NULL));
+    }
+
+    for (size_t i = 0; i < THREADED_PRODUCERS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&producers[i]));
+        aws_thread_clean_up(&producers[i]);
+    }
+    /* one stop item per consumer, each one stops at the first it sees */
+    for (size_t i = 0; i < THREADED_CONSUMERS; ++i) {
+        ASSERT_TRUE(aws_mpmc_queue_push_wait(data.queue, NULL, AWS_MPMC_QUEUE_WAIT_FOREVER));
+    }
+    for (size_t i = 0; i < THREADED_CONSUMERS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&consumers[i]));
+        aws_thread_clean_up(&consumers[i]);
+    }
+
+    ASSERT_UINT_EQUALS(0, aws_atomic_load_int(&data.errors));
+    for (size_t i = 0; i < THREADED_PRODUCERS * THREADED_ITEMS_PER_PRODUCER; ++i) {
+        ASSERT_UINT_EQUALS(1, data.seen[i]);
+    }
+
+    aws_mem_release(allocator, data.seen);
+    aws_mpmc_queue_destroy(data.queue);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(mpmc_queue_multi_threaded, s_test_mpmc_queue_multi_threaded)
@@ -0,0 +1,229 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/parallel_for.h>
+
+#include <aws/common/atomics.h>
+#include <aws/common/condition_variable.h>
+#include <aws/common/mutex.h>
+#include <aws/common/task_scheduler.h>
+#include <aws/common/thread.h>
+#include <aws/common/thread_pool.h>
+#include <aws/testing/aws_test_harness.h>
+
+struct visit_data {
+    uint8_t *visits;
+    struct aws_atomic_var call_count;
+    aws_thread_id_t last_thread_id;
+};
+
+static void s_visit_fn(size_t begin, size_t end, void *user_data) {
+    struct visit_data *data = user_data;
+    for (size_t i = begin; i < end; ++i) {
+        /* ranges never overlap, so no two threads write the same byte */
+        data->visits[i]++;
+    }
+    data->last_thread_id = aws_thread_current_thread_id();
+    aws_atomic_fetch_add(&data->call_count, 1);
+}
+
+static int s_check_visited_once(const struct visit_data *data, size_t begin, size_t end, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        ASSERT_UINT_EQUALS(i >= begin && i < end ? 1 : 0, data->visits[i]);
+    }
+    return AWS_OP_SUCCESS;
+}
+
+static int s_test_parallel_for_covers_range(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_common_library_init(allocator);
+
+    enum { SIZE = 100000 };
+    struct visit_data data;
+    AWS_ZERO_STRUCT(data);
+    data.visits = aws_mem_calloc(allocator, SIZE, 1);
+    ASSERT_NOT_NULL(data.visits);
+    aws_atomic_init_int(&data.call_count, 0);
+
+    struct aws_thread_pool_options options = {.worker_count = 4};
+    struct aws_thread_pool *pool = aws_thread_pool_new(allocator, &options);
+    ASSERT_NOT_NULL(pool);
+
+    /* about four chunks per thread */
+    aws_parallel_for(allocator, pool, 7, SIZE - 3, 1, s_visit_fn, &data);
+    ASSERT_SUCCESS(s_check_visited_once(&data, 7, SIZE - 3, SIZE));
+    ASSERT_UINT_EQUALS(20, aws_atomic_load_int(&data.call_count));
+
+    /* the grain wins over the automatic chunk size */
+    memset(data.visits, 0, SIZE);
+    aws_atomic_store_int(&data.call_count, 0);
+    aws_parallel_for(allocator, pool, 0, SIZE, SIZE / 2, s_visit_fn, &data);
+    ASSERT_SUCCESS(s_check_visited_once(&data, 0, SIZE, SIZE));
+    ASSERT_UINT_EQUALS(2, aws_atomic_load_int(&data.call_count));
+
+    /* a range that fits in one grain runs on the calling thread */
+    memset(data.visits, 0, SIZE);
+    aws_atomic_store_int(&data.call_count, 0);
+    aws_parallel_for(allocator, pool, 0, 100, 1000, s_visit_fn, &data);
+    ASSERT_SUCCESS(s_check_visited_once(&data, 0, 100, SIZE));
+    ASSERT_UINT_EQUALS(1, aws_atomic_load_int(&data.call_count));
+    ASSERT_TRUE(aws_thread_thread_id_equal(aws_thread_current_thread_id(), data.last_thread_id));
+
+    /* so does everything without a pool */
+    memset(data.visits, 0, SIZE);
+    aws_atomic_store_int(&data.call_count, 0);
+    aws_parallel_for(allocator, NULL, 0, SIZE, 1, s_visit_fn, &data);
+    ASSERT_SUCCESS(s_check_visited_once(&data, 0, SIZE, SIZE));
+    ASSERT_UINT_EQUALS(1, aws_atomic_load_int(&data.call_count));
+
+    aws_parallel_for(allocator, pool, 5, 5, 1, s_visit_fn, &data);
+    ASSERT_UINT_EQUALS(1, aws_atomic_load_int(&data.call_count));
+
+    aws_thread_pool_release(pool);
+    aws_mem_release(allocator, data.visits);
+    aws_common_library_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(parallel_for_covers_range, s_test_parallel_for_covers_range)
+
+struct sum_result {
+    uint64_t sum;
+    /* range folded into this result, to check the partial results are combined in order */
+    size_t begin;
+    size_t end;
+    bool out_of_order;
+};
+
+static void s_sum_reduce_fn(size_t begin, size_t end, void *partial_result, void *user_data) {
+    (void)user_data;
+    struct sum_result *partial = partial_result;
+    if (partial->begin != 0 || partial->end != 0) {
+        partial->out_of_order = true;
+    }
+    for (size_t i = begin; i < end; ++i) {
+        partial->sum += i;
+    }
+    partial->begin = begin;
+    partial->end = end;
+}
+
+static void s_sum_combine_fn(void *result, const void *partial_result, void *user_data) {
+    (void)user_data;
+    struct sum_result *total = result;
+    const struct sum_result *partial = partial_result;
+
+    if (partial->begin != total->end) {
+        total->out_of_order = true;
+    }
+    total->out_of_order |= partial->out_of_order;
+    total->sum += partial->sum;
+    total->end = partial->end;
+}
+
+static int s_test_parallel_reduce_sum(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_common_library_init(allocator);
+
+    struct aws_thread_pool_options options = {.worker_count = 3};
+    struct aws_thread_pool *pool = aws_thread_pool_new(allocator, &options);
+    ASSERT_NOT_NULL(pool);
+
+    const size_t counts[] = {1, 10, 1000, 123457};
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(counts); ++i) {
+        struct sum_result identity = {0};
+        struct sum_result result = {0};
+        ASSERT_SUCCESS(aws_parallel_reduce(
+            allocator,
+            pool,
+            0,
+            counts[i],
+            1,
+            sizeof(struct sum_result),
+            &identity,
+            &result,
+            s_sum_reduce_fn,
+            s_sum_combine_fn,
+            NULL));
+
+        ASSERT_FALSE(result.out_of_order);
+        ASSERT_UINT_EQUALS(counts[i], result.end);
+        ASSERT_UINT_EQUALS((uint64_t)counts[i] * (counts[i] - 1) / 2, result.sum);
+    }
+
+    aws_thread_pool_release(pool);
+    aws_common_library_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(parallel_reduce_sum, s_test_parallel_reduce_sum)
+
+struct nested_data {
+    struct aws_allocator *allocator;
+    struct aws_thread_pool *pool;
+    struct visit_data visit;
+    struct aws_mutex mutex;
+    struct aws_condition_variable c_var;
+    size_t done_count;
+};
+
+enum { NESTED_TASKS = 4, NESTED_SIZE = 10000 };
+
+/* Every worker runs a parallel_for at once, so the helpers they submit can only run once the loops are over. */
+static void s_nested_task_fn(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)status;
+    struct nested_data *data = arg;
+    size_t index = (size_t)(task->type_tag[0] - '0');
+
+    aws_parallel_for(
+        data->allocator, data->pool, index * NESTED_SIZE, (index + 1) * NESTED_SIZE, 1, s_visit_fn, &data->visit);
+
+    aws_mutex_lock(&data->mutex);
+    ++data->done_count;
+    aws_mutex_unlock(&data->mutex);
+    aws_condition_variable_notify_one(&data->c_var);
+}
+
+static bool s_nested_done_pred(void *arg) {
+    struct nested_data *data = arg;
+    return data->done_count == NESTED_TASKS;
+}
+
+static int s_test_parallel_for_from_pool_task(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_common_library_init(allocator);
+
+    struct nested_data data = {
+        .allocator = allocator,
+        .mutex = AWS_MUTEX_INIT,
+        .c_var = AWS_CONDITION_VARIABLE_INIT,
+    };
+    data.visit.visits = aws_mem_calloc(allocator, NESTED_TASKS * NESTED_SIZE, 1);
+    ASSERT_NOT_NULL(data.visit.visits);
+    aws_atomic_init_int(&data.visit.call_count, 0);
+
+    struct aws_thread_pool_options options = {.worker_count = 2};
+    data.pool = aws_thread_pool_new(allocator, &options);
+    ASSERT_NOT_NULL(data.pool);
+
+    static const char *s_tags[NESTED_TASKS] = {"0", "1", "2", "3"};
+    struct aws_task tasks[NESTED_TASKS];
+    for (size_t i = 0; i < NESTED_TASKS; ++i) {
+        aws_task_init(&tasks[i], s_nested_task_fn, &data, s_tags[i]);
+        aws_thread_pool_submit(data.pool, &tasks[i]);
+    }
+
+    ASSERT_SUCCESS(aws_mutex_lock(&data.mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(&data.c_var, &data.mutex, s_nested_done_pred, &data));
+    ASSERT_SUCCESS(aws_mutex_unlock(&data.mutex));
+    ASSERT_SUCCESS(s_check_visited_once(&data.visit, 0, NESTED_TASKS * NESTED_SIZE, NESTED_TASKS * NESTED_SIZE));
+
+    aws_thread_pool_release(data.pool);
+    aws_mem_release(allocator, data.visit.visits);
+    aws_common_library_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(parallel_for_from_pool_task, s_test_parallel_for_from_pool_task)
@@ -0,0 +1,356 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/persistent_ring_buffer.h>
+
+#include <aws/common/file.h>
+#include <aws/common/math.h>
+#include <aws/common/string.h>
+#include <aws/testing/aws_test_harness.h>
+
+/*
+ * The tests that damage the file know its layout: two 512 byte header copies at the start of a 4096 byte header
+ * region, then the records. A record with a 48 byte payload takes 64 bytes.
+ */
+#define HEADER_REGION_SIZE 4096
+#define HEADER_SLOT_SIZE 512
+#define HEADER_SEQUENCE_OFFSET 24
+#define SMALL_RECORD_SIZE 48
+#define SMALL_RECORD_FOOTPRINT 64
+
+/* each test gets its own file, since tests may run in parallel */
+AWS_STATIC_STRING_FROM_LITERAL(s_push_consume_path, "persistent_ring_buffer_push_consume.spool");
+AWS_STATIC_STRING_FROM_LITERAL(s_reopen_path, "persistent_ring_buffer_reopen.spool");
+AWS_STATIC_STRING_FROM_LITERAL(s_torn_header_path, "persistent_ring_buffer_torn_header.spool");
+AWS_STATIC_STRING_FROM_LITERAL(s_truncated_file_path, "persistent_ring_buffer_truncated_file.spool");
+AWS_STATIC_STRING_FROM_LITERAL(s_power_loss_path, "persistent_ring_buffer_power_loss.spool");
+static const struct aws_string *s_spool_path;
+AWS_STATIC_STRING_FROM_LITERAL(s_read_mode, "rb");
+AWS_STATIC_STRING_FROM_LITERAL(s_write_mode, "wb");
+
+static struct aws_persistent_ring_buffer *s_open(
+    struct aws_allocator *allocator,
+    size_t capacity,
+    enum aws_persistent_ring_buffer_sync_policy sync_policy) {
+
+    struct aws_persistent_ring_buffer_options options = {
+        .path = aws_byte_cursor_from_string(s_spool_path),
+        .capacity = capacity,
+        .sync_policy = sync_policy,
+        .sync_interval_ns = 1,
+    };
+    return aws_persistent_ring_buffer_new(allocator, &options);
+}
+
+/* Record `id` is (id * 37) % 200 bytes long, unless it's a small one, and its bytes count up from id. */
+static void s_fill_record(struct aws_byte_buf *record, size_t id, bool small) {
+    aws_byte_buf_reset(record, false);
+    size_t size = small ? SMALL_RECORD_SIZE : (id * 37) % 200;
+    for (size_t i = 0; i < size; ++i) {
+        aws_byte_buf_write_u8(record, (uint8_t)(id + i));
+    }
+}
+
+static int s_push_records(struct aws_persistent_ring_buffer *buffer, size_t first_id, size_t count, bool small) {
+    uint8_t storage[256] = {0};
+    struct aws_byte_buf record = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+    for (size_t id = first_id; id < first_id + count; ++id) {
+        s_fill_record(&record, id, small);
+        ASSERT_SUCCESS(aws_persistent_ring_buffer_push(buffer, aws_byte_cursor_from_buf(&record)));
+    }
+    return AWS_OP_SUCCESS;
+}
+
+static int s_consume_records(struct aws_persistent_ring_buffer *buffer, size_t first_id, size_t count, bool small) {
+    uint8_t storage[256] = {0};
+    struct aws_byte_buf expected = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+    for (size_t id = first_id; id < first_id + count; ++id) {
+        s_fill_record(&expected, id, small);
+        struct aws_byte_cursor record;
+        ASSERT_TRUE(aws_persistent_ring_buffer_peek(buffer, &record));
+        ASSERT_BIN_ARRAYS_EQUALS(expected.buffer, expected.len, record.ptr, record.len);
+        ASSERT_SUCCESS(aws_persistent_ring_buffer_consume(buffer));
+    }
+    return AWS_OP_SUCCESS;
+}
+
+static int s_read_file(struct aws_byte_buf *contents) {
+    FILE *file = aws_fopen_safe(s_spool_path, s_read_mode);
+    ASSERT_NOT_NULL(file);
+    contents->len = fread(contents->buffer, 1, contents->capacity, file);
+    fclose(file);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_write_file(const struct aws_byte_buf *contents, size_t length) {
+    FILE *file = aws_fopen_safe(s_spool_path, s_write_mode);
+    ASSERT_NOT_NULL(file);
+    ASSERT_UINT_EQUALS(length, fwrite(contents->buffer, 1, length, file));
+    fclose(file);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_test_persistent_ring_buffer_push_consume(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    s_spool_path = s_push_consume_path;
+    aws_file_delete(s_spool_path);
+
+    struct aws_persistent_ring_buffer *buffer = s_open(allocator, 100, AWS_PERSISTENT_RING_BUFFER_SYNC_NEVER);
+    ASSERT_NOT_NULL(buffer);
+    ASSERT_UINT_EQUALS(4096, aws_persistent_ring_buffer_get_capacity(buffer));
+
+    struct aws_byte_cursor record;
+    ASSERT_FALSE(aws_persistent_ring_buffer_peek(buffer, &record));
+    ASSERT_ERROR(AWS_ERROR_LIST_EMPTY, aws_persistent_ring_buffer_consume(buffer));
+    uint8_t too_big[4096] = {0};
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT,
+        aws_persistent_ring_buffer_push(buffer, aws_byte_cursor_from_array(too_big, sizeof(too_big))));
+
+    /* many laps of records of all sizes, consuming only when full */
+    size_t pushed = 0;
+    size_t consumed = 0;
+    uint8_t storage[256] = {0};
+    struct aws_byte_buf next = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+    while (pushed < 2000) {
+        s_fill_record(&next, pushed, false);
+        if (aws_persistent_ring_buffer_push(buffer, aws_byte_cursor_from_buf(&next)) == AWS_OP_SUCCESS) {
+            ++pushed;
+            continue;
+        }
+        ASSERT_INT_EQUALS(AWS_ERROR_OOM, aws_last_error());
+        ASSERT_TRUE(pushed > consumed);
+        size_t count = (pushed - consumed + 1) / 2;
+        ASSERT_SUCCESS(s_consume_records(buffer, consumed, count, false));
+        consumed += count;
+    }
+
+    ASSERT_UINT_EQUALS(pushed - consumed, aws_persistent_ring_buffer_get_record_count(buffer));
+    ASSERT_SUCCESS(s_consume_records(buffer, consumed, pushed - consumed, false));
+    ASSERT_FALSE(aws_persistent_ring_buffer_peek(buffer, &record));
+
+    aws_persistent_ring_buffer_destroy(buffer);
+    aws_file_delete(s_spool_path);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(persistent_ring_buffer_push_consume, s_test_persistent_ring_buffer_push_consume)
+
+static int s_test_persistent_ring_buffer_reopen(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    s_spool_path = s_reopen_path;
+
+    const enum aws_persistent_ring_buffer_sync_policy policies[] = {
+        AWS_PERSISTENT_RING_BUFFER_SYNC_NEVER,
+        AWS_PERSISTENT_RING_BUFFER_SYNC_PERIODIC,
+        AWS_PERSISTENT_RING_BUFFER_SYNC_PER_COMMIT,
+    };
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(policies); ++i) {
+        aws_file_delete(s_spool_path);
+
+        struct aws_persistent_ring_buffer *buffer = s_open(allocator, 4096, policies[i]);
+        ASSERT_NOT_NULL(buffer);
+        /* ends up with records 30 to 79, wrapped around the end of the file */
+        ASSERT_SUCCESS(s_push_records(buffer, 0, 50, true));
+        ASSERT_SUCCESS(s_consume_records(buffer, 0, 30, true));
+        ASSERT_SUCCESS(s_push_records(buffer, 50, 30, true));
+        aws_persistent_ring_buffer_destroy(buffer);
+
+        /* the file's capacity wins over the one asked for */
+        buffer = s_open(allocator, 1 << 20, policies[i]);
+        ASSERT_NOT_NULL(buffer);
+        ASSERT_UINT_EQUALS(4096, aws_persistent_ring_buffer_get_capacity(buffer));
+        ASSERT_UINT_EQUALS(50, aws_persistent_ring_buffer_get_record_count(buffer));
+        ASSERT_SUCCESS(s_consume_records(buffer, 30, 10, true));
+        ASSERT_SUCCESS(s_push_records(buffer, 80, 5, true));
+        aws_persistent_ring_buffer_destroy(buffer);
+
+        buffer = s_open(allocator, 4096, policies[i]);
+        ASSERT_NOT_NULL(buffer);
+        ASSERT_UINT_EQUALS(45, aws_persistent_ring_buffer_get_record_count(buffer));
+        ASSERT_SUCCESS(s_consume_records(buffer, 40, 45, true));
+        aws_persistent_ring_buffer_destroy(buffer);
+    }
+
+    aws_file_delete(s_spool_path);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(persistent_ring_buffer_reopen, s_test_persistent_ring_buffer_reopen)
+
+/* Tearing either header copy loses at most the last update; tearing both starts over empty. */
+static int s_test_persistent_ring_buffer_torn_header(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    s_spool_path = s_torn_header_path;
+
+    struct aws_byte_buf contents;
+    ASSERT_SUCCESS(aws_byte_buf_init(&contents, allocator, HEADER_REGION_SIZE + 4096));
+
+    size_t recovered_counts[2] = {0};
+    for (size_t slot = 0; slot < 3; ++slot) {
+        aws_file_delete(s_spool_path);
+        struct aws_persistent_ring_buffer *buffer = s_open(allocator, 4096, AWS_PERSISTENT_RING_BUFFER_SYNC_NEVER);
+        ASSERT_NOT_NULL(buffer);
+        ASSERT_SUCCESS(s_push_records(buffer, 0, 5, true));
+        aws_persistent_ring_buffer_destroy(buffer);
+
+        ASSERT_SUCCESS(s_read_file(&contents));
+        ASSERT_UINT_EQUALS(HEADER_REGION_SIZE + 4096, contents.len);
+        /* slot 2 means both */
+        for (size_t torn = 0; torn < 2; ++torn) {
+            if (slot == torn || slot == 2) {
+                memset(contents.buffer + torn * HEADER_SLOT_SIZE + 20, 0xAB, 16);
+            }
+        }
+        ASSERT_SUCCESS(s_write_file(&contents, contents.len));
+
+        buffer = s_open(allocator, 8192, AWS_PERSISTENT_RING_BUFFER_SYNC_NEVER);
+        ASSERT_NOT_NULL(buffer);
+        size_t count = aws_persistent_ring_buffer_get_record_count(buffer);
+        if (slot == 2) {
+            ASSERT_UINT_EQUALS(0, count);
+            ASSERT_UINT_EQUALS(8192, aws_persistent_ring_buffer_get_capacity(buffer));
+        } else {
+            recovered_counts[slot] = count;
+            ASSERT_UINT_EQUALS(4096, aws_persistent_ring_buffer_get_capacity(buffer));
+            ASSERT_SUCCESS(s_consume_records(buffer, 0, count, true));
+        }
+        aws_persistent_ring_buffer_destroy(buffer);
+    }
+
+    /* one copy held the last push and the other didn't */
+    ASSERT_UINT_EQUALS(9, recovered_counts[0] + recovered_counts[1]);
+    ASSERT_TRUE(recovered_counts[0] == 4 || recovered_counts[0] == 5);
+
+    aws_byte_buf_clean_up(&contents);
+    aws_file_delete(s_spool_path);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(persistent_ring_buffer_torn_header, s_test_persistent_ring_buffer_torn_header)
+
+/* A file cut short keeps the records that are still whole, and so does one with a damaged record. */
+static int s_test_persistent_ring_buffer_truncated_file(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    s_spool_path = s_truncated_file_path;
+
+    struct aws_byte_buf contents;
+    ASSERT_SUCCESS(aws_byte_buf_init(&contents, allocator, HEADER_REGION_SIZE + 4096));
+
+    aws_file_delete(s_spool_path);
+    struct aws_persistent_ring_buffer *buffer = s_open(allocator, 4096, AWS_PERSISTENT_RING_BUFFER_SYNC_PER_COMMIT);
+    ASSERT_NOT_NULL(buffer);
+    ASSERT_SUCCESS(s_push_records(buffer, 0, 10, true));
+    aws_persistent_ring_buffer_destroy(buffer);
+
+    /* cut in the middle of record 6 */
+    ASSERT_SUCCESS(s_read_file(&contents));
+    ASSERT_SUCCESS(s_write_file(&contents, HEADER_REGION_SIZE + 6 * SMALL_RECORD_FOOTPRINT + 20));
+
+    buffer = s_open(allocator, 4096, AWS_PERSISTENT_RING_BUFFER_SYNC_PER_COMMIT);
+    ASSERT_NOT_NULL(buffer);
+    ASSERT_UINT_EQUALS(6, aws_persistent_ring_buffer_get_record_count(buffer));
+    /* and what comes after is usable again */
+    ASSERT_SUCCESS(s_push_records(buffer, 6, 2, true));
+    aws_persistent_ring_buffer_destroy(buffer);
+
+    /* damage a payload byte of record 3 */
+    ASSERT_SUCCESS(s_read_file(&contents));
+    ASSERT_UINT_EQUALS(HEADER_REGION_SIZE + 4096, contents.len);
+    contents.buffer[HEADER_REGION_SIZE + 3 * SMALL_RECORD_FOOTPRINT + 30] ^= 0x01;
+    ASSERT_SUCCESS(s_write_file(&contents, contents.len));
+
+    buffer = s_open(allocator, 4096, AWS_PERSISTENT_RING_BUFFER_SYNC_PER_COMMIT);
+    ASSERT_NOT_NULL(buffer);
+    ASSERT_UINT_EQUALS(3, aws_persistent_ring_buffer_get_record_count(buffer));
+    ASSERT_SUCCESS(s_consume_records(buffer, 0, 3, true));
+    aws_persistent_ring_buffer_destroy(buffer);
+
+    /* cut inside the header region: nothing to recover */
+    ASSERT_SUCCESS(s_write_file(&contents, 40));
+    buffer = s_open(allocator, 4096, AWS_PERSISTENT_RING_BUFFER_SYNC_PER_COMMIT);
+    ASSERT_NOT_NULL(buffer);
+    ASSERT_UINT_EQUALS(0, aws_persistent_ring_buffer_get_record_count(buffer));
+    ASSERT_SUCCESS(s_push_records(buffer, 0, 1, true));
+    ASSERT_SUCCESS(s_consume_records(buffer, 0, 1, true));
+    aws_persistent_ring_buffer_destroy(buffer);
+
+    aws_byte_buf_clean_up(&contents);
+    aws_file_delete(s_spool_path);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(persistent_ring_buffer_truncated_file, s_test_persistent_ring_buffer_truncated_file)
+
+static uint64_t s_header_sequence(const struct aws_byte_buf *contents, size_t slot) {
+    uint64_t sequence = 0;
+    memcpy(&sequence, contents->buffer + slot * HEADER_SLOT_SIZE + HEADER_SEQUENCE_OFFSET, sizeof(sequence));
+    return sequence;
+}
+
+/*
+ * With AWS_PERSISTENT_RING_BUFFER_SYNC_PER_COMMIT, the power going out in the middle of a push that reuses space freed
+ * by (unsynced) consumes must not cost any record that was already committed.
+ *
+ * Without a way to drop the page cache, the file as it would be on disk is put together by hand: the header region as
+ * of the last push, plus any header copy the interrupted push wrote before its own, which it only writes to sync it.
+ * The push's own header is lost, as if the power went out right after its record was synced.
+ */
+static int s_test_persistent_ring_buffer_power_loss(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    s_spool_path = s_power_loss_path;
+    aws_file_delete(s_spool_path);
+
+    struct aws_byte_buf synced_headers;
+    ASSERT_SUCCESS(aws_byte_buf_init(&synced_headers, allocator, HEADER_REGION_SIZE + 4096));
+    struct aws_byte_buf consumed_headers;
+    ASSERT_SUCCESS(aws_byte_buf_init(&consumed_headers, allocator, HEADER_REGION_SIZE + 4096));
+    struct aws_byte_buf contents;
+    ASSERT_SUCCESS(aws_byte_buf_init(&contents, allocator, HEADER_REGION_SIZE + 4096));
+
+    struct aws_persistent_ring_buffer *buffer = s_open(allocator, 4096, AWS_PERSISTENT_RING_BUFFER_SYNC_PER_COMMIT);
+    ASSERT_NOT_NULL(buffer);
+    /* full, and synced up to record 63 */
+    ASSERT_SUCCESS(s_push_records(buffer, 0, 64, true));
+    ASSERT_SUCCESS(s_read_file(&synced_headers));
+
+    ASSERT_SUCCESS(s_consume_records(buffer, 0, 10, true));
+    ASSERT_SUCCESS(s_read_file(&consumed_headers));
+    uint64_t last_consume_sequence =
+        aws_max_u64(s_header_sequence(&consumed_headers, 0), s_header_sequence(&consumed_headers, 1));
+
+    /* lands where record 0 used to be */
+    ASSERT_SUCCESS(s_push_records(buffer, 64, 1, true));
+    ASSERT_SUCCESS(s_read_file(&contents));
+    ASSERT_UINT_EQUALS(HEADER_REGION_SIZE + 4096, contents.len);
+    aws_persistent_ring_buffer_destroy(buffer);
+
+    uint64_t push_sequence = aws_max_u64(s_header_sequence(&contents, 0), s_header_sequence(&contents, 1));
+    for (size_t slot = 0; slot < 2; ++slot) {
+        uint64_t sequence = s_header_sequence(&contents, slot);
+        if (sequence <= last_consume_sequence || sequence == push_sequence) {
+            memcpy(
+                contents.buffer + slot * HEADER_SLOT_SIZE,
+                synced_headers.buffer + slot * HEADER_SLOT_SIZE,
+                HEADER_SLOT_SIZE);
+        }
+    }
+    ASSERT_SUCCESS(s_write_file(&contents, contents.len));
+
+    buffer = s_open(allocator, 4096, AWS_PERSISTENT_RING_BUFFER_SYNC_PER_COMMIT);
+    ASSERT_NOT_NULL(buffer);
+    ASSERT_UINT_EQUALS(54, aws_persistent_ring_buffer_get_record_count(buffer));
+    ASSERT_SUCCESS(s_consume_records(buffer, 10, 54, true));
+    aws_persistent_ring_buffer_destroy(buffer);
+
+    aws_byte_buf_clean_up(&contents);
+    aws_byte_buf_clean_up(&consumed_headers);
+    aws_byte_buf_clean_up(&synced_headers);
+    aws_file_delete(s_spool_path);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(persistent_ring_buffer_power_loss, s_test_persistent_ring_buffer_power_loss)
@@ -486,6 +486,199 @@ static int s_priority_queue_clear_backpointers_test(struct aws_allocator *alloca
     return 0;
 }
 
+struct arity_test_element {
+    int value;
+    struct aws_priority_queue_node node;
+};
+
+static int s_compare_arity_test_elements(const void *a, const void *b) {
+    const struct arity_test_element *arg1 = *(const struct arity_test_element **)a;
+    const struct arity_test_element *arg2 = *(const struct arity_test_element **)b;
+    return s_compare_ints(&arg1->value, &arg2->value);
+}
+
+static int s_check_arity(struct aws_allocator *allocator, size_t arity) {
+    enum { SIZE = 500 };
+    struct arity_test_element elements[SIZE];
+    int expected[SIZE];
+
+    struct aws_priority_queue queue;
+    ASSERT_SUCCESS(aws_priority_queue_init_dynamic_with_arity(
+        &queue, allocator, 4, sizeof(struct arity_test_element *), s_compare_arity_test_elements, arity));
+
+    for (size_t i = 0; i < SIZE; ++i) {
+        elements[i].value = rand() % 1000;
+        aws_priority_queue_node_init(&elements[i].node);
+        struct arity_test_element *element = &elements[i];
+        ASSERT_SUCCESS(aws_priority_queue_push_ref(&queue, &element, &element->node));
+    }
+
+    /* remove every third element through its backpointer, then everything else must pop in order */
+    size_t expected_count = 0;
+    for (size_t i = 0; i < SIZE; ++i) {
+        if (i % 3 == 0) {
+            struct arity_test_element *removed = NULL;
+            ASSERT_SUCCESS(aws_priority_queue_remove(&queue, &removed, &elements[i].node));
+            ASSERT_PTR_EQUALS(&elements[i], removed);
+            ASSERT_FALSE(aws_priority_queue_node_is_in_queue(&elements[i].node));
+        } else {
+            expected[expected_count++] = elements[i].value;
+        }
+    }
+
+    qsort(expected, expected_count, sizeof(int), s_compare_ints);
+    ASSERT_UINT_EQUALS(expected_count, aws_priority_queue_size(&queue));
+
+    for (size_t i = 0; i < expected_count; ++i) {
+        struct arity_test_element *top = NULL;
+        ASSERT_SUCCESS(aws_priority_queue_pop(&queue, &top));
+        ASSERT_INT_EQUALS(expected[i], top->value);
+        ASSERT_FALSE(aws_priority_queue_node_is_in_queue(&top->node));
+    }
+
+    aws_priority_queue_clean_up(&queue);
+    return 0;
+}
+
+static int s_test_priority_queue_arity(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    srand((unsigned)(uintptr_t)&allocator);
+    for (size_t arity = 2; arity <= AWS_PRIORITY_QUEUE_MAX_ARITY; ++arity) {
+        ASSERT_SUCCESS(s_check_arity(allocator, arity));
+    }
+
+    struct aws_priority_queue queue;
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT,
+        aws_priority_queue_init_dynamic_with_arity(&queue, allocator, 4, sizeof(int), s_compare_ints, 1));
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT,
+        aws_priority_queue_init_dynamic_with_arity(
+            &queue, allocator, 4, sizeof(int), s_compare_ints, AWS_PRIORITY_QUEUE_MAX_ARITY + 1));
+
+    return 0;
+}
+
+static int s_test_priority_queue_update(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    enum { SIZE = 200 };
+    struct arity_test_element elements[SIZE];
+    int expected[SIZE];
+
+    struct aws_priority_queue queue;
+    ASSERT_SUCCESS(aws_priority_queue_init_dynamic(
+        &queue, allocator, SIZE, sizeof(struct arity_test_element *), s_compare_arity_test_elements));
+
+    srand((unsigned)(uintptr_t)&queue);
+    for (size_t i = 0; i < SIZE; ++i) {
+        elements[i].value = rand() % 1000;
+        aws_priority_queue_node_init(&elements[i].node);
+        struct arity_test_element *element = &elements[i];
+        ASSERT_SUCCESS(aws_priority_queue_push_ref(&queue, &element, &element->node));
+    }
+
+    /* move every element somewhere else, half of them towards the top and half towards the bottom */
+    for (size_t i = 0; i < SIZE; ++i) {
+        elements[i].value = (i % 2) ? elements[i].value / 2 : elements[i].value * 2;
+        ASSERT_SUCCESS(aws_priority_queue_update(&queue, &elements[i].node));
+        expected[i] = elements[i].value;
+    }
+
+    qsort(expected, SIZE, sizeof(int), s_compare_ints);
+    for (size_t i = 0; i < SIZE; ++i) {
+        struct arity_test_element *top = NULL;
+        ASSERT_SUCCESS(aws_priority_queue_pop(&queue, &top));
+        ASSERT_INT_EQUALS(expected[i], top->value);
+    }
+
+    /* updating a node that is no longer in the queue is an error */
+    ASSERT_ERROR(AWS_ERROR_PRIORITY_QUEUE_BAD_NODE, aws_priority_queue_update(&queue, &elements[0].node));
+
+    aws_priority_queue_clean_up(&queue);
+    return 0;
+}
+
+static int s_check_push_many(struct aws_allocator *allocator, size_t initial_count, size_t batch_count) {
+    enum { SIZE = 300 };
+    AWS_FATAL_ASSERT(initial_count + batch_count <= SIZE);
+
+    struct arity_test_element elements[SIZE];
+    struct arity_test_element *element_ptrs[SIZE];
+    struct aws_priority_queue_node *backpointers[SIZE];
+    int expected[SIZE];
+
+    struct aws_priority_queue queue;
+    ASSERT_SUCCESS(aws_priority_queue_init_dynamic_with_arity(
+        &queue, allocator, 1, sizeof(struct arity_test_element *), s_compare_arity_test_elements, 4));
+
+    size_t count = initial_count + batch_count;
+    for (size_t i = 0; i < count; ++i) {
+        elements[i].value = rand() % 1000;
+        aws_priority_queue_node_init(&elements[i].node);
+        element_ptrs[i] = &elements[i];
+        /* leave a few holes to make sure NULL backpointers are accepted */
+        backpointers[i] = (i % 5) ? &elements[i].node : NULL;
+        expected[i] = elements[i].value;
+    }
+
+    for (size_t i = 0; i < initial_count; ++i) {
+        ASSERT_SUCCESS(aws_priority_queue_push_ref(&queue, &element_ptrs[i], backpointers[i]));
+    }
+    ASSERT_SUCCESS(aws_priority_queue_push_many_ref(
+        &queue, &element_ptrs[initial_count], &backpointers[initial_count], batch_count));
+    ASSERT_UINT_EQUALS(count, aws_priority_queue_size(&queue));
+
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_TRUE(aws_priority_queue_node_is_in_queue(&elements[i].node) == (backpointers[i] != NULL));
+    }
+
+    qsort(expected, count, sizeof(int), s_compare_ints);
+    for (size_t i = 0; i < count; ++i) {
+        struct arity_test_element *top = NULL;
+        ASSERT_SUCCESS(aws_priority_queue_pop(&queue, &top));
+        ASSERT_INT_EQUALS(expected[i], top->value);
+        ASSERT_FALSE(aws_priority_queue_node_is_in_queue(&top->node));
+    }
+
+    aws_priority_queue_clean_up(&queue);
+    return 0;
+}
+
+static int s_test_priority_queue_push_many(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    srand((unsigned)(uintptr_t)&allocator);
+
+    /* both the bulk rebuild and the sift-each path */
+    ASSERT_SUCCESS(s_check_push_many(allocator, 0, 1));
+    ASSERT_SUCCESS(s_check_push_many(allocator, 0, 250));
+    ASSERT_SUCCESS(s_check_push_many(allocator, 10, 250));
+    ASSERT_SUCCESS(s_check_push_many(allocator, 250, 10));
+
+    /* a static queue accepts a batch that fits and rejects one that doesn't, without partially adding it */
+    enum { STATIC_SIZE = 8 };
+    int storage[STATIC_SIZE];
+    int values[STATIC_SIZE] = {7, 3, 5, 1, 8, 2, 6, 4};
+    struct aws_priority_queue queue;
+    aws_priority_queue_init_static(&queue, storage, STATIC_SIZE, sizeof(int), s_compare_ints);
+
+    ASSERT_SUCCESS(aws_priority_queue_push_many(&queue, values, 5));
+    ASSERT_ERROR(AWS_ERROR_LIST_EXCEEDS_MAX_SIZE, aws_priority_queue_push_many(&queue, values, 4));
+    ASSERT_UINT_EQUALS(5, aws_priority_queue_size(&queue));
+    ASSERT_SUCCESS(aws_priority_queue_push_many(&queue, &values[5], 3));
+
+    for (int i = 1; i <= STATIC_SIZE; ++i) {
+        int top = 0;
+        ASSERT_SUCCESS(aws_priority_queue_pop(&queue, &top));
+        ASSERT_INT_EQUALS(i, top);
+    }
+
+    aws_priority_queue_clean_up(&queue);
+    return 0;
+}
+
 AWS_TEST_CASE(priority_queue_remove_interior_sift_down_test, s_test_remove_interior_sift_down);
 AWS_TEST_CASE(priority_queue_remove_interior_sift_up_test, s_test_remove_interior_sift_up);
 AWS_TEST_CASE(priority_queue_remove_leaf_test, s_test_remove_leaf);
@@ -494,3 +687,6 @@ AWS_TEST_CASE(priority_queue_push_pop_order_test, s_test_priority_queue_preserve
 AWS_TEST_CASE(priority_queue_random_values_test, s_test_priority_queue_random_values);
 AWS_TEST_CASE(priority_queue_size_and_capacity_test, s_test_priority_queue_size_and_capacity);
 AWS_TEST_CASE(priority_queue_clear_backpointers_test, s_priority_queue_clear_backpointers_test);
+AWS_TEST_CASE(priority_queue_arity_test, s_test_priority_queue_arity);
+AWS_TEST_CASE(priority_queue_update_test, s_test_priority_queue_update);
+AWS_TEST_CASE(priority_queue_push_many_test, s_test_priority_queue_push_many);
@@ -209,6 +209,165 @@ static int s_test_acquire_tail_always_chases_head(struct aws_allocator *allocato
 
 AWS_TEST_CASE(ring_buffer_acquire_tail_always_chases_head_test, s_test_acquire_tail_always_chases_head)
 
+static int s_test_mirrored_wraps_contiguously(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    struct aws_ring_buffer ring_buffer;
+    ASSERT_SUCCESS(aws_ring_buffer_init_mirrored(&ring_buffer, allocator, 16));
+#ifdef __linux__
+    ASSERT_TRUE(aws_ring_buffer_is_mirrored(&ring_buffer));
+#endif
+    if (!aws_ring_buffer_is_mirrored(&ring_buffer)) {
+        /* fell back to the regular layout with the size as is */
+        ASSERT_UINT_EQUALS(16, ring_buffer.allocation_end - ring_buffer.allocation);
+        aws_ring_buffer_clean_up(&ring_buffer);
+        return AWS_OP_SUCCESS;
+    }
+
+    /* rounded up to a page */
+    size_t capacity = ring_buffer.allocation_end - ring_buffer.allocation;
+    ASSERT_TRUE(capacity >= 16 && capacity % 8 == 0);
+    uint8_t *ptr = ring_buffer.allocation;
+
+    struct aws_byte_buf vended_buffer_1;
+    AWS_ZERO_STRUCT(vended_buffer_1);
+    struct aws_byte_buf vended_buffer_2;
+    AWS_ZERO_STRUCT(vended_buffer_2);
+    struct aws_byte_buf vended_buffer_3;
+    AWS_ZERO_STRUCT(vended_buffer_3);
+
+    ASSERT_SUCCESS(aws_ring_buffer_acquire(&ring_buffer, capacity / 8 * 6, &vended_buffer_1));
+    ASSERT_SUCCESS(aws_ring_buffer_acquire(&ring_buffer, capacity / 8, &vended_buffer_2));
+    ASSERT_PTR_EQUALS(ptr + capacity / 8 * 6, vended_buffer_2.buffer);
+    aws_ring_buffer_release(&ring_buffer, &vended_buffer_1);
+
+    /* runs past allocation_end instead of going back to the start */
+    ASSERT_SUCCESS(aws_ring_buffer_acquire(&ring_buffer, capacity / 8 * 4, &vended_buffer_3));
+    ASSERT_PTR_EQUALS(ptr + capacity / 8 * 7, vended_buffer_3.buffer);
+    ASSERT_UINT_EQUALS(capacity / 8 * 4, vended_buffer_3.capacity);
+    ASSERT_TRUE(aws_ring_buffer_buf_belongs_to_pool(&ring_buffer, &vended_buffer_3));
+
+    /* and the part past the end is the start of the buffer */
+    for (size_t i = 0; i < vended_buffer_3.capacity; ++i) {
+        ASSERT_TRUE(aws_byte_buf_write_u8(&vended_buffer_3, (uint8_t)(i * 7 + 1)));
+    }
+    for (size_t i = 0; i < capacity / 8 * 3; ++i) {
+        ASSERT_UINT_EQUALS((uint8_t)((i + capacity / 8) * 7 + 1), ptr[i]);
+    }
+
+    /* B and C, in one piece */
+    struct aws_byte_cursor regions[2];
+    ASSERT_UINT_EQUALS(1, aws_ring_buffer_get_acquired_regions(&ring_buffer, regions));
+    ASSERT_PTR_EQUALS(vended_buffer_2.buffer, regions[0].ptr);
+    ASSERT_UINT_EQUALS(capacity / 8 * 5, regions[0].len);
+
+    /* 5/8 of the capacity is in use, and one byte always stays free */
+    ASSERT_ERROR(AWS_ERROR_OOM, aws_ring_buffer_acquire(&ring_buffer, capacity / 8 * 3, &vended_buffer_1));
+    ASSERT_SUCCESS(aws_ring_buffer_acquire_up_to(&ring_buffer, 1, capacity, &vended_buffer_1));
+    ASSERT_PTR_EQUALS(ptr + capacity / 8 * 3, vended_buffer_1.buffer);
+    ASSERT_UINT_EQUALS(capacity / 8 * 3 - 1, vended_buffer_1.capacity);
+    ASSERT_ERROR(AWS_ERROR_OOM, aws_ring_buffer_acquire_up_to(&ring_buffer, 1, capacity, &vended_buffer_1));
+
+    aws_ring_buffer_release(&ring_buffer, &vended_buffer_2);
+    aws_ring_buffer_release(&ring_buffer, &vended_buffer_3);
+    ASSERT_PTR_EQUALS(ptr + capacity / 8 * 3, aws_atomic_load_ptr(&ring_buffer.tail));
+    aws_ring_buffer_release(&ring_buffer, &vended_buffer_1);
+    ASSERT_TRUE(aws_ring_buffer_is_empty(&ring_buffer));
+
+    /* an empty buffer hands out the whole capacity */
+    ASSERT_SUCCESS(aws_ring_buffer_acquire(&ring_buffer, capacity, &vended_buffer_1));
+    ASSERT_PTR_EQUALS(ptr, vended_buffer_1.buffer);
+    ASSERT_ERROR(AWS_ERROR_OOM, aws_ring_buffer_acquire(&ring_buffer, 1, &vended_buffer_2));
+    aws_ring_buffer_release(&ring_buffer, &vended_buffer_1);
+
+    /* go around many times with odd sizes, writing through every buffer */
+    size_t sizes[] = {capacity / 3, capacity / 2 + 1, 7, capacity - 5};
+    for (size_t i = 0; i < 100; ++i) {
+        size_t size = sizes[i % AWS_ARRAY_SIZE(sizes)];
+        ASSERT_SUCCESS(aws_ring_buffer_acquire(&ring_buffer, size, &vended_buffer_1));
+        ASSERT_UINT_EQUALS(size, vended_buffer_1.capacity);
+        memset(vended_buffer_1.buffer, (int)i, size);
+        ASSERT_UINT_EQUALS((uint8_t)i, vended_buffer_1.buffer[size - 1]);
+        aws_ring_buffer_release(&ring_buffer, &vended_buffer_1);
+    }
+
+    aws_ring_buffer_clean_up(&ring_buffer);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(ring_buffer_mirrored_wraps_contiguously_test, s_test_mirrored_wraps_contiguously)
+
+static int s_test_acquire_release_many(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    struct aws_ring_buffer ring_buffer;
+    ASSERT_SUCCESS(aws_ring_buffer_init(&ring_buffer, allocator, 16));
+    uint8_t *ptr = ring_buffer.allocation;
+
+    struct aws_byte_buf first[2];
+    struct aws_byte_buf second[2];
+    struct aws_byte_buf third[2];
+    AWS_ZERO_ARRAY(first);
+    AWS_ZERO_ARRAY(second);
+    AWS_ZERO_ARRAY(third);
+    struct aws_byte_cursor regions[2];
+    ASSERT_UINT_EQUALS(0, aws_ring_buffer_get_acquired_regions(&ring_buffer, regions));
+
+    size_t sizes[] = {4, 8};
+    ASSERT_SUCCESS(aws_ring_buffer_acquire_many(&ring_buffer, sizes, 2, first));
+    ASSERT_PTR_EQUALS(ptr, first[0].buffer);
+    ASSERT_UINT_EQUALS(4, first[0].capacity);
+    ASSERT_PTR_EQUALS(ptr + 4, first[1].buffer);
+    ASSERT_UINT_EQUALS(8, first[1].capacity);
+
+    /* all or nothing: the 2 would fit, the 4 wouldn't */
+    size_t too_big[] = {2, 4};
+    ASSERT_ERROR(AWS_ERROR_OOM, aws_ring_buffer_acquire_many(&ring_buffer, too_big, 2, second));
+    ASSERT_NULL(second[0].buffer);
+    size_t empty_size[] = {0};
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_ring_buffer_acquire_many(&ring_buffer, empty_size, 1, second));
+
+    ASSERT_UINT_EQUALS(1, aws_ring_buffer_get_acquired_regions(&ring_buffer, regions));
+    ASSERT_PTR_EQUALS(ptr, regions[0].ptr);
+    ASSERT_UINT_EQUALS(12, regions[0].len);
+
+    aws_ring_buffer_release_many(&ring_buffer, first, 2);
+    ASSERT_NULL(first[0].buffer);
+    ASSERT_NULL(first[1].buffer);
+    ASSERT_TRUE(aws_ring_buffer_is_empty(&ring_buffer));
+
+    /* empty, so this starts over at the beginning */
+    size_t sizes_2[] = {10, 4};
+    ASSERT_SUCCESS(aws_ring_buffer_acquire_many(&ring_buffer, sizes_2, 2, second));
+    ASSERT_PTR_EQUALS(ptr, second[0].buffer);
+    ASSERT_PTR_EQUALS(ptr + 10, second[1].buffer);
+    aws_ring_buffer_release(&ring_buffer, &second[0]);
+
+    /* the 2 goes at the end and the 6 goes back to the start */
+    size_t sizes_3[] = {2, 6};
+    ASSERT_SUCCESS(aws_ring_buffer_acquire_many(&ring_buffer, sizes_3, 2, third));
+    ASSERT_PTR_EQUALS(ptr + 14, third[0].buffer);
+    ASSERT_PTR_EQUALS(ptr, third[1].buffer);
+
+    ASSERT_UINT_EQUALS(2, aws_ring_buffer_get_acquired_regions(&ring_buffer, regions));
+    ASSERT_PTR_EQUALS(ptr + 10, regions[0].ptr);
+    ASSERT_UINT_EQUALS(6, regions[0].len);
+    ASSERT_PTR_EQUALS(ptr, regions[1].ptr);
+    ASSERT_UINT_EQUALS(6, regions[1].len);
+
+    struct aws_byte_buf to_release[] = {second[1], third[0]};
+    aws_ring_buffer_release_many(&ring_buffer, to_release, 2);
+    ASSERT_UINT_EQUALS(1, aws_ring_buffer_get_acquired_regions(&ring_buffer, regions));
+    ASSERT_PTR_EQUALS(ptr, regions[0].ptr);
+    ASSERT_UINT_EQUALS(6, regions[0].len);
+
+    aws_ring_buffer_release(&ring_buffer, &third[1]);
+    ASSERT_UINT_EQUALS(0, aws_ring_buffer_get_acquired_regions(&ring_buffer, regions));
+
+    aws_ring_buffer_clean_up(&ring_buffer);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(ring_buffer_acquire_release_many_test, s_test_acquire_release_many)
+
 struct mt_test_data {
     struct aws_ring_buffer ring_buf;
     struct aws_linked_list buffer_queue;
@@ -329,3 +329,126 @@ static int s_test_byte_cursor_next_split(struct aws_allocator *allocator, void *
 
     return 0;
 }
+
+AWS_TEST_CASE(test_byte_cursor_next_split_on_any, s_test_byte_cursor_next_split_on_any)
+static int s_test_byte_cursor_next_split_on_any(struct aws_allocator *allocator, void *ctx) {
+    (void)allocator;
+    (void)ctx;
+
+    struct aws_byte_delimiter_set delimiters;
+    aws_byte_delimiter_set_init(&delimiters, aws_byte_cursor_from_c_str("&="));
+
+    struct aws_byte_cursor to_split1 = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("a=1&bb=&c");
+    struct aws_byte_cursor result1 = {0};
+    ASSERT_TRUE(aws_byte_cursor_next_split_on_any(&to_split1, &delimiters, &result1));
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(result1, "a");
+    ASSERT_UINT_EQUALS('=', result1.ptr[result1.len]);
+
+    ASSERT_TRUE(aws_byte_cursor_next_split_on_any(&to_split1, &delimiters, &result1));
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(result1, "1");
+    ASSERT_UINT_EQUALS('&', result1.ptr[result1.len]);
+
+    ASSERT_TRUE(aws_byte_cursor_next_split_on_any(&to_split1, &delimiters, &result1));
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(result1, "bb");
+
+    ASSERT_TRUE(aws_byte_cursor_next_split_on_any(&to_split1, &delimiters, &result1));
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(result1, "");
+    ASSERT_UINT_EQUALS('&', result1.ptr[result1.len]);
+
+    ASSERT_TRUE(aws_byte_cursor_next_split_on_any(&to_split1, &delimiters, &result1));
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(result1, "c");
+    ASSERT_PTR_EQUALS(to_split1.ptr + to_split1.len, result1.ptr + result1.len);
+
+    ASSERT_FALSE(aws_byte_cursor_next_split_on_any(&to_split1, &delimiters, &result1));
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(result1, "");
+
+    /* same edge cases as aws_byte_cursor_next_split() */
+    struct aws_byte_cursor to_split2 = {0};
+    struct aws_byte_cursor result2 = {0};
+    ASSERT_TRUE(aws_byte_cursor_next_split_on_any(&to_split2, &delimiters, &result2));
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(result2, "");
+    ASSERT_FALSE(aws_byte_cursor_next_split_on_any(&to_split2, &delimiters, &result2));
+
+    struct aws_byte_cursor to_split3 = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("=&");
+    struct aws_byte_cursor result3 = {0};
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(aws_byte_cursor_next_split_on_any(&to_split3, &delimiters, &result3));
+        ASSERT_CURSOR_VALUE_CSTRING_EQUALS(result3, "");
+    }
+    ASSERT_FALSE(aws_byte_cursor_next_split_on_any(&to_split3, &delimiters, &result3));
+
+    /* an empty set never splits */
+    struct aws_byte_delimiter_set no_delimiters;
+    aws_byte_delimiter_set_init(&no_delimiters, aws_byte_cursor_from_c_str(""));
+    struct aws_byte_cursor result4 = {0};
+    ASSERT_TRUE(aws_byte_cursor_next_split_on_any(&to_split1, &no_delimiters, &result4));
+    ASSERT_TRUE(aws_byte_cursor_eq(&to_split1, &result4));
+    ASSERT_FALSE(aws_byte_cursor_next_split_on_any(&to_split1, &no_delimiters, &result4));
+
+    return 0;
+}
+
+static uint64_t s_next_random(uint64_t *state) {
+    /* xorshift64, so the test is the same on every run */
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/*
+ * Random sets of up to 16 delimiters, any byte value, against inputs long enough to cover the vectorized path and the
+ * tail after it. Every split must end exactly where a byte-by-byte search says it should.
+ */
+AWS_TEST_CASE(test_byte_cursor_next_split_on_any_matches_naive, s_test_byte_cursor_next_split_on_any_matches_naive)
+static int s_test_byte_cursor_next_split_on_any_matches_naive(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+
+    for (size_t iteration = 0; iteration < 2000; ++iteration) {
+        uint8_t delimiter_bytes[16];
+        size_t delimiter_count = 1 + (size_t)(s_next_random(&random_state) % 16);
+        for (size_t i = 0; i < delimiter_count; ++i) {
+            delimiter_bytes[i] = (uint8_t)s_next_random(&random_state);
+        }
+        struct aws_byte_delimiter_set delimiters;
+        aws_byte_delimiter_set_init(&delimiters, aws_byte_cursor_from_array(delimiter_bytes, delimiter_count));
+
+        /* a fresh allocation per input, so reading past the end would show up under a sanitizer */
+        size_t len = (size_t)(s_next_random(&random_state) % 200);
+        uint8_t *input = aws_mem_acquire(allocator, len + 1);
+        for (size_t i = 0; i < len; ++i) {
+            /* mostly bytes that share a nibble with a delimiter, sometimes a delimiter */
+            uint8_t delimiter = delimiter_bytes[s_next_random(&random_state) % delimiter_count];
+            uint64_t choice = s_next_random(&random_state) % 8;
+            if (choice == 0) {
+                input[i] = delimiter;
+            } else if (choice < 4) {
+                input[i] = (uint8_t)((delimiter & 0xF0) | (s_next_random(&random_state) & 0x0F));
+            } else if (choice < 7) {
+                input[i] = (uint8_t)((delimiter & 0x0F) | (s_next_random(&random_state) & 0xF0));
+            } else {
+                input[i] = (uint8_t)s_next_random(&random_state);
+            }
+        }
+
+        struct aws_byte_cursor input_cur = aws_byte_cursor_from_array(input, len);
+        struct aws_byte_cursor split = {0};
+        size_t expected_start = 0;
+        while (aws_byte_cursor_next_split_on_any(&input_cur, &delimiters, &split)) {
+            size_t expected_end = expected_start;
+            while (expected_end < len && !memchr(delimiter_bytes, input[expected_end], delimiter_count)) {
+                ++expected_end;
+            }
+            ASSERT_PTR_EQUALS(input + expected_start, split.ptr);
+            ASSERT_UINT_EQUALS(expected_end - expected_start, split.len);
+            expected_start = expected_end + 1;
+        }
+        ASSERT_UINT_EQUALS(len + 1, expected_start);
+
+        aws_mem_release(allocator, input);
+    }
+
+    return 0;
+}
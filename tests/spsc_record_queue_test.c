@@ -0,0 +1,168 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/spsc_record_queue.h>
+
+#include <aws/common/clock.h>
+#include <aws/common/thread.h>
+#include <aws/testing/aws_test_harness.h>
+
+static int s_test_spsc_record_queue_single_threaded(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    struct aws_spsc_record_queue queue;
+    /* rounded down to 64 bytes, records take 8 bytes of header plus their size rounded up to 8 */
+    ASSERT_SUCCESS(aws_spsc_record_queue_init(&queue, allocator, 64 + 7));
+
+    struct aws_byte_cursor record;
+    ASSERT_FALSE(aws_spsc_record_queue_read(&queue, &record));
+
+    /* reserved records stay invisible until committed: [0, 16) and [16, 24) */
+    struct aws_byte_buf dest;
+    ASSERT_SUCCESS(aws_spsc_record_queue_reserve(&queue, 5, &dest));
+    ASSERT_UINT_EQUALS(5, dest.capacity);
+    ASSERT_UINT_EQUALS(0, dest.len);
+    ASSERT_TRUE(aws_byte_buf_write_from_whole_cursor(&dest, aws_byte_cursor_from_c_str("first")));
+    ASSERT_SUCCESS(aws_spsc_record_queue_reserve(&queue, 0, &dest));
+    ASSERT_FALSE(aws_spsc_record_queue_read(&queue, &record));
+    aws_spsc_record_queue_commit(&queue);
+
+    /* [24, 40) and [40, 56) */
+    ASSERT_SUCCESS(aws_spsc_record_queue_push(&queue, aws_byte_cursor_from_c_str("third")));
+    ASSERT_SUCCESS(aws_spsc_record_queue_push(&queue, aws_byte_cursor_from_c_str("fourth")));
+
+    ASSERT_ERROR(AWS_ERROR_OOM, aws_spsc_record_queue_push(&queue, aws_byte_cursor_from_c_str("fifth")));
+    /* bigger than the whole buffer */
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_spsc_record_queue_reserve(&queue, 57, &dest));
+
+    ASSERT_TRUE(aws_spsc_record_queue_read(&queue, &record));
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(record, "first");
+    ASSERT_TRUE(aws_spsc_record_queue_read(&queue, &record));
+    ASSERT_UINT_EQUALS(0, record.len);
+
+    /* nothing is released until consumed */
+    ASSERT_ERROR(AWS_ERROR_OOM, aws_spsc_record_queue_push(&queue, aws_byte_cursor_from_c_str("fifth")));
+    aws_spsc_record_queue_consume(&queue);
+
+    /* doesn't fit in [56, 64), so it starts over at [0, 16) */
+    ASSERT_SUCCESS(aws_spsc_record_queue_push(&queue, aws_byte_cursor_from_c_str("fifth")));
+    ASSERT_TRUE(aws_spsc_record_queue_read(&queue, &record));
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(record, "third");
+    ASSERT_TRUE(aws_spsc_record_queue_read(&queue, &record));
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(record, "fourth");
+    ASSERT_TRUE(aws_spsc_record_queue_read(&queue, &record));
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(record, "fifth");
+    ASSERT_FALSE(aws_spsc_record_queue_read(&queue, &record));
+    aws_spsc_record_queue_consume(&queue);
+
+    /* the ring buffer is empty, so it starts over at the beginning again and this record ends exactly where the
+     * consumer left off */
+    ASSERT_SUCCESS(aws_spsc_record_queue_push(&queue, aws_byte_cursor_from_c_str("sixth")));
+    ASSERT_TRUE(aws_spsc_record_queue_read(&queue, &record));
+    ASSERT_CURSOR_VALUE_CSTRING_EQUALS(record, "sixth");
+    ASSERT_FALSE(aws_spsc_record_queue_read(&queue, &record));
+    aws_spsc_record_queue_consume(&queue);
+
+    /* a record as big as the whole buffer fits once it is empty */
+    ASSERT_SUCCESS(aws_spsc_record_queue_reserve(&queue, 56, &dest));
+    aws_spsc_record_queue_commit(&queue);
+    ASSERT_TRUE(aws_spsc_record_queue_read(&queue, &record));
+    ASSERT_UINT_EQUALS(56, record.len);
+    aws_spsc_record_queue_consume(&queue);
+
+    /* nothing shows up, so this gives up */
+    uint64_t start = 0;
+    ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&start));
+    ASSERT_FALSE(aws_spsc_record_queue_read_wait(&queue, 1000000, &record));
+    uint64_t end = 0;
+    ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&end));
+    ASSERT_TRUE(end - start >= 1000000);
+
+    ASSERT_SUCCESS(aws_spsc_record_queue_reserve(&queue, 40, &dest));
+    ASSERT_ERROR(AWS_ERROR_OOM, aws_spsc_record_queue_reserve_wait(&queue, 40, 1000000, &dest));
+    /* waiting committed what was reserved */
+    ASSERT_TRUE(aws_spsc_record_queue_read(&queue, &record));
+    ASSERT_UINT_EQUALS(40, record.len);
+
+    aws_spsc_record_queue_clean_up(&queue);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(spsc_record_queue_single_threaded, s_test_spsc_record_queue_single_threaded)
+
+enum {
+    THREADED_RECORD_COUNT = 200000,
+    THREADED_MAX_RECORD_SIZE = 300,
+    THREADED_BATCH_SIZE = 7,
+};
+
+struct threaded_test_data {
+    struct aws_spsc_record_queue queue;
+    int producer_result;
+};
+
+/* Record i holds (i % THREADED_MAX_RECORD_SIZE) bytes, all equal to (uint8_t)i. */
+static void s_producer_thread(void *arg) {
+    struct threaded_test_data *data = arg;
+    data->producer_result = AWS_OP_SUCCESS;
+
+    for (size_t i = 0; i < THREADED_RECORD_COUNT; ++i) {
+        struct aws_byte_buf dest;
+        if (aws_spsc_record_queue_reserve_wait(
+                &data->queue, i % THREADED_MAX_RECORD_SIZE, AWS_SPSC_RECORD_QUEUE_WAIT_FOREVER, &dest)) {
+            data->producer_result = AWS_OP_ERR;
+            return;
+        }
+        memset(dest.buffer, (uint8_t)i, dest.capacity);
+        if (i % THREADED_BATCH_SIZE == 0) {
+            aws_spsc_record_queue_commit(&data->queue);
+        }
+    }
+    aws_spsc_record_queue_commit(&data->queue);
+}
+
+static int s_test_spsc_record_queue_multi_threaded(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    struct threaded_test_data data;
+    AWS_ZERO_STRUCT(data);
+    /* small enough to wrap around and fill up all the time */
+    ASSERT_SUCCESS(aws_spsc_record_queue_init(&data.queue, allocator, 4096));
+
+    struct aws_thread producer;
+    ASSERT_SUCCESS(aws_thread_init(&producer, allocator));
+    ASSERT_SUCCESS(aws_thread_launch(&producer, s_producer_thread, &data, NULL));
+
+    for (size_t i = 0; i < THREADED_RECORD_COUNT; ++i) {
+        struct aws_byte_cursor record;
+        ASSERT_TRUE(aws_spsc_record_queue_read_wait(&data.queue, AWS_SPSC_RECORD_QUEUE_WAIT_FOREVER, &record));
+        ASSERT_UINT_EQUALS(i % THREADED_MAX_RECORD_SIZE, record.len);
+        for (size_t j = 0; j < record.len; ++j) {
+            ASSERT_UINT_EQUALS((uint8_t)i, record.ptr[j]);
+        }
+        /* consume in batches too, but never sleep on unconsumed records */
+        struct aws_byte_cursor next;
+        if (i % 3 == 0 || !aws_spsc_record_queue_read(&data.queue, &next)) {
+            aws_spsc_record_queue_consume(&data.queue);
+        } else {
+            ++i;
+            ASSERT_UINT_EQUALS(i % THREADED_MAX_RECORD_SIZE, next.len);
+            for (size_t j = 0; j < next.len; ++j) {
+                ASSERT_UINT_EQUALS((uint8_t)i, next.ptr[j]);
+            }
+            aws_spsc_record_queue_consume(&data.queue);
+        }
+    }
+
+    ASSERT_SUCCESS(aws_thread_join(&producer));
+    aws_thread_clean_up(&producer);
+    ASSERT_SUCCESS(data.producer_result);
+
+    struct aws_byte_cursor record;
+    ASSERT_FALSE(aws_spsc_record_queue_read(&data.queue, &record));
+
+    aws_spsc_record_queue_clean_up(&data.queue);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(spsc_record_queue_multi_threaded, s_test_spsc_record_queue_multi_threaded)
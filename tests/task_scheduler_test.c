@@ -4,6 +4,9 @@
  */
 
 #include <aws/common/task_scheduler.h>
+
+#include <aws/common/array_list.h>
+#include <aws/common/clock.h>
 #include <aws/common/thread.h>
 #include <aws/testing/aws_test_harness.h>
 
@@ -253,6 +256,38 @@ static int s_test_scheduler_cleanup_cancellation(struct aws_allocator *allocator
     return 0;
 }
 
+/* A task that was never scheduled and never went through aws_task_init() has a zeroed priority_queue_node, which looks
+ * like index 0 of the timed queue. Canceling it must not take the task that really is there. */
+static int s_test_scheduler_cancel_unscheduled_task(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_task_scheduler scheduler;
+    ASSERT_SUCCESS(aws_task_scheduler_init(&scheduler, allocator));
+
+    struct cancellation_args future_task_args = {.status = 100000};
+    struct aws_task future_task;
+    aws_task_init(&future_task, s_cancellation_fn, &future_task_args, "cancel_unscheduled_task_future");
+    aws_task_scheduler_schedule_future(&scheduler, &future_task, 10);
+
+    struct cancellation_args unscheduled_task_args = {.status = 100000};
+    struct aws_task unscheduled_task;
+    AWS_ZERO_STRUCT(unscheduled_task);
+    unscheduled_task.fn = s_cancellation_fn;
+    unscheduled_task.arg = &unscheduled_task_args;
+
+    aws_task_scheduler_cancel_task(&scheduler, &unscheduled_task);
+    ASSERT_INT_EQUALS(AWS_TASK_STATUS_CANCELED, unscheduled_task_args.status);
+    ASSERT_INT_EQUALS(100000, future_task_args.status);
+    ASSERT_UINT_EQUALS(1, aws_task_scheduler_get_task_count(&scheduler));
+
+    aws_task_scheduler_run_all(&scheduler, 10);
+    ASSERT_INT_EQUALS(AWS_TASK_STATUS_RUN_READY, future_task_args.status);
+    ASSERT_UINT_EQUALS(0, aws_task_scheduler_get_task_count(&scheduler));
+
+    aws_task_scheduler_clean_up(&scheduler);
+    return 0;
+}
+
 static int s_test_scheduler_cleanup_reentrants(struct aws_allocator *allocator, void *ctx) {
     (void)ctx;
 
@@ -416,12 +451,477 @@ static int s_test_scheduler_task_delete_on_run(struct aws_allocator *allocator,
     return 0;
 }
 
+struct timing_wheel_test_task {
+    struct aws_task task;
+    struct timing_wheel_test *test;
+    bool canceled;
+    bool ran;
+};
+
+struct timing_wheel_test {
+    struct aws_task_scheduler scheduler;
+    uint64_t now;
+    uint64_t last_run_timestamp;
+    size_t out_of_order_count;
+    size_t early_count;
+};
+
+static void s_timing_wheel_test_task_fn(struct aws_task *task, void *arg, enum aws_task_status status) {
+    struct timing_wheel_test_task *test_task = arg;
+    struct timing_wheel_test *test = test_task->test;
+
+    if (status == AWS_TASK_STATUS_CANCELED) {
+        test_task->canceled = true;
+        return;
+    }
+
+    test_task->ran = true;
+    if (task->timestamp > test->now) {
+        ++test->early_count;
+    }
+    if (task->timestamp < test->last_run_timestamp) {
+        ++test->out_of_order_count;
+    }
+    test->last_run_timestamp = task->timestamp;
+}
+
+static int s_test_scheduler_timing_wheel(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    enum { TASK_COUNT = 2000 };
+
+    struct timing_wheel_test test;
+    AWS_ZERO_STRUCT(test);
+
+    /* a tiny tick, so that the timestamps below spread across several wheel levels */
+    struct aws_task_scheduler_options options = {
+        .timer_backend = AWS_TASK_SCHEDULER_TIMER_BACKEND_TIMING_WHEEL,
+        .timing_wheel_tick = 16,
+    };
+    ASSERT_SUCCESS(aws_task_scheduler_init_with_options(&test.scheduler, allocator, &options));
+
+    struct timing_wheel_test_task *tasks = aws_mem_calloc(allocator, TASK_COUNT, sizeof(struct timing_wheel_test_task));
+    ASSERT_NOT_NULL(tasks);
+
+    srand((unsigned)(uintptr_t)&test);
+    uint64_t earliest = UINT64_MAX;
+    for (size_t i = 0; i < TASK_COUNT; ++i) {
+        tasks[i].test = &test;
+        aws_task_init(&tasks[i].task, s_timing_wheel_test_task_fn, &tasks[i], "timing_wheel_test");
+
+        /* a mix of near timers, many sharing a tick, and far ones */
+        uint64_t timestamp = (i % 2) ? (uint64_t)(rand() % 4096) : ((uint64_t)rand() << (rand() % 24));
+        aws_task_scheduler_schedule_future(&test.scheduler, &tasks[i].task, timestamp);
+        earliest = aws_min_u64(earliest, timestamp);
+    }
+
+    /* the reported next time may be conservative, but never late */
+    uint64_t next_time = 0;
+    ASSERT_TRUE(aws_task_scheduler_has_tasks(&test.scheduler, &next_time));
+    ASSERT_TRUE(next_time <= earliest);
+
+    for (size_t i = 0; i < TASK_COUNT; i += 7) {
+        aws_task_scheduler_cancel_task(&test.scheduler, &tasks[i].task);
+        ASSERT_TRUE(tasks[i].canceled);
+    }
+
+    /* advance in uneven steps, checking that everything due has run, in order, and nothing else has */
+    while (test.now < ((uint64_t)RAND_MAX << 24)) {
+        test.now += (uint64_t)rand() * (1 + rand() % 4096);
+        aws_task_scheduler_run_all(&test.scheduler, test.now);
+
+        if (aws_task_scheduler_has_tasks(&test.scheduler, &next_time)) {
+            ASSERT_TRUE(next_time > test.now);
+        }
+
+        for (size_t i = 0; i < TASK_COUNT; ++i) {
+            if (!tasks[i].canceled) {
+                ASSERT_TRUE(tasks[i].ran == (tasks[i].task.timestamp <= test.now));
+            }
+        }
+    }
+
+    ASSERT_UINT_EQUALS(0, test.early_count);
+    ASSERT_UINT_EQUALS(0, test.out_of_order_count);
+
+    /* anything left over is canceled on clean up */
+    struct timing_wheel_test_task far_task = {.test = &test};
+    aws_task_init(&far_task.task, s_timing_wheel_test_task_fn, &far_task, "timing_wheel_test_far");
+    aws_task_scheduler_schedule_future(&test.scheduler, &far_task.task, UINT64_MAX - 1);
+    aws_task_scheduler_clean_up(&test.scheduler);
+    ASSERT_TRUE(far_task.canceled);
+
+    aws_mem_release(allocator, tasks);
+    return 0;
+}
+
+static struct aws_task s_reentrant_child_task;
+
+static void s_schedule_child_fn(struct aws_task *task, void *arg, enum aws_task_status status) {
+    struct aws_task_scheduler *scheduler = arg;
+    aws_task_init(&s_reentrant_child_task, s_task_n_fn, NULL, "run_some_child");
+    aws_task_scheduler_schedule_now(scheduler, &s_reentrant_child_task);
+    s_task_n_fn(task, NULL, status);
+}
+
+static int s_test_scheduler_run_some_budget(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    s_executed_tasks_n = 0;
+
+    struct aws_task_scheduler scheduler;
+    ASSERT_SUCCESS(aws_task_scheduler_init(&scheduler, allocator));
+
+    struct aws_task asap_tasks[5];
+    struct aws_task timed_tasks[5];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(asap_tasks); ++i) {
+        aws_task_init(&asap_tasks[i], s_task_n_fn, NULL, "run_some_asap");
+        aws_task_scheduler_schedule_now(&scheduler, &asap_tasks[i]);
+        aws_task_init(&timed_tasks[i], s_task_n_fn, NULL, "run_some_timed");
+        aws_task_scheduler_schedule_future(&scheduler, &timed_tasks[i], i + 1);
+    }
+
+    /* asap and due timed tasks take turns, and the call stops at the budget */
+    ASSERT_TRUE(aws_task_scheduler_run_some(&scheduler, 10, 4, 0));
+    ASSERT_UINT_EQUALS(4, s_executed_tasks_n);
+    ASSERT_PTR_EQUALS(&asap_tasks[0], s_executed_tasks[0].task);
+    ASSERT_PTR_EQUALS(&timed_tasks[0], s_executed_tasks[1].task);
+    ASSERT_PTR_EQUALS(&asap_tasks[1], s_executed_tasks[2].task);
+    ASSERT_PTR_EQUALS(&timed_tasks[1], s_executed_tasks[3].task);
+
+    /* leftovers run before anything scheduled after them */
+    struct aws_task parent_task;
+    aws_task_init(&parent_task, s_schedule_child_fn, &scheduler, "run_some_parent");
+    aws_task_scheduler_schedule_now(&scheduler, &parent_task);
+
+    /* a task scheduled while running doesn't run in the same call, but is reported as remaining work */
+    ASSERT_TRUE(aws_task_scheduler_run_some(&scheduler, 10, 0, 0));
+    ASSERT_UINT_EQUALS(11, s_executed_tasks_n);
+    for (size_t i = 2; i < AWS_ARRAY_SIZE(timed_tasks); ++i) {
+        ASSERT_PTR_EQUALS(&timed_tasks[i], s_executed_tasks[i + 2].task);
+        ASSERT_PTR_EQUALS(&asap_tasks[i], s_executed_tasks[i + 5].task);
+    }
+    ASSERT_PTR_EQUALS(&parent_task, s_executed_tasks[10].task);
+
+    ASSERT_FALSE(aws_task_scheduler_run_some(&scheduler, 10, 0, 0));
+    ASSERT_UINT_EQUALS(12, s_executed_tasks_n);
+    ASSERT_PTR_EQUALS(&s_reentrant_child_task, s_executed_tasks[11].task);
+    for (size_t i = 0; i < s_executed_tasks_n; ++i) {
+        ASSERT_INT_EQUALS(AWS_TASK_STATUS_RUN_READY, s_executed_tasks[i].status);
+    }
+
+    aws_task_scheduler_clean_up(&scheduler);
+    return 0;
+}
+
+static void s_sleepy_task_fn(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    size_t *run_count = arg;
+    ++*run_count;
+    aws_thread_current_sleep(2000000);
+}
+
+static int s_test_scheduler_run_some_time_budget(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_task_scheduler scheduler;
+    ASSERT_SUCCESS(aws_task_scheduler_init(&scheduler, allocator));
+
+    size_t run_count = 0;
+    struct aws_task tasks[5];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tasks); ++i) {
+        aws_task_init(&tasks[i], s_sleepy_task_fn, &run_count, "run_some_sleepy");
+        aws_task_scheduler_schedule_now(&scheduler, &tasks[i]);
+    }
+
+    /* each task takes 2ms, so a 3ms budget can't fit all of them */
+    ASSERT_TRUE(aws_task_scheduler_run_some(&scheduler, 0, 0, 3000000));
+    ASSERT_TRUE(run_count >= 1 && run_count < AWS_ARRAY_SIZE(tasks));
+
+    ASSERT_FALSE(aws_task_scheduler_run_some(&scheduler, 0, 0, 0));
+    ASSERT_UINT_EQUALS(AWS_ARRAY_SIZE(tasks), run_count);
+
+    aws_task_scheduler_clean_up(&scheduler);
+    return 0;
+}
+
+/* A time budget that's already used up by the time the first task could run still lets that one task run */
+static int s_test_scheduler_run_some_tiny_time_budget(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_task_scheduler scheduler;
+    ASSERT_SUCCESS(aws_task_scheduler_init(&scheduler, allocator));
+
+    size_t run_count = 0;
+    struct aws_task tasks[3];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tasks); ++i) {
+        aws_task_init(&tasks[i], s_sleepy_task_fn, &run_count, "run_some_tiny_budget");
+        aws_task_scheduler_schedule_now(&scheduler, &tasks[i]);
+    }
+
+    /* each task sleeps for much longer than the budget, so every call runs exactly one */
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tasks); ++i) {
+        bool more_ready = aws_task_scheduler_run_some(&scheduler, 0, 0, 1);
+        ASSERT_UINT_EQUALS(i + 1, run_count);
+        ASSERT_TRUE(more_ready == (i + 1 < AWS_ARRAY_SIZE(tasks)));
+    }
+    ASSERT_UINT_EQUALS(0, aws_task_scheduler_get_task_count(&scheduler));
+
+    aws_task_scheduler_clean_up(&scheduler);
+    return 0;
+}
+
+static int s_test_scheduler_priority_lanes_strict(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    s_executed_tasks_n = 0;
+
+    struct aws_task_scheduler scheduler;
+    ASSERT_SUCCESS(aws_task_scheduler_init(&scheduler, allocator));
+
+    struct aws_task background_task;
+    aws_task_init(&background_task, s_task_n_fn, NULL, "priority_background");
+    aws_task_scheduler_schedule_now_with_priority(&scheduler, &background_task, AWS_TASK_PRIORITY_BACKGROUND);
+
+    struct aws_task timed_task;
+    aws_task_init(&timed_task, s_task_n_fn, NULL, "priority_timed");
+    aws_task_scheduler_schedule_future(&scheduler, &timed_task, 1);
+
+    /* schedule_now() is the normal lane */
+    struct aws_task normal_task;
+    aws_task_init(&normal_task, s_task_n_fn, NULL, "priority_normal");
+    aws_task_scheduler_schedule_now(&scheduler, &normal_task);
+
+    struct aws_task high_tasks[2];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(high_tasks); ++i) {
+        aws_task_init(&high_tasks[i], s_task_n_fn, NULL, "priority_high");
+        aws_task_scheduler_schedule_now_with_priority(&scheduler, &high_tasks[i], AWS_TASK_PRIORITY_HIGH);
+    }
+
+    /* with no weights, a lane only runs once every higher priority lane is empty */
+    ASSERT_TRUE(aws_task_scheduler_run_some(&scheduler, 10, 3, 0));
+    ASSERT_UINT_EQUALS(3, s_executed_tasks_n);
+    ASSERT_PTR_EQUALS(&high_tasks[0], s_executed_tasks[0].task);
+    ASSERT_PTR_EQUALS(&high_tasks[1], s_executed_tasks[1].task);
+    ASSERT_PTR_EQUALS(&normal_task, s_executed_tasks[2].task);
+
+    struct aws_task late_high_task;
+    aws_task_init(&late_high_task, s_task_n_fn, NULL, "priority_high_late");
+    aws_task_scheduler_schedule_now_with_priority(&scheduler, &late_high_task, AWS_TASK_PRIORITY_HIGH);
+
+    /* run_all() drains every lane, highest priority first */
+    aws_task_scheduler_run_all(&scheduler, 10);
+    ASSERT_UINT_EQUALS(6, s_executed_tasks_n);
+    ASSERT_PTR_EQUALS(&late_high_task, s_executed_tasks[3].task);
+    ASSERT_PTR_EQUALS(&timed_task, s_executed_tasks[4].task);
+    ASSERT_PTR_EQUALS(&background_task, s_executed_tasks[5].task);
+    ASSERT_FALSE(aws_task_scheduler_has_tasks(&scheduler, NULL));
+
+    aws_task_scheduler_clean_up(&scheduler);
+    return 0;
+}
+
+static int s_test_scheduler_priority_lanes_weighted(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    s_executed_tasks_n = 0;
+
+    struct aws_task_scheduler_options options = {
+        .priority_weights =
+            {
+                [AWS_TASK_PRIORITY_HIGH] = 2,
+                [AWS_TASK_PRIORITY_NORMAL] = 1,
+            },
+    };
+    struct aws_task_scheduler scheduler;
+    ASSERT_SUCCESS(aws_task_scheduler_init_with_options(&scheduler, allocator, &options));
+
+    struct aws_task high_tasks[6];
+    struct aws_task normal_tasks[6];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(high_tasks); ++i) {
+        aws_task_init(&high_tasks[i], s_task_n_fn, (void *)AWS_TASK_PRIORITY_HIGH, "priority_high");
+        aws_task_scheduler_schedule_now_with_priority(&scheduler, &high_tasks[i], AWS_TASK_PRIORITY_HIGH);
+        aws_task_init(&normal_tasks[i], s_task_n_fn, (void *)AWS_TASK_PRIORITY_NORMAL, "priority_normal");
+        aws_task_scheduler_schedule_now(&scheduler, &normal_tasks[i]);
+    }
+
+    struct aws_task background_tasks[2];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(background_tasks); ++i) {
+        aws_task_init(&background_tasks[i], s_task_n_fn, (void *)AWS_TASK_PRIORITY_BACKGROUND, "priority_background");
+        aws_task_scheduler_schedule_now_with_priority(&scheduler, &background_tasks[i], AWS_TASK_PRIORITY_BACKGROUND);
+    }
+
+    /* high gets two turns for every normal one, and the unweighted background lane waits for both to drain */
+    ASSERT_TRUE(aws_task_scheduler_run_some(&scheduler, 0, 9, 0));
+    ASSERT_UINT_EQUALS(9, s_executed_tasks_n);
+    size_t high_count = 0;
+    for (size_t i = 0; i < s_executed_tasks_n; ++i) {
+        ASSERT_TRUE(s_executed_tasks[i].arg != (void *)AWS_TASK_PRIORITY_BACKGROUND);
+        high_count += s_executed_tasks[i].arg == (void *)AWS_TASK_PRIORITY_HIGH;
+    }
+    ASSERT_UINT_EQUALS(6, high_count);
+
+    ASSERT_FALSE(aws_task_scheduler_run_some(&scheduler, 0, 0, 0));
+    ASSERT_UINT_EQUALS(14, s_executed_tasks_n);
+    for (size_t i = 9; i < 12; ++i) {
+        ASSERT_PTR_EQUALS(&normal_tasks[i - 6], s_executed_tasks[i].task);
+    }
+    ASSERT_PTR_EQUALS(&background_tasks[0], s_executed_tasks[12].task);
+    ASSERT_PTR_EQUALS(&background_tasks[1], s_executed_tasks[13].task);
+
+    aws_task_scheduler_clean_up(&scheduler);
+    return 0;
+}
+
+static const struct aws_task_type_stats *s_find_type_stats(const struct aws_array_list *stats_list, const char *tag) {
+    for (size_t i = 0; i < aws_array_list_length(stats_list); ++i) {
+        struct aws_task_type_stats *stats = NULL;
+        aws_array_list_get_at_ptr(stats_list, (void **)&stats, i);
+        if (strcmp(stats->type_tag, tag) == 0) {
+            return stats;
+        }
+    }
+    return NULL;
+}
+
+static uint64_t s_histogram_count(const uint64_t *histogram) {
+    uint64_t count = 0;
+    for (size_t i = 0; i < AWS_TASK_STATS_HISTOGRAM_BUCKETS; ++i) {
+        count += histogram[i];
+    }
+    return count;
+}
+
+static int s_test_scheduler_stats(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    s_executed_tasks_n = 0;
+
+    struct aws_array_list stats_list;
+    ASSERT_SUCCESS(aws_array_list_init_dynamic(&stats_list, allocator, 4, sizeof(struct aws_task_type_stats)));
+
+    /* stats are off by default */
+    struct aws_task_scheduler scheduler;
+    ASSERT_SUCCESS(aws_task_scheduler_init(&scheduler, allocator));
+    ASSERT_ERROR(AWS_ERROR_INVALID_STATE, aws_task_scheduler_get_stats(&scheduler, &stats_list));
+    aws_task_scheduler_clean_up(&scheduler);
+
+    struct aws_task_scheduler_options options = {.enable_stats = true};
+    ASSERT_SUCCESS(aws_task_scheduler_init_with_options(&scheduler, allocator, &options));
+
+    struct aws_task fast_tasks[3];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(fast_tasks); ++i) {
+        aws_task_init(&fast_tasks[i], s_task_n_fn, NULL, "stats_fast");
+        aws_task_scheduler_schedule_now(&scheduler, &fast_tasks[i]);
+    }
+
+    /* due 1ms before the run starts, so it has at least 1ms of queue delay */
+    uint64_t now = 0;
+    ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&now));
+    struct aws_task late_task;
+    aws_task_init(&late_task, s_task_n_fn, NULL, "stats_late");
+    aws_task_scheduler_schedule_future(&scheduler, &late_task, now - 1000000);
+
+    size_t sleepy_run_count = 0;
+    struct aws_task sleepy_task;
+    aws_task_init(&sleepy_task, s_sleepy_task_fn, &sleepy_run_count, "stats_sleepy");
+    aws_task_scheduler_schedule_now(&scheduler, &sleepy_task);
+
+    struct aws_task canceled_task;
+    aws_task_init(&canceled_task, s_task_n_fn, NULL, NULL);
+    aws_task_scheduler_schedule_now(&scheduler, &canceled_task);
+    aws_task_scheduler_cancel_task(&scheduler, &canceled_task);
+
+    ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&now));
+    aws_task_scheduler_run_all(&scheduler, now);
+    ASSERT_UINT_EQUALS(5, s_executed_tasks_n);
+    ASSERT_UINT_EQUALS(1, sleepy_run_count);
+
+    ASSERT_SUCCESS(aws_task_scheduler_get_stats(&scheduler, &stats_list));
+    ASSERT_UINT_EQUALS(4, aws_array_list_length(&stats_list));
+
+    const struct aws_task_type_stats *fast = s_find_type_stats(&stats_list, "stats_fast");
+    ASSERT_NOT_NULL(fast);
+    ASSERT_UINT_EQUALS(3, fast->run_count);
+    ASSERT_UINT_EQUALS(0, fast->canceled_count);
+    ASSERT_UINT_EQUALS(3, s_histogram_count(fast->queue_delay_histogram));
+    ASSERT_UINT_EQUALS(3, s_histogram_count(fast->run_time_histogram));
+
+    const struct aws_task_type_stats *late = s_find_type_stats(&stats_list, "stats_late");
+    ASSERT_NOT_NULL(late);
+    ASSERT_UINT_EQUALS(1, late->run_count);
+    ASSERT_TRUE(late->queue_delay_max_ns >= 1000000);
+    ASSERT_UINT_EQUALS(late->queue_delay_max_ns, late->queue_delay_total_ns);
+
+    /* the sleepy task takes 2ms, which lands in bucket 20 or above */
+    const struct aws_task_type_stats *sleepy = s_find_type_stats(&stats_list, "stats_sleepy");
+    ASSERT_NOT_NULL(sleepy);
+    ASSERT_UINT_EQUALS(1, sleepy->run_count);
+    ASSERT_TRUE(sleepy->run_time_max_ns >= 2000000);
+    for (size_t i = 0; i < 20; ++i) {
+        ASSERT_UINT_EQUALS(0, sleepy->run_time_histogram[i]);
+    }
+    ASSERT_UINT_EQUALS(1, s_histogram_count(sleepy->run_time_histogram));
+
+    const struct aws_task_type_stats *canceled = s_find_type_stats(&stats_list, "unknown");
+    ASSERT_NOT_NULL(canceled);
+    ASSERT_UINT_EQUALS(0, canceled->run_count);
+    ASSERT_UINT_EQUALS(1, canceled->canceled_count);
+    ASSERT_UINT_EQUALS(0, s_histogram_count(canceled->run_time_histogram));
+
+    aws_task_scheduler_reset_stats(&scheduler);
+    aws_array_list_clear(&stats_list);
+    ASSERT_SUCCESS(aws_task_scheduler_get_stats(&scheduler, &stats_list));
+    ASSERT_UINT_EQUALS(0, aws_array_list_length(&stats_list));
+
+    aws_array_list_clean_up(&stats_list);
+    aws_task_scheduler_clean_up(&scheduler);
+    return 0;
+}
+
+static int s_test_scheduler_task_count(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    s_executed_tasks_n = 0;
+
+    struct aws_task_scheduler scheduler;
+    ASSERT_SUCCESS(aws_task_scheduler_init(&scheduler, allocator));
+    ASSERT_UINT_EQUALS(0, aws_task_scheduler_get_task_count(&scheduler));
+
+    struct aws_task tasks[4];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tasks); ++i) {
+        aws_task_init(&tasks[i], s_task_n_fn, NULL, "task_count");
+    }
+    aws_task_scheduler_schedule_now(&scheduler, &tasks[0]);
+    aws_task_scheduler_schedule_now_with_priority(&scheduler, &tasks[1], AWS_TASK_PRIORITY_BACKGROUND);
+    aws_task_scheduler_schedule_future(&scheduler, &tasks[2], 10);
+    aws_task_scheduler_schedule_future(&scheduler, &tasks[3], 20);
+    ASSERT_UINT_EQUALS(4, aws_task_scheduler_get_task_count(&scheduler));
+
+    aws_task_scheduler_cancel_task(&scheduler, &tasks[2]);
+    ASSERT_UINT_EQUALS(3, aws_task_scheduler_get_task_count(&scheduler));
+
+    aws_task_scheduler_run_all(&scheduler, 0);
+    ASSERT_UINT_EQUALS(1, aws_task_scheduler_get_task_count(&scheduler));
+
+    ASSERT_FALSE(aws_task_scheduler_run_some(&scheduler, 20, 0, 0));
+    ASSERT_UINT_EQUALS(0, aws_task_scheduler_get_task_count(&scheduler));
+
+    aws_task_scheduler_clean_up(&scheduler);
+    return 0;
+}
+
 AWS_TEST_CASE(scheduler_pops_task_late_test, s_test_scheduler_pops_task_fashionably_late);
 AWS_TEST_CASE(scheduler_ordering_test, s_test_scheduler_ordering);
 AWS_TEST_CASE(scheduler_has_tasks_test, s_test_scheduler_has_tasks);
 AWS_TEST_CASE(scheduler_reentrant_safe, s_test_scheduler_reentrant_safe);
 AWS_TEST_CASE(scheduler_cleanup_cancellation, s_test_scheduler_cleanup_cancellation);
+AWS_TEST_CASE(scheduler_cancel_unscheduled_task, s_test_scheduler_cancel_unscheduled_task);
 AWS_TEST_CASE(scheduler_cleanup_reentrants, s_test_scheduler_cleanup_reentrants);
 AWS_TEST_CASE(scheduler_schedule_cancellation, s_test_scheduler_schedule_cancellation);
 AWS_TEST_CASE(scheduler_cleanup_idempotent, s_test_scheduler_cleanup_idempotent);
 AWS_TEST_CASE(scheduler_task_delete_on_run, s_test_scheduler_task_delete_on_run);
+AWS_TEST_CASE(scheduler_timing_wheel_test, s_test_scheduler_timing_wheel);
+AWS_TEST_CASE(scheduler_run_some_budget_test, s_test_scheduler_run_some_budget);
+AWS_TEST_CASE(scheduler_run_some_time_budget_test, s_test_scheduler_run_some_time_budget);
+AWS_TEST_CASE(scheduler_run_some_tiny_time_budget_test, s_test_scheduler_run_some_tiny_time_budget);
+AWS_TEST_CASE(scheduler_priority_lanes_strict_test, s_test_scheduler_priority_lanes_strict);
+AWS_TEST_CASE(scheduler_priority_lanes_weighted_test, s_test_scheduler_priority_lanes_weighted);
+AWS_TEST_CASE(scheduler_stats_test, s_test_scheduler_stats);
+AWS_TEST_CASE(scheduler_task_count_test, s_test_scheduler_task_count);
@@ -0,0 +1,220 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/thread_pool.h>
+
+#include <aws/common/atomics.h>
+#include <aws/common/condition_variable.h>
+#include <aws/common/mutex.h>
+#include <aws/common/task_scheduler.h>
+#include <aws/testing/aws_test_harness.h>
+
+struct thread_pool_test_data {
+    struct aws_thread_pool *pool;
+    struct aws_task *tasks;
+    size_t task_count;
+    struct aws_atomic_var *run_counts;
+    struct aws_atomic_var ready_count;
+    struct aws_atomic_var canceled_count;
+    struct aws_mutex mutex;
+    struct aws_condition_variable c_var;
+};
+
+static struct thread_pool_test_data s_test_data;
+
+static int s_test_data_init(struct aws_allocator *allocator, size_t task_count) {
+    AWS_ZERO_STRUCT(s_test_data);
+    s_test_data.task_count = task_count;
+    s_test_data.tasks = aws_mem_calloc(allocator, task_count, sizeof(struct aws_task));
+    ASSERT_NOT_NULL(s_test_data.tasks);
+    s_test_data.run_counts = aws_mem_calloc(allocator, task_count, sizeof(struct aws_atomic_var));
+    ASSERT_NOT_NULL(s_test_data.run_counts);
+    for (size_t i = 0; i < task_count; ++i) {
+        aws_atomic_init_int(&s_test_data.run_counts[i], 0);
+    }
+    aws_atomic_init_int(&s_test_data.ready_count, 0);
+    aws_atomic_init_int(&s_test_data.canceled_count, 0);
+    ASSERT_SUCCESS(aws_mutex_init(&s_test_data.mutex));
+    ASSERT_SUCCESS(aws_condition_variable_init(&s_test_data.c_var));
+    return AWS_OP_SUCCESS;
+}
+
+static void s_test_data_clean_up(struct aws_allocator *allocator) {
+    aws_condition_variable_clean_up(&s_test_data.c_var);
+    aws_mutex_clean_up(&s_test_data.mutex);
+    aws_mem_release(allocator, s_test_data.run_counts);
+    aws_mem_release(allocator, s_test_data.tasks);
+}
+
+static bool s_all_tasks_done_pred(void *arg) {
+    (void)arg;
+    return aws_atomic_load_int(&s_test_data.ready_count) + aws_atomic_load_int(&s_test_data.canceled_count) ==
+           s_test_data.task_count;
+}
+
+static int s_wait_for_all_tasks(void) {
+    ASSERT_SUCCESS(aws_mutex_lock(&s_test_data.mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &s_test_data.c_var, &s_test_data.mutex, s_all_tasks_done_pred, NULL));
+    ASSERT_SUCCESS(aws_mutex_unlock(&s_test_data.mutex));
+    return AWS_OP_SUCCESS;
+}
+
+static void s_record_run(size_t index, enum aws_task_status status) {
+    aws_atomic_fetch_add(&s_test_data.run_counts[index], 1);
+    struct aws_atomic_var *counter =
+        status == AWS_TASK_STATUS_RUN_READY ? &s_test_data.ready_count : &s_test_data.canceled_count;
+
+    aws_mutex_lock(&s_test_data.mutex);
+    aws_atomic_fetch_add(counter, 1);
+    aws_mutex_unlock(&s_test_data.mutex);
+    aws_condition_variable_notify_all(&s_test_data.c_var);
+}
+
+static void s_counting_task_fn(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    s_record_run((size_t)arg, status);
+}
+
+static int s_check_each_task_ran_once(void) {
+    for (size_t i = 0; i < s_test_data.task_count; ++i) {
+        ASSERT_UINT_EQUALS(1, aws_atomic_load_int(&s_test_data.run_counts[i]));
+    }
+    return AWS_OP_SUCCESS;
+}
+
+static int s_test_thread_pool_runs_all_tasks(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_common_library_init(allocator);
+
+    enum { TASK_COUNT = 5000 };
+    ASSERT_SUCCESS(s_test_data_init(allocator, TASK_COUNT));
+
+    struct aws_thread_pool_options options = {.worker_count = 4};
+    struct aws_thread_pool *pool = aws_thread_pool_new(allocator, &options);
+    ASSERT_NOT_NULL(pool);
+    ASSERT_UINT_EQUALS(4, aws_thread_pool_get_worker_count(pool));
+
+    for (size_t i = 0; i < TASK_COUNT; ++i) {
+        aws_task_init(&s_test_data.tasks[i], s_counting_task_fn, (void *)i, "thread_pool_runs_all_tasks");
+        aws_thread_pool_submit(pool, &s_test_data.tasks[i]);
+    }
+
+    ASSERT_SUCCESS(s_wait_for_all_tasks());
+    ASSERT_UINT_EQUALS(TASK_COUNT, aws_atomic_load_int(&s_test_data.ready_count));
+    ASSERT_SUCCESS(s_check_each_task_ran_once());
+
+    aws_thread_pool_release(pool);
+    s_test_data_clean_up(allocator);
+    aws_common_library_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(thread_pool_runs_all_tasks, s_test_thread_pool_runs_all_tasks)
+
+/* Task i submits tasks 2i+1 and 2i+2 from inside the pool, so everything but the root goes through the workers'
+ * deques (and, with the tiny deque used below, through the overflow path too). */
+static void s_fan_out_task_fn(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    size_t index = (size_t)arg;
+
+    if (status == AWS_TASK_STATUS_RUN_READY) {
+        for (size_t child = 2 * index + 1; child <= 2 * index + 2 && child < s_test_data.task_count; ++child) {
+            aws_task_init(&s_test_data.tasks[child], s_fan_out_task_fn, (void *)child, "thread_pool_fan_out");
+            aws_thread_pool_submit(s_test_data.pool, &s_test_data.tasks[child]);
+        }
+    }
+
+    s_record_run(index, status);
+}
+
+static int s_test_thread_pool_submit_from_worker(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_common_library_init(allocator);
+
+    enum { TASK_COUNT = (1 << 12) - 1 };
+    ASSERT_SUCCESS(s_test_data_init(allocator, TASK_COUNT));
+
+    struct aws_thread_pool_options options = {
+        .worker_count = 3,
+        .deque_capacity = 8,
+    };
+    s_test_data.pool = aws_thread_pool_new(allocator, &options);
+    ASSERT_NOT_NULL(s_test_data.pool);
+
+    aws_task_init(&s_test_data.tasks[0], s_fan_out_task_fn, (void *)0, "thread_pool_fan_out");
+    aws_thread_pool_submit(s_test_data.pool, &s_test_data.tasks[0]);
+
+    ASSERT_SUCCESS(s_wait_for_all_tasks());
+    ASSERT_UINT_EQUALS(TASK_COUNT, aws_atomic_load_int(&s_test_data.ready_count));
+    ASSERT_SUCCESS(s_check_each_task_ran_once());
+
+    aws_thread_pool_release(s_test_data.pool);
+    s_test_data_clean_up(allocator);
+    aws_common_library_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(thread_pool_submit_from_worker, s_test_thread_pool_submit_from_worker)
+
+/* Whatever hasn't run by the time the pool is released must be canceled, and nothing may run twice. */
+static int s_test_thread_pool_release_cancels_pending(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_common_library_init(allocator);
+
+    enum { TASK_COUNT = 1000 };
+    ASSERT_SUCCESS(s_test_data_init(allocator, TASK_COUNT));
+
+    struct aws_thread_pool_options options = {.worker_count = 2};
+    struct aws_thread_pool *pool = aws_thread_pool_new(allocator, &options);
+    ASSERT_NOT_NULL(pool);
+
+    for (size_t i = 0; i < TASK_COUNT; ++i) {
+        aws_task_init(&s_test_data.tasks[i], s_counting_task_fn, (void *)i, "thread_pool_release_cancels_pending");
+        aws_thread_pool_submit(pool, &s_test_data.tasks[i]);
+    }
+
+    aws_thread_pool_release(pool);
+
+    ASSERT_TRUE(s_all_tasks_done_pred(NULL));
+    ASSERT_SUCCESS(s_check_each_task_ran_once());
+
+    s_test_data_clean_up(allocator);
+    aws_common_library_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(thread_pool_release_cancels_pending, s_test_thread_pool_release_cancels_pending)
+
+static int s_test_thread_pool_pinned_to_cpu_group(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_common_library_init(allocator);
+
+    enum { TASK_COUNT = 100 };
+    ASSERT_SUCCESS(s_test_data_init(allocator, TASK_COUNT));
+
+    uint16_t cpu_group = 0;
+    struct aws_thread_pool_options options = {
+        .worker_count = 2,
+        .cpu_group = &cpu_group,
+    };
+    struct aws_thread_pool *pool = aws_thread_pool_new(allocator, &options);
+    ASSERT_NOT_NULL(pool);
+
+    for (size_t i = 0; i < TASK_COUNT; ++i) {
+        aws_task_init(&s_test_data.tasks[i], s_counting_task_fn, (void *)i, "thread_pool_pinned_to_cpu_group");
+        aws_thread_pool_submit(pool, &s_test_data.tasks[i]);
+    }
+
+    ASSERT_SUCCESS(s_wait_for_all_tasks());
+    ASSERT_SUCCESS(s_check_each_task_ran_once());
+
+    aws_thread_pool_release(pool);
+    s_test_data_clean_up(allocator);
+    aws_common_library_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(thread_pool_pinned_to_cpu_group, s_test_thread_pool_pinned_to_cpu_group)
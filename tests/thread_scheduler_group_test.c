@@ -0,0 +1,188 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/common/thread_scheduler_group.h>
+
+#include <aws/common/atomics.h>
+#include <aws/common/clock.h>
+#include <aws/common/condition_variable.h>
+#include <aws/common/mutex.h>
+#include <aws/common/task_scheduler.h>
+#include <aws/common/thread.h>
+#include <aws/common/thread_scheduler.h>
+#include <aws/testing/aws_test_harness.h>
+
+enum {
+    KEY_COUNT = 64,
+    TASKS_PER_KEY = 100,
+};
+
+struct key_state {
+    /* only touched from the key's scheduler thread, which is the point of the group */
+    size_t next_sequence;
+    aws_thread_id_t thread_id;
+    bool out_of_order;
+    bool moved_threads;
+};
+
+struct keyed_task {
+    struct aws_task task;
+    struct key_state *key_state;
+    size_t sequence;
+};
+
+static struct aws_mutex s_mutex = AWS_MUTEX_INIT;
+static struct aws_condition_variable s_c_var = AWS_CONDITION_VARIABLE_INIT;
+static size_t s_done_count;
+
+static void s_keyed_task_fn(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    struct keyed_task *keyed_task = arg;
+    struct key_state *key_state = keyed_task->key_state;
+
+    aws_thread_id_t thread_id = aws_thread_current_thread_id();
+    if (keyed_task->sequence == 0) {
+        key_state->thread_id = thread_id;
+    } else if (!aws_thread_thread_id_equal(key_state->thread_id, thread_id)) {
+        key_state->moved_threads = true;
+    }
+
+    if (keyed_task->sequence != key_state->next_sequence) {
+        key_state->out_of_order = true;
+    }
+    key_state->next_sequence = keyed_task->sequence + 1;
+
+    aws_mutex_lock(&s_mutex);
+    ++s_done_count;
+    aws_mutex_unlock(&s_mutex);
+    aws_condition_variable_notify_one(&s_c_var);
+}
+
+static bool s_all_done_pred(void *arg) {
+    size_t *expected = arg;
+    return s_done_count == *expected;
+}
+
+static int s_test_thread_scheduler_group_key_ordering(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_common_library_init(allocator);
+    s_done_count = 0;
+
+    struct aws_thread_scheduler_group_options options = {.scheduler_count = 4};
+    struct aws_thread_scheduler_group *group = aws_thread_scheduler_group_new(allocator, &options);
+    ASSERT_NOT_NULL(group);
+    ASSERT_UINT_EQUALS(4, aws_thread_scheduler_group_get_scheduler_count(group));
+
+    struct key_state key_states[KEY_COUNT];
+    AWS_ZERO_ARRAY(key_states);
+    struct keyed_task *tasks = aws_mem_calloc(allocator, KEY_COUNT * TASKS_PER_KEY, sizeof(struct keyed_task));
+    ASSERT_NOT_NULL(tasks);
+
+    /* interleave the keys, so that each scheduler sees several keys' tasks mixed together */
+    for (size_t sequence = 0; sequence < TASKS_PER_KEY; ++sequence) {
+        for (size_t key = 0; key < KEY_COUNT; ++key) {
+            struct keyed_task *keyed_task = &tasks[sequence * KEY_COUNT + key];
+            keyed_task->key_state = &key_states[key];
+            keyed_task->sequence = sequence;
+            aws_task_init(&keyed_task->task, s_keyed_task_fn, keyed_task, "scheduler_group_keyed");
+            aws_thread_scheduler_group_schedule_now(group, key, &keyed_task->task);
+        }
+    }
+
+    ASSERT_SUCCESS(aws_mutex_lock(&s_mutex));
+    size_t expected = KEY_COUNT * TASKS_PER_KEY;
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(&s_c_var, &s_mutex, s_all_done_pred, &expected));
+    ASSERT_SUCCESS(aws_mutex_unlock(&s_mutex));
+
+    bool used_schedulers[4] = {false};
+    for (size_t key = 0; key < KEY_COUNT; ++key) {
+        ASSERT_FALSE(key_states[key].out_of_order);
+        ASSERT_FALSE(key_states[key].moved_threads);
+        ASSERT_UINT_EQUALS(TASKS_PER_KEY, key_states[key].next_sequence);
+
+        struct aws_thread_scheduler *scheduler = aws_thread_scheduler_group_get_scheduler_for_key(group, key);
+        for (size_t i = 0; i < AWS_ARRAY_SIZE(used_schedulers); ++i) {
+            if (aws_thread_scheduler_group_get_scheduler(group, i) == scheduler) {
+                used_schedulers[i] = true;
+            }
+        }
+    }
+
+    /* 64 keys are plenty to land on every one of 4 schedulers */
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(used_schedulers); ++i) {
+        ASSERT_TRUE(used_schedulers[i]);
+    }
+
+    aws_thread_scheduler_group_release(group);
+    aws_mem_release(allocator, tasks);
+    aws_common_library_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(thread_scheduler_group_key_ordering, s_test_thread_scheduler_group_key_ordering)
+
+static void s_noop_task_fn(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)arg;
+    (void)status;
+}
+
+/* Queue depths are published by the schedulers' threads as they go, so wait for them to settle. */
+static int s_wait_for_total_queue_depth(struct aws_thread_scheduler_group *group, size_t expected) {
+    struct aws_thread_scheduler_group_metrics metrics;
+    for (size_t attempt = 0; attempt < 1000; ++attempt) {
+        aws_thread_scheduler_group_get_metrics(group, &metrics);
+        if (metrics.total_queue_depth == expected) {
+            return AWS_OP_SUCCESS;
+        }
+        aws_thread_current_sleep(1000000);
+    }
+
+    ASSERT_UINT_EQUALS(expected, metrics.total_queue_depth);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_test_thread_scheduler_group_metrics(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_common_library_init(allocator);
+
+    uint16_t cpu_group = 0;
+    struct aws_thread_scheduler_group_options options = {.cpu_group = &cpu_group};
+    struct aws_thread_scheduler_group *group = aws_thread_scheduler_group_new(allocator, &options);
+    ASSERT_NOT_NULL(group);
+    size_t scheduler_count = aws_thread_scheduler_group_get_scheduler_count(group);
+    ASSERT_TRUE(scheduler_count >= 1);
+
+    uint64_t far_future = 0;
+    aws_high_res_clock_get_ticks(&far_future);
+    far_future += (uint64_t)3600 * AWS_TIMESTAMP_NANOS;
+
+    /* every task on key 7, so they all queue up on one scheduler */
+    struct aws_task tasks[10];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tasks); ++i) {
+        aws_task_init(&tasks[i], s_noop_task_fn, NULL, "scheduler_group_metrics");
+        aws_thread_scheduler_group_schedule_future(group, 7, &tasks[i], far_future);
+    }
+
+    ASSERT_SUCCESS(s_wait_for_total_queue_depth(group, AWS_ARRAY_SIZE(tasks)));
+    struct aws_thread_scheduler_group_metrics metrics;
+    aws_thread_scheduler_group_get_metrics(group, &metrics);
+    ASSERT_UINT_EQUALS(AWS_ARRAY_SIZE(tasks), metrics.max_queue_depth);
+    ASSERT_PTR_EQUALS(
+        aws_thread_scheduler_group_get_scheduler_for_key(group, 7),
+        aws_thread_scheduler_group_get_scheduler(group, metrics.max_queue_depth_index));
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tasks); ++i) {
+        aws_thread_scheduler_group_cancel_task(group, 7, &tasks[i]);
+    }
+    ASSERT_SUCCESS(s_wait_for_total_queue_depth(group, 0));
+
+    aws_thread_scheduler_group_release(group);
+    aws_common_library_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(thread_scheduler_group_metrics, s_test_thread_scheduler_group_metrics)
@@ -8,6 +8,7 @@
 #include <aws/common/clock.h>
 #include <aws/common/condition_variable.h>
 #include <aws/common/task_scheduler.h>
+#include <aws/common/thread.h>
 #include <aws/testing/aws_test_harness.h>
 
 struct executed_task_data {
@@ -236,3 +237,363 @@ static int s_test_scheduler_cancellation_for_pending_scheduled_task(struct aws_a
 AWS_TEST_CASE(
     test_scheduler_cancellation_for_pending_scheduled_task,
     s_test_scheduler_cancellation_for_pending_scheduled_task)
+
+enum {
+    CONCURRENT_SUBMISSION_PRODUCERS = 4,
+    CONCURRENT_SUBMISSION_TASKS_PER_PRODUCER = 2000,
+};
+
+struct concurrent_submission_producer {
+    struct aws_thread_scheduler *scheduler;
+    struct aws_task tasks[CONCURRENT_SUBMISSION_TASKS_PER_PRODUCER];
+    /* only touched from the scheduler thread */
+    size_t next_expected;
+    bool out_of_order;
+};
+
+static struct concurrent_submission_producer s_producers[CONCURRENT_SUBMISSION_PRODUCERS];
+static size_t s_concurrent_tasks_run;
+
+static void s_concurrent_submission_task_fn(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)status;
+    struct concurrent_submission_producer *producer = arg;
+    size_t sequence = (size_t)(task - producer->tasks);
+    if (sequence != producer->next_expected) {
+        producer->out_of_order = true;
+    }
+    producer->next_expected = sequence + 1;
+
+    aws_mutex_lock(&s_test_mutex);
+    ++s_concurrent_tasks_run;
+    aws_mutex_unlock(&s_test_mutex);
+    aws_condition_variable_notify_one(&s_test_c_var);
+}
+
+static void s_concurrent_submission_producer_fn(void *arg) {
+    struct concurrent_submission_producer *producer = arg;
+    for (size_t i = 0; i < CONCURRENT_SUBMISSION_TASKS_PER_PRODUCER; ++i) {
+        aws_task_init(&producer->tasks[i], s_concurrent_submission_task_fn, producer, "concurrent_submission");
+        aws_thread_scheduler_schedule_now(producer->scheduler, &producer->tasks[i]);
+    }
+}
+
+static bool s_concurrent_tasks_ran_predicate(void *arg) {
+    (void)arg;
+    return s_concurrent_tasks_run == CONCURRENT_SUBMISSION_PRODUCERS * CONCURRENT_SUBMISSION_TASKS_PER_PRODUCER;
+}
+
+/* several threads submit at once: every task must run exactly once, and each thread's tasks in submission order. */
+static int s_test_scheduler_concurrent_submission(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_common_library_init(allocator);
+    s_concurrent_tasks_run = 0;
+
+    struct aws_thread_scheduler *thread_scheduler = aws_thread_scheduler_new(allocator, NULL);
+    ASSERT_NOT_NULL(thread_scheduler);
+
+    struct aws_thread threads[CONCURRENT_SUBMISSION_PRODUCERS];
+    for (size_t i = 0; i < CONCURRENT_SUBMISSION_PRODUCERS; ++i) {
+        AWS_ZERO_STRUCT(s_producers[i]);
+        s_producers[i].scheduler = thread_scheduler;
+        ASSERT_SUCCESS(aws_thread_init(&threads[i], allocator));
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], s_concurrent_submission_producer_fn, &s_producers[i], NULL));
+    }
+
+    for (size_t i = 0; i < CONCURRENT_SUBMISSION_PRODUCERS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]));
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    ASSERT_SUCCESS(aws_mutex_lock(&s_test_mutex));
+    ASSERT_SUCCESS(
+        aws_condition_variable_wait_pred(&s_test_c_var, &s_test_mutex, s_concurrent_tasks_ran_predicate, NULL));
+    ASSERT_SUCCESS(aws_mutex_unlock(&s_test_mutex));
+
+    aws_thread_scheduler_release(thread_scheduler);
+
+    for (size_t i = 0; i < CONCURRENT_SUBMISSION_PRODUCERS; ++i) {
+        ASSERT_FALSE(s_producers[i].out_of_order);
+        ASSERT_UINT_EQUALS(CONCURRENT_SUBMISSION_TASKS_PER_PRODUCER, s_producers[i].next_expected);
+    }
+
+    aws_common_library_clean_up();
+    return 0;
+}
+
+AWS_TEST_CASE(test_thread_scheduler_concurrent_submission, s_test_scheduler_concurrent_submission)
+
+enum {
+    CANCEL_RACE_TASKS = 5000,
+};
+
+static struct aws_task s_cancel_race_tasks[CANCEL_RACE_TASKS];
+static struct aws_atomic_var s_cancel_race_invocations[CANCEL_RACE_TASKS];
+static size_t s_cancel_race_ready;
+static size_t s_cancel_race_canceled;
+
+static void s_cancel_race_task_fn(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)arg;
+    aws_atomic_fetch_add(&s_cancel_race_invocations[task - s_cancel_race_tasks], 1);
+
+    aws_mutex_lock(&s_test_mutex);
+    if (status == AWS_TASK_STATUS_RUN_READY) {
+        ++s_cancel_race_ready;
+    } else {
+        ++s_cancel_race_canceled;
+    }
+    aws_mutex_unlock(&s_test_mutex);
+    aws_condition_variable_notify_one(&s_test_c_var);
+}
+
+static bool s_cancel_race_ready_predicate(void *arg) {
+    size_t *expected_ready = arg;
+    return s_cancel_race_ready == *expected_ready;
+}
+
+static bool s_cancel_race_done_predicate(void *arg) {
+    (void)arg;
+    return s_cancel_race_ready + s_cancel_race_canceled == CANCEL_RACE_TASKS;
+}
+
+struct cancel_race_canceller {
+    struct aws_thread_scheduler *scheduler;
+    bool reverse;
+};
+
+static void s_cancel_race_canceller_fn(void *arg) {
+    struct cancel_race_canceller *canceller = arg;
+    for (size_t i = 0; i < CANCEL_RACE_TASKS; ++i) {
+        size_t index = canceller->reverse ? CANCEL_RACE_TASKS - 1 - i : i;
+        aws_thread_scheduler_cancel_task(canceller->scheduler, &s_cancel_race_tasks[index]);
+    }
+}
+
+static void s_cancel_race_reset(void) {
+    s_cancel_race_ready = 0;
+    s_cancel_race_canceled = 0;
+    for (size_t i = 0; i < CANCEL_RACE_TASKS; ++i) {
+        aws_task_init(&s_cancel_race_tasks[i], s_cancel_race_task_fn, NULL, "cancel_race");
+        aws_atomic_init_int(&s_cancel_race_invocations[i], 0);
+    }
+}
+
+static int s_wait_for_cancel_race_tasks(void) {
+    ASSERT_SUCCESS(aws_mutex_lock(&s_test_mutex));
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(&s_test_c_var, &s_test_mutex, s_cancel_race_done_predicate, NULL));
+    ASSERT_SUCCESS(aws_mutex_unlock(&s_test_mutex));
+
+    for (size_t i = 0; i < CANCEL_RACE_TASKS; ++i) {
+        ASSERT_UINT_EQUALS(1, aws_atomic_load_int(&s_cancel_race_invocations[i]));
+    }
+    return AWS_OP_SUCCESS;
+}
+
+/* Two foreign threads cancel tasks (from opposite ends) while they are being submitted and run. Whichever side wins,
+ * every task must be invoked exactly once. */
+static int s_test_scheduler_cancel_run_race(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_common_library_init(allocator);
+    s_cancel_race_reset();
+
+    struct aws_thread_scheduler *thread_scheduler = aws_thread_scheduler_new(allocator, NULL);
+    ASSERT_NOT_NULL(thread_scheduler);
+
+    struct cancel_race_canceller cancellers[2] = {
+        {.scheduler = thread_scheduler, .reverse = false},
+        {.scheduler = thread_scheduler, .reverse = true},
+    };
+
+    for (size_t i = 0; i < CANCEL_RACE_TASKS / 2; ++i) {
+        aws_thread_scheduler_schedule_now(thread_scheduler, &s_cancel_race_tasks[i]);
+    }
+
+    struct aws_thread threads[AWS_ARRAY_SIZE(cancellers)];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(cancellers); ++i) {
+        ASSERT_SUCCESS(aws_thread_init(&threads[i], allocator));
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], s_cancel_race_canceller_fn, &cancellers[i], NULL));
+    }
+
+    /* keep submitting while the cancellers run. Canceling a task before it's submitted does nothing, and canceling one
+     * that is still on its way to the thread makes the thread run it canceled when it takes it. */
+    for (size_t i = CANCEL_RACE_TASKS / 2; i < CANCEL_RACE_TASKS; ++i) {
+        aws_thread_scheduler_schedule_now(thread_scheduler, &s_cancel_race_tasks[i]);
+    }
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(cancellers); ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]));
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    ASSERT_SUCCESS(s_wait_for_cancel_race_tasks());
+
+    aws_thread_scheduler_release(thread_scheduler);
+    aws_common_library_clean_up();
+    return 0;
+}
+
+AWS_TEST_CASE(test_thread_scheduler_cancel_run_race, s_test_scheduler_cancel_run_race)
+
+/* Canceling far-future tasks from a foreign thread must hand them back right away, and canceling a task that already
+ * ran must not invoke it again. */
+static int s_test_scheduler_cancel_future_tasks(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_common_library_init(allocator);
+    s_cancel_race_reset();
+
+    struct aws_thread_scheduler *thread_scheduler = aws_thread_scheduler_new(allocator, NULL);
+    ASSERT_NOT_NULL(thread_scheduler);
+
+    uint64_t far_future = 0;
+    aws_high_res_clock_get_ticks(&far_future);
+    far_future += (uint64_t)3600 * AWS_TIMESTAMP_NANOS;
+
+    aws_thread_scheduler_schedule_now(thread_scheduler, &s_cancel_race_tasks[0]);
+    for (size_t i = 1; i < CANCEL_RACE_TASKS; ++i) {
+        aws_thread_scheduler_schedule_future(thread_scheduler, &s_cancel_race_tasks[i], far_future + i);
+    }
+
+    /* wait for the first task, so that canceling it below is a cancel after run */
+    ASSERT_SUCCESS(aws_mutex_lock(&s_test_mutex));
+    size_t expected_ready = 1;
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(
+        &s_test_c_var, &s_test_mutex, s_cancel_race_ready_predicate, &expected_ready));
+    ASSERT_SUCCESS(aws_mutex_unlock(&s_test_mutex));
+
+    struct cancel_race_canceller canceller = {.scheduler = thread_scheduler, .reverse = true};
+    struct aws_thread thread;
+    ASSERT_SUCCESS(aws_thread_init(&thread, allocator));
+    ASSERT_SUCCESS(aws_thread_launch(&thread, s_cancel_race_canceller_fn, &canceller, NULL));
+    ASSERT_SUCCESS(aws_thread_join(&thread));
+    aws_thread_clean_up(&thread);
+
+    ASSERT_SUCCESS(s_wait_for_cancel_race_tasks());
+    ASSERT_UINT_EQUALS(1, s_cancel_race_ready);
+    ASSERT_UINT_EQUALS(CANCEL_RACE_TASKS - 1, s_cancel_race_canceled);
+
+    aws_thread_scheduler_release(thread_scheduler);
+    aws_common_library_clean_up();
+    return 0;
+}
+
+AWS_TEST_CASE(test_thread_scheduler_cancel_future_tasks, s_test_scheduler_cancel_future_tasks)
+
+struct timer_slack_task {
+    struct aws_task task;
+    uint64_t ran_at;
+};
+
+static size_t s_timer_slack_ran;
+
+static void s_timer_slack_task_fn(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    (void)status;
+    struct timer_slack_task *slack_task = arg;
+    aws_high_res_clock_get_ticks(&slack_task->ran_at);
+
+    aws_mutex_lock(&s_test_mutex);
+    ++s_timer_slack_ran;
+    aws_mutex_unlock(&s_test_mutex);
+    aws_condition_variable_notify_one(&s_test_c_var);
+}
+
+static bool s_timer_slack_predicate(void *arg) {
+    size_t *waiting_for = arg;
+    return s_timer_slack_ran == *waiting_for;
+}
+
+static int s_test_scheduler_timer_slack(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_common_library_init(allocator);
+    s_timer_slack_ran = 0;
+
+    const uint64_t slack = 50000000;
+    struct aws_thread_scheduler_options options = {.timer_slack_ns = slack};
+    struct aws_thread_scheduler *thread_scheduler = aws_thread_scheduler_new_with_options(allocator, &options);
+    ASSERT_NOT_NULL(thread_scheduler);
+
+    /* three timers 5ms apart, well inside one slack window. The window starts at least one full slack away, since any
+     * wakeup after the first timer is due (e.g. for a submission, if this thread gets descheduled between them) would
+     * run it right away. */
+    uint64_t now = 0;
+    aws_high_res_clock_get_ticks(&now);
+    uint64_t first_time = (now / slack + 2) * slack + 1000000;
+
+    struct timer_slack_task tasks[3];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tasks); ++i) {
+        aws_task_init(&tasks[i].task, s_timer_slack_task_fn, &tasks[i], "timer_slack");
+        aws_thread_scheduler_schedule_future(thread_scheduler, &tasks[i].task, first_time + i * 5000000);
+    }
+
+    ASSERT_SUCCESS(aws_mutex_lock(&s_test_mutex));
+    size_t expected = AWS_ARRAY_SIZE(tasks);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(&s_test_c_var, &s_test_mutex, s_timer_slack_predicate, &expected));
+    ASSERT_SUCCESS(aws_mutex_unlock(&s_test_mutex));
+
+    /* none ran early, and the earlier timers were held back to share the last one's wakeup */
+    uint64_t last_time = tasks[AWS_ARRAY_SIZE(tasks) - 1].task.timestamp;
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tasks); ++i) {
+        ASSERT_TRUE(tasks[i].ran_at >= tasks[i].task.timestamp);
+        ASSERT_TRUE(tasks[i].ran_at >= last_time);
+    }
+
+    aws_thread_scheduler_release(thread_scheduler);
+    aws_common_library_clean_up();
+    return 0;
+}
+
+AWS_TEST_CASE(test_thread_scheduler_timer_slack, s_test_scheduler_timer_slack)
+
+static int s_test_scheduler_wakeup_backends(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    aws_common_library_init(allocator);
+
+    enum aws_thread_scheduler_wakeup_backend backends[] = {
+        AWS_THREAD_SCHEDULER_WAKEUP_BACKEND_DEFAULT,
+        AWS_THREAD_SCHEDULER_WAKEUP_BACKEND_CONDITION_VARIABLE,
+        AWS_THREAD_SCHEDULER_WAKEUP_BACKEND_EPOLL,
+    };
+
+    for (size_t b = 0; b < AWS_ARRAY_SIZE(backends); ++b) {
+        struct aws_thread_scheduler_options options = {.wakeup_backend = backends[b]};
+        struct aws_thread_scheduler *thread_scheduler = aws_thread_scheduler_new_with_options(allocator, &options);
+#if !defined(__linux__)
+        if (backends[b] == AWS_THREAD_SCHEDULER_WAKEUP_BACKEND_EPOLL) {
+            ASSERT_NULL(thread_scheduler);
+            ASSERT_INT_EQUALS(AWS_ERROR_PLATFORM_NOT_SUPPORTED, aws_last_error());
+            continue;
+        }
+#endif
+        ASSERT_NOT_NULL(thread_scheduler);
+        s_timer_slack_ran = 0;
+
+        /* let the thread go to sleep with nothing to do, so the first submission has to wake it up */
+        aws_thread_current_sleep(10000000);
+
+        struct timer_slack_task tasks[3];
+        uint64_t now = 0;
+        aws_high_res_clock_get_ticks(&now);
+        for (size_t i = 0; i < AWS_ARRAY_SIZE(tasks); ++i) {
+            aws_task_init(&tasks[i].task, s_timer_slack_task_fn, &tasks[i], "wakeup_backend");
+        }
+        aws_thread_scheduler_schedule_now(thread_scheduler, &tasks[0].task);
+        aws_thread_scheduler_schedule_future(thread_scheduler, &tasks[1].task, now + 2000000);
+        aws_thread_scheduler_schedule_future(thread_scheduler, &tasks[2].task, now + 20000000);
+
+        ASSERT_SUCCESS(aws_mutex_lock(&s_test_mutex));
+        size_t expected = AWS_ARRAY_SIZE(tasks);
+        ASSERT_SUCCESS(
+            aws_condition_variable_wait_pred(&s_test_c_var, &s_test_mutex, s_timer_slack_predicate, &expected));
+        ASSERT_SUCCESS(aws_mutex_unlock(&s_test_mutex));
+
+        for (size_t i = 1; i < AWS_ARRAY_SIZE(tasks); ++i) {
+            ASSERT_TRUE(tasks[i].ran_at >= tasks[i].task.timestamp);
+        }
+
+        aws_thread_scheduler_release(thread_scheduler);
+    }
+
+    aws_common_library_clean_up();
+    return 0;
+}
+
+AWS_TEST_CASE(test_thread_scheduler_wakeup_backends, s_test_scheduler_wakeup_backends)